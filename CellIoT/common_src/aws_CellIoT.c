@@ -60,9 +60,8 @@ CELLIOTReturnCode_t CELLIOT_On( uint32_t baudrate )
     if (kStatus_Success != result)
         return eCellIoTFailure;
 
-    /* Power off the module and wait 30ms */
+    /* Power off the module. No fixed wait: readiness is probed by the reset sequence */
     //CELLIOTSHIELD_PowerUp(false);	/*TODO:Later, have a look at this */
-    vTaskDelay(MSEC_TO_TICK(30));
 
     /* Create a on_CellIoT semaphore, */
     g_CellIoT_semaph = xSemaphoreCreateBinary();
@@ -75,8 +74,7 @@ CELLIOTReturnCode_t CELLIOT_On( uint32_t baudrate )
     if (NULL == g_connect_semaph)
         return eCellIoTFailure;
 
-    /* Wait for Cellular-IoT */
-    vTaskDelay(MSEC_TO_TICK(100));
+    /* Cellular-IoT readiness is detected with +SYSSTART and AT probes on reset */
     g_CellIoT_is_on = 1;
 
     return eCellIoTSuccess;
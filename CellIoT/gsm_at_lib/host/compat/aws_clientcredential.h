@@ -0,0 +1,11 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/* Host stand-in, the host build does not connect to a cloud */
+#ifndef __AWS_CLIENTCREDENTIAL__H__
+#define __AWS_CLIENTCREDENTIAL__H__
+
+#endif /* __AWS_CLIENTCREDENTIAL__H__ */
@@ -0,0 +1,15 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/* Host stand-in for the MCUXpresso SDK header, debug console goes to stdout */
+#ifndef _FSL_DEBUGCONSOLE_H_
+#define _FSL_DEBUGCONSOLE_H_
+
+#include <stdio.h>
+
+#define PRINTF printf
+
+#endif /* _FSL_DEBUGCONSOLE_H_ */
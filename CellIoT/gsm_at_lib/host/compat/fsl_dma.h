@@ -0,0 +1,20 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/* Host stand-in for the MCUXpresso SDK header, only types named by CellIoT_lib.h */
+#ifndef _FSL_DMA_H_
+#define _FSL_DMA_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef int32_t status_t;
+
+#define DMA_MAX_TRANSFER_COUNT 0x400U
+
+typedef struct _dma_handle dma_handle_t;
+
+#endif /* _FSL_DMA_H_ */
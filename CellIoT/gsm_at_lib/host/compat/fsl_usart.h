@@ -0,0 +1,15 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/* Host stand-in for the MCUXpresso SDK header, only types named by CellIoT_lib.h */
+#ifndef _FSL_USART_H_
+#define _FSL_USART_H_
+
+#include "fsl_dma.h"
+
+typedef struct _usart_type USART_Type;
+
+#endif /* _FSL_USART_H_ */
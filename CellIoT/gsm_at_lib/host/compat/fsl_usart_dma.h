@@ -0,0 +1,15 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/* Host stand-in for the MCUXpresso SDK header, only types named by CellIoT_lib.h */
+#ifndef _FSL_USART_DMA_H_
+#define _FSL_USART_DMA_H_
+
+#include "fsl_usart.h"
+
+typedef struct _usart_dma_handle usart_dma_handle_t;
+
+#endif /* _FSL_USART_DMA_H_ */
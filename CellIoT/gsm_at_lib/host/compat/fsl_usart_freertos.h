@@ -0,0 +1,13 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+/* Host stand-in for the MCUXpresso SDK header, nothing of it is used on the host */
+#ifndef __FSL_USART_RTOS_H__
+#define __FSL_USART_RTOS_H__
+
+#include "fsl_usart_dma.h"
+
+#endif /* __FSL_USART_RTOS_H__ */
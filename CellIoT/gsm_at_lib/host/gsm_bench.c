@@ -0,0 +1,170 @@
+/**
+ * \file            gsm_bench.c
+ * \brief           Socket throughput and latency of the library against a loopback TCP server
+ */
+
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "gsm_private.h"
+#include "gsm_ll_sim.h"
+#include "gsm_sim_tcp.h"
+#include "CellIoT_lib.h"
+
+/*
+ * Usage:
+ *   gsm_bench [blocks] [block_size]
+ *
+ * Blocks are sent one after another with AT+SQNSSENDEXT to a TCP echo server
+ * of this process and read back on +SQNSRING with AT+SQNSRECV, through the
+ * simulated module and a real socket of the host. Round trip time of each
+ * block and throughput are printed with the module side counters.
+ *
+ * Time spent on the AT port is simulated at its negotiated line rate,
+ * processing times of the module are given in bench_run. Network latency
+ * is the one of the loopback interface.
+ */
+
+#define BENCH_BLOCKS                200
+#define BENCH_BLOCK_SIZE            512
+#define BENCH_BLOCK_SIZE_MAX        1024        /* Echo of a block must fit in socket buffer of the module */
+#define BENCH_RECV_TIMEOUT          5000
+
+#define BENCH_CHECK(cond)           do { if (!(cond)) { printf("FAIL %s:%d: %s\r\n", __FILE__, __LINE__, #cond); return 0; } } while (0)
+
+static int bench_listen_fd = -1;
+
+/**
+ * \brief           Echo everything received, one connection at a time
+ */
+static void*
+bench_echo_server(void* arg) {
+    uint8_t buff[2048];
+    ssize_t n;
+    int fd;
+
+    GSM_UNUSED(arg);
+    while ((fd = accept(bench_listen_fd, NULL, NULL)) >= 0) {
+        while ((n = recv(fd, buff, sizeof(buff), 0)) > 0) {
+            if (send(fd, buff, (size_t)n, MSG_NOSIGNAL) != n) {
+                break;
+            }
+        }
+        close(fd);
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Start echo server on loopback interface
+ * \return          Port of the server, `0` on failure
+ */
+static uint16_t
+bench_echo_start(void) {
+    struct sockaddr_in addr = { 0 };
+    socklen_t addr_len = sizeof(addr);
+    pthread_t thread;
+
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((bench_listen_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0
+        || bind(bench_listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0
+        || listen(bench_listen_fd, 1) != 0
+        || getsockname(bench_listen_fd, (struct sockaddr*)&addr, &addr_len) != 0
+        || pthread_create(&thread, NULL, bench_echo_server, NULL) != 0) {
+        return 0;
+    }
+    pthread_detach(thread);
+    return ntohs(addr.sin_port);
+}
+
+/**
+ * \brief           Run the benchmark
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+bench_run(uint32_t blocks, uint32_t size) {
+    static unsigned char tx[BENCH_BLOCK_SIZE_MAX], rx[BENCH_BLOCK_SIZE_MAX];
+    gsm_ll_sim_cfg_t cfg = { 0 };
+    gsm_ll_sim_stats_t stats;
+    uint32_t start, t, rtt, rtt_min = UINT32_MAX, rtt_max = 0, rtt_sum = 0, elapsed, len;
+    uint16_t port;
+    uint8_t conn;
+
+    BENCH_CHECK((port = bench_echo_start()) != 0);
+
+    cfg.cmd_delay = 2;
+    cfg.urc_delay = 5;
+    cfg.boot_time = 20;
+    cfg.peer = &gsm_sim_tcp_peer;
+    BENCH_CHECK(gsm_ll_sim_start(&cfg) == gsmOK);
+    BENCH_CHECK(gsm_init(NULL, 1) == gsmOK);
+
+    BENCH_CHECK((conn = CellIoT_lib_socketAlloc()) != 0);
+    /* Hex encoded data both ways, as SOCKETS_SetCfgExt of the application */
+    BENCH_CHECK(CellIoT_lib_setSocketCfgExt(conn, 1, 1, 0, 1, 1, NULL, NULL, 1) == gsmOK);
+    BENCH_CHECK(CellIoT_lib_socketDial(conn, 0, port, "127.0.0.1", 0, 0, 1, 0, NULL, NULL, 1) == gsmOK);
+
+    start = gsm_sys_now();
+    for (uint32_t b = 0; b < blocks; b++) {
+        for (uint32_t i = 0; i < size; i++) {
+            tx[i] = GSM_U8(b + i);
+        }
+        t = gsm_sys_now();
+        BENCH_CHECK(CellIoT_lib_socketSend(conn, tx, size) == gsmOK);
+        for (len = 0; len < size && gsm_sys_now() - t < BENCH_RECV_TIMEOUT;) {
+            len += CellIoT_lib_socketReadData(conn, &rx[len], GSM_U16(size - len));
+            if (len < size) {
+                gsm_delay(1);
+            }
+        }
+        BENCH_CHECK(len == size && !memcmp(rx, tx, size));
+        rtt = gsm_sys_now() - t;
+        rtt_min = GSM_MIN(rtt_min, rtt);
+        rtt_max = GSM_MAX(rtt_max, rtt);
+        rtt_sum += rtt;
+    }
+    elapsed = GSM_MAX(gsm_sys_now() - start, 1);
+
+    BENCH_CHECK(CellIoT_lib_socketClose(conn) == gsmOK);
+    CellIoT_lib_socketFree(conn);
+
+    gsm_ll_sim_get_stats(&stats);
+    printf("AT port %u baud, %u blocks of %u bytes in %u ms\r\n",
+        (unsigned)gsm.ll.uart.baudrate, (unsigned)blocks, (unsigned)size, (unsigned)elapsed);
+    printf("throughput %u bytes/s each way\r\n", (unsigned)((uint64_t)blocks * size * 1000 / elapsed));
+    printf("round trip ms: min %u, avg %u, max %u\r\n",
+        (unsigned)rtt_min, (unsigned)(rtt_sum / blocks), (unsigned)rtt_max);
+    printf("module: %u commands, %u URCs, AT bytes in %u / out %u, socket bytes out %u / in %u, dropped %u\r\n",
+        (unsigned)stats.commands, (unsigned)stats.urcs, (unsigned)stats.at_tx_bytes, (unsigned)stats.at_rx_bytes,
+        (unsigned)stats.sock_tx_bytes, (unsigned)stats.sock_rx_bytes, (unsigned)stats.sock_dropped);
+    printf("data arrival to AT+SQNSRECV ms: avg %u, max %u over %u reads\r\n",
+        (unsigned)(stats.rx_reads > 0 ? stats.rx_latency_sum / stats.rx_reads : 0),
+        (unsigned)stats.rx_latency_max, (unsigned)stats.rx_reads);
+    BENCH_CHECK(stats.sock_dropped == 0);
+    return 1;
+}
+
+int
+main(int argc, char** argv) {
+    uint32_t blocks = argc >= 2 ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_BLOCKS;
+    uint32_t size = argc >= 3 ? (uint32_t)strtoul(argv[2], NULL, 0) : BENCH_BLOCK_SIZE;
+
+    setvbuf(stdout, NULL, _IONBF, 0);
+    if (blocks == 0 || size == 0 || size > BENCH_BLOCK_SIZE_MAX) {
+        printf("Usage: %s [blocks] [block_size <= %u]\r\n", argv[0], (unsigned)BENCH_BLOCK_SIZE_MAX);
+        return 2;
+    }
+    return bench_run(blocks, size) ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+/**
+ * \file            gsm_config.h
+ * \brief           Configuration of the Linux host build
+ */
+
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef GSM_HDR_CONFIG_H
+#define GSM_HDR_CONFIG_H
+
+/*
+ * Same AT dialect as the board configuration in apps/gsm_config.h,
+ * with the AT port replaced by the replay and simulated module backends
+ */
+#define GSM_SEQUANS_SPECIFIC_CMD            1
+#define GSM_CFG_AT_ECHO                     0
+#define GSM_CFG_SYS_PORT                    GSM_SYS_PORT_POSIX
+#define GSM_CFG_INPUT_USE_PROCESS           1
+#define GSM_CFG_AT_PORT_BAUDRATE_115200     115200U
+#define GSM_CFG_AT_PORT_BAUDRATE_921600     921600U
+#define GSM_CFG_AT_PORT_BAUDRATE            GSM_CFG_AT_PORT_BAUDRATE_115200
+#define GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE  1
+#define GSM_CFG_AT_PORT_BAUDRATE_MAX        GSM_CFG_AT_PORT_BAUDRATE_921600
+
+#define GSM_CFG_NETWORK                     1
+#define GSM_CFG_CONN                        1
+#define GSM_CFG_NETCONN                     1
+#define GSM_CFG_MQTT_SQNS_SOCKETS           1
+
+#define GSM_CFG_AT_TRACE                    1
+#define GSM_CFG_AT_TRACE_BUFF_SIZE          0x4000
+#define GSM_CFG_STATS                       1
+#define GSM_CFG_LL_REPLAY                   1
+#define GSM_CFG_LL_SIM                      1
+
+#define GSM_CFG_DBG                         GSM_DBG_OFF
+
+/* CellIoT_lib.c gets it from FreeRTOS.h through the system port on the target */
+#include <assert.h>
+#define configASSERT(x)                     assert(x)
+
+#include "gsm_config_default.h"
+
+#endif /* GSM_HDR_CONFIG_H */
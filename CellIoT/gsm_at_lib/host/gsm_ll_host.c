@@ -0,0 +1,87 @@
+/**
+ * \file            gsm_ll_host.c
+ * \brief           Low-level driver of the Linux host build
+ */
+
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "gsm_private.h"
+#include "gsm_ll.h"
+#include "gsm_mem.h"
+#include "gsm_ll_replay.h"
+#include "gsm_ll_sim.h"
+
+/*
+ * There is no AT port on the host, a transcript loaded with
+ * gsm_ll_replay_start or the simulated module started with
+ * gsm_ll_sim_start talks to the library instead.
+ */
+
+/**
+ * \brief           Callback function called from initialization process
+ * \note            This function may be called multiple times if AT baudrate is changed from application
+ * \param[in,out]   ll: Pointer to \ref gsm_ll_t structure to fill data for communication functions
+ * \return          Member of \ref gsmr_t enumeration
+ */
+gsmr_t
+gsm_ll_init(gsm_ll_t* ll) {
+    if (gsm_ll_replay_is_active()) {
+        return gsm_ll_replay_init(ll);
+    }
+    if (gsm_ll_sim_is_active()) {
+        return gsm_ll_sim_init(ll);
+    }
+    return gsmERR;
+}
+
+/**
+ * \brief           Callback function to de-init low-level communication part
+ * \param[in,out]   ll: Pointer to \ref gsm_ll_t structure to fill data for communication functions
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_deinit(gsm_ll_t* ll) {
+    if (gsm_ll_replay_is_active()) {
+        return gsm_ll_replay_deinit(ll);
+    }
+    if (gsm_ll_sim_is_active()) {
+        return gsm_ll_sim_deinit(ll);
+    }
+    return gsmOK;
+}
+
+/* Custom allocator, see gsm_mem_lwmem.c for the target */
+
+void*
+gsm_mem_malloc(size_t size) {
+    return malloc(size);
+}
+
+void*
+gsm_mem_calloc(size_t num, size_t size) {
+    return calloc(num, size);
+}
+
+void
+gsm_mem_free(void* ptr) {
+    free(ptr);
+}
+
+/**
+ * \brief           Log output of the AT parser, goes to the FreeRTOS logging task on the target
+ */
+void
+vLoggingPrintf(const char* format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
@@ -0,0 +1,215 @@
+/**
+ * \file            gsm_session.c
+ * \brief           Record and replay an AT session on the Linux host
+ */
+
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gsm_private.h"
+#include "gsm_trace.h"
+#include "gsm_ll_replay.h"
+#include "gsm_ll_sim.h"
+#include "CellIoT_lib.h"
+
+/*
+ * Usage:
+ *   gsm_session record <transcript>            run the session against the simulated module
+ *   gsm_session replay <transcript> [chunk]    run the session against the transcript
+ *
+ * Transcripts are text, in the format of gsm_trace_dump, so sessions captured
+ * from the debug console of the board replay the same way. Lines starting with
+ * `#` are comments. Replay fails when the library does not send the recorded
+ * bytes or the session does not complete.
+ */
+
+#define SESSION_TRANSCRIPT_MAX      0x10000
+#define SESSION_HOST                "echo.example.com"
+#define SESSION_PORT                7
+#define SESSION_RECV_TIMEOUT        5000
+
+#define SESSION_CHECK(cond)         do { if (!(cond)) { printf("FAIL %s:%d: %s\r\n", __FILE__, __LINE__, #cond); return 0; } } while (0)
+
+static uint8_t transcript[SESSION_TRANSCRIPT_MAX];
+static size_t transcript_len;
+static uint8_t record;
+static FILE* record_file;
+
+/**
+ * \brief           Start recording before the reset sequence is sent
+ */
+static gsmr_t
+session_evt(gsm_evt_t* evt) {
+    if (record && evt->type == GSM_EVT_INIT_FINISH) {
+        gsm_trace_start();
+    }
+    return gsmOK;
+}
+
+/**
+ * \brief           Session shared by record and replay, library must send the same bytes in both
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+session_run(void) {
+    static const unsigned char msg[] = "GSM-AT host session";
+    unsigned char rx[64];
+    char params[64], ip_str[16];
+    gsm_ip_t ip;
+    uint32_t len = 0, start;
+    uint8_t conn;
+
+    SESSION_CHECK(gsm_init(session_evt, 1) == gsmOK);
+
+    SESSION_CHECK((conn = CellIoT_lib_socketAlloc()) != 0);
+    SESSION_CHECK(CellIoT_lib_getHostIP(SESSION_HOST, &ip, NULL, NULL, 1) == gsmOK);
+    sprintf(ip_str, "%u.%u.%u.%u", (unsigned)ip.ip[0], (unsigned)ip.ip[1], (unsigned)ip.ip[2], (unsigned)ip.ip[3]);
+    /* Hex encoded data both ways, as SOCKETS_SetCfgExt of the application */
+    SESSION_CHECK(CellIoT_lib_setSocketCfgExt(conn, 1, 1, 0, 1, 1, NULL, NULL, 1) == gsmOK);
+    SESSION_CHECK(CellIoT_lib_getSocketCfgExt(conn, params, sizeof(params)) == gsmOK);
+    SESSION_CHECK(!strcmp(params, "1,1,0,1,1"));
+    SESSION_CHECK(CellIoT_lib_socketDial(conn, 0, SESSION_PORT, ip_str, 0, 0, 1, 0, NULL, NULL, 1) == gsmOK);
+
+    /* Peer echoes the data, it is read on +SQNSRING */
+    SESSION_CHECK(CellIoT_lib_socketSend(conn, msg, sizeof(msg) - 1) == gsmOK);
+    for (start = gsm_sys_now(); len < sizeof(msg) - 1 && gsm_sys_now() - start < SESSION_RECV_TIMEOUT;) {
+        len += CellIoT_lib_socketReadData(conn, &rx[len], GSM_U16(sizeof(rx) - len));
+        gsm_delay(1);
+    }
+    SESSION_CHECK(len == sizeof(msg) - 1 && !memcmp(rx, msg, len));
+
+    SESSION_CHECK(CellIoT_lib_socketClose(conn) == gsmOK);
+    CellIoT_lib_socketFree(conn);
+    return 1;
+}
+
+/**
+ * \brief           Write one line of transcript dump
+ */
+static void
+session_dump_line(const char* line) {
+    fprintf(record_file, "%s\n", line);
+}
+
+/**
+ * \brief           Read text transcript to binary records
+ * \note            Dump splits records in lines of 32 bytes with the same time and direction
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+session_load(const char* path) {
+    char line[256], dir, *hex;
+    gsm_trace_rec_t rec, prev = { 0 };
+    size_t prev_pos = 0, n;
+    unsigned long time;
+    unsigned int byte;
+    FILE* f;
+
+    if ((f = fopen(path, "r")) == NULL) {
+        printf("Cannot open %s\r\n", path);
+        return 0;
+    }
+    transcript_len = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (line[0] == '#' || sscanf(line, "%lu %c", &time, &dir) != 2 || (hex = strchr(strchr(line, ' ') + 1, ' ')) == NULL) {
+            continue;
+        }
+        hex++;
+        n = strcspn(hex, "\r\n") / 2;
+        if (transcript_len + sizeof(rec) + n > sizeof(transcript)) {
+            fclose(f);
+            return 0;
+        }
+        if (prev.len > 0 && prev.len % 32 == 0 && prev.time == time && prev.dir == (uint8_t)dir) {
+            prev.len += GSM_U16(n);             /* Continuation of previous record */
+        } else {
+            prev.time = GSM_U32(time);
+            prev.len = GSM_U16(n);
+            prev.dir = GSM_U8(dir);
+            prev.reserved = 0;
+            prev_pos = transcript_len;
+            transcript_len += sizeof(rec);
+        }
+        GSM_MEMCPY(&transcript[prev_pos], &prev, sizeof(prev));
+        for (size_t i = 0; i < n && sscanf(&hex[2 * i], "%2x", &byte) == 1; i++) {
+            transcript[transcript_len++] = GSM_U8(byte);
+        }
+    }
+    fclose(f);
+    return transcript_len > 0;
+}
+
+static int
+session_record(const char* path) {
+    gsm_ll_sim_cfg_t cfg = { 0 };
+    const uint8_t* data;
+    size_t len;
+
+    cfg.cmd_delay = 2;
+    cfg.net_latency = 10;
+    cfg.urc_delay = 5;
+    cfg.boot_time = 20;
+    record = 1;
+    if (gsm_ll_sim_start(&cfg) != gsmOK || !session_run()) {
+        return 1;
+    }
+    gsm_trace_stop();
+    if (!gsm_trace_get(&data, &len)) {
+        printf("Transcript truncated, increase GSM_CFG_AT_TRACE_BUFF_SIZE\r\n");
+        return 1;
+    }
+    if ((record_file = fopen(path, "w")) == NULL) {
+        printf("Cannot create %s\r\n", path);
+        return 1;
+    }
+    fprintf(record_file, "# Recorded against the simulated module by gsm_session record\n");
+    gsm_trace_dump(session_dump_line);
+    fclose(record_file);
+    printf("Recorded %u bytes\r\n", (unsigned)len);
+    return 0;
+}
+
+static int
+session_replay(const char* path, size_t rx_chunk) {
+    gsm_ll_replay_cfg_t cfg = { 0 };
+    gsm_ll_replay_stats_t stats;
+    uint8_t ok;
+
+    if (!session_load(path)) {
+        return 1;
+    }
+    cfg.transcript = transcript;
+    cfg.len = transcript_len;
+    cfg.rx_chunk = rx_chunk;
+    cfg.tx_timeout = 2000;
+    if (gsm_ll_replay_start(&cfg) != gsmOK) {
+        return 1;
+    }
+    ok = session_run();
+    if (gsm_ll_replay_wait(5000, &stats) != gsmOK) {
+        printf("Transcript not finished\r\n");
+        ok = 0;
+    }
+    printf("records %u, rx %u, tx %u, tx mismatches %u, tx timeouts %u\r\n",
+        (unsigned)stats.records, (unsigned)stats.rx_bytes, (unsigned)stats.tx_bytes,
+        (unsigned)stats.tx_mismatches, (unsigned)stats.tx_timeouts);
+    return ok && stats.tx_mismatches == 0 && stats.tx_timeouts == 0 ? 0 : 1;
+}
+
+int
+main(int argc, char** argv) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    if (argc >= 3 && !strcmp(argv[1], "record")) {
+        return session_record(argv[2]);
+    } else if (argc >= 3 && !strcmp(argv[1], "replay")) {
+        return session_replay(argv[2], argc >= 4 ? (size_t)strtoul(argv[3], NULL, 0) : 0);
+    }
+    printf("Usage: %s record|replay <transcript> [rx_chunk]\r\n", argv[0]);
+    return 2;
+}
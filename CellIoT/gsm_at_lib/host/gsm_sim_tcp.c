@@ -0,0 +1,178 @@
+/**
+ * \file            gsm_sim_tcp.c
+ * \brief           TCP sockets of the host behind the simulated module
+ */
+
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "gsm_private.h"
+#include "gsm_sim_tcp.h"
+
+#define SIM_TCP_READ_SIZE           512
+
+/**
+ * \brief           Socket of one simulated connection
+ *
+ * Owned by its reader thread, which closes and frees it at end of stream.
+ * `closed` is set with core locked when the device or the peer closed the
+ * connection, nothing more is given to the simulated module after it.
+ */
+typedef struct {
+    int fd;                                     /*!< Socket descriptor */
+    uint8_t conn;                               /*!< Connection ID, `1` based as in AT commands */
+    uint8_t closed;                             /*!< Connection closed on module side */
+} sim_tcp_sock_t;
+
+static sim_tcp_sock_t* sim_tcp_socks[GSM_CFG_MAX_CONNS];
+
+/**
+ * \brief           Detach socket from its connection, reader thread gets end of stream
+ * \note            Called with core locked
+ */
+static void
+sim_tcp_detach(sim_tcp_sock_t* s) {
+    s->closed = 1;
+    sim_tcp_socks[s->conn - 1] = NULL;
+    shutdown(s->fd, SHUT_RDWR);
+}
+
+/**
+ * \brief           Give data received on socket to the simulated module
+ * \param[in]       arg: Socket, \ref sim_tcp_sock_t
+ */
+static void*
+sim_tcp_reader(void* arg) {
+    sim_tcp_sock_t* s = arg;
+    uint8_t buff[SIM_TCP_READ_SIZE];
+    ssize_t n;
+
+    do {
+        n = recv(s->fd, buff, sizeof(buff), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        gsm_core_lock();
+        if (!s->closed) {
+            if (n > 0) {
+                gsm_ll_sim_peer_input(s->conn, buff, (size_t)n);
+            } else {
+                gsm_ll_sim_peer_close(s->conn);
+                sim_tcp_detach(s);
+            }
+        }
+        gsm_core_unlock();
+    } while (n > 0 || (n < 0 && errno == EINTR));
+    close(s->fd);
+    free(s);
+    return NULL;
+}
+
+/**
+ * \brief           Connect socket to address dialed with `AT+SQNSD`
+ * \note            Called with core locked
+ * \return          `1` when connected, `0` otherwise
+ */
+static uint8_t
+sim_tcp_connect(uint8_t conn, const char* host, uint16_t port) {
+    struct addrinfo hints = { 0 }, *res, *ai;
+    sim_tcp_sock_t* s;
+    pthread_t thread;
+    char port_str[6];
+    int fd = -1, one = 1;
+
+    if (conn == 0 || conn > GSM_CFG_MAX_CONNS) {
+        return 0;
+    }
+    if (sim_tcp_socks[conn - 1] != NULL) {
+        sim_tcp_detach(sim_tcp_socks[conn - 1]);
+    }
+
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    snprintf(port_str, sizeof(port_str), "%u", (unsigned)port);
+    if (getaddrinfo(host, port_str, &hints, &res) != 0) {
+        return 0;
+    }
+    for (ai = res; ai != NULL; ai = ai->ai_next) {
+        if ((fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol)) < 0) {
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) {
+        return 0;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    if ((s = calloc(1, sizeof(*s))) == NULL) {
+        close(fd);
+        return 0;
+    }
+    s->fd = fd;
+    s->conn = conn;
+    if (pthread_create(&thread, NULL, sim_tcp_reader, s) != 0) {
+        close(fd);
+        free(s);
+        return 0;
+    }
+    pthread_detach(thread);
+    sim_tcp_socks[conn - 1] = s;
+    return 1;
+}
+
+/**
+ * \brief           Send data of `AT+SQNSSENDEXT` on socket
+ * \note            Called with core locked
+ */
+static void
+sim_tcp_send(uint8_t conn, const uint8_t* data, size_t len) {
+    sim_tcp_sock_t* s = conn >= 1 && conn <= GSM_CFG_MAX_CONNS ? sim_tcp_socks[conn - 1] : NULL;
+    ssize_t n;
+
+    while (s != NULL && len > 0) {
+        n = send(s->fd, data, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n <= 0) {
+            break;                              /* Reader thread reports the close */
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+/**
+ * \brief           Close socket on `AT+SQNSH`
+ * \note            Called with core locked
+ */
+static void
+sim_tcp_close(uint8_t conn) {
+    if (conn >= 1 && conn <= GSM_CFG_MAX_CONNS && sim_tcp_socks[conn - 1] != NULL) {
+        sim_tcp_detach(sim_tcp_socks[conn - 1]);
+    }
+}
+
+const gsm_ll_sim_peer_t gsm_sim_tcp_peer = {
+    .connect_fn = sim_tcp_connect,
+    .send_fn = sim_tcp_send,
+    .close_fn = sim_tcp_close,
+};
@@ -0,0 +1,33 @@
+/**
+ * \file            gsm_sim_tcp.h
+ * \brief           TCP sockets of the host behind the simulated module
+ */
+
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef GSM_HDR_SIM_TCP_H
+#define GSM_HDR_SIM_TCP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "gsm_ll_sim.h"
+
+/*
+ * Peer for gsm_ll_sim_cfg_t: `AT+SQNSD` connects a real TCP socket
+ * to the dialed address and port, data goes over it both ways.
+ * The simulated module answers `AT+SQNDNSLKUP` with `127.0.0.1`,
+ * servers are reached on the loopback interface.
+ */
+extern const gsm_ll_sim_peer_t gsm_sim_tcp_peer;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* GSM_HDR_SIM_TCP_H */
@@ -10,6 +10,25 @@
 #include "sim_manager.h"
 #include "network_apn_settings.h"
 #include "network_utils.h"
+#include "CellIoT_cache.h"
+#include "CellIoT_keepalive.h"
+
+/* Interval of registration status queries while waiting for network */
+#define GSM_INIT_REG_QUERY_INTERVAL     5000
+
+/* Released when device reports registered network */
+static gsm_sys_sem_t reg_sem;
+
+/**
+ * \brief           Check if device is registered to home or roaming network
+ * \return          `1` if registered, `0` otherwise
+ */
+static uint8_t
+is_registered(void) {
+    gsm_network_reg_status_t status = gsm_network_get_reg_status();
+    return status == GSM_NETWORK_REG_STATUS_CONNECTED
+        || status == GSM_NETWORK_REG_STATUS_CONNECTED_ROAMING;
+}
 
 /**
  * \brief           Initialization thread
@@ -20,6 +39,10 @@ gsmr_t AT_Parser_Init(void)
 	gsmr_t result = gsmERR;
 	configPRINTF(("Starting GSM application!\r\n"));
 
+    if (!gsm_sys_sem_isvalid(&reg_sem) && !gsm_sys_sem_create(&reg_sem, 0)) {
+        return gsmERRMEM;
+    }
+
     /* Initialize GSM with default callback function */
 	result = gsm_init(gsm_callback_func, 1);
     if (result != gsmOK) {
@@ -29,6 +52,35 @@ gsmr_t AT_Parser_Init(void)
     return result;
 }
 
+/**
+ * \brief           Wait for device to register to network
+ *
+ * Wakes up on `+CEREG`/`+CREG` registration URCs, status is additionally
+ * queried from device on every interval in case URC was missed
+ *
+ * \param[in]       timeout_ms: Maximal time to wait in units of milliseconds
+ * \return          \ref gsmOK when registered, \ref gsmTIMEOUT otherwise
+ */
+gsmr_t AT_Parser_WaitRegistered(uint32_t timeout_ms)
+{
+    uint32_t start = gsm_sys_now(), elapsed, slice;
+
+    while (!is_registered()) {
+        elapsed = gsm_sys_now() - start;
+        if (elapsed >= timeout_ms) {
+            return gsmTIMEOUT;
+        }
+        slice = timeout_ms - elapsed;
+        if (slice > GSM_INIT_REG_QUERY_INTERVAL) {
+            slice = GSM_INIT_REG_QUERY_INTERVAL;
+        }
+        if (gsm_sys_sem_wait(&reg_sem, slice) == GSM_SYS_TIMEOUT) {
+            gsm_network_update_reg_status(NULL, NULL, 0);
+        }
+    }
+    return gsmOK;
+}
+
 /**
  * \brief           Event callback function for GSM stack
  * \param[in]       evt: Event information with data
@@ -37,11 +89,29 @@ gsmr_t AT_Parser_Init(void)
 gsmr_t gsm_callback_func(gsm_evt_t* evt)
 {
     switch (gsm_evt_get_type(evt)) {
-        case GSM_EVT_INIT_FINISH: configPRINTF(("Library initialized!\r\n")); break;
+        case GSM_EVT_INIT_FINISH: {
+            configPRINTF(("Library initialized!\r\n"));
+            CellIoT_cache_Load();               /* Known module identity and configuration */
+            CellIoT_keepalive_Load();           /* Ping intervals learned per operator */
+            break;
+        }
+        case GSM_EVT_DEVICE_IDENTIFIED: CellIoT_cache_Validate(); break;
         /* Process and print registration change */
-        case GSM_EVT_NETWORK_REG_CHANGED: network_utils_process_reg_change(evt); break;
+        case GSM_EVT_NETWORK_REG_CHANGED: {
+            network_utils_process_reg_change(evt);
+            if (is_registered()) {
+                gsm_sys_sem_release(&reg_sem);  /* Wake up registration waiter */
+            }
+            break;
+        }
         /* Process current network operator */
-        case GSM_EVT_NETWORK_OPERATOR_CURRENT: network_utils_process_curr_operator(evt); break;
+        case GSM_EVT_NETWORK_OPERATOR_CURRENT: {
+            network_utils_process_curr_operator(evt);
+            if (gsm_evt_network_operator_get_current(evt) != NULL) {
+                CellIoT_keepalive_SetOperator(gsm_evt_network_operator_get_current(evt));
+            }
+            break;
+        }
         /* Process signal strength */
         case GSM_EVT_SIGNAL_STRENGTH: network_utils_process_rssi(evt); break;
 
@@ -34,12 +34,25 @@
 #include "gsm_mqtt_client.h"
 #include "gsm_mem.h"
 #include "gsm_pbuf.h"
+#include "gsm_timeout.h"
+#if GSM_CFG_MQTT_SQNS_SOCKETS
+#include <stdio.h>
+#include "CellIoT_lib.h"
+#include "CellIoT_tools.h"
+#endif /* GSM_CFG_MQTT_SQNS_SOCKETS */
 
 /**
  * \brief           MQTT client connection
  */
 typedef struct gsm_mqtt_client {
+#if GSM_CFG_MQTT_SQNS_SOCKETS
+    uint8_t sock_id;                            /*!< Module connection ID, `0` when socket is not open */
+    uint8_t sock_closed;                        /*!< Set when close command finished, also on error */
+    uint8_t sock_cmds;                          /*!< Number of socket commands in queue with client as argument */
+    size_t sock_send_len;                       /*!< Number of bytes sent by active send command */
+#else /* GSM_CFG_MQTT_SQNS_SOCKETS */
     gsm_conn_p conn;                            /*!< Active used connection for MQTT */
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS */
     const gsm_mqtt_client_info_t* info;         /*!< Connection info */
     gsm_mqtt_state_t conn_state;                /*!< MQTT connection state */
 
@@ -75,7 +88,12 @@ typedef struct gsm_mqtt_client {
 #define GSM_CFG_DBG_MQTT_STATE                  (GSM_CFG_DBG_MQTT | GSM_DBG_TYPE_STATE)
 #define GSM_CFG_DBG_MQTT_TRACE_WARNING          (GSM_CFG_DBG_MQTT | GSM_DBG_TYPE_TRACE | GSM_DBG_LVL_WARNING)
 
+#if GSM_CFG_MQTT_SQNS_SOCKETS
+static void     mqtt_sock_sent_cb(gsmr_t res, void* arg);
+static void     mqtt_sock_closed_cb(gsmr_t res, void* arg);
+#else /* GSM_CFG_MQTT_SQNS_SOCKETS */
 static gsmr_t   mqtt_conn_cb(gsm_evt_t* evt);
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS */
 static void     send_data(gsm_mqtt_client_p client);
 
 /**
@@ -110,6 +128,13 @@ typedef enum {
 #define MQTT_PARSER_STATE_CALC_REM_LEN  0x01    /*!< MQTT parser in calculating remaining length state */
 #define MQTT_PARSER_STATE_READ_REM      0x02    /*!< MQTT parser in reading remaining bytes state */
 
+/* Interval between poll callbacks, in units of milliseconds */
+#if GSM_CFG_MQTT_SQNS_SOCKETS
+#define MQTT_POLL_INTERVAL              GSM_CFG_MQTT_SQNS_POLL_INTERVAL
+#else /* GSM_CFG_MQTT_SQNS_SOCKETS */
+#define MQTT_POLL_INTERVAL              GSM_CFG_CONN_POLL_INTERVAL
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS */
+
 /* Get packet type from incoming byte */
 #define MQTT_RCV_GET_PACKET_TYPE(d)     ((mqtt_msg_type_t)(((d) >> 0x04) & 0x0F))
 #define MQTT_RCV_GET_PACKET_QOS(d)      ((gsm_mqtt_qos_t)(((d) >> 0x01) & 0x03))
@@ -402,7 +427,17 @@ send_data(gsm_mqtt_client_p client) {
     if (len > 0) {                                  /* Anything to send? */
         gsmr_t res;
         addr = gsm_buff_get_linear_block_read_address(&client->tx_buff);/* Get address of linear memory */
-        if ((res = gsm_conn_send(client->conn, addr, len, NULL, 0)) == gsmOK) {
+#if GSM_CFG_MQTT_SQNS_SOCKETS
+        len = GSM_MIN(len, GSM_CFG_CONN_MAX_DATA_LEN);  /* Maximal length of one send command */
+        res = CellIoT_lib_socketSendExt(client->sock_id, addr, GSM_U32(len), mqtt_sock_sent_cb, client, 0);
+        if (res == gsmOK) {
+            client->sock_send_len = len;
+            client->sock_cmds++;
+        }
+#else /* GSM_CFG_MQTT_SQNS_SOCKETS */
+        res = gsm_conn_send(client->conn, addr, len, NULL, 0);
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS */
+        if (res == gsmOK) {
             client->written_total += len;       /* Increase number of bytes written to queue */
             client->is_sending = 1;             /* Remember active sending flag */
         } else {
@@ -431,7 +466,16 @@ mqtt_close(gsm_mqtt_client_p client) {
     if (client->conn_state != GSM_MQTT_CONN_DISCONNECTED
         && client->conn_state != GSM_MQTT_CONN_DISCONNECTING) {
 
+#if GSM_CFG_MQTT_SQNS_SOCKETS
+        if (client->sock_id != 0) {             /* Socket cannot be closed while it is being opened */
+            res = CellIoT_lib_socketCloseExt(client->sock_id, mqtt_sock_closed_cb, client, 0);
+            if (res == gsmOK) {
+                client->sock_cmds++;
+            }
+        }
+#else /* GSM_CFG_MQTT_SQNS_SOCKETS */
         res = gsm_conn_close(client->conn, 0);  /* Close the connection in non-blocking mode */
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS */
         if (res == gsmOK) {
             client->conn_state = GSM_MQTT_CONN_DISCONNECTING;
         }
@@ -649,108 +693,126 @@ mqtt_process_incoming_message(gsm_mqtt_client_p client) {
 }
 
 /**
- * \brief           Parse incoming buffer data and try to construct clean packet from it
+ * \brief           Parse linear block of incoming data and try to construct clean packet from it
  * \param[in]       client: MQTT client
- * \param[in]       pbuf: Received packet buffer with data
- * \return          `1` on success, `0` otherwise
+ * \param[in]       d: Received data
+ * \param[in]       buff_len: Length of received data
  */
-static uint8_t
-mqtt_parse_incoming(gsm_mqtt_client_p client, gsm_pbuf_p pbuf) {
-    size_t idx, buff_len = 0, buff_offset = 0;
-    uint8_t ch, *d;
+static void
+mqtt_parse_incoming_data(gsm_mqtt_client_p client, uint8_t* d, size_t buff_len) {
+    size_t idx;
+    uint8_t ch;
+
+    for (idx = 0; idx < buff_len; idx++) {  /* Process entire linear buffer */
+        ch = d[idx];
+        switch (client->parser_state) {     /* Check parser state */
+            case MQTT_PARSER_STATE_INIT: {  /* We are waiting for start byte and packet type */
+                GSM_DEBUGF(GSM_CFG_DBG_MQTT_STATE,
+                    "[MQTT] Parser init state, received first byte of packet 0x%02X\r\n", (unsigned)ch);
+
+                /* Save other info about message */
+                client->msg_hdr_byte = ch;  /* Save first entry */
+                client->msg_rem_len = 0;    /* Reset remaining length */
+                client->msg_rem_len_mult = 0;   /* Reset length multiplier */
+                client->msg_curr_pos = 0;   /* Reset current buffer write pointer */
+
+                client->parser_state = MQTT_PARSER_STATE_CALC_REM_LEN;
+                break;
+            }
+            case MQTT_PARSER_STATE_CALC_REM_LEN: {  /* Calculate remaining length of packet */
+                /* Length of packet is LSB first, each consist of up to 7 bits */
+                client->msg_rem_len |= (ch & 0x7F) << ((size_t)7 * (size_t)client->msg_rem_len_mult++);
 
-    do {
-        buff_offset += buff_len;                /* Calculate new offset of buffer */
-        d = gsm_pbuf_get_linear_addr(pbuf, buff_offset, &buff_len); /* Get address pointer */
-        if (d == NULL) {
-            break;
-        }
-        for (idx = 0; idx < buff_len; idx++) {  /* Process entire linear buffer */
-            ch = d[idx];
-            switch (client->parser_state) {     /* Check parser state */
-                case MQTT_PARSER_STATE_INIT: {  /* We are waiting for start byte and packet type */
+                if (!(ch & 0x80)) {         /* Is this last entry? */
                     GSM_DEBUGF(GSM_CFG_DBG_MQTT_STATE,
-                        "[MQTT] Parser init state, received first byte of packet 0x%02X\r\n", (unsigned)ch);
-
-                    /* Save other info about message */
-                    client->msg_hdr_byte = ch;  /* Save first entry */
-                    client->msg_rem_len = 0;    /* Reset remaining length */
-                    client->msg_rem_len_mult = 0;   /* Reset length multiplier */
-                    client->msg_curr_pos = 0;   /* Reset current buffer write pointer */
-
-                    client->parser_state = MQTT_PARSER_STATE_CALC_REM_LEN;
-                    break;
-                }
-                case MQTT_PARSER_STATE_CALC_REM_LEN: {  /* Calculate remaining length of packet */
-                    /* Length of packet is LSB first, each consist of up to 7 bits */
-                    client->msg_rem_len |= (ch & 0x7F) << ((size_t)7 * (size_t)client->msg_rem_len_mult++);
+                        "[MQTT] Remaining length received: %d bytes\r\n", (int)client->msg_rem_len);
+
+                    if (client->msg_rem_len > 0) {
+                        /*
+                         * Check if all data bytes are part of single pbuf.
+                         * this is done by check if current idx position vs length is more than expected data length
+                         * Check must be "greater as" due to idx currently pointing to last length byte and not beginning of data
+                         */
+                        if ((buff_len - idx) > client->msg_rem_len) {
+                            void* tmp_ptr = client->rx_buff;
+                            size_t tmp_len = client->rx_buff_len;
+
+                            /* Set new client pointer */
+                            client->rx_buff = &d[idx + 1];  /* Data are one byte after */
+                            client->rx_buff_len = client->msg_rem_len;
+
+                            mqtt_process_incoming_message(client);  /* Process new message */
+
+                            /* Reset to previous values */
+                            client->rx_buff = tmp_ptr;
+                            client->rx_buff_len = tmp_len;
+                            client->parser_state = MQTT_PARSER_STATE_INIT;
 
-                    if (!(ch & 0x80)) {         /* Is this last entry? */
-                        GSM_DEBUGF(GSM_CFG_DBG_MQTT_STATE,
-                            "[MQTT] Remaining length received: %d bytes\r\n", (int)client->msg_rem_len);
-
-                        if (client->msg_rem_len > 0) {
-                            /*
-                             * Check if all data bytes are part of single pbuf.
-                             * this is done by check if current idx position vs length is more than expected data length
-                             * Check must be "greater as" due to idx currently pointing to last length byte and not beginning of data
-                             */
-                            if ((buff_len - idx) > client->msg_rem_len) {
-                                void* tmp_ptr = client->rx_buff;
-                                size_t tmp_len = client->rx_buff_len;
-
-                                /* Set new client pointer */
-                                client->rx_buff = &d[idx + 1];  /* Data are one byte after */
-                                client->rx_buff_len = client->msg_rem_len;
-
-                                mqtt_process_incoming_message(client);  /* Process new message */
-
-                                /* Reset to previous values */
-                                client->rx_buff = tmp_ptr;
-                                client->rx_buff_len = tmp_len;
-                                client->parser_state = MQTT_PARSER_STATE_INIT;
-
-                                idx += client->msg_rem_len; /* Skip data part only, idx is increased again in for loop */
-                            } else {
-                                client->parser_state = MQTT_PARSER_STATE_READ_REM;
-                            }
+                            idx += client->msg_rem_len; /* Skip data part only, idx is increased again in for loop */
                         } else {
-                            mqtt_process_incoming_message(client);
-                            client->parser_state = MQTT_PARSER_STATE_INIT;
+                            client->parser_state = MQTT_PARSER_STATE_READ_REM;
                         }
+                    } else {
+                        mqtt_process_incoming_message(client);
+                        client->parser_state = MQTT_PARSER_STATE_INIT;
                     }
-                    break;
                 }
-                case MQTT_PARSER_STATE_READ_REM: {  /* Read remaining bytes and write to RX buffer */
-                    /* Process only if rx buff length is big enough */
-                    if (client->msg_curr_pos < client->rx_buff_len) {
-                        client->rx_buff[client->msg_curr_pos] = ch; /* Write received character */
-                    }
-                    client->msg_curr_pos++;
+                break;
+            }
+            case MQTT_PARSER_STATE_READ_REM: {  /* Read remaining bytes and write to RX buffer */
+                /* Process only if rx buff length is big enough */
+                if (client->msg_curr_pos < client->rx_buff_len) {
+                    client->rx_buff[client->msg_curr_pos] = ch; /* Write received character */
+                }
+                client->msg_curr_pos++;
 
-                    /* We reached end of received characters? */
-                    if (client->msg_curr_pos == client->msg_rem_len) {
-                        if (client->msg_curr_pos <= client->rx_buff_len) {  /* Check if it was possible to write all data to rx buffer */
-                            GSM_DEBUGF(GSM_CFG_DBG_MQTT_STATE,
-                                "[MQTT] Packet parsed and ready for processing\r\n");
+                /* We reached end of received characters? */
+                if (client->msg_curr_pos == client->msg_rem_len) {
+                    if (client->msg_curr_pos <= client->rx_buff_len) {  /* Check if it was possible to write all data to rx buffer */
+                        GSM_DEBUGF(GSM_CFG_DBG_MQTT_STATE,
+                            "[MQTT] Packet parsed and ready for processing\r\n");
 
-                            mqtt_process_incoming_message(client);  /* Process incoming packet */
-                        } else {
-                            GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING,
-                                "[MQTT] Packet too big for rx buffer. Packet discarded\r\n");
-                        }
-                        client->parser_state = MQTT_PARSER_STATE_INIT;  /* Go to initial state and listen for next received packet */
+                        mqtt_process_incoming_message(client);  /* Process incoming packet */
+                    } else {
+                        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING,
+                            "[MQTT] Packet too big for rx buffer. Packet discarded\r\n");
                     }
-                    break;
+                    client->parser_state = MQTT_PARSER_STATE_INIT;  /* Go to initial state and listen for next received packet */
                 }
-                default:
-                    client->parser_state = MQTT_PARSER_STATE_INIT;
+                break;
             }
+            default:
+                client->parser_state = MQTT_PARSER_STATE_INIT;
+        }
+    }
+}
+
+#if !GSM_CFG_MQTT_SQNS_SOCKETS || __DOXYGEN__
+
+/**
+ * \brief           Parse incoming buffer data and try to construct clean packet from it
+ * \param[in]       client: MQTT client
+ * \param[in]       pbuf: Received packet buffer with data
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+mqtt_parse_incoming(gsm_mqtt_client_p client, gsm_pbuf_p pbuf) {
+    size_t buff_len = 0, buff_offset = 0;
+    uint8_t* d;
+
+    do {
+        buff_offset += buff_len;                /* Calculate new offset of buffer */
+        d = gsm_pbuf_get_linear_addr(pbuf, buff_offset, &buff_len); /* Get address pointer */
+        if (d == NULL) {
+            break;
         }
+        mqtt_parse_incoming_data(client, d, buff_len);
     } while (buff_len > 0);
     return 0;
 }
 
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS || __DOXYGEN__ */
+
 /******************************************************************************************************/
 /******************************************************************************************************/
 /* Connection callback functions                                                                      */
@@ -834,6 +896,8 @@ mqtt_connected_cb(gsm_mqtt_client_p client) {
     send_data(client);                          /* Flush and send the actual data */
 }
 
+#if !GSM_CFG_MQTT_SQNS_SOCKETS || __DOXYGEN__
+
 /**
  * \brief           Received data callback function
  * \param[in]       client: MQTT client
@@ -848,6 +912,8 @@ mqtt_data_recv_cb(gsm_mqtt_client_p client, gsm_pbuf_p pbuf) {
     return 1;
 }
 
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS || __DOXYGEN__ */
+
 /**
  * \brief           Data sent callback
  * \param[in]       client: MQTT client
@@ -906,7 +972,7 @@ mqtt_data_sent_cb(gsm_mqtt_client_p client, size_t sent_len, uint8_t successful)
 
 /**
  * \brief           Poll for client connection
- *                  Called every GSM_CFG_CONN_POLL_INTERVAL ms when MQTT client TCP connection is established
+ *                  Called every \ref MQTT_POLL_INTERVAL ms when MQTT client TCP connection is established
  * \param[in]       client: MQTT client
  * \return          `1` on success, `0` otherwise
  */
@@ -924,9 +990,9 @@ mqtt_poll_cb(gsm_mqtt_client_p client) {
      * to make sure we are still alive
      */
     if (client->info->keep_alive                /* Keep alive must be enabled */
-        /* Poll time is in units of GSM_CFG_CONN_POLL_INTERVAL milliseconds,
+        /* Poll time is in units of MQTT_POLL_INTERVAL milliseconds,
            while keep_alive is in units of seconds */
-        && (client->poll_time * GSM_CFG_CONN_POLL_INTERVAL) >= (uint32_t)(client->info->keep_alive * 1000)) {
+        && (client->poll_time * MQTT_POLL_INTERVAL) >= (uint32_t)(client->info->keep_alive * 1000)) {
 
         if (output_check_enough_memory(client, 0)) {/* Check if memory available in output buffer */
             write_fixed_header(client, MQTT_MSG_TYPE_PINGREQ, 0, (gsm_mqtt_qos_t)0, 0, 0);  /* Write PINGREQ command to output buffer */
@@ -963,10 +1029,17 @@ mqtt_closed_cb(gsm_mqtt_client_p client, gsmr_t res, uint8_t forced) {
      * when we are connected or in disconnecting mode
      */
     client->conn_state = GSM_MQTT_CONN_DISCONNECTED;/* Connection is disconnected, ready to be established again */
+#if GSM_CFG_MQTT_SQNS_SOCKETS
+    CellIoT_lib_socketFree(client->sock_id);    /* Release connection ID, user may connect again from event */
+    client->sock_id = 0;
+    client->sock_closed = 0;
+#endif /* GSM_CFG_MQTT_SQNS_SOCKETS */
     client->evt.evt.disconnect.is_accepted = state == GSM_MQTT_CONNECTED || state == GSM_MQTT_CONN_DISCONNECTING;   /* Set connection state */
     client->evt.type = GSM_MQTT_EVT_DISCONNECT; /* Connection disconnected from server */
     client->evt_fn(client, &client->evt);       /* Notify upper layer about closed connection */
+#if !GSM_CFG_MQTT_SQNS_SOCKETS
     client->conn = NULL;                        /* Reset connection handle */
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS */
 
     /* Check all requests */
     while ((request = request_get_pending(client, -1)) != NULL) {
@@ -987,6 +1060,70 @@ mqtt_closed_cb(gsm_mqtt_client_p client, gsmr_t res, uint8_t forced) {
     return 1;
 }
 
+#if GSM_CFG_MQTT_SQNS_SOCKETS || __DOXYGEN__
+
+/**
+ * \brief           Socket send command finished callback
+ * \param[in]       res: Result of send command
+ * \param[in]       arg: MQTT client
+ */
+static void
+mqtt_sock_sent_cb(gsmr_t res, void* arg) {
+    gsm_mqtt_client_p client = arg;
+
+    client->sock_cmds--;
+    mqtt_data_sent_cb(client, client->sock_send_len, res == gsmOK);
+}
+
+/**
+ * \brief           Socket close command finished callback
+ * \param[in]       res: Result of close command
+ * \param[in]       arg: MQTT client
+ */
+static void
+mqtt_sock_closed_cb(gsmr_t res, void* arg) {
+    gsm_mqtt_client_p client = arg;
+
+    client->sock_cmds--;
+    client->sock_closed = 1;                    /* Socket is not used anymore, even if command failed */
+    GSM_UNUSED(res);
+}
+
+/**
+ * \brief           Socket poll timeout callback
+ *
+ * Sequans sockets have no connection events, data received with `AT+SQNSRECV`
+ * is processed here directly from the receive buffers, without copy.
+ * Poll is scheduled again until socket is closed.
+ *
+ * \param[in]       arg: MQTT client
+ */
+static void
+mqtt_sock_poll_cb(void* arg) {
+    gsm_mqtt_client_p client = arg;
+    unsigned char* data;
+    uint32_t len;
+
+    while ((len = CellIoT_lib_socketPeekData(client->sock_id, &data)) > 0) {
+        client->poll_time = 0;                  /* Reset kep alive time */
+        mqtt_parse_incoming_data(client, data, len);
+        CellIoT_lib_socketSkipData(client->sock_id, len);
+    }
+
+    if (client->sock_closed || !CellIoT_lib_socketIsOpen(client->sock_id)) {
+        /* Closed by either side, commands in queue still use the client */
+        if (client->sock_cmds == 0) {
+            mqtt_closed_cb(client, gsmOK, GSM_U8(client->conn_state == GSM_MQTT_CONN_DISCONNECTING));
+            return;
+        }
+    } else {
+        mqtt_poll_cb(client);
+    }
+    gsm_timeout_add(MQTT_POLL_INTERVAL, mqtt_sock_poll_cb, client);
+}
+
+#else /* GSM_CFG_MQTT_SQNS_SOCKETS || __DOXYGEN__ */
+
 /**
  * \brief           Connection callback
  * \param[in]       evt: Callback parameters
@@ -1067,6 +1204,8 @@ mqtt_conn_cb(gsm_evt_t* evt) {
     return gsmOK;
 }
 
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS */
+
 /**
  * \brief           Allocate a new MQTT client structure
  * \param[in]       tx_buff_len: Length of raw data output buffer
@@ -1114,6 +1253,8 @@ gsm_mqtt_client_delete(gsm_mqtt_client_p client) {
 /**
  * \brief           Connect to MQTT server
  * \note            After TCP connection is established, CONNECT packet is automatically sent to server
+ * \note            With \ref GSM_CFG_MQTT_SQNS_SOCKETS, function blocks until TCP connection is established
+ *                  and cannot be called from callback. Error is returned when TCP connection fails
  * \param[in]       client: MQTT client
  * \param[in]       host: Host address for server
  * \param[in]       port: Host port number
@@ -1125,12 +1266,75 @@ gsmr_t
 gsm_mqtt_client_connect(gsm_mqtt_client_p client, const char* host, gsm_port_t port,
                         gsm_mqtt_evt_fn evt_fn, const gsm_mqtt_client_info_t* info) {
     gsmr_t res = gsmERR;
+#if GSM_CFG_MQTT_SQNS_SOCKETS
+    gsm_network_reg_status_t reg;
+    gsm_ip_t ip;
+    char ip_str[16];
+    uint8_t sock_id;
+#endif /* GSM_CFG_MQTT_SQNS_SOCKETS */
 
     GSM_ASSERT("client != NULL", client != NULL);   /* t input parameters */
     GSM_ASSERT("host != NULL", host != NULL);
     GSM_ASSERT("port > 0", port > 0);
     GSM_ASSERT("info != NULL", info != NULL);
 
+#if GSM_CFG_MQTT_SQNS_SOCKETS
+    reg = gsm_network_get_reg_status();
+    gsm_core_lock();
+    if ((reg == GSM_NETWORK_REG_STATUS_CONNECTED || reg == GSM_NETWORK_REG_STATUS_CONNECTED_ROAMING)
+        && client->conn_state == GSM_MQTT_CONN_DISCONNECTED) {
+        client->info = info;                    /* Save client info parameters */
+        client->evt_fn = evt_fn != NULL ? evt_fn : mqtt_evt_fn_default;
+        client->conn_state = GSM_MQTT_CONN_CONNECTING;
+        res = gsmOK;
+    }
+    gsm_core_unlock();
+    if (res != gsmOK) {
+        return res;
+    }
+
+    /* Open socket with blocking commands, configuration is only sent when it changed */
+    sock_id = CellIoT_lib_socketAlloc();
+    if (sock_id == 0) {
+        res = gsmERRMEM;
+    } else if ((res = CellIoT_lib_getHostIP(host, &ip, NULL, NULL, 1)) == gsmOK) {
+        sprintf(ip_str, "%u.%u.%u.%u", (unsigned)ip.ip[0], (unsigned)ip.ip[1], (unsigned)ip.ip[2], (unsigned)ip.ip[3]);
+        res = (gsmr_t)SOCKETS_SetCfg(sock_id);
+        if (res == gsmOK) {
+            res = (gsmr_t)SOCKETS_SetCfgExt(sock_id);
+        }
+        if (res == gsmOK) {
+            res = (gsmr_t)SOCKETS_SetSockSecurity(sock_id, info->sec_profile != 0 ? info->sec_profile : 1, GSM_U8(info->sec_profile != 0));
+        }
+        if (res == gsmOK) {
+            res = CellIoT_lib_socketDial(sock_id, 0, GSM_PORT2NUM(port), ip_str, 0, 0, 1, 0, NULL, NULL, 1);
+        }
+    }
+
+    if (res == gsmOK) {
+        gsm_core_lock();
+        client->sock_id = sock_id;
+        client->sock_closed = 0;
+        res = gsm_timeout_add(MQTT_POLL_INTERVAL, mqtt_sock_poll_cb, client);
+        if (res == gsmOK) {
+            mqtt_connected_cb(client);          /* Send CONNECT packet */
+        } else {
+            client->sock_id = 0;
+        }
+        gsm_core_unlock();
+        if (res != gsmOK) {
+            CellIoT_lib_socketClose(sock_id);
+        }
+    }
+    if (res != gsmOK) {
+        GSM_DEBUGF(GSM_CFG_DBG_MQTT_TRACE_WARNING,
+            "[MQTT] Cannot open socket to %s with error: %d\r\n", host, (int)res);
+        CellIoT_lib_socketFree(sock_id);
+        gsm_core_lock();
+        client->conn_state = GSM_MQTT_CONN_DISCONNECTED;
+        gsm_core_unlock();
+    }
+#else /* GSM_CFG_MQTT_SQNS_SOCKETS */
     gsm_core_lock();
     if (gsm_network_is_attached() && client->conn_state == GSM_MQTT_CONN_DISCONNECTED) {
         client->info = info;                    /* Save client info parameters */
@@ -1143,6 +1347,7 @@ gsm_mqtt_client_connect(gsm_mqtt_client_p client, const char* host, gsm_port_t p
         }
     }
     gsm_core_unlock();
+#endif /* !GSM_CFG_MQTT_SQNS_SOCKETS */
 
     return res;
 }
@@ -36,6 +36,8 @@
 #include "gsm_threads.h"
 #include "gsm_ll.h"
 #include "gsm_utils.h"
+#include "gsm_trace.h"
+#include "gsm_stats.h"
 
 #if GSM_CFG_OS != 1
 #error GSM_CFG_OS must be set to 1!
@@ -46,6 +48,18 @@ static gsm_evt_func_t def_evt_link;
 
 gsm_t gsm;
 
+#if GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE
+/* AT port baudrates tried on negotiation, highest first */
+static const uint32_t at_baudrates[] = {
+    3686400, 1843200, 921600, 460800, 230400, 115200
+};
+
+/* Number of passes over all rates before device is considered silent, covers its boot time */
+#define GSM_AT_BAUDRATE_SYNC_ROUNDS     3
+
+static gsmr_t   gsm_sync_at_baudrate(void);
+#endif /* GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE */
+
 /**
  * \brief           Default callback function for events
  * \param[in]       evt: Pointer to callback data structure
@@ -119,9 +133,19 @@ gsm_init(gsm_evt_fn evt_func, const uint32_t blocking) {
     gsm_sys_sem_wait(&gsm.sem_sync, 0);         /* Wait semaphore, should be unlocked in produce thread */
     gsm_sys_sem_release(&gsm.sem_sync);         /* Release semaphore manually */
 
+    if (gsm.m.ring_list == NULL) {
+        gsm.m.ring_list = gsm_ring_list_init(); /* Create ring list, +SQNSRING may arrive during reset sequence */
+    }
+
     gsm_core_lock();
     gsm.ll.uart.baudrate = GSM_CFG_AT_PORT_BAUDRATE;
     gsm_ll_init(&gsm.ll);                       /* Init low-level communication */
+#if GSM_CFG_AT_TRACE
+    gsm_trace_attach(&gsm.ll);                  /* Record TX bytes */
+#endif /* GSM_CFG_AT_TRACE */
+#if GSM_CFG_STATS
+    gsm_stats_attach(&gsm.ll);                  /* Count TX bytes */
+#endif /* GSM_CFG_STATS */
 
 #if !GSM_CFG_INPUT_USE_PROCESS
     gsm_buff_init(&gsm.buff, GSM_CFG_RCV_BUFF_SIZE);    /* Init buffer for input data */
@@ -139,7 +163,17 @@ gsm_init(gsm_evt_fn evt_func, const uint32_t blocking) {
 #if GSM_CFG_RESET_ON_INIT
     if (gsm.status.f.dev_present) {
         gsm_core_unlock();
+#if GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE
+        if (blocking) {
+            gsm_sync_at_baudrate();             /* Device may still run at rate of previous negotiation */
+        }
+#endif /* GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE */
         res = gsm_reset_with_delay(GSM_CFG_RESET_DELAY_DEFAULT, NULL, NULL, blocking);  /* Send reset sequence with delay */
+#if GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE
+        if (blocking && res == gsmOK) {
+            gsm_negotiate_at_baudrate(GSM_CFG_AT_PORT_BAUDRATE_MAX);
+        }
+#endif /* GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE */
         gsm_core_lock();
     }
 #else /* GSM_CFG_RESET_ON_INIT */
@@ -147,9 +181,6 @@ gsm_init(gsm_evt_fn evt_func, const uint32_t blocking) {
 #endif /* !GSM_CFG_RESET_ON_INIT */
     gsm_core_unlock();
 
-	gsm.m.ring_list = gsm_ring_list_init();		/* Create ring list */
-    gsm.m.conn_val_id = 0;						/* Init the valid connection to 0 */
-
     return res;
 
 cleanup:
@@ -282,6 +313,146 @@ gsm_set_func_mode(uint8_t mode,
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
 }
 
+/**
+ * \brief           Change AT port baudrate on device and host
+ *
+ * `AT+IPR` is sent at current rate, then host port is switched and the link is verified with `AT`.
+ * If verification fails, host port is switched back to previous rate.
+ * Device may already run at new rate in that case, use \ref gsm_probe_at_baudrate to find it.
+ *
+ * \param[in]       baudrate: New baudrate
+ * \param[in]       evt_fn: Callback function called when command is finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_set_at_baudrate(uint32_t baudrate,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("baudrate > 0", baudrate > 0);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_IPR;
+    GSM_MSG_VAR_REF(msg).msg.uart.baudrate = baudrate;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 2000);
+}
+
+/**
+ * \brief           Switch host AT port to baudrate and check if device answers
+ * \note            Device is not reconfigured. On failure host port returns to previous rate
+ * \param[in]       baudrate: Baudrate to probe
+ * \param[in]       evt_fn: Callback function called when command is finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_probe_at_baudrate(uint32_t baudrate,
+                        const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("baudrate > 0", baudrate > 0);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_UART;
+    GSM_MSG_VAR_REF(msg).msg.uart.baudrate = baudrate;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, GSM_CFG_AT_PORT_PROBE_TIMEOUT);
+}
+
+/**
+ * \brief           Get current host AT port baudrate
+ * \return          Baudrate in units of bits per second
+ */
+uint32_t
+gsm_get_at_baudrate(void) {
+    uint32_t baudrate;
+    gsm_core_lock();
+    baudrate = gsm.ll.uart.baudrate;
+    gsm_core_unlock();
+    return baudrate;
+}
+
+#if GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE
+
+/**
+ * \brief           Find the rate device currently answers at
+ *
+ * Current host rate is tried first, then every supported rate from the highest.
+ * Device keeps `AT+IPR` in its non-volatile memory, so after a previous negotiation
+ * it normally answers on the first or second probe.
+ *
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+gsm_sync_at_baudrate(void) {
+    uint32_t curr = gsm_get_at_baudrate();
+    size_t i, round;
+
+    for (round = 0; round < GSM_AT_BAUDRATE_SYNC_ROUNDS; round++) {
+        if (gsm_probe_at_baudrate(curr, NULL, NULL, 1) == gsmOK) {
+            return gsmOK;
+        }
+        for (i = 0; i < GSM_ARRAYSIZE(at_baudrates); i++) {
+            if (at_baudrates[i] != curr
+                && gsm_probe_at_baudrate(at_baudrates[i], NULL, NULL, 1) == gsmOK) {
+                return gsmOK;
+            }
+        }
+    }
+    return gsmERR;
+}
+
+/**
+ * \brief           Negotiate highest AT port baudrate both sides support
+ *
+ * Host first synchronizes with the rate device runs at,
+ * then tries supported rates from the highest one not above `max_baudrate`.
+ * Every switch is verified; a failed rate falls back to a working one before the next is tried.
+ *
+ * \note            Only blocking mode is supported
+ * \param[in]       max_baudrate: Highest baudrate to use
+ * \return          \ref gsmOK when host and device agree on a rate, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_negotiate_at_baudrate(uint32_t max_baudrate) {
+    size_t i;
+
+    if (gsm_sync_at_baudrate() != gsmOK) {
+        GSM_DEBUGF(GSM_CFG_DBG_INIT | GSM_DBG_LVL_SEVERE | GSM_DBG_TYPE_TRACE,
+            "[CORE] Device does not answer at any AT port baudrate\r\n");
+        return gsmERR;
+    }
+
+    for (i = 0; i < GSM_ARRAYSIZE(at_baudrates); i++) {
+        if (at_baudrates[i] > max_baudrate) {
+            continue;
+        }
+        if (at_baudrates[i] <= gsm_get_at_baudrate()) {
+            break;                              /* Already at highest possible rate */
+        }
+        if (gsm_set_at_baudrate(at_baudrates[i], NULL, NULL, 1) == gsmOK) {
+            break;
+        }
+
+        /* Device may have switched even if host could not verify it */
+        if (gsm_sync_at_baudrate() != gsmOK) {
+            return gsmERR;
+        }
+    }
+
+    GSM_DEBUGF(GSM_CFG_DBG_INIT | GSM_DBG_TYPE_TRACE,
+        "[CORE] AT port running at %d\r\n", (int)gsm_get_at_baudrate());
+    return gsmOK;
+}
+
+#endif /* GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE */
+
 /**
  * \brief           Notify stack if device is present or not
  *
@@ -138,3 +138,56 @@ gsm_device_get_serial_number(char* serial, size_t len, const gsm_api_cmd_evt_fn
 
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
 }
+
+/**
+ * \brief           Get device identity known to the stack, no command is sent
+ * \param[out]      id: Output identity. Strings are empty when not yet read from device
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_device_get_identity(gsm_device_identity_t* id) {
+    GSM_ASSERT("id != NULL", id != NULL);
+
+    gsm_core_lock();
+    GSM_MEMCPY(id->manufacturer, gsm.m.model_manufacturer, sizeof(id->manufacturer));
+    GSM_MEMCPY(id->model, gsm.m.model_number, sizeof(id->model));
+    GSM_MEMCPY(id->serial_number, gsm.m.model_serial_number, sizeof(id->serial_number));
+    GSM_MEMCPY(id->revision, gsm.m.model_revision, sizeof(id->revision));
+    gsm_core_unlock();
+    return gsmOK;
+}
+
+/**
+ * \brief           Set device identity remembered from previous run
+ *
+ * When identity is set, reset sequence only reads serial number back from device
+ * and skips manufacturer, model and revision queries if serial number matches.
+ * Call it on \ref GSM_EVT_INIT_FINISH event, before first reset.
+ *
+ * \param[in]       id: Identity to use
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_device_set_identity(const gsm_device_identity_t* id) {
+    GSM_ASSERT("id != NULL", id != NULL);
+
+    gsm_core_lock();
+    GSM_MEMCPY(gsm.m.model_manufacturer, id->manufacturer, sizeof(gsm.m.model_manufacturer));
+    GSM_MEMCPY(gsm.m.model_number, id->model, sizeof(gsm.m.model_number));
+    GSM_MEMCPY(gsm.m.model_serial_number, id->serial_number, sizeof(gsm.m.model_serial_number));
+    GSM_MEMCPY(gsm.m.model_revision, id->revision, sizeof(gsm.m.model_revision));
+    gsm.m.model_manufacturer[sizeof(gsm.m.model_manufacturer) - 1] = 0;
+    gsm.m.model_number[sizeof(gsm.m.model_number) - 1] = 0;
+    gsm.m.model_serial_number[sizeof(gsm.m.model_serial_number) - 1] = 0;
+    gsm.m.model_revision[sizeof(gsm.m.model_revision) - 1] = 0;
+
+    gsm.m.model = GSM_DEVICE_MODEL_UNKNOWN;
+    for (size_t i = 0; i < gsm_dev_model_map_size; i++) {
+        if (strstr(gsm.m.model_number, gsm_dev_model_map[i].id_str) != NULL) {
+            gsm.m.model = gsm_dev_model_map[i].model;
+            break;
+        }
+    }
+    gsm_core_unlock();
+    return gsmOK;
+}
@@ -181,6 +181,16 @@ gsm_evt_signal_strength_get_rssi(gsm_evt_t* cc) {
     return cc->evt.rssi.rssi;
 }
 
+/**
+ * \brief           Get radio connection state
+ * \param[in]       cc: Event data
+ * \return          `1` when radio signalling connection is active, `0` when idle
+ */
+uint8_t
+gsm_evt_network_radio_is_connected(gsm_evt_t* cc) {
+    return cc->evt.radio.connected;
+}
+
 #if GSM_CFG_CONN || __DOXYGEN__
 
 /**
@@ -463,3 +473,78 @@ gsm_evt_call_changed_get_call(gsm_evt_t* cc) {
 }
 
 #endif /* GSM_CFG_CALL || __DOXYGEN__ */
+
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+
+/**
+ * \brief           Get result of module MQTT client event
+ * \param[in]       cc: Event handle
+ * \return          \ref gsmOK when the broker accepted the request or the message was read in full
+ */
+gsmr_t
+gsm_evt_sqns_mqtt_get_result(gsm_evt_t* cc) {
+    return cc->evt.sqns_mqtt.res;
+}
+
+/**
+ * \brief           Get result code reported by the module
+ * \param[in]       cc: Event handle
+ * \return          `0` on success, module specific error code otherwise
+ */
+int32_t
+gsm_evt_sqns_mqtt_get_rc(gsm_evt_t* cc) {
+    return cc->evt.sqns_mqtt.rc;
+}
+
+/**
+ * \brief           Get topic of message or subscription
+ * \param[in]       cc: Event handle
+ * \return          Topic, `NULL` when not reported
+ */
+const char *
+gsm_evt_sqns_mqtt_get_topic(gsm_evt_t* cc) {
+    return cc->evt.sqns_mqtt.topic;
+}
+
+/**
+ * \brief           Get payload of received message
+ * \note            Valid only for \ref GSM_EVT_SQNS_MQTT_MESSAGE event, during the callback
+ * \param[in]       cc: Event handle
+ * \return          Payload data
+ */
+const uint8_t *
+gsm_evt_sqns_mqtt_get_data(gsm_evt_t* cc) {
+    return cc->evt.sqns_mqtt.data;
+}
+
+/**
+ * \brief           Get payload length of received message
+ * \param[in]       cc: Event handle
+ * \return          Number of bytes read
+ */
+size_t
+gsm_evt_sqns_mqtt_get_len(gsm_evt_t* cc) {
+    return cc->evt.sqns_mqtt.len;
+}
+
+/**
+ * \brief           Get quality of service of received message
+ * \param[in]       cc: Event handle
+ * \return          Quality of service
+ */
+uint8_t
+gsm_evt_sqns_mqtt_get_qos(gsm_evt_t* cc) {
+    return cc->evt.sqns_mqtt.qos;
+}
+
+/**
+ * \brief           Get message identifier
+ * \param[in]       cc: Event handle
+ * \return          Message identifier, `0` when not reported
+ */
+uint32_t
+gsm_evt_sqns_mqtt_get_mid(gsm_evt_t* cc) {
+    return cc->evt.sqns_mqtt.mid;
+}
+
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
@@ -35,6 +35,7 @@
 #include "gsm.h"
 #include "gsm_input.h"
 #include "gsm_buff.h"
+#include "gsm_trace.h"
 
 static uint32_t gsm_recv_total_len;
 static uint32_t gsm_recv_calls;
@@ -96,6 +97,9 @@ gsm_input_process(const void* data, size_t len) {
     gsm_recv_calls++;                           /* Update number of calls */
 
     gsm_core_lock();
+#if GSM_CFG_AT_TRACE
+    gsm_trace_rx(data, len);                    /* Record RX bytes */
+#endif /* GSM_CFG_AT_TRACE */
     res = gsmi_process(data, len);              /* Process input data */
     gsm_core_unlock();
     return res;
@@ -41,6 +41,8 @@
 #include "gsm_parser.h"
 #include "gsm_unicode.h"
 #include "gsm_ll.h"
+#include "gsm_timeout.h"
+#include "gsm_stats.h"
 #include "stddef.h"
 #include "fsl_dma.h"
 #include "CellIoT_lib.h"
@@ -52,6 +54,7 @@ static uint32_t bytes_to_read = 0;
 static uint8_t sqnsrecv_conn_id;
 static uint32_t sqnsrecv_bytes_pending;
 static gsmr_t gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error);
+static void gsmi_ready_wait_timeout(void* arg);
 
 /**
  * \brief           Memory mapping
@@ -77,6 +80,13 @@ gsm_dev_model_map[] = {
 #include "gsm_models.h"
 };
 
+/* Count unsolicited result code */
+#if GSM_CFG_STATS
+#define GSM_STATS_URC()                 gsm_stats_urc()
+#else
+#define GSM_STATS_URC()
+#endif /* GSM_CFG_STATS */
+
 /**
  * \brief           Size of device models mapping array
  */
@@ -304,52 +314,36 @@ gsmi_send_sized_string(const char* str, size_t size, uint8_t e, uint8_t q, uint8
 }
 
 /**
- * \brief           Send string to AT port, either plain or escaped
- * \param[in]       str: Pointer to input string to string
+ * \brief           Send binary data to AT port as hexadecimal string
+ *
+ * Data is encoded in small chunks, low-level driver transmits previous chunk while next one is encoded
+ *
+ * \param[in]       str: Pointer to input data
  * \param[in]       c: number of bytes to send
+ * \param[in]       ctrlz: Set to `1` to terminate data with `CTRL+Z`
  */
-static unsigned char lc[4000];
-
 void
 gsmi_send_raw(const unsigned char* str, uint32_t c , uint8_t ctrlz ) {
-
-	unsigned char lc_st;
-
-    if (
-    	(str != NULL)
-    	&&
-		( c < 2000 )
-		)
-    {
-		for( uint32_t i = 0; i < c<<1 ; i+=2 , str++ )
-		{
-			lc_st = *str;
-			lc_st >>=4;
-			lc_st &= 0x0f;
-			if( ( 0 <= lc_st ) && ( lc_st <= 9 ) )
-			{
-				lc[i] = lc_st + 0x30;
-			}
-			else
-			{
-				lc[i] = lc_st + 0x37;
-			}
-			lc_st = *str;
-			lc_st &= 0x0f;
-
-			if( ( 0 <= lc_st ) && ( lc_st <= 9 ) )
-			{
-				lc[i+1] = lc_st + 0x30;
-			}
-			else
-			{
-				lc[i+1] = lc_st + 0x37;
-			}
-		}
-
-    	AT_PORT_SEND( lc , c<<1) ;
-		if( ctrlz> 0 )
-			AT_PORT_SEND_CTRL_Z();
+    static const char hex[] = "0123456789ABCDEF";
+    char lc[64];
+    size_t n = 0;
+
+    if ((str != NULL) && (c < 2000)) {
+        for (uint32_t i = 0; i < c; i++, str++) {
+            lc[n++] = hex[(*str >> 4) & 0x0F];
+            lc[n++] = hex[*str & 0x0F];
+            if (n == sizeof(lc)) {
+                AT_PORT_SEND(lc, n);
+                n = 0;
+            }
+        }
+        if (n > 0) {
+            AT_PORT_SEND(lc, n);
+        }
+        if (ctrlz > 0) {
+            AT_PORT_SEND_CTRL_Z();
+        }
+        AT_PORT_SEND_FLUSH();
     }
 }
 
@@ -410,9 +404,13 @@ gsmi_receive_raw(const char* str , uint8_t connid , uint32_t rx_size )
 	if (str != NULL)
 	{
 		unsigned char lc_st;
+		st_RXData * rx = CellIoT_lib_rxPoolGet(connid, rx_size);
 
-		sRXData[connid - 1][u8_nextFreeBufferPool].connid = connid;
-		sRXData[connid - 1][u8_nextFreeBufferPool].BytesPending = rx_size;
+		/* Socket closed in between or no buffer left, the data is dropped */
+		if( rx == NULL )
+		{
+			return;
+		}
 
 		/* Convert the ASCII data to Integer data */
 		for( uint32_t i = 0  ; i < rx_size ; i++ )
@@ -420,42 +418,65 @@ gsmi_receive_raw(const char* str , uint8_t connid , uint32_t rx_size )
 			lc_st = *str;
 			if( ( '0' <= lc_st ) && ( lc_st <= '9' ) )
 			{
-				*sRXData[connid - 1][u8_nextFreeBufferPool].ptr_end = lc_st - 0x30;
+				*rx->ptr_end = lc_st - 0x30;
 			}
 			else
 			{
-				*sRXData[connid - 1][u8_nextFreeBufferPool].ptr_end = lc_st - 0x37;
+				*rx->ptr_end = lc_st - 0x37;
 			}
 
-			*sRXData[connid - 1][u8_nextFreeBufferPool].ptr_end  <<= 4;
-			*sRXData[connid - 1][u8_nextFreeBufferPool].ptr_end &= 0xF0;
+			*rx->ptr_end  <<= 4;
+			*rx->ptr_end &= 0xF0;
 			str++;
 
 			lc_st = *str;
 			if( ( '0' <= lc_st ) && ( lc_st <= '9' ) )
 			{
-				*sRXData[connid - 1][u8_nextFreeBufferPool].ptr_end += ( (lc_st - 0x30) & 0x0F );
+				*rx->ptr_end += ( (lc_st - 0x30) & 0x0F );
 			}
 			else
 			{
-				*sRXData[connid - 1][u8_nextFreeBufferPool].ptr_end += ( (lc_st - 0x37) & 0x0F );
+				*rx->ptr_end += ( (lc_st - 0x37) & 0x0F );
 			}
 			str++;
 
-			if( sRXData[connid - 1][u8_nextFreeBufferPool].ptr_end == &sRXData[connid - 1][u8_nextFreeBufferPool].RxBuffer[CELLULAR_BUFFER_SIZE - 1] )
+			if( rx->ptr_end == &rx->RxBuffer[CELLULAR_BUFFER_SIZE - 1] )
 			{
-				sRXData[connid - 1][u8_nextFreeBufferPool].ptr_end  = &sRXData[connid - 1][u8_nextFreeBufferPool].RxBuffer[0];
+				rx->ptr_end  = &rx->RxBuffer[0];
 			}
 			else
 			{
-				sRXData[connid - 1][u8_nextFreeBufferPool].ptr_end++;
+				rx->ptr_end++;
 			}
 
 		}
-		u8_nextFreeBufferPool == BUFFER_POLLS_NB - 1 ? u8_nextFreeBufferPool = 0 : u8_nextFreeBufferPool++;
     }
 }   
 
+/**
+ * \brief           Update the connection state once the module has closed it
+ * \param[in]       conn_id: Connection ID, between 1 and GSM_CFG_MAX_CONNS
+ * \param[in]       flush: `1` to discard the data not read yet, `0` to keep it for the Application
+ */
+static void
+gsmi_sqns_conn_closed(uint32_t conn_id, uint8_t flush)
+{
+	if( conn_id == 0 || conn_id > GSM_CFG_MAX_CONNS )
+	{
+		return;
+	}
+
+	gsm.m.conns[conn_id - 1].status.f.active = 0;
+
+	/* Data announced by the module can not be requested anymore */
+	gsm_ring_list_delete_conn_elem(gsm.m.ring_list, conn_id, 1);
+
+	if( flush )
+	{
+		CellIoT_lib_rxPoolFlush(conn_id);
+	}
+}
+
 
 /**
  * \brief           Send number (decimal) to AT port
@@ -475,6 +496,62 @@ gsmi_send_number(uint32_t num, uint8_t q, uint8_t c) {
     AT_PORT_SEND_QUOTE_COND(q);                 /* Send quote */
 }
 
+/**
+ * \brief           Unit of 3GPP TS 24.008 GPRS timer
+ */
+typedef struct {
+    uint32_t mult;                              /*!< Unit in seconds */
+    uint8_t code;                               /*!< Unit code, upper 3 bits of timer octet */
+} gsmi_gprs_timer_unit_t;
+
+/**
+ * \brief           GPRS Timer 3 units, used for periodic TAU (T3412 extended)
+ */
+const gsmi_gprs_timer_unit_t
+gsmi_gprs_timer3_units[] = {
+    { 2, 3 }, { 30, 4 }, { 60, 5 }, { 600, 0 }, { 3600, 1 }, { 36000, 2 }, { 1152000, 6 }
+};
+
+/**
+ * \brief           GPRS Timer 2 units, used for active time (T3324)
+ */
+const gsmi_gprs_timer_unit_t
+gsmi_gprs_timer2_units[] = {
+    { 2, 0 }, { 60, 1 }, { 360, 2 }
+};
+
+/**
+ * \brief           Send GPRS timer to AT port as quoted 8-bit string
+ *
+ * Smallest unit which can hold the value is used, value is rounded up
+ *
+ * \param[in]       seconds: Timer value in units of seconds
+ * \param[in]       units: Timer units, sorted by ascending multiplier
+ * \param[in]       units_len: Number of entries in units array
+ * \param[in]       c: Set to `1` to include comma before string
+ */
+static void
+gsmi_send_gprs_timer(uint32_t seconds, const gsmi_gprs_timer_unit_t* units, size_t units_len, uint8_t c) {
+    char str[9];
+    uint32_t val = 31;
+    uint8_t code = units[units_len - 1].code;   /* Longest possible timer when out of range */
+    uint8_t octet;
+
+    for (size_t i = 0; i < units_len; i++) {
+        if ((seconds + units[i].mult - 1) / units[i].mult <= 31) {
+            val = (seconds + units[i].mult - 1) / units[i].mult;
+            code = units[i].code;
+            break;
+        }
+    }
+    octet = GSM_U8((code << 5) | val);
+    for (size_t i = 0; i < 8; i++) {
+        str[i] = (octet & (0x80 >> i)) ? '1' : '0';
+    }
+    str[8] = 0;
+    gsmi_send_string(str, 0, 1, c);
+}
+
 /**
  * \brief           Send port number to AT port
  * \param[in]       port: Port number to send
@@ -580,6 +657,8 @@ reset_connections(uint8_t forced) {
  */
 void
 gsmi_reset_everything(uint8_t forced) {
+    st_NewRingList* ring_list;
+
     /**
      * \todo: Put stack to default state:
      *          - Close all the connection in memory
@@ -606,12 +685,43 @@ gsmi_reset_everything(uint8_t forced) {
     }
 #endif /* GSM_CFG_NETWORK */
 
-    /* Invalid GSM modules */
-    GSM_MEMSET(&gsm.m, 0x00, sizeof(gsm.m));
+    /* Ring list is allocated once in gsm_init and outlives module resets */
+    ring_list = gsm.m.ring_list;
+
+    /* Invalid GSM modules, device identity is kept while device stays present */
+    if (gsm.status.f.dev_present) {
+        char manufacturer[sizeof(gsm.m.model_manufacturer)], number[sizeof(gsm.m.model_number)];
+        char serial_number[sizeof(gsm.m.model_serial_number)], revision[sizeof(gsm.m.model_revision)];
+        gsm_device_model_t model = gsm.m.model;
+
+        GSM_MEMCPY(manufacturer, gsm.m.model_manufacturer, sizeof(manufacturer));
+        GSM_MEMCPY(number, gsm.m.model_number, sizeof(number));
+        GSM_MEMCPY(serial_number, gsm.m.model_serial_number, sizeof(serial_number));
+        GSM_MEMCPY(revision, gsm.m.model_revision, sizeof(revision));
+        GSM_MEMSET(&gsm.m, 0x00, sizeof(gsm.m));
+        GSM_MEMCPY(gsm.m.model_manufacturer, manufacturer, sizeof(manufacturer));
+        GSM_MEMCPY(gsm.m.model_number, number, sizeof(number));
+        GSM_MEMCPY(gsm.m.model_serial_number, serial_number, sizeof(serial_number));
+        GSM_MEMCPY(gsm.m.model_revision, revision, sizeof(revision));
+        gsm.m.model = model;
+    } else {
+        GSM_MEMSET(&gsm.m, 0x00, sizeof(gsm.m));
+        gsm.m.model = GSM_DEVICE_MODEL_UNKNOWN;
+    }
+    gsm.m.ring_list = ring_list;
 
     /* Manually set states */
     gsm.m.sim.state = (gsm_sim_state_t)-1;
-    gsm.m.model = GSM_DEVICE_MODEL_UNKNOWN;
+}
+
+/**
+ * \brief           Check if device identity was already read from device
+ * \return          `1` when manufacturer, model, serial number and revision are known, `0` otherwise
+ */
+static uint8_t
+gsmi_device_is_identified(void) {
+    return gsm.m.model_manufacturer[0] != '\0' && gsm.m.model_number[0] != '\0'
+        && gsm.m.model_serial_number[0] != '\0' && gsm.m.model_revision[0] != '\0';
 }
 
 /**
@@ -830,6 +940,35 @@ gsmi_conn_closed_process(uint8_t conn_num, uint8_t forced) {
 
 #endif /* GSM_CFG_CONN || __DOXYGEN__ */
 
+/**
+ * \brief           Timeout callback while waiting for device or SIM to become ready
+ *
+ * Missing `+SYSSTART` is replaced with periodic `AT` probes,
+ * SIM readiness after PIN entry is polled with `AT+CPIN?`
+ *
+ * \param[in]       arg: Message the wait belongs to
+ */
+static void
+gsmi_ready_wait_timeout(void* arg) {
+    gsm_msg_t* msg = arg;
+
+    if (gsm.msg != msg) {                       /* Message already finished */
+        return;
+    }
+    if (CMD_IS_DEF(GSM_CMD_RESET)
+        && (CMD_IS_CUR(GSM_CMD_SYSSTART_WAIT) || CMD_IS_CUR(GSM_CMD_UART))) {
+        /* Give up after maximal number of probes, message timeout ends the reset */
+        if (msg->msg.reset.probes < GSM_CFG_RESET_PROBE_MAX) {
+            ++msg->msg.reset.probes;
+            msg->cmd = GSM_CMD_UART;            /* Check if device answers */
+            msg->fn(msg);
+            gsm_timeout_add(GSM_CFG_RESET_PROBE_INTERVAL, gsmi_ready_wait_timeout, msg);
+        }
+    } else if (CMD_IS_DEF(GSM_CMD_CPIN_SET) && CMD_IS_CUR(GSM_CMD_CPIN_WAIT)) {
+        msg->cmd = GSM_CMD_CPIN_GET;            /* No URC yet, ask for SIM status */
+        msg->fn(msg);
+    }
+}
 
 /**
  * \brief           Process received string from GSM
@@ -843,6 +982,12 @@ gsmi_parse_received(gsm_recv_t* rcv) {
 
     /* Try to remove non-parsable strings */
     if (rcv->len == 2 && rcv->data[0] == '\r' && rcv->data[1] == '\n') {
+#if GSM_CFG_SQNS_MQTT
+        /* Payload of AT+SQNSMQTTRCVMESSAGE follows the first empty line */
+        if (CMD_IS_CUR(GSM_CMD_SQNSMQTTCLIENTRCVMESSAGE) && gsm.msg->msg.sqns_mqtt_rcv.read == 1) {
+            gsm.msg->msg.sqns_mqtt_rcv.read = gsm.msg->msg.sqns_mqtt_rcv.rx->tot_len > 0 ? 2 : 0;
+        }
+#endif /* GSM_CFG_SQNS_MQTT */
         return;
     }
 
@@ -871,6 +1016,7 @@ gsmi_parse_received(gsm_recv_t* rcv) {
         } else if (!strncmp(rcv->data, "+PDP: DEACT", 11)) {
             /* PDP has been deactivated */
             gsm_network_check_status(NULL, NULL, 0);/* Update status */
+            GSM_STATS_URC();
 #endif /* GSM_CFG_NETWORK */
 #if GSM_CFG_CONN
         } else if (!strncmp(rcv->data, "+RECEIVE", 8)) {
@@ -878,8 +1024,32 @@ gsmi_parse_received(gsm_recv_t* rcv) {
 #endif /* GSM_CFG_CONN */
         } else if (!strncmp(rcv->data, "+CREG", 5)) {   /* Check for +CREG indication */
             gsmi_parse_creg(rcv->data, GSM_U8(CMD_IS_CUR(GSM_CMD_CREG_GET)));  /* Parse +CREG response */
+            if (!CMD_IS_CUR(GSM_CMD_CREG_GET)) {
+                GSM_STATS_URC();
+            }
+        } else if (!strncmp(rcv->data, "+CEREG", 6)) {  /* Check for +CEREG indication */
+            gsmi_parse_creg(rcv->data, GSM_U8(CMD_IS_CUR(GSM_CMD_CEREG_GET))); /* Parse +CEREG response */
+            if (!CMD_IS_CUR(GSM_CMD_CEREG_GET)) {
+                GSM_STATS_URC();
+            }
+        } else if (!strncmp(rcv->data, "+CSCON", 6)) {  /* Check for radio connection state */
+            gsmi_parse_cscon(rcv->data);
+            GSM_STATS_URC();
         } else if (!strncmp(rcv->data, "+CPIN", 5)) {   /* Check for +CPIN indication for SIM */
+            if (!CMD_IS_CUR(GSM_CMD_CPIN_GET)) {
+                GSM_STATS_URC();
+            }
             gsmi_parse_cpin(rcv->data, 1 /* !CMD_IS_DEF(GSM_CMD_CPIN_SET) */);  /* Parse +CPIN response */
+            if (CMD_IS_CUR(GSM_CMD_CPIN_WAIT) && gsm.m.sim.state == GSM_SIM_STATE_READY) {
+                gsm_timeout_remove(gsmi_ready_wait_timeout);
+                is_ok = 1;                      /* SIM is ready, finish waiting */
+            }
+        } else if (!strncmp(rcv->data, "+SYSSTART", 9)) {   /* Device finished booting */
+            GSM_STATS_URC();
+            if (CMD_IS_CUR(GSM_CMD_SYSSTART_WAIT)) {
+                gsm_timeout_remove(gsmi_ready_wait_timeout);
+                is_ok = 1;
+            }
         } else if (CMD_IS_CUR(GSM_CMD_COPS_GET) && !strncmp(rcv->data, "+COPS", 5)) {
             gsmi_parse_cops(rcv->data);         /* Parse current +COPS */
 #if GSM_CFG_SMS
@@ -925,9 +1095,14 @@ gsmi_parse_received(gsm_recv_t* rcv) {
 #if GSM_SEQUANS_SPECIFIC_CMD
         } else if (CMD_IS_CUR(GSM_CMD_SQNDNSLKUP) && !strncmp(rcv->data, "+SQNDNSLKUP", 11)) {
         	gsmi_parse_sqndnslkup(rcv->data);         /* Parse +SQNDNSLKUP statement */
+        } else if ((CMD_IS_CUR(GSM_CMD_SQNSCFG_GET) && !strncmp(rcv->data, "+SQNSCFG:", 9))
+                || (CMD_IS_CUR(GSM_CMD_SQNSCFGEXT_GET) && !strncmp(rcv->data, "+SQNSCFGEXT:", 12))
+                || (CMD_IS_CUR(GSM_CMD_SQNSPCFG_GET) && !strncmp(rcv->data, "+SQNSPCFG:", 10))) {
+            gsmi_parse_sqns_cfg_get(rcv->data); /* Parse settings read back from the module */
         }
         else if( !strncmp(rcv->data, "+SQNSRING", 9) )
         {
+			GSM_STATS_URC();
 			if(gsmi_parse_rcvdata_update(rcv->data))
 			{
 				rxDataStage = SQNSRING_RECEIVED;
@@ -961,9 +1136,35 @@ gsmi_parse_received(gsm_recv_t* rcv) {
 		}
 		else if( !strncmp(rcv->data, "+SQNSH", 6) )
 		{
-			// can be parsed to check the connection ID.
-			is_ok = 1;
+			const char* ptx = &rcv->data[6];
+			uint32_t conn_id;
+
+			/* Skip ': ' */
+			while( *ptx == ':' || *ptx == ' ' )
+			{
+				ptx++;
+			}
+			conn_id = gsmi_parse_number(&ptx);
+
+			if( CMD_IS_CUR(GSM_CMD_SQNSH) && conn_id == gsm.msg->msg.socket_dial.connId )
+			{
+				gsmi_sqns_conn_closed(conn_id, 1);
+				is_ok = 1;
+			}
+			else
+			{
+				/* Closed by the remote host, keep the data received so far for the Application */
+				gsmi_sqns_conn_closed(conn_id, 0);
+				GSM_STATS_URC();
+			}
+		}
+#if GSM_CFG_SQNS_MQTT
+		else if( !strncmp(rcv->data, "+SQNSMQTTON", 11) )
+		{
+			gsmi_parse_sqnsmqtt(rcv->data);		/* Parse module MQTT client URC */
+			GSM_STATS_URC();
 		}
+#endif /* GSM_CFG_SQNS_MQTT */
 #endif /* GSM_SEQUANS_SPECIFIC_CMD */
 
 
@@ -1154,35 +1355,35 @@ gsmi_parse_received(gsm_recv_t* rcv) {
 #if GSM_SEQUANS_SPECIFIC_CMD
         else if (CMD_IS_DEF(GSM_CMD_SQNSD)) {
 			/* For SQNSD, OK is returned before important data */
-			if (gsm.m.conn_val_id < GSM_CFG_MAX_CONNS) {
-				uint8_t id;
-				gsm_conn_t* conn = &gsm.m.conns[gsm.m.conn_val_id];   /* Get connection handle */
-
-				if ( ( !strncmp(rcv->data, "CONNECT" CRLF, 7 + CRLF_LEN) ) ||
-					 ( !strncmp(rcv->data, "OK" CRLF, 2 + CRLF_LEN) ) ) {
-					id = conn->val_id;
-					GSM_MEMSET(conn, 0x00, sizeof(*conn));  /* Reset connection parameters */
-					conn->num = gsm.m.conn_val_id;
-					conn->status.f.active = 1;
-					conn->val_id = ++id;            /* Set new validation ID */
-
-					/* Set connection parameters */
-					conn->status.f.client = 1;
-					conn->evt_func = gsm.msg->msg.conn_start.evt_func;
-					conn->arg = gsm.msg->msg.conn_start.arg;
-
-					/* Set status */
-					gsm.msg->msg.conn_start.conn_res = GSM_CONN_CONNECT_OK;
-
-					/* Add a connection to the valid connection structure */
-					gsm.m.conn_val_id++;
-					is_ok = 1;
+			uint8_t conn_id = gsm.msg->msg.socket_dial.connId;
+
+			if (conn_id == 0 || conn_id > GSM_CFG_MAX_CONNS) {
+				is_error = 1;
+			} else if ( ( !strncmp(rcv->data, "CONNECT" CRLF, 7 + CRLF_LEN) ) ||
+						( !strncmp(rcv->data, "OK" CRLF, 2 + CRLF_LEN) ) ) {
+				uint8_t id, reserved;
+				gsm_conn_t* conn = &gsm.m.conns[conn_id - 1];   /* Get connection handle */
+
+				id = conn->val_id;
+				reserved = conn->status.f.reserved;
+				GSM_MEMSET(conn, 0x00, sizeof(*conn));  /* Reset connection parameters */
+				conn->num = conn_id;
+				conn->status.f.active = 1;
+				conn->status.f.reserved = reserved;
+				conn->val_id = ++id;            /* Set new validation ID */
+
+				/* Set connection parameters */
+				conn->status.f.client = 1;
+				conn->type = gsm.msg->msg.socket_dial.txProt ? GSM_CONN_TYPE_UDP : GSM_CONN_TYPE_TCP;
+				conn->remote_port = gsm.msg->msg.socket_dial.rHostPort;
+				if (gsm.msg->msg.socket_dial.ip != NULL) {
+					const char* ip_str = gsm.msg->msg.socket_dial.ip;
+					gsmi_parse_ip(&ip_str, &conn->remote_ip);
 				}
+				is_ok = 1;
 			} else if (!strncmp(rcv->data, "+CME ERROR:", 10)) {
-				gsm.msg->msg.conn_start.conn_res = GSM_CONN_CONNECT_ERROR;
 				is_error = 1;
 			} else if (!strncmp(rcv->data, "NO CARRIER" CRLF, 10 + CRLF_LEN)) {
-				gsm.msg->msg.conn_start.conn_res = GSM_CONN_CONNECT_ERROR;
 				is_error = 1;
 			}
         }
@@ -1267,8 +1468,15 @@ gsmi_parse_received(gsm_recv_t* rcv) {
         	{
 				if( !strncmp(rcv->data, "OK" CRLF , 2+CRLF_LEN ))
 				{
+					uint8_t conn_id = gsm.msg->msg.rx_data.connId;
 
-					gsm.msg->msg.rx_data.pptrRx = (unsigned char*)sRXData[gsm.msg->msg.rx_data.connId - 1][u8_nextBufferPoolForData].RxBuffer;
+					/* Point to the oldest data of the connection */
+					gsm.msg->msg.rx_data.pptrRx = NULL;
+					if( conn_id != 0 && conn_id <= GSM_CFG_MAX_CONNS && sRXQueue[conn_id - 1].count > 0 )
+					{
+						st_RXQueue * queue = &sRXQueue[conn_id - 1];
+						gsm.msg->msg.rx_data.pptrRx = (unsigned char*)sRXData[queue->bufferIdx[queue->head]].ptr_start;
+					}
 					is_ok = 1;
 				}
 				else
@@ -1284,14 +1492,35 @@ gsmi_parse_received(gsm_recv_t* rcv) {
         	if( !strncmp( rcv->data , "OK" CRLF , 2+CRLF_LEN ))
         	{
         		is_ok = 1;
-        		/* Remove a connection to the valid connection structure */
-				gsm.m.conn_val_id--;
+        		/* The connection is closed, pending data is not needed anymore */
+        		gsmi_sqns_conn_closed(gsm.msg->msg.socket_dial.connId, 1);
         	}
         	else if( !strncmp( rcv->data , "ERROR" CRLF , 5+CRLF_LEN ))
         	{
         		is_error = 1;
         	}
         }
+#if GSM_CFG_SQNS_MQTT
+        else if (CMD_IS_CUR(GSM_CMD_SQNSMQTTCLIENTCONNECT)) {
+            /* OK only accepts the request, result comes with +SQNSMQTTONCONNECT */
+            if (is_ok) {
+                is_ok = 0;
+            }
+            if (!strncmp(rcv->data, "+SQNSMQTTONCONNECT", 18)) {
+                if (gsm.msg->msg.sqns_mqtt_connect.rc == 0) {
+                    is_ok = 1;
+                } else {
+                    is_error = 1;
+                }
+            }
+        }
+#endif /* GSM_CFG_SQNS_MQTT */
+        else if ((CMD_IS_CUR(GSM_CMD_SQNSCFG_GET) || CMD_IS_CUR(GSM_CMD_SQNSCFGEXT_GET) || CMD_IS_CUR(GSM_CMD_SQNSPCFG_GET))
+                 && is_ok && !gsm.msg->msg.cfg_get.found) {
+            /* Module did not list the requested ID */
+            is_ok = 0;
+            is_error = 1;
+        }
 #endif
     }
 
@@ -1319,6 +1548,9 @@ gsmi_parse_received(gsm_recv_t* rcv) {
     if (is_ok || is_error) {
         gsmr_t res = gsmOK;
         if (gsm.msg != NULL) {                  /* Do we have active message? */
+#if GSM_CFG_STATS
+            gsm_stats_cmd_end(gsm.msg->cmd, GSM_U8(is_error != 0));
+#endif /* GSM_CFG_STATS */
             res = gsmi_process_sub_cmd(gsm.msg, &is_ok, &is_error);
             if (res != gsmCONT) {               /* Shall we continue with next subcommand under this one? */
                 if (is_ok) {                    /* Check OK status */
@@ -1397,6 +1629,9 @@ gsmi_process(const void* data, size_t data_len) {
     if (!gsm.status.f.dev_present) {
         return gsmERRNODEVICE;
     }
+#if GSM_CFG_STATS
+    gsm_stats_rx(data_len);
+#endif /* GSM_CFG_STATS */
 
     while (d_len) {                             /* Read entire set of characters from buffer */
         ch = *d++;                              /* Get next character */
@@ -1531,6 +1766,47 @@ gsmi_process(const void* data, size_t data_len) {
                 gsm.msg->msg.sms_list.read = 0;
             }
 #endif /* GSM_CFG_SMS */
+#if GSM_CFG_SQNS_MQTT
+        } else if (CMD_IS_CUR(GSM_CMD_SQNSMQTTCLIENTRCVMESSAGE) && gsm.msg->msg.sqns_mqtt_rcv.read == 2) {
+            static const char err_resp[] = "ERROR" CRLF;
+            gsm_sqns_mqtt_rx_t* rx = gsm.msg->msg.sqns_mqtt_rcv.rx;
+            size_t len, tocopy;
+
+            /*
+             * When the message is not available anymore, module answers ERROR
+             * after the same empty line. Track whether payload matches it so far
+             */
+            if (gsm.msg->msg.sqns_mqtt_rcv.err == gsm.msg->msg.sqns_mqtt_rcv.ptr
+                && ch == (uint8_t)err_resp[gsm.msg->msg.sqns_mqtt_rcv.err]) {
+                gsm.msg->msg.sqns_mqtt_rcv.err++;
+            }
+            if (rx->len < rx->size) {
+                rx->data[rx->len++] = ch;
+            }
+            gsm.msg->msg.sqns_mqtt_rcv.ptr++;
+
+            /* Try to read more data directly from buffer once it cannot be an error */
+            if (gsm.msg->msg.sqns_mqtt_rcv.err != gsm.msg->msg.sqns_mqtt_rcv.ptr) {
+                len = GSM_MIN(d_len, rx->tot_len - gsm.msg->msg.sqns_mqtt_rcv.ptr);
+                tocopy = GSM_MIN(len, rx->size - rx->len);
+                GSM_MEMCPY(&rx->data[rx->len], d, tocopy);
+                rx->len += tocopy;
+                gsm.msg->msg.sqns_mqtt_rcv.ptr += len;
+                d_len -= len;
+                d += len;
+            }
+
+            if (gsm.msg->msg.sqns_mqtt_rcv.err == sizeof(err_resp) - 1) {
+                gsm.msg->msg.sqns_mqtt_rcv.read = 0;
+                rx->len = 0;
+                strcpy(recv_buff.data, err_resp);
+                recv_buff.len = strlen(recv_buff.data);
+                gsmi_parse_received(&recv_buff);
+                RECV_RESET();
+            } else if (gsm.msg->msg.sqns_mqtt_rcv.ptr == rx->tot_len) {
+                gsm.msg->msg.sqns_mqtt_rcv.read = 0;    /* OK follows the payload */
+            }
+#endif /* GSM_CFG_SQNS_MQTT */
 #if GSM_CFG_USSD
         } else if (CMD_IS_CUR(GSM_CMD_CUSD) && gsm.msg->msg.ussd.read) {
             if (ch == '"') {
@@ -1678,6 +1954,7 @@ gsmi_process(const void* data, size_t data_len) {
 							{
 								gsmi_send_string(gsm.msg->msg.modem_memory.cert_key_ptr, 0, 0, 0);
 							}
+							AT_PORT_SEND_FLUSH();
 						}
                         else if(CMD_IS_DEF(GSM_CMD_SQNSSEND))
                         {
@@ -1689,6 +1966,14 @@ gsmi_process(const void* data, size_t data_len) {
                         	RECV_RESET();       /* Reset received object */
 	                        gsmi_send_raw(gsm.msg->msg.tx_data.ptrTx, gsm.msg->msg.tx_data.Txsize , 0);
 	                    }
+#if GSM_CFG_SQNS_MQTT
+                        else if (CMD_IS_CUR(GSM_CMD_SQNSMQTTCLIENTPUBLISH)) {
+                            RECV_RESET();       /* Reset received object */
+
+                            /* Payload goes as is, module frames it */
+                            AT_PORT_SEND_WITH_FLUSH(gsm.msg->msg.sqns_mqtt_topic.data, gsm.msg->msg.sqns_mqtt_topic.len);
+                        }
+#endif /* GSM_CFG_SQNS_MQTT */
 #endif
                     }
 
@@ -1744,6 +2029,25 @@ gsmi_process(const void* data, size_t data_len) {
     n_cmd = (new_cmd);                          \
 } while (0)
 
+/**
+ * \brief           Change baudrate of local AT port
+ * \param[in]       baudrate: New baudrate
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+gsmi_set_local_baudrate(uint32_t baudrate) {
+    gsmr_t res;
+
+    if (baudrate == gsm.ll.uart.baudrate) {
+        return gsmOK;
+    }
+    gsm.ll.uart.baudrate = baudrate;
+    res = gsm_ll_init(&gsm.ll);                 /* Low-level reloads the divider only */
+    GSM_DEBUGF(GSM_CFG_DBG_INIT | GSM_DBG_TYPE_TRACE,
+        "[CORE] AT port baudrate set to %d\r\n", (int)baudrate);
+    return res;
+}
+
 /**
  * \brief           Process current command with known execution status and start another if necessary
  * \param[in]       msg: Pointer to current message
@@ -1758,17 +2062,45 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
         switch (CMD_GET_CUR()) {                /* Check current command */
             case GSM_CMD_RESET: {
                 gsmi_reset_everything(1);       /* Reset everything */
+                SET_NEW_CMD(GSM_CMD_SYSSTART_WAIT); /* Wait for device to boot */
+                break;
+            }
+            case GSM_CMD_SYSSTART_WAIT:
+            case GSM_CMD_UART: {                /* Device booted or answered probe */
+                gsm_timeout_remove(gsmi_ready_wait_timeout);
                 SET_NEW_CMD(GSM_CFG_AT_ECHO ? GSM_CMD_ATE1 : GSM_CMD_ATE0); /* Set ECHO mode */
-                gsm_delay(5000);                /* Delay for some time before we can continue after reset */
                 break;
             }
             case GSM_CMD_ATE0:
             case GSM_CMD_ATE1:      SET_NEW_CMD(GSM_CMD_CFUN_SET); break;   /* Set full functionality */
             case GSM_CMD_CFUN_SET:  SET_NEW_CMD(GSM_CMD_CMEE_SET); break;   /* Set detailed error reporting */
-            case GSM_CMD_CMEE_SET:  SET_NEW_CMD(GSM_CMD_CGMI_GET); break;   /* Get manufacturer */
+            case GSM_CMD_CMEE_SET: {
+                if (gsmi_device_is_identified()) {
+                    /* Identity known, only check serial number to detect swapped device */
+                    GSM_MEMCPY(msg->msg.reset.serial_number, gsm.m.model_serial_number, sizeof(msg->msg.reset.serial_number));
+                    SET_NEW_CMD(GSM_CMD_CGSN_GET);
+                } else {
+                    SET_NEW_CMD(GSM_CMD_CGMI_GET);  /* Get manufacturer */
+                }
+                break;
+            }
             case GSM_CMD_CGMI_GET:  SET_NEW_CMD(GSM_CMD_CGMM_GET); break;   /* Get model */
             case GSM_CMD_CGMM_GET:  SET_NEW_CMD(GSM_CMD_CGSN_GET); break;   /* Get product serial number */
-            case GSM_CMD_CGSN_GET:  SET_NEW_CMD(GSM_CMD_CGMR_GET); break;   /* Get product revision */
+            case GSM_CMD_CGSN_GET: {
+                if (msg->msg.reset.serial_number[0] == '\0') {
+                    SET_NEW_CMD(GSM_CMD_CGMR_GET);  /* Get product revision */
+                } else if (*is_ok && !strncmp(msg->msg.reset.serial_number, gsm.m.model_serial_number,
+                    sizeof(msg->msg.reset.serial_number))) {
+                    gsmi_send_cb(GSM_EVT_DEVICE_IDENTIFIED);    /* Same device, identity is valid */
+                    SET_NEW_CMD(GSM_CMD_CREG_SET);
+                } else {
+                    /* Different device, read complete identity */
+                    msg->msg.reset.serial_number[0] = '\0';
+                    gsm.m.model = GSM_DEVICE_MODEL_UNKNOWN;
+                    SET_NEW_CMD(GSM_CMD_CGMI_GET);
+                }
+                break;
+            }
             case GSM_CMD_CGMR_GET: {
                 /*
                  * At this point we have modem info.
@@ -1780,7 +2112,8 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
                 SET_NEW_CMD(GSM_CMD_CREG_SET);      /* Enable unsolicited code for CREG */
                 break;
             }
-            case GSM_CMD_CREG_SET: break;/* Set call state */
+            case GSM_CMD_CREG_SET: SET_NEW_CMD(GSM_CMD_CEREG_SET); break;  /* Enable unsolicited code for CEREG */
+            case GSM_CMD_CEREG_SET: break;
             /*case GSM_CMD_CREG_SET: SET_NEW_CMD(GSM_CMD_CLCC_SET); break;*//* Set call state */
             case GSM_CMD_CLCC_SET: SET_NEW_CMD(GSM_CMD_CPIN_GET); break;/* Get SIM state */
             case GSM_CMD_CPIN_GET: break;
@@ -1791,6 +2124,24 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
         if (n_cmd == GSM_CMD_IDLE) {
             RESET_SEND_EVT(msg, gsmOK);
         }
+    } else if (CMD_IS_DEF(GSM_CMD_IPR)) {
+        if (CMD_IS_CUR(GSM_CMD_IPR) && *is_ok) {
+            /* OK is still sent at the old rate, device switches right after it */
+            msg->msg.uart.prev_baudrate = gsm.ll.uart.baudrate;
+            if (gsmi_set_local_baudrate(msg->msg.uart.baudrate) == gsmOK) {
+                gsm_delay(GSM_CFG_AT_PORT_BAUDRATE_SETTLE_DELAY);
+                SET_NEW_CMD(GSM_CMD_UART);      /* Verify link at new rate */
+            } else {
+                *is_ok = 0;
+                *is_error = 1;
+            }
+        } else if (CMD_IS_CUR(GSM_CMD_UART) && !*is_ok) {
+            gsmi_set_local_baudrate(msg->msg.uart.prev_baudrate);
+        }
+    } else if (CMD_IS_DEF(GSM_CMD_UART)) {
+        if (!*is_ok) {
+            gsmi_set_local_baudrate(msg->msg.uart.prev_baudrate);
+        }
     } else if (CMD_IS_DEF(GSM_CMD_COPS_GET)) {
         if (CMD_IS_CUR(GSM_CMD_COPS_GET)) {
             gsm.evt.evt.operator_current.operator_current = &gsm.m.network.curr_operator;
@@ -1816,10 +2167,17 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
         }
     } else if (CMD_IS_DEF(GSM_CMD_CPIN_SET)) {  /* Set PIN code */
         switch (CMD_GET_CUR()) {
-            case GSM_CMD_CPIN_GET: {            /* Get own phone number */
-                if (*is_ok && gsm.m.sim.state == GSM_SIM_STATE_PIN) {
+            case GSM_CMD_CPIN_GET: {            /* Get SIM status */
+                if (*is_ok && gsm.m.sim.state == GSM_SIM_STATE_PIN && !msg->msg.cpin_enter.pin_sent) {
                     SET_NEW_CMD(GSM_CMD_CPIN_SET);  /* Set command to write PIN */
-                } else if (gsm.m.sim.state != GSM_SIM_STATE_READY) {
+                } else if (gsm.m.sim.state == GSM_SIM_STATE_READY) {
+                    break;
+                } else if (msg->msg.cpin_enter.pin_sent && gsm.m.sim.state != GSM_SIM_STATE_PIN
+                    && gsm.m.sim.state != GSM_SIM_STATE_PUK
+                    && msg->msg.cpin_enter.polls < GSM_CFG_SIM_READY_POLL_MAX) {
+                    ++msg->msg.cpin_enter.polls;
+                    SET_NEW_CMD(GSM_CMD_CPIN_WAIT); /* SIM still initializing */
+                } else {
                     *is_ok = 0;
                     *is_error = 1;
                 }
@@ -1827,10 +2185,12 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
             }
             case GSM_CMD_CPIN_SET: {            /* Set CPIN */
                 if (*is_ok) {
-                    gsm_delay(5000);            /* Make delay to make sure SIM is ready */
+                    msg->msg.cpin_enter.pin_sent = 1;
+                    SET_NEW_CMD(GSM_CMD_CPIN_WAIT); /* Wait for SIM to become ready */
                 }
                 break;
             }
+            case GSM_CMD_CPIN_WAIT: break;      /* +CPIN: READY received */
             default:
                 break;
         }
@@ -2075,6 +2435,9 @@ gsmi_process_sub_cmd(gsm_msg_t* msg, uint8_t* is_ok, uint16_t* is_error) {
  */
 gsmr_t
 gsmi_initiate_cmd(gsm_msg_t* msg) {
+#if GSM_CFG_STATS
+    gsm_stats_cmd_start(CMD_GET_CUR());         /* Latency is measured from here to final response */
+#endif /* GSM_CFG_STATS */
     switch (CMD_GET_CUR()) {                    /* Check current message we want to send over AT */
         case GSM_CMD_RESET: {                   /* Reset modem with AT commands */
             /* Try with hardware reset */
@@ -2095,6 +2458,35 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
+        case GSM_CMD_SYSSTART_WAIT: {           /* Nothing to send, probe only if URC does not come */
+            gsm_timeout_add(GSM_CFG_RESET_SYSSTART_TIMEOUT, gsmi_ready_wait_timeout, msg);
+            break;
+        }
+        case GSM_CMD_CPIN_WAIT: {               /* Nothing to send, poll only if URC does not come */
+            gsm_timeout_add(GSM_CFG_SIM_READY_POLL_INTERVAL, gsmi_ready_wait_timeout, msg);
+            break;
+        }
+        case GSM_CMD_IPR: {                     /* Set device AT port baudrate */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+IPR=");
+            gsmi_send_number(GSM_U32(msg->msg.uart.baudrate), 0, 0);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_UART: {                    /* Probe AT port */
+            if (CMD_IS_DEF(GSM_CMD_UART)) {
+                msg->msg.uart.prev_baudrate = gsm.ll.uart.baudrate;
+                if (msg->msg.uart.baudrate != gsm.ll.uart.baudrate) {
+                    if (gsmi_set_local_baudrate(msg->msg.uart.baudrate) != gsmOK) {
+                        return gsmERR;
+                    }
+                    gsm_delay(GSM_CFG_AT_PORT_BAUDRATE_SETTLE_DELAY);
+                }
+            }
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_END_AT();
+            break;
+        }
         case GSM_CMD_ATE0:
         case GSM_CMD_ATE1: {
             AT_PORT_SEND_BEGIN_AT();
@@ -2154,6 +2546,56 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
             AT_PORT_SEND_END_AT();
             break;
         }
+        case GSM_CMD_CEREG_SET: {               /* Enable +CEREG message */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CEREG=1");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_CEREG_GET: {               /* Get EPS network registration status */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CEREG?");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_CPSMS_SET: {               /* Request power saving mode timers */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CPSMS=");
+            if (msg->msg.psm.enable) {
+                AT_PORT_SEND_CONST_STR("1,,,");
+                gsmi_send_gprs_timer(msg->msg.psm.tau, gsmi_gprs_timer3_units, GSM_ARRAYSIZE(gsmi_gprs_timer3_units), 0);
+                gsmi_send_gprs_timer(msg->msg.psm.active_time, gsmi_gprs_timer2_units, GSM_ARRAYSIZE(gsmi_gprs_timer2_units), 1);
+            } else {
+                AT_PORT_SEND_CONST_STR("0");
+            }
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_CEDRXS_SET: {              /* Request eDRX cycle */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CEDRXS=");
+            if (msg->msg.edrx.enable) {
+                char str[5];
+                for (size_t i = 0; i < 4; i++) {
+                    str[i] = (msg->msg.edrx.cycle & (0x08 >> i)) ? '1' : '0';
+                }
+                str[4] = 0;
+                AT_PORT_SEND_CONST_STR("1");
+                gsmi_send_number(GSM_U32(msg->msg.edrx.act), 0, 1);
+                gsmi_send_string(str, 0, 1, 1);
+            } else {
+                AT_PORT_SEND_CONST_STR("0");
+            }
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_CSCON_SET: {               /* Enable +CSCON reports */
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+CSCON=");
+            gsmi_send_number(GSM_U32(!!msg->msg.cscon.enable), 0, 0);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
         case GSM_CMD_CFUN_SET: {
             AT_PORT_SEND_BEGIN_AT();
             AT_PORT_SEND_CONST_STR("+CFUN=");
@@ -2651,6 +3093,7 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
 			gsmi_send_number(GSM_U32(msg->msg.tx_data.connId), 0, 0);
 			gsmi_send_number(GSM_U32(msg->msg.tx_data.Txsize), 0, 1);
 			AT_PORT_SEND_CONST_STR("\r");
+			AT_PORT_SEND_FLUSH();
         }
         break;
 
@@ -2680,9 +3123,19 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
 			gsmi_send_number(GSM_U32(msg->msg.tls_security_profile_cfg.version), 0, 1);
 			gsmi_send_string(msg->msg.tls_security_profile_cfg.cipherSpecs, 1, 1, 1);
 			gsmi_send_number(GSM_U32(msg->msg.tls_security_profile_cfg.certValidLevel), 0, 1);
-			gsmi_send_number(GSM_U32(msg->msg.tls_security_profile_cfg.caCertificateID), 0, 1);
-			gsmi_send_number(GSM_U32(msg->msg.tls_security_profile_cfg.clientCertificateID), 0, 1);
-			gsmi_send_number(GSM_U32(msg->msg.tls_security_profile_cfg.clientPrivateKeyID), 0, 1);
+			/* Empty fields for the certificates not used by the profile */
+			if(SQNS_NVM_SLOT_NONE != msg->msg.tls_security_profile_cfg.caCertificateID)
+				gsmi_send_number(GSM_U32(msg->msg.tls_security_profile_cfg.caCertificateID), 0, 1);
+			else
+				AT_PORT_SEND_CONST_STR(",");
+			if(SQNS_NVM_SLOT_NONE != msg->msg.tls_security_profile_cfg.clientCertificateID)
+				gsmi_send_number(GSM_U32(msg->msg.tls_security_profile_cfg.clientCertificateID), 0, 1);
+			else
+				AT_PORT_SEND_CONST_STR(",");
+			if(SQNS_NVM_SLOT_NONE != msg->msg.tls_security_profile_cfg.clientPrivateKeyID)
+				gsmi_send_number(GSM_U32(msg->msg.tls_security_profile_cfg.clientPrivateKeyID), 0, 1);
+			else
+				AT_PORT_SEND_CONST_STR(",");
 			if(NULL != msg->msg.tls_security_profile_cfg.psk)
 			{
 				gsmi_send_string(msg->msg.tls_security_profile_cfg.psk, 1, 1, 1);
@@ -2716,6 +3169,25 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
 			break;
 		}
 
+		case GSM_CMD_SQNSPCFG_GET: {
+			AT_PORT_SEND_BEGIN_AT();
+			AT_PORT_SEND_CONST_STR("+SQNSPCFG?");
+			AT_PORT_SEND_END_AT();
+			break;
+		}
+		case GSM_CMD_SQNSCFG_GET: {
+			AT_PORT_SEND_BEGIN_AT();
+			AT_PORT_SEND_CONST_STR("+SQNSCFG?");
+			AT_PORT_SEND_END_AT();
+			break;
+		}
+		case GSM_CMD_SQNSCFGEXT_GET: {
+			AT_PORT_SEND_BEGIN_AT();
+			AT_PORT_SEND_CONST_STR("+SQNSCFGEXT?");
+			AT_PORT_SEND_END_AT();
+			break;
+		}
+
 		case GSM_CMD_SQNSH: {
 			AT_PORT_SEND_BEGIN_AT();
 			AT_PORT_SEND_CONST_STR("+SQNSH=");
@@ -2751,6 +3223,69 @@ gsmi_initiate_cmd(gsm_msg_t* msg) {
 			AT_PORT_SEND_END_AT();
 			break;
 		}
+#if GSM_CFG_SQNS_MQTT
+        case GSM_CMD_SQNSMQTTCLIENTCFG: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+SQNSMQTTCFG=0");
+            gsmi_send_string(msg->msg.sqns_mqtt_cfg.client_id, 1, 1, 1);
+            if (msg->msg.sqns_mqtt_cfg.user != NULL || msg->msg.sqns_mqtt_cfg.pass != NULL
+                || msg->msg.sqns_mqtt_cfg.sp_id > 0) {
+                gsmi_send_string(msg->msg.sqns_mqtt_cfg.user, 1, 1, 1);
+                gsmi_send_string(msg->msg.sqns_mqtt_cfg.pass, 1, 1, 1);
+                if (msg->msg.sqns_mqtt_cfg.sp_id > 0) {
+                    gsmi_send_number(GSM_U32(msg->msg.sqns_mqtt_cfg.sp_id), 0, 1);
+                }
+            }
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_SQNSMQTTCLIENTCONNECT: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+SQNSMQTTCONNECT=0");
+            gsmi_send_string(msg->msg.sqns_mqtt_connect.host, 1, 1, 1);
+            gsmi_send_port(msg->msg.sqns_mqtt_connect.port, 0, 1);
+            gsmi_send_number(GSM_U32(msg->msg.sqns_mqtt_connect.keep_alive), 0, 1);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_SQNSMQTTCLIENTDISCONNECT: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+SQNSMQTTDISCONNECT=0");
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_SQNSMQTTCLIENTSUBSCRIBE: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+SQNSMQTTSUBSCRIBE=0");
+            gsmi_send_string(msg->msg.sqns_mqtt_topic.topic, 1, 1, 1);
+            gsmi_send_number(GSM_U32(msg->msg.sqns_mqtt_topic.qos), 0, 1);
+            AT_PORT_SEND_END_AT();
+            break;
+        }
+        case GSM_CMD_SQNSMQTTCLIENTPUBLISH: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+SQNSMQTTPUBLISH=0");
+            gsmi_send_string(msg->msg.sqns_mqtt_topic.topic, 1, 1, 1);
+            gsmi_send_number(GSM_U32(msg->msg.sqns_mqtt_topic.qos), 0, 1);
+            gsmi_send_number(GSM_U32(msg->msg.sqns_mqtt_topic.len), 0, 1);
+            AT_PORT_SEND_CONST_STR("\r");     /* Payload follows "> " */
+            AT_PORT_SEND_FLUSH();
+            break;
+        }
+        case GSM_CMD_SQNSMQTTCLIENTRCVMESSAGE: {
+            AT_PORT_SEND_BEGIN_AT();
+            AT_PORT_SEND_CONST_STR("+SQNSMQTTRCVMESSAGE=0");
+            gsmi_send_string(msg->msg.sqns_mqtt_rcv.rx->topic, 1, 1, 1);
+            if (msg->msg.sqns_mqtt_rcv.rx->mid > 0) {
+                gsmi_send_number(msg->msg.sqns_mqtt_rcv.rx->mid, 0, 1);
+            }
+            AT_PORT_SEND_END_AT();
+            msg->msg.sqns_mqtt_rcv.read = 1;    /* Wait for empty line before payload */
+            msg->msg.sqns_mqtt_rcv.ptr = 0;
+            msg->msg.sqns_mqtt_rcv.err = 0;
+            break;
+        }
+#endif /* GSM_CFG_SQNS_MQTT */
 
 #endif /* GSM_SEQUANS_SPECIFIC_CMD */
         default:
@@ -2831,6 +3366,8 @@ gsmi_send_msg_to_producer_mbox(gsm_msg_t* msg, gsmr_t (*process_fn)(gsm_msg_t *)
  */
 void
 gsmi_process_events_for_timeout_or_error(gsm_msg_t* msg, gsmr_t err) {
+    gsm_timeout_remove(gsmi_ready_wait_timeout);    /* Stop pending readiness wait, if any */
+
     switch (msg->cmd_def) {
         case GSM_CMD_RESET: {
             /* Reset command error */
@@ -2844,6 +3381,15 @@ gsmi_process_events_for_timeout_or_error(gsm_msg_t* msg, gsmr_t err) {
             break;
         }
 
+        case GSM_CMD_IPR:
+        case GSM_CMD_UART: {
+            /* No answer at the new rate, go back to the previous one */
+            if (msg->msg.uart.prev_baudrate > 0) {
+                gsmi_set_local_baudrate(msg->msg.uart.prev_baudrate);
+            }
+            break;
+        }
+
         case GSM_CMD_COPS_GET_OPT: {
             /* Operator scan command error */
             OPERATOR_SCAN_SEND_EVT(msg, err);
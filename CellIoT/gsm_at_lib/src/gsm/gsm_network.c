@@ -156,6 +156,104 @@ gsm_network_rssi(int16_t* rssi,
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 120000);
 }
 
+/**
+ * \brief           Query EPS network registration status from device
+ *
+ * Result updates \ref gsm_network_get_reg_status and is reported with \ref GSM_EVT_NETWORK_REG_CHANGED event
+ *
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_network_update_reg_status(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_CEREG_GET;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Request power saving mode from network
+ *
+ * Network may grant different timers than requested
+ *
+ * \param[in]       enable: Set to `1` to request PSM, `0` to disable it
+ * \param[in]       tau: Periodic tracking area update period (T3412) in units of seconds
+ * \param[in]       active_time: Time device stays reachable after radio goes idle (T3324) in units of seconds
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_network_set_psm(uint8_t enable, uint32_t tau, uint32_t active_time,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_CPSMS_SET;
+    GSM_MSG_VAR_REF(msg).msg.psm.enable = enable;
+    GSM_MSG_VAR_REF(msg).msg.psm.tau = tau;
+    GSM_MSG_VAR_REF(msg).msg.psm.active_time = active_time;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Request extended discontinuous reception from network
+ * \param[in]       enable: Set to `1` to request eDRX, `0` to disable it
+ * \param[in]       act: Access technology type, `4` for LTE-M, `5` for NB-IoT
+ * \param[in]       cycle: 4-bit eDRX cycle value as in 3GPP TS 24.008, e.g. `5` for 81.92 seconds on LTE-M
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_network_set_edrx(uint8_t enable, uint8_t act, uint8_t cycle,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_CEDRXS_SET;
+    GSM_MSG_VAR_REF(msg).msg.edrx.enable = enable;
+    GSM_MSG_VAR_REF(msg).msg.edrx.act = act;
+    GSM_MSG_VAR_REF(msg).msg.edrx.cycle = cycle & 0x0F;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Enable radio connection state reports
+ *
+ * Changes are reported with \ref GSM_EVT_NETWORK_RADIO_CHANGED event
+ *
+ * \param[in]       enable: Set to `1` to enable reports, `0` to disable them
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_network_set_radio_report(uint8_t enable,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_CSCON_SET;
+    GSM_MSG_VAR_REF(msg).msg.cscon.enable = enable;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
 /**
  * \brief           Get network registration status
  * \return          Member of \ref gsm_network_reg_status_t enumeration
@@ -322,20 +322,39 @@ gsmi_parse_memories_string(const char** src, uint32_t* mem_dst) {
 }
 
 /**
- * \brief           Parse received +CREG message
+ * \brief           Parse received +CREG or +CEREG message
  * \param[in]       str: Input string
  * \return          1 on success, 0 otherwise
  */
 uint8_t
 gsmi_parse_creg(const char* str, uint8_t skip_first) {
+    gsm_network_reg_status_t status;
+    uint8_t is_eps = 0;
+
     if (*str == '+') {
-        str += 7;
+        is_eps = str[2] == 'E';                 /* +CEREG or +CREG */
+        str += is_eps ? 8 : 7;
     }
 
     if (skip_first) {
         gsmi_parse_number(&str);
     }
-    gsm.m.network.status = (gsm_network_reg_status_t)gsmi_parse_number(&str);
+    status = (gsm_network_reg_status_t)gsmi_parse_number(&str);
+    if (is_eps) {
+        gsm.m.network.eps_status = status;
+    } else {
+        gsm.m.network.cs_status = status;
+    }
+
+    /* LTE-only devices may keep CS domain unregistered, take whichever domain is registered */
+    if (gsm.m.network.eps_status == GSM_NETWORK_REG_STATUS_CONNECTED ||
+        gsm.m.network.eps_status == GSM_NETWORK_REG_STATUS_CONNECTED_ROAMING) {
+        status = gsm.m.network.eps_status;
+    } else if (gsm.m.network.cs_status == GSM_NETWORK_REG_STATUS_CONNECTED ||
+        gsm.m.network.cs_status == GSM_NETWORK_REG_STATUS_CONNECTED_ROAMING) {
+        status = gsm.m.network.cs_status;
+    }
+    gsm.m.network.status = status;
 
     /*
      * In case we are connected to network,
@@ -358,6 +377,35 @@ gsmi_parse_creg(const char* str, uint8_t skip_first) {
     return 1;
 }
 
+/**
+ * \brief           Parse received +CSCON signalling connection status
+ *
+ * Unsolicited code carries mode only, query response has `<n>,<mode>`
+ *
+ * \param[in]       str: Input string
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsmi_parse_cscon(const char* str) {
+    uint8_t connected;
+
+    if (*str == '+') {
+        str += 8;
+    }
+    connected = GSM_U8(gsmi_parse_number(&str));
+    if (*str == ',') {
+        connected = GSM_U8(gsmi_parse_number(&str));    /* Query response, second value is mode */
+    }
+    connected = connected ? 1 : 0;
+
+    if (gsm.m.network.rrc_connected != connected) {
+        gsm.m.network.rrc_connected = connected;
+        gsm.evt.evt.radio.connected = connected;
+        gsmi_send_cb(GSM_EVT_NETWORK_RADIO_CHANGED);
+    }
+    return 1;
+}
+
 /**
  * \brief           Parse received +CSQ signal value
  * \param[in]       str: Input string
@@ -1007,13 +1055,13 @@ gsmi_parse_ipd(const char* str) {
 uint8_t
 gsmi_parse_sqndnslkup(const char* str) {
 
-	if(gsm.m.conn_val_id > GSM_CFG_MAX_CONNS)
+	gsm_ip_t* ip = gsm.msg->msg.host_ip_config.ip;   /* Get IP data structure provided by the caller */
+
+	if(ip == NULL)
 	{
 		return 0;
 	}
 
-	gsm_ip_t* ip = &gsm.m.conns[gsm.m.conn_val_id].remote_ip;   /* Get IP data structure from connection handle */
-
     if (*str == '+') {
         str += 13;
     }
@@ -1024,6 +1072,45 @@ gsmi_parse_sqndnslkup(const char* str) {
     return 1;
 }
 
+/**
+ * \brief           Parse one line of +SQNSCFG, +SQNSCFGEXT or +SQNSPCFG read command
+ * \note            The module lists every ID, only the parameters of the requested one are kept,
+ *                  as the module formats them and without CRLF
+ * \param[in]       str: Input string
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsmi_parse_sqns_cfg_get(const char* str) {
+    char* params = gsm.msg->msg.cfg_get.params;
+    size_t len = 0;
+
+    if (params == NULL || gsm.msg->msg.cfg_get.params_len == 0) {
+        return 0;
+    }
+
+    str = strchr(str, ':');
+    if (str == NULL) {
+        return 0;
+    }
+    while (*str == ':' || *str == ' ') {        /* Skip ': ' */
+        str++;
+    }
+    if (gsmi_parse_number(&str) != gsm.msg->msg.cfg_get.id) {
+        return 0;                               /* Line of another ID */
+    }
+    if (*str == ',') {
+        str++;
+    }
+
+    while (*str != '\0' && *str != '\r' && *str != '\n' && len < gsm.msg->msg.cfg_get.params_len - 1) {
+        params[len++] = *str++;
+    }
+    params[len] = '\0';
+    gsm.msg->msg.cfg_get.found = 1;
+
+    return 1;
+}
+
 extern void
 gsmi_receive_raw(const char* str , uint8_t connid , uint32_t rx_size );
 /**
@@ -1037,19 +1124,22 @@ gsmi_parse_rcvdata_update(const char* str)
 	uint32_t conn_id, read_count;
 	char * ptx = (char *) str;
 
-	if(gsm.m.conn_val_id > GSM_CFG_MAX_CONNS)
-	{
-		return 0;
-	}
-
 	/* Jump directly to the number by skipping '+SQNSRING: ' */
 	ptx += 11;
 
 	conn_id = ( uint32_t ) gsmi_parse_number( (const char**) &ptx);
 	read_count = ( uint32_t ) gsmi_parse_number( (const char**) &ptx);
 
-	/* store pending data info */
-	if( (read_count << 1) > (AT_BUFFER_SIZE << 1) )
+	/* Ignore data announced for a connection no socket owns */
+	if( conn_id == 0 || conn_id > GSM_CFG_MAX_CONNS || !gsm.m.conns[conn_id - 1].status.f.reserved )
+	{
+		return 0;
+	}
+
+	/* store pending data info, a UDP datagram is always read at once
+	 * since the module discards what is not read of it
+	 */
+	if( ( gsm.m.conns[conn_id - 1].type != GSM_CONN_TYPE_UDP ) && ( (read_count << 1) > (AT_BUFFER_SIZE << 1) ) )
 	{
 		uint32_t bp = read_count;
 		uint32_t cid = conn_id;
@@ -1082,63 +1172,72 @@ gsmi_parse_rcvdata_ntf(const char* str, uint8_t *conn_id, uint32_t *bytes_pendin
 	uint32_t ret = 0;
 	char * ptx = (char *) str;
 
-	if(gsm.m.conn_val_id > GSM_CFG_MAX_CONNS)
-	{
-		return 0;
-	}
-
 	/* Jump directly to the number by skipping '+SQNSRECV: ' */
 	ptx += SQNSRECV_JUMP;
 
 	*conn_id = ( uint32_t ) gsmi_parse_number( (const char**) &ptx);
 	*bytes_pending = ( uint32_t ) gsmi_parse_number( (const char**) &ptx);
 
-	ret = 1;
-
-	gsm_ring_list_delete_elem(gsm.m.ring_list, 0);
+	/* The request was not necessarily sent for the first ring of the list,
+	 * remove the one of the connection the data belongs to
+	 */
+	gsm_ring_list_delete_conn_elem(gsm.m.ring_list, *conn_id, 0);
 	gsm.m.ring_list->is_at_sqnsrecv_ongoing = 0;
 
+	if( *conn_id == 0 || *conn_id > GSM_CFG_MAX_CONNS )
+	{
+		return 0;
+	}
+
+	ret = 1;
+
 	return ret;
 }
 
 
 /**
- * \brief           Parse +SQNSRING
+ * \brief           Parse +SQNSRING carrying its data
+ * \note            Called on each received character with the line received so far
  * \param[in]       str: Input string
- * \return          1 on success, 0 otherwise
+ * \return          Length of the URC up to the last character of its data,
+ *                  0 when the line is not such a URC (yet)
  */
 uint32_t
 gsmi_handle_recv_string(const char * str, uint8_t ring_recv )
 {
-//	uint8_t conn_id;
+	const char * ptr;
 	uint32_t read_count;
 
-	char * ptr = strstr("+SQNSRING:", str );
-
-	if( ptr != NULL )
+	if( strncmp( str, "+SQNSRING:", 10 ) != 0 )
 	{
-		ptr += 11;
-
-		/*conn_id = */( uint32_t ) gsmi_parse_number( (const char**) &ptr);
-		read_count = ( uint32_t ) gsmi_parse_number( (const char**) &ptr);
-		/* read_count = total nb of bytes from the URC to the last character of the received data
-		 * e.g +SQNSRING:1,10,0A0B0CFE123456789ABC
-		 */
-		read_count = ( ptr - str + 1 ) +  read_count * 2;
-		ring_recv = 1;
+		return 0;
 	}
-	else
+	ptr = str + 10;
+	if( *ptr == ' ' )
 	{
-		read_count = 0;
-		ring_recv = 0;
+		ptr++;
 	}
 
+	/*conn_id = */( void ) gsmi_parse_number( &ptr );
+	read_count = ( uint32_t ) gsmi_parse_number( &ptr );
 
-	return read_count;
+	/* Without a comma after the length the data is read with AT+SQNSRECV,
+	 * the line is parsed as usual.
+	 * read_count = total nb of bytes from the URC to the last character of the received data
+	 * e.g +SQNSRING:1,10,0A0B0CFE123456789ABC
+	 */
+	if( *ptr != ',' )
+	{
+		return 0;
+	}
+	( void ) ring_recv;
+	return ( uint32_t ) ( ptr - str + 1 ) + read_count * 2;
 }
 
 /**
  * \brief           Send AT+SQNSRECV when +SQNSRING has been received
+ * \note            The oldest ring of a connection which can take a buffer is served,
+ *                  so a socket not read by the Application does not block the others
  * \return          1 if Success, 0 otherwise
  */
 uint32_t
@@ -1147,7 +1246,12 @@ gsmi_send_sqnsrecv(void)
 	uint32_t status = 0;
 	st_RingElem *element = gsm.m.ring_list->first_ring;
 
-	if(sRXData[element->connid - 1][u8_nextFreeBufferPool].BytesPending == 0)
+	while( element != NULL && !CellIoT_lib_rxPoolCanAccept(element->connid) )
+	{
+		element = element->next_ring;
+	}
+
+	if( element != NULL )
 	{
 		AT_PORT_SEND_BEGIN_AT();
 		AT_PORT_SEND_CONST_STR("+SQNSRECV=");
@@ -1166,4 +1270,77 @@ gsmi_send_sqnsrecv(void)
 }
 
 
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+/**
+ * \brief           Parse +SQNSMQTTON URCs of module MQTT client and send event
+ *
+ * Announced messages are not reported here, they are read first
+ *
+ * \param[in]       str: Input string
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsmi_parse_sqnsmqtt(const char* str) {
+    static char topic[GSM_CFG_SQNS_MQTT_TOPIC_LEN];
+    gsm_evt_type_t type;
+    size_t len;
+    uint8_t qos;
+
+    if (!strncmp(str, "+SQNSMQTTONCONNECT", 18)) {
+        type = GSM_EVT_SQNS_MQTT_CONNECT;
+        str += 18;
+    } else if (!strncmp(str, "+SQNSMQTTONDISCONNECT", 21)) {
+        type = GSM_EVT_SQNS_MQTT_DISCONNECT;
+        str += 21;
+    } else if (!strncmp(str, "+SQNSMQTTONPUBLISH", 18)) {
+        type = GSM_EVT_SQNS_MQTT_PUBLISH;
+        str += 18;
+    } else if (!strncmp(str, "+SQNSMQTTONSUBSCRIBE", 20)) {
+        type = GSM_EVT_SQNS_MQTT_SUBSCRIBE;
+        str += 20;
+    } else if (!strncmp(str, "+SQNSMQTTONMESSAGE", 18)) {
+        type = GSM_EVT_SQNS_MQTT_MESSAGE;
+        str += 18;
+    } else {
+        return 0;
+    }
+
+    /* Skip ': ' and client ID */
+    while (*str == ':' || *str == ' ') {
+        str++;
+    }
+    gsmi_parse_number(&str);
+
+    GSM_MEMSET(&gsm.evt.evt.sqns_mqtt, 0x00, sizeof(gsm.evt.evt.sqns_mqtt));
+    if (str[0] == ',' && str[1] == '"') {
+        gsmi_parse_string(&str, topic, sizeof(topic), 1);
+        gsm.evt.evt.sqns_mqtt.topic = topic;
+    }
+
+    if (type == GSM_EVT_SQNS_MQTT_MESSAGE) {
+        len = GSM_SZ(gsmi_parse_number(&str));
+        qos = GSM_U8(gsmi_parse_number(&str));
+        gsm.evt.evt.sqns_mqtt.mid = *str == ',' ? GSM_U32(gsmi_parse_number(&str)) : 0;
+        if (gsm.evt.evt.sqns_mqtt.topic != NULL
+            && gsmi_sqns_mqtt_rx_start(topic, len, qos, gsm.evt.evt.sqns_mqtt.mid) == gsmOK) {
+            return 1;
+        }
+
+        /* Message cannot be read, let application know it is lost */
+        gsm.evt.evt.sqns_mqtt.res = gsmERRMEM;
+        gsm.evt.evt.sqns_mqtt.qos = qos;
+    } else {
+        if (type == GSM_EVT_SQNS_MQTT_PUBLISH) {
+            gsm.evt.evt.sqns_mqtt.mid = GSM_U32(gsmi_parse_number(&str));
+        }
+        gsm.evt.evt.sqns_mqtt.rc = *str == ',' ? gsmi_parse_number(&str) : 0;
+        gsm.evt.evt.sqns_mqtt.res = gsm.evt.evt.sqns_mqtt.rc == 0 ? gsmOK : gsmERR;
+        if (type == GSM_EVT_SQNS_MQTT_CONNECT && CMD_IS_CUR(GSM_CMD_SQNSMQTTCLIENTCONNECT)) {
+            gsm.msg->msg.sqns_mqtt_connect.rc = gsm.evt.evt.sqns_mqtt.rc;
+        }
+    }
+    gsmi_send_cb(type);
+    return 1;
+}
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
 #endif /* GSM_SEQUANS_SPECIFIC_CMD */
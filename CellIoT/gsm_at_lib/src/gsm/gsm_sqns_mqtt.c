@@ -0,0 +1,259 @@
+/**
+ * \file            gsm_sqns_mqtt.c
+ * \brief           MQTT client of Sequans module
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#include "gsm_private.h"
+#include "gsm_sqns_mqtt.h"
+#include "gsm_mem.h"
+
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+
+#if !GSM_CFG_USE_API_FUNC_EVT
+#error "GSM_CFG_USE_API_FUNC_EVT must be enabled for module MQTT client, it frees received messages"
+#endif /* !GSM_CFG_USE_API_FUNC_EVT */
+
+/**
+ * \brief           Configure MQTT client of the module
+ * \note            Module keeps the configuration until it is changed
+ * \param[in]       client_id: Client identifier
+ * \param[in]       user: User name. Set to `NULL` when not used
+ * \param[in]       pass: Password. Set to `NULL` when not used
+ * \param[in]       sp_id: Security profile identifier set up with `AT+SQNSPCFG`, `0` for plain TCP
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_sqns_mqtt_config(const char* client_id, const char* user, const char* pass, uint8_t sp_id,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("client_id != NULL && strlen(client_id) > 0", client_id != NULL && strlen(client_id) > 0);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SQNSMQTTCLIENTCFG;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_cfg.client_id = client_id;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_cfg.user = user;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_cfg.pass = pass;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_cfg.sp_id = sp_id;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Connect MQTT client of the module to broker
+ *
+ * Command finishes when the module reports connection result,
+ * \ref GSM_EVT_SQNS_MQTT_CONNECT event is sent as well
+ *
+ * \param[in]       host: Broker host name or IP address
+ * \param[in]       port: Broker port
+ * \param[in]       keep_alive: Keep-alive interval in units of seconds, pings are sent by the module
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_sqns_mqtt_connect(const char* host, gsm_port_t port, uint16_t keep_alive,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("host != NULL && strlen(host) > 0", host != NULL && strlen(host) > 0);
+    GSM_ASSERT("port > 0", port > 0);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SQNSMQTTCLIENTCONNECT;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_connect.host = host;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_connect.port = port;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_connect.keep_alive = keep_alive;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 60000);
+}
+
+/**
+ * \brief           Disconnect MQTT client of the module
+ * \note            \ref GSM_EVT_SQNS_MQTT_DISCONNECT event is sent when the module is disconnected
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_sqns_mqtt_disconnect(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SQNSMQTTCLIENTDISCONNECT;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Subscribe to topic
+ * \note            Broker result comes with \ref GSM_EVT_SQNS_MQTT_SUBSCRIBE event
+ * \param[in]       topic: Topic filter. It must be valid until command finishes when not blocking
+ * \param[in]       qos: Quality of service, `0` to `2`
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_sqns_mqtt_subscribe(const char* topic, uint8_t qos,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("topic != NULL && strlen(topic) > 0", topic != NULL && strlen(topic) > 0);
+    GSM_ASSERT("qos <= 2", qos <= 2);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SQNSMQTTCLIENTSUBSCRIBE;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_topic.topic = topic;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_topic.qos = qos;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Publish message
+ *
+ * Payload is sent as is, without hex encoding. Command finishes when the module
+ * accepted the message, delivery comes with \ref GSM_EVT_SQNS_MQTT_PUBLISH event
+ *
+ * \param[in]       topic: Topic to publish on
+ * \param[in]       qos: Quality of service, `0` to `2`
+ * \param[in]       data: Payload. Topic and payload must be valid until command finishes when not blocking
+ * \param[in]       len: Length of payload in units of bytes
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_sqns_mqtt_publish(const char* topic, uint8_t qos, const void* data, size_t len,
+                    const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking) {
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("topic != NULL && strlen(topic) > 0", topic != NULL && strlen(topic) > 0);
+    GSM_ASSERT("qos <= 2", qos <= 2);
+    GSM_ASSERT("data != NULL && len > 0", data != NULL && len > 0);
+
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SQNSMQTTCLIENTPUBLISH;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_topic.topic = topic;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_topic.qos = qos;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_topic.data = data;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_topic.len = len;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 30000);
+}
+
+/**
+ * \brief           Report message read by \ref gsmi_sqns_mqtt_rx_start and free it
+ * \note            Called from producer thread with core locked, also on timeout
+ * \param[in]       res: Read result
+ * \param[in]       arg: Message, \ref gsm_sqns_mqtt_rx_t
+ */
+static void
+gsmi_sqns_mqtt_rx_finish(gsmr_t res, void* arg) {
+    gsm_sqns_mqtt_rx_t* rx = arg;
+
+    if (res == gsmOK && rx->len < rx->tot_len) {
+        res = gsmERRMEM;                        /* Truncated, larger than GSM_CFG_SQNS_MQTT_MAX_LEN */
+    }
+    GSM_MEMSET(&gsm.evt.evt.sqns_mqtt, 0x00, sizeof(gsm.evt.evt.sqns_mqtt));
+    gsm.evt.evt.sqns_mqtt.res = res;
+    gsm.evt.evt.sqns_mqtt.topic = rx->topic;
+    gsm.evt.evt.sqns_mqtt.data = rx->data;
+    gsm.evt.evt.sqns_mqtt.len = rx->len;
+    gsm.evt.evt.sqns_mqtt.qos = rx->qos;
+    gsm.evt.evt.sqns_mqtt.mid = rx->mid;
+    gsmi_send_cb(GSM_EVT_SQNS_MQTT_MESSAGE);
+    gsm_mem_free(rx);
+}
+
+/**
+ * \brief           Read message announced with `+SQNSMQTTONMESSAGE`
+ *
+ * Topic is copied with the payload buffer, \ref GSM_EVT_SQNS_MQTT_MESSAGE event
+ * is sent once the read finishes, whatever its result
+ *
+ * \param[in]       topic: Message topic
+ * \param[in]       len: Payload length announced by the module
+ * \param[in]       qos: Quality of service
+ * \param[in]       mid: Message identifier, `0` when not given
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsmi_sqns_mqtt_rx_start(const char* topic, size_t len, uint8_t qos, uint32_t mid) {
+    GSM_MSG_VAR_DEFINE(msg);
+    gsm_sqns_mqtt_rx_t* rx;
+    size_t size;
+    gsmr_t res;
+
+    GSM_MSG_VAR_ALLOC(msg, 0);
+    size = GSM_MIN(len, GSM_CFG_SQNS_MQTT_MAX_LEN);
+    rx = gsm_mem_malloc(sizeof(*rx) + size + strlen(topic) + 1);
+    if (rx == NULL) {
+        GSM_MSG_VAR_FREE(msg);
+        return gsmERRMEM;
+    }
+    GSM_MEMSET(rx, 0x00, sizeof(*rx));
+    rx->mid = mid;
+    rx->qos = qos;
+    rx->tot_len = len;
+    rx->size = size;
+    rx->data = (uint8_t *)&rx[1];
+    rx->topic = (char *)&rx->data[size];
+    strcpy(rx->topic, topic);
+
+    GSM_MSG_VAR_REF(msg).evt_fn = gsmi_sqns_mqtt_rx_finish;
+    GSM_MSG_VAR_REF(msg).evt_arg = rx;
+    GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SQNSMQTTCLIENTRCVMESSAGE;
+    GSM_MSG_VAR_REF(msg).msg.sqns_mqtt_rcv.rx = rx;
+
+    res = gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+    if (res != gsmOK) {
+        gsm_mem_free(rx);                       /* Message was not queued, event function is not called */
+    }
+    return res;
+}
+
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
@@ -0,0 +1,323 @@
+/**
+ * \file            gsm_stats.c
+ * \brief           AT command latency and AT port counters
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#include "gsm_private.h"
+#include "gsm_stats.h"
+
+#if GSM_CFG_STATS || __DOXYGEN__
+
+static gsm_stats_cmd_t stats_cmds[GSM_CMD_END];
+static uint32_t stats_start_time;
+static uint32_t stats_busy_time;
+static uint32_t stats_tx_bytes, stats_rx_bytes, stats_urcs;
+
+/* Command in progress */
+static gsm_cmd_t stats_cur_cmd;
+static uint32_t stats_cur_start;
+
+static gsm_ll_send_fn stats_ll_send_fn;         /* Send function below statistics */
+
+/**
+ * \brief           Send function counting TX bytes
+ */
+static size_t
+stats_send(const void* data, size_t len) {
+    if (data != NULL) {
+        stats_tx_bytes += GSM_U32(len);
+    }
+    return stats_ll_send_fn(data, len);
+}
+
+/**
+ * \brief           Write little-endian value to blob
+ * \return          Number of bytes the value takes
+ */
+static size_t
+stats_put(uint8_t* buff, size_t len, size_t pos, uint32_t val, size_t size) {
+    for (size_t i = 0; i < size; i++, val >>= 8) {
+        if (buff != NULL && pos + i < len) {
+            buff[pos + i] = GSM_U8(val);
+        }
+    }
+    return size;
+}
+
+/**
+ * \brief           Reset all counters
+ */
+void
+gsm_stats_reset(void) {
+    gsm_core_lock();
+    GSM_MEMSET(stats_cmds, 0x00, sizeof(stats_cmds));
+    stats_start_time = gsm_sys_now();
+    stats_busy_time = 0;
+    stats_tx_bytes = 0;
+    stats_rx_bytes = 0;
+    stats_urcs = 0;
+    if (stats_cur_cmd != GSM_CMD_IDLE) {
+        stats_cur_start = stats_start_time;
+    }
+    gsm_core_unlock();
+}
+
+/**
+ * \brief           Get histogram bin for latency
+ * \param[in]       time: Latency in units of milliseconds
+ * \return          Bin index, `0` to `GSM_STATS_HIST_BINS - 1`
+ */
+uint8_t
+gsm_stats_hist_bin(uint32_t time) {
+    uint8_t bin = 0;
+
+    while (time >= 4 && bin < GSM_STATS_HIST_BINS - 1) {
+        time >>= 2;
+        bin++;
+    }
+    return bin;
+}
+
+/**
+ * \brief           Get statistics of one command
+ * \param[in]       cmd: Command to get statistics for
+ * \param[out]      stats: Pointer to output result
+ * \return          `1` if command was executed at least once, `0` otherwise
+ */
+uint8_t
+gsm_stats_get_cmd(gsm_cmd_t cmd, gsm_stats_cmd_t* stats) {
+    if (cmd >= GSM_CMD_END) {
+        return 0;
+    }
+    gsm_core_lock();
+    *stats = stats_cmds[cmd];
+    gsm_core_unlock();
+    return stats->count > 0 || stats->timeouts > 0;
+}
+
+/**
+ * \brief           Get AT port statistics
+ * \param[out]      stats: Pointer to output result
+ */
+void
+gsm_stats_get_link(gsm_stats_link_t* stats) {
+    uint32_t now, busy, line;
+
+    gsm_core_lock();
+    now = gsm_sys_now();
+    busy = stats_busy_time;
+    if (stats_cur_cmd != GSM_CMD_IDLE) {
+        busy += now - stats_cur_start;          /* Include command in progress */
+    }
+    stats->elapsed = now - stats_start_time;
+    stats->busy_time = busy;
+    stats->tx_bytes = stats_tx_bytes;
+    stats->rx_bytes = stats_rx_bytes;
+    stats->urcs = stats_urcs;
+    stats->busy_permille = 0;
+    stats->line_permille = 0;
+    if (stats->elapsed > 0) {
+        stats->busy_permille = GSM_U16(GSM_MIN(1000ULL * busy / stats->elapsed, 1000));
+        if (gsm.ll.uart.baudrate > 0) {
+            /* Bytes take 10 bits on the line, both directions share elapsed time */
+            line = GSM_U32(10000000ULL * (stats_tx_bytes + stats_rx_bytes) / gsm.ll.uart.baudrate / stats->elapsed);
+            stats->line_permille = GSM_U16(GSM_MIN(line, 1000));
+        }
+    }
+    gsm_core_unlock();
+}
+
+/**
+ * \brief           Export statistics as binary blob
+ *
+ * All values are little endian. Header is
+ * `'G'`, `'S'`, version, number of histogram bins, number of command entries (`16-bit`),
+ * followed by elapsed time, busy time, TX bytes, RX bytes and URCs (`32-bit` each).
+ * Each command entry is command ID (`16-bit`), count, sum (`32-bit`),
+ * min, max, errors, timeouts and histogram bins (`16-bit`).
+ * Only commands executed at least once have an entry.
+ *
+ * \param[out]      buff: Output buffer, may be `NULL` to get required size
+ * \param[in]       len: Size of output buffer in units of bytes
+ * \return          Size of complete blob, blob is truncated when larger than `len`
+ */
+size_t
+gsm_stats_export(void* buff, size_t len) {
+    uint8_t* b = buff;
+    gsm_stats_link_t link;
+    gsm_stats_cmd_t* c;
+    size_t pos = 0, entries = 0;
+
+    gsm_stats_get_link(&link);
+    gsm_core_lock();
+    for (size_t i = 0; i < GSM_CMD_END; i++) {
+        if (stats_cmds[i].count > 0 || stats_cmds[i].timeouts > 0) {
+            entries++;
+        }
+    }
+    pos += stats_put(b, len, pos, 'G', 1);
+    pos += stats_put(b, len, pos, 'S', 1);
+    pos += stats_put(b, len, pos, GSM_STATS_BLOB_VERSION, 1);
+    pos += stats_put(b, len, pos, GSM_STATS_HIST_BINS, 1);
+    pos += stats_put(b, len, pos, GSM_U32(entries), 2);
+    pos += stats_put(b, len, pos, link.elapsed, 4);
+    pos += stats_put(b, len, pos, link.busy_time, 4);
+    pos += stats_put(b, len, pos, link.tx_bytes, 4);
+    pos += stats_put(b, len, pos, link.rx_bytes, 4);
+    pos += stats_put(b, len, pos, link.urcs, 4);
+    for (size_t i = 0; i < GSM_CMD_END; i++) {
+        c = &stats_cmds[i];
+        if (c->count == 0 && c->timeouts == 0) {
+            continue;
+        }
+        pos += stats_put(b, len, pos, GSM_U32(i), 2);
+        pos += stats_put(b, len, pos, c->count, 4);
+        pos += stats_put(b, len, pos, c->sum, 4);
+        pos += stats_put(b, len, pos, c->min, 2);
+        pos += stats_put(b, len, pos, c->max, 2);
+        pos += stats_put(b, len, pos, c->errors, 2);
+        pos += stats_put(b, len, pos, c->timeouts, 2);
+        for (size_t k = 0; k < GSM_STATS_HIST_BINS; k++) {
+            pos += stats_put(b, len, pos, c->hist[k], 2);
+        }
+    }
+    gsm_core_unlock();
+    return pos;
+}
+
+/**
+ * \brief           Insert TX counter between the library and low-level send function
+ * \note            Called by library after low-level driver is initialized
+ * \param[in,out]   ll: Low-level structure with send function set
+ */
+void
+gsm_stats_attach(gsm_ll_t* ll) {
+    if (ll->send_fn != stats_send) {
+        stats_ll_send_fn = ll->send_fn;
+        ll->send_fn = stats_send;
+    }
+    if (stats_start_time == 0) {
+        stats_start_time = gsm_sys_now();
+    }
+}
+
+/**
+ * \brief           Command was sent to device
+ * \note            Must be called with core locked
+ * \param[in]       cmd: Command sent
+ */
+void
+gsm_stats_cmd_start(gsm_cmd_t cmd) {
+    uint32_t now = gsm_sys_now();
+
+    if (stats_cur_cmd != GSM_CMD_IDLE) {
+        stats_busy_time += now - stats_cur_start;   /* Retry of the same command */
+    }
+    stats_cur_cmd = cmd;
+    stats_cur_start = now;
+}
+
+/**
+ * \brief           Final response received for command
+ * \note            Must be called with core locked
+ * \param[in]       cmd: Command that finished
+ * \param[in]       is_error: `1` when finished with error
+ */
+void
+gsm_stats_cmd_end(gsm_cmd_t cmd, uint8_t is_error) {
+    gsm_stats_cmd_t* c;
+    uint32_t time;
+    uint16_t t16;
+    uint8_t bin;
+
+    if (cmd != stats_cur_cmd || cmd >= GSM_CMD_END) {
+        return;                                 /* Start was not seen */
+    }
+    time = gsm_sys_now() - stats_cur_start;
+    stats_busy_time += time;
+    stats_cur_cmd = GSM_CMD_IDLE;
+
+    c = &stats_cmds[cmd];
+    t16 = GSM_U16(GSM_MIN(time, 0xFFFF));
+    if (c->count == 0 || t16 < c->min) {
+        c->min = t16;
+    }
+    if (t16 > c->max) {
+        c->max = t16;
+    }
+    c->count++;
+    c->sum += time;
+    if (is_error && c->errors < 0xFFFF) {
+        c->errors++;
+    }
+    bin = gsm_stats_hist_bin(time);
+    if (c->hist[bin] < 0xFFFF) {
+        c->hist[bin]++;
+    }
+}
+
+/**
+ * \brief           Command did not finish in time
+ * \note            Must be called with core locked
+ * \param[in]       cmd: Command that timed out
+ */
+void
+gsm_stats_cmd_timeout(gsm_cmd_t cmd) {
+    if (cmd == stats_cur_cmd && cmd < GSM_CMD_END) {
+        stats_busy_time += gsm_sys_now() - stats_cur_start;
+        stats_cur_cmd = GSM_CMD_IDLE;
+        if (stats_cmds[cmd].timeouts < 0xFFFF) {
+            stats_cmds[cmd].timeouts++;
+        }
+    }
+}
+
+/**
+ * \brief           Bytes received from device
+ * \note            Must be called with core locked
+ * \param[in]       len: Number of bytes
+ */
+void
+gsm_stats_rx(size_t len) {
+    stats_rx_bytes += GSM_U32(len);
+}
+
+/**
+ * \brief           Unsolicited result code received
+ * \note            Must be called with core locked
+ */
+void
+gsm_stats_urc(void) {
+    stats_urcs++;
+}
+
+#endif /* GSM_CFG_STATS || __DOXYGEN__ */
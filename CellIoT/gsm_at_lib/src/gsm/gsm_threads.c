@@ -36,6 +36,7 @@
 #include "gsm_parser.h"
 #include "gsm_int.h"
 #include "gsm_timeout.h"
+#include "gsm_stats.h"
 #include "gsm.h"
 #include "gsm_mem.h"
 #include "gsm_sys.h"
@@ -116,6 +117,9 @@ gsm_thread_produce(void* const arg) {
 
             /* Notify application on command timeout */
             if (res == gsmTIMEOUT) {
+#if GSM_CFG_STATS
+                gsm_stats_cmd_timeout(msg->cmd);
+#endif /* GSM_CFG_STATS */
                 gsmi_send_cb(GSM_EVT_CMD_TIMEOUT);
             }
 
@@ -0,0 +1,211 @@
+/**
+ * \file            gsm_trace.c
+ * \brief           AT port transcript recorder
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#include "gsm_private.h"
+#include "gsm_trace.h"
+
+#if GSM_CFG_AT_TRACE || __DOXYGEN__
+
+static uint8_t trace_buff[GSM_CFG_AT_TRACE_BUFF_SIZE];
+static size_t trace_len;                        /* Bytes used in trace_buff */
+static size_t trace_tx_open;                    /* Offset of TX record not yet flushed, 0 when none */
+static uint32_t trace_start_time;
+static uint8_t trace_running;
+static uint8_t trace_overflow;
+static gsm_ll_send_fn trace_ll_send_fn;         /* Send function of low-level driver */
+
+/**
+ * \brief           Append data to transcript
+ * \note            Must be called with core locked
+ * \param[in]       dir: Record direction
+ * \param[in]       data: Data to append, `NULL` or `0` length closes open TX record
+ * \param[in]       len: Number of bytes
+ */
+static void
+trace_append(gsm_trace_dir_t dir, const void* data, size_t len) {
+    gsm_trace_rec_t rec;
+
+    if (data == NULL || len == 0) {
+        trace_tx_open = 0;                      /* Flush closes the TX record */
+        return;
+    }
+    if (!trace_running) {
+        return;
+    }
+
+    if (dir == GSM_TRACE_DIR_TX && trace_tx_open > 0) {
+        GSM_MEMCPY(&rec, &trace_buff[trace_tx_open - 1], sizeof(rec));
+        if (rec.len + len > 0xFFFF) {
+            trace_tx_open = 0;
+        }
+    } else {
+        trace_tx_open = 0;                      /* RX in between splits TX records */
+    }
+
+    if (trace_len + (trace_tx_open ? 0 : sizeof(rec)) + len > sizeof(trace_buff)) {
+        trace_running = 0;                      /* Keep consistent prefix of session */
+        trace_overflow = 1;
+        return;
+    }
+
+    if (trace_tx_open) {
+        rec.len += GSM_U16(len);
+        GSM_MEMCPY(&trace_buff[trace_tx_open - 1], &rec, sizeof(rec));
+    } else {
+        rec.time = gsm_sys_now() - trace_start_time;
+        rec.len = GSM_U16(len);
+        rec.dir = GSM_U8(dir);
+        rec.reserved = 0;
+        GSM_MEMCPY(&trace_buff[trace_len], &rec, sizeof(rec));
+        if (dir == GSM_TRACE_DIR_TX) {
+            trace_tx_open = trace_len + 1;
+        }
+        trace_len += sizeof(rec);
+    }
+    GSM_MEMCPY(&trace_buff[trace_len], data, len);
+    trace_len += len;
+}
+
+/**
+ * \brief           Low-level send function wrapper recording TX bytes
+ */
+static size_t
+trace_send(const void* data, size_t len) {
+    trace_append(GSM_TRACE_DIR_TX, data, len);
+    return trace_ll_send_fn(data, len);
+}
+
+/**
+ * \brief           Start new recording, previous transcript is discarded
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_trace_start(void) {
+    gsm_core_lock();
+    trace_len = 0;
+    trace_tx_open = 0;
+    trace_overflow = 0;
+    trace_start_time = gsm_sys_now();
+    trace_running = 1;
+    gsm_core_unlock();
+    return gsmOK;
+}
+
+/**
+ * \brief           Stop recording, transcript is kept
+ */
+void
+gsm_trace_stop(void) {
+    gsm_core_lock();
+    trace_running = 0;
+    gsm_core_unlock();
+}
+
+/**
+ * \brief           Get recorded transcript
+ * \note            Recording must be stopped before transcript is read
+ * \param[out]      data: Pointer to output transcript pointer
+ * \param[out]      len: Pointer to output transcript length in units of bytes
+ * \return          `1` if complete, `0` if recording stopped on full buffer
+ */
+uint8_t
+gsm_trace_get(const uint8_t** data, size_t* len) {
+    *data = trace_buff;
+    *len = trace_len;
+    return !trace_overflow;
+}
+
+/**
+ * \brief           Output recorded transcript as text lines
+ *
+ * Each record is output as `<time> <R|T> <hex data>` line, long records are split
+ * over several lines with the same time. Lines are meant to be captured from debug
+ * console and converted back to binary transcript for replay.
+ *
+ * \param[in]       out_fn: Function called for each line
+ */
+void
+gsm_trace_dump(gsm_trace_out_fn out_fn) {
+    static const char hex[] = "0123456789ABCDEF";
+    char line[24 + 2 * 32];
+    gsm_trace_rec_t rec;
+    size_t pos = 0, i, n, off;
+
+    while (pos + sizeof(rec) <= trace_len) {
+        GSM_MEMCPY(&rec, &trace_buff[pos], sizeof(rec));
+        pos += sizeof(rec);
+        for (off = 0; off < rec.len; off += n) {
+            n = GSM_MIN((size_t)(rec.len - off), (size_t)32);
+            i = sprintf(line, "%lu %c ", (unsigned long)rec.time, (char)rec.dir);
+            for (size_t k = 0; k < n; k++) {
+                line[i++] = hex[trace_buff[pos + off + k] >> 4];
+                line[i++] = hex[trace_buff[pos + off + k] & 0x0F];
+            }
+            line[i] = 0;
+            out_fn(line);
+        }
+        pos += rec.len;
+    }
+    if (trace_overflow) {
+        out_fn("# truncated");
+    }
+}
+
+/**
+ * \brief           Insert recorder between the library and low-level send function
+ * \note            Called by library after low-level driver is initialized
+ * \param[in,out]   ll: Low-level structure with send function set
+ */
+void
+gsm_trace_attach(gsm_ll_t* ll) {
+    if (ll->send_fn != trace_send) {
+        trace_ll_send_fn = ll->send_fn;
+        ll->send_fn = trace_send;
+    }
+}
+
+/**
+ * \brief           Record bytes received from device
+ * \note            Must be called with core locked
+ * \param[in]       data: Received data
+ * \param[in]       len: Number of bytes
+ */
+void
+gsm_trace_rx(const void* data, size_t len) {
+    if (data != NULL && len > 0) {
+        trace_append(GSM_TRACE_DIR_RX, data, len);
+    }
+}
+
+#endif /* GSM_CFG_AT_TRACE || __DOXYGEN__ */
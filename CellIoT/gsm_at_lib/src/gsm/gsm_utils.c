@@ -240,3 +240,54 @@ void gsm_ring_list_delete_elem(st_NewRingList *list, int8_t pos)
 		}
     }
 }
+
+/**
+ * \brief           Delete the ring elems of a connection
+ * \param[in]       list: list that keep trace of the '+SRQNSRING' received
+ * \param[in]       conn_id: connection id of the elems to delete
+ * \param[in]       all: `1` to delete every elem of the connection, `0` to delete the first one only
+ * \return          Number of bytes pending of the deleted elems
+ */
+uint32_t gsm_ring_list_delete_conn_elem(st_NewRingList *list, uint32_t conn_id, uint8_t all)
+{
+	st_RingElem *cur_elem, *prev_elem = NULL;
+	uint32_t bytes = 0;
+
+    if (list == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    cur_elem = list->first_ring;
+    while( cur_elem != NULL )
+    {
+    	if( cur_elem->connid == conn_id )
+    	{
+    		st_RingElem *del_elem = cur_elem;
+
+    		if (prev_elem != NULL)
+    		{
+    			prev_elem->next_ring = del_elem->next_ring;
+    		}
+    		else
+    		{
+    			list->first_ring = del_elem->next_ring;
+    		}
+    		cur_elem = del_elem->next_ring;
+    		bytes += del_elem->BytesPending;
+    		free(del_elem);
+
+    		if (!all)
+    		{
+    			break;
+    		}
+    	}
+    	else
+    	{
+    		prev_elem = cur_elem;
+    		cur_elem = cur_elem->next_ring;
+    	}
+    }
+
+    return bytes;
+}
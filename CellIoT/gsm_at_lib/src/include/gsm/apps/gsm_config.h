@@ -47,6 +47,8 @@
 #define GSM_CFG_AT_PORT_BAUDRATE_115200     115200U
 #define GSM_CFG_AT_PORT_BAUDRATE_921600     921600U
 #define GSM_CFG_AT_PORT_BAUDRATE			GSM_CFG_AT_PORT_BAUDRATE_115200
+#define GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE  1	/* Boot at 115200, then switch up to the shield rate */
+#define GSM_CFG_AT_PORT_BAUDRATE_MAX        GSM_CFG_AT_PORT_BAUDRATE_921600
 
 
 /* Enable network, conn and netconn APIs */
@@ -54,6 +56,9 @@
 #define GSM_CFG_CONN                        1
 #define GSM_CFG_NETCONN                     1
 
+/* MQTT client runs over the Sequans sockets */
+#define GSM_CFG_MQTT_SQNS_SOCKETS           1
+
 #define SERIAL_DEBUG						1
 
 /* After user configuration, call default config to merge config together */
@@ -11,6 +11,7 @@
 #include "gsm_typedefs.h"
 
 gsmr_t AT_Parser_Init(void);
+gsmr_t AT_Parser_WaitRegistered(uint32_t timeout_ms);
 gsmr_t gsm_callback_func(gsm_evt_t* evt);
 
 #endif /* GSM_AT_LIB_SRC_APPS_GSM_INIT_H_ */
@@ -90,6 +90,10 @@ typedef struct {
     const char* will_topic;                     /*!< Will topic */
     const char* will_message;                   /*!< Will message */
     gsm_mqtt_qos_t will_qos;                    /*!< Will topic quality of service */
+#if GSM_CFG_MQTT_SQNS_SOCKETS || __DOXYGEN__
+    uint8_t sec_profile;                        /*!< Module security profile ID (`1` to `6`) for TLS run by the module.
+                                                    Set to `0` for plain TCP. Profile must be provisioned before connect */
+#endif /* GSM_CFG_MQTT_SQNS_SOCKETS || __DOXYGEN__ */
 } gsm_mqtt_client_info_t;
 
 /**
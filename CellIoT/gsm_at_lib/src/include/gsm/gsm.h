@@ -53,6 +53,13 @@ gsmr_t      gsm_reset_with_delay(uint32_t delay, const gsm_api_cmd_evt_fn evt_fn
 
 gsmr_t      gsm_set_func_mode(uint8_t mode, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 
+gsmr_t      gsm_set_at_baudrate(uint32_t baudrate, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t      gsm_probe_at_baudrate(uint32_t baudrate, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+uint32_t    gsm_get_at_baudrate(void);
+#if GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE
+gsmr_t      gsm_negotiate_at_baudrate(uint32_t max_baudrate);
+#endif /* GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE */
+
 gsmr_t      gsm_core_lock(void);
 gsmr_t      gsm_core_unlock(void);
 
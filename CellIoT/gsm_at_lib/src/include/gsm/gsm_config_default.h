@@ -114,9 +114,10 @@
 /**
  * \brief           Maximal number of connections AT software can support on GSM device
  *
+ * Sequans modules provide connection IDs `1` to `6`, connection ID `n` is kept in `conns[n - 1]`
  */
 #ifndef GSM_CFG_MAX_CONNS
-#define GSM_CFG_MAX_CONNS                   1 /* 6 */
+#define GSM_CFG_MAX_CONNS                   6
 #endif
 
 /**
@@ -159,6 +160,38 @@
 #define GSM_CFG_AT_PORT_BAUDRATE            921600
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` AT port baudrate negotiation in \ref gsm_init
+ *
+ * Stack starts at \ref GSM_CFG_AT_PORT_BAUDRATE, finds the rate device answers at
+ * and switches both sides to the highest rate not above \ref GSM_CFG_AT_PORT_BAUDRATE_MAX
+ */
+#ifndef GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE
+#define GSM_CFG_AT_PORT_BAUDRATE_NEGOTIATE  0
+#endif
+
+/**
+ * \brief           Highest baudrate used by AT port negotiation
+ * \note            Host USART clock must be able to generate every rate up to this one
+ */
+#ifndef GSM_CFG_AT_PORT_BAUDRATE_MAX
+#define GSM_CFG_AT_PORT_BAUDRATE_MAX        GSM_CFG_AT_PORT_BAUDRATE
+#endif
+
+/**
+ * \brief           Delay in units of milliseconds after AT port baudrate change before link is probed
+ */
+#ifndef GSM_CFG_AT_PORT_BAUDRATE_SETTLE_DELAY
+#define GSM_CFG_AT_PORT_BAUDRATE_SETTLE_DELAY   20
+#endif
+
+/**
+ * \brief           Maximal time in units of milliseconds to wait for answer on AT port probe
+ */
+#ifndef GSM_CFG_AT_PORT_PROBE_TIMEOUT
+#define GSM_CFG_AT_PORT_PROBE_TIMEOUT       500
+#endif
+
 /**
  * \brief           Buffer size for received data waiting to be processed
  * \note            When server mode is active and a lot of connections are in queue
@@ -202,6 +235,45 @@
 #define GSM_CFG_RESET_DELAY_DEFAULT         1000
 #endif
 
+/**
+ * \brief           Time in units of milliseconds to wait for `+SYSSTART` after device restart
+ *
+ * When it does not come, device is probed with `AT` until it answers
+ */
+#ifndef GSM_CFG_RESET_SYSSTART_TIMEOUT
+#define GSM_CFG_RESET_SYSSTART_TIMEOUT      8000
+#endif
+
+/**
+ * \brief           Interval in units of milliseconds between `AT` probes after restart
+ */
+#ifndef GSM_CFG_RESET_PROBE_INTERVAL
+#define GSM_CFG_RESET_PROBE_INTERVAL        1000
+#endif
+
+/**
+ * \brief           Maximal number of `AT` probes after restart before reset fails
+ */
+#ifndef GSM_CFG_RESET_PROBE_MAX
+#define GSM_CFG_RESET_PROBE_MAX             20
+#endif
+
+/**
+ * \brief           Interval in units of milliseconds between SIM status polls after PIN entry
+ *
+ * Polling stops as soon as `+CPIN: READY` is received
+ */
+#ifndef GSM_CFG_SIM_READY_POLL_INTERVAL
+#define GSM_CFG_SIM_READY_POLL_INTERVAL     250
+#endif
+
+/**
+ * \brief           Maximal number of SIM status polls after PIN entry
+ */
+#ifndef GSM_CFG_SIM_READY_POLL_MAX
+#define GSM_CFG_SIM_READY_POLL_MAX          40
+#endif
+
 /**
  * \defgroup        GSM_CONFIG_DBG Debugging
  * \brief           Debugging configurations
@@ -394,6 +466,58 @@
 #define GSM_CFG_INPUT_USE_PROCESS           0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` recording of AT port transcript
+ *
+ * When enabled, TX and RX bytes are recorded with timestamps between
+ * \ref gsm_trace_start and \ref gsm_trace_stop calls
+ *
+ * \sa              GSM_CFG_AT_TRACE_BUFF_SIZE
+ */
+#ifndef GSM_CFG_AT_TRACE
+#define GSM_CFG_AT_TRACE                    0
+#endif
+
+/**
+ * \brief           Size of AT transcript buffer in units of bytes
+ *
+ * Recording stops when buffer is full, so transcript is always the beginning of the session
+ */
+#ifndef GSM_CFG_AT_TRACE_BUFF_SIZE
+#define GSM_CFG_AT_TRACE_BUFF_SIZE          0x2000
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` AT command statistics
+ *
+ * Latency histogram of every command and AT port counters, see \ref GSM_STATS.
+ * Counters only add a few operations per command and per received chunk,
+ * table of all commands takes `32` bytes per command of \ref gsm_cmd_t
+ */
+#ifndef GSM_CFG_STATS
+#define GSM_CFG_STATS                       0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` replay low-level backend
+ *
+ * When enabled and transcript is loaded with \ref gsm_ll_replay_start before \ref gsm_init,
+ * low-level driver feeds recorded RX bytes to the library instead of using the AT port
+ */
+#ifndef GSM_CFG_LL_REPLAY
+#define GSM_CFG_LL_REPLAY                   0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` simulated module low-level backend
+ *
+ * When enabled and simulation is started with \ref gsm_ll_sim_start before \ref gsm_init,
+ * low-level driver talks to an in-process Sequans module instead of the AT port
+ */
+#ifndef GSM_CFG_LL_SIM
+#define GSM_CFG_LL_SIM                      0
+#endif
+
 /**
  * \brief           Producer thread hook, called each time thread wakes-up and does the processing.
  *
@@ -488,6 +612,28 @@
 #define GSM_CFG_MQTT_MAX_REQUESTS           8
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` MQTT client over Sequans sockets
+ *
+ * When enabled, client uses `AT+SQNSD`, `AT+SQNSSENDEXT` and the data received
+ * with `AT+SQNSRECV` instead of connection API, optionally with TLS run by the module.
+ * \ref gsm_mqtt_client_connect is then blocking until TCP connection is established
+ *
+ * \note            \ref GSM_SEQUANS_SPECIFIC_CMD must be enabled
+ */
+#ifndef GSM_CFG_MQTT_SQNS_SOCKETS
+#define GSM_CFG_MQTT_SQNS_SOCKETS           0
+#endif
+
+/**
+ * \brief           Poll interval in units of milliseconds for MQTT client over Sequans sockets
+ *
+ * Received data is processed and keep-alive is checked on every poll
+ */
+#ifndef GSM_CFG_MQTT_SQNS_POLL_INTERVAL
+#define GSM_CFG_MQTT_SQNS_POLL_INTERVAL     100
+#endif
+
 /**
  * \brief           Set debug level for MQTT client module
  *
@@ -599,6 +745,34 @@
 #define GSM_CFG_USSD                        0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` MQTT client of Sequans module.
+ *
+ * MQTT framing, TLS and keep-alive run on the module with `AT+SQNSMQTT` commands,
+ * received messages are read automatically and reported with \ref GSM_EVT_SQNS_MQTT_MESSAGE event
+ *
+ * \note            \ref GSM_SEQUANS_SPECIFIC_CMD must be enabled
+ */
+#ifndef GSM_CFG_SQNS_MQTT
+#define GSM_CFG_SQNS_MQTT                   0
+#endif
+
+/**
+ * \brief           Maximal length of received MQTT message payload in units of bytes
+ *
+ * Longer messages are truncated and reported with \ref gsmERRMEM result
+ */
+#ifndef GSM_CFG_SQNS_MQTT_MAX_LEN
+#define GSM_CFG_SQNS_MQTT_MAX_LEN           1024
+#endif
+
+/**
+ * \brief           Maximal length of topic in MQTT module URCs, including `NULL` termination
+ */
+#ifndef GSM_CFG_SQNS_MQTT_TOPIC_LEN
+#define GSM_CFG_SQNS_MQTT_TOPIC_LEN         256
+#endif
+
 /**
  * \}
  */
@@ -47,6 +47,19 @@ extern "C" {
  * \{
  */
 
+/**
+ * \brief           Device identity as read during reset sequence
+ */
+typedef struct {
+    char manufacturer[20];                      /*!< Device manufacturer */
+    char model[20];                             /*!< Device model number */
+    char serial_number[20];                     /*!< Device serial number */
+    char revision[20];                          /*!< Device revision */
+} gsm_device_identity_t;
+
+gsmr_t      gsm_device_get_identity(gsm_device_identity_t* id);
+gsmr_t      gsm_device_set_identity(const gsm_device_identity_t* id);
+
 gsmr_t      gsm_device_get_manufacturer(char* manuf, size_t len, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t      gsm_device_get_model(char* model, size_t len, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t      gsm_device_get_revision(char* rev, size_t len, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
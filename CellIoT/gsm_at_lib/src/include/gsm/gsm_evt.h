@@ -178,6 +178,18 @@ void*               gsm_evt_conn_error_get_arg(gsm_evt_t* cc);
 
 int16_t gsm_evt_signal_strength_get_rssi(gsm_evt_t* cc);
 
+/**
+ * \}
+ */
+
+/**
+ * \anchor          GSM_EVT_NETWORK_RADIO_CHANGED
+ * \name            Radio state
+ * \brief           Event helper functions for \ref GSM_EVT_NETWORK_RADIO_CHANGED event
+ */
+
+uint8_t gsm_evt_network_radio_is_connected(gsm_evt_t* cc);
+
 /**
  * \}
  */
@@ -257,6 +269,25 @@ gsmr_t          gsm_evt_operator_scan_get_result(gsm_evt_t* cc);
 gsm_operator_t* gsm_evt_operator_scan_get_entries(gsm_evt_t* cc);
 size_t          gsm_evt_operator_scan_get_length(gsm_evt_t* cc);
 
+/**
+ * \}
+ */
+
+/**
+ * \anchor          GSM_EVT_SQNS_MQTT
+ * \name            Module MQTT client
+ * \brief           Event helper functions for \ref GSM_EVT_SQNS_MQTT_CONNECT, \ref GSM_EVT_SQNS_MQTT_DISCONNECT,
+ *                  \ref GSM_EVT_SQNS_MQTT_PUBLISH, \ref GSM_EVT_SQNS_MQTT_SUBSCRIBE and \ref GSM_EVT_SQNS_MQTT_MESSAGE events
+ */
+
+gsmr_t          gsm_evt_sqns_mqtt_get_result(gsm_evt_t* cc);
+int32_t         gsm_evt_sqns_mqtt_get_rc(gsm_evt_t* cc);
+const char*     gsm_evt_sqns_mqtt_get_topic(gsm_evt_t* cc);
+const uint8_t*  gsm_evt_sqns_mqtt_get_data(gsm_evt_t* cc);
+size_t          gsm_evt_sqns_mqtt_get_len(gsm_evt_t* cc);
+uint8_t         gsm_evt_sqns_mqtt_get_qos(gsm_evt_t* cc);
+uint32_t        gsm_evt_sqns_mqtt_get_mid(gsm_evt_t* cc);
+
 /**
  * \}
  */
@@ -73,6 +73,9 @@ extern "C" {
 #if GSM_SEQUANS_SPECIFIC_CMD || __DOXYGEN__
 #include "CellIoT_types.h"
 #endif /* GSM_SEQUANS_SPECIFIC_CMD || __DOXYGEN__ */
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+#include "gsm_sqns_mqtt.h"
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
 
 
 #ifdef __cplusplus
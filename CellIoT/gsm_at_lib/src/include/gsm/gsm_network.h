@@ -49,6 +49,10 @@ extern "C" {
 
 /* Basic commands, always available */
 gsmr_t      gsm_network_rssi(int16_t* rssi, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t      gsm_network_set_psm(uint8_t enable, uint32_t tau, uint32_t active_time, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t      gsm_network_set_edrx(uint8_t enable, uint8_t act, uint8_t cycle, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t      gsm_network_set_radio_report(uint8_t enable, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t      gsm_network_update_reg_status(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsm_network_reg_status_t    gsm_network_get_reg_status(void);
 
 /* TCP/IP related commands */
@@ -47,6 +47,7 @@ uint8_t     gsmi_parse_mac(const char** src, gsm_mac_t* mac);
 
 uint8_t     gsmi_parse_cpin(const char* str, uint8_t send_evt);
 uint8_t     gsmi_parse_creg(const char* str, uint8_t skip_first);
+uint8_t     gsmi_parse_cscon(const char* str);
 uint8_t     gsmi_parse_csq(const char* str);
 
 uint8_t     gsmi_parse_cmgs(const char* str, size_t* num);
@@ -66,10 +67,12 @@ uint8_t     gsmi_parse_cpbr(const char* str);
 uint8_t     gsmi_parse_cpbf(const char* str);
 
 uint8_t     gsmi_parse_sqndnslkup(const char* str);
+uint8_t     gsmi_parse_sqns_cfg_get(const char* str);
 uint8_t 	gsmi_parse_rcvdata_update(const char* str);
 uint8_t		gsmi_parse_rcvdata_ntf(const char* str, uint8_t *, uint32_t *);
 uint32_t    gsmi_handle_recv_string(const char * str, uint8_t ring_recv );
 uint32_t 	gsmi_send_sqnsrecv(void);
+uint8_t     gsmi_parse_sqnsmqtt(const char* str);
 
 uint8_t     gsmi_parse_cipstatus_conn(const char* str, uint8_t is_conn_line, uint8_t* continueScan);
 
@@ -58,11 +58,12 @@ typedef enum {
     /* Basic AT commands */
     GSM_CMD_RESET,                              /*!< Reset device */
     GSM_CMD_RESET_DEVICE_FIRST_CMD,             /*!< Reset device first driver specific command */
+    GSM_CMD_SYSSTART_WAIT,                      /*!< Wait for `+SYSSTART` after restart, nothing is sent */
     GSM_CMD_ATE0,                               /*!< Disable ECHO mode on AT commands */
     GSM_CMD_ATE1,                               /*!< Enable ECHO mode on AT commands */
     GSM_CMD_GSLP,                               /*!< Set GSM to sleep mode */
     GSM_CMD_RESTORE,                            /*!< Restore GSM internal settings to default values */
-    GSM_CMD_UART,
+    GSM_CMD_UART,                               /*!< Probe AT port at local baudrate, `AT` only */
 
     GSM_CMD_CGACT_SET_0,
     GSM_CMD_CGACT_SET_1,
@@ -163,6 +164,7 @@ typedef enum {
     GSM_CMD_SIM_PROCESS_BASIC_CMDS,             /*!< Command setup, executed when SIM is in READY state */
     GSM_CMD_CPIN_SET,                           /*!< Enter PIN */
     GSM_CMD_CPIN_GET,                           /*!< Read current SIM status */
+    GSM_CMD_CPIN_WAIT,                          /*!< Wait for SIM ready after PIN entry, nothing is sent */
     GSM_CMD_CPIN_ADD,                           /*!< Add new PIN to SIM if pin is not set */
     GSM_CMD_CPIN_CHANGE,                        /*!< Change already active SIM */
     GSM_CMD_CPIN_REMOVE,                        /*!< Remove current PIN */
@@ -173,6 +175,11 @@ typedef enum {
     GSM_CMD_CFUN_GET,                           /*!< Get Phone Functionality */
     GSM_CMD_CREG_SET,                           /*!< Network Registration set output */
     GSM_CMD_CREG_GET,                           /*!< Get current network registration status */
+    GSM_CMD_CEREG_SET,                          /*!< EPS network registration set output */
+    GSM_CMD_CEREG_GET,                          /*!< Get current EPS network registration status */
+    GSM_CMD_CPSMS_SET,                          /*!< Power saving mode setting */
+    GSM_CMD_CEDRXS_SET,                         /*!< eDRX setting */
+    GSM_CMD_CSCON_SET,                          /*!< Signalling connection status reporting */
     GSM_CMD_CBC,                                /*!< Battery Charge */
     GSM_CMD_CNUM,                               /*!< Subscriber Number */
 
@@ -258,12 +265,12 @@ typedef enum {
 #if GSM_SEQUANS_SPECIFIC_CMD
 	GSM_CMD_SQNSNVW_W,							/*!< Write data in NVM */
 	GSM_CMD_SQNSNVW_R,							/*!< Read data in NVM */
-	GSM_CMD_SQNSMQTTCLIENTCFG,
-	GSM_CMD_SQNSMQTTCLIENTCONNECT,
-	GSM_CMD_SQNSMQTTCLIENTSUBSCRIBE,
-	GSM_CMD_SQNSMQTTCLIENTPUBLISH,
-	GSM_CMD_SQNSMQTTCLIENTRCVMESSAGE,
-	GSM_CMD_SQNSMQTTCLIENTDISCONNECT,
+	GSM_CMD_SQNSMQTTCLIENTCFG,					/*!< Configure module MQTT client identity and security profile */
+	GSM_CMD_SQNSMQTTCLIENTCONNECT,				/*!< Connect module MQTT client, finished by +SQNSMQTTONCONNECT */
+	GSM_CMD_SQNSMQTTCLIENTSUBSCRIBE,			/*!< Subscribe to topic */
+	GSM_CMD_SQNSMQTTCLIENTPUBLISH,				/*!< Publish message, payload is sent after "> " */
+	GSM_CMD_SQNSMQTTCLIENTRCVMESSAGE,			/*!< Read message announced by +SQNSMQTTONMESSAGE */
+	GSM_CMD_SQNSMQTTCLIENTDISCONNECT,			/*!< Disconnect module MQTT client */
 	GSM_CMD_SQNDNSLKUP,							/*!< Query to DNS server to resolve the host name into an IP address */
 	GSM_CMD_SQNSD,								/*!< Opens a remote connection via socket */
 	GSM_CMD_SQNSSEND,
@@ -273,6 +280,9 @@ typedef enum {
 	GSM_CMD_SQNSPCFG,							/*!< Sets the security profile parameters required to configure the following SSL/TLS connections properties */
 	GSM_CMD_SQNSCFG,							/*!< Sets the socket configuration parameters */
 	GSM_CMD_SQNSCFGEXT,							/*!< Sets the socket configuration extended parameters */
+	GSM_CMD_SQNSPCFG_GET,						/*!< Reads back the security profile parameters */
+	GSM_CMD_SQNSCFG_GET,						/*!< Reads back the socket configuration parameters */
+	GSM_CMD_SQNSCFGEXT_GET,						/*!< Reads back the socket configuration extended parameters */
 	GSM_CMD_SQNSH,
 	GSM_CMD_SQNSLG,
 	GSM_CMD_SQNPLG,
@@ -316,6 +326,7 @@ typedef struct gsm_conn {
             uint8_t in_closing:1;               /*!< Status if connection is in closing mode.
                                                     When in closing mode, ignore any possible received data from function */
             uint8_t bearer:1;                   /*!< Bearer used. Can be `1` or `0` */
+            uint8_t reserved:1;                 /*!< Connection ID is allocated to a socket, see \ref CellIoT_lib_socketAlloc */
         } f;                                    /*!< Connection flags */
     } status;                                   /*!< Connection status union with flag bits */
 } gsm_conn_t;
@@ -348,6 +359,21 @@ typedef struct {
     gsm_pbuf_p          buff;                   /*!< Pointer to data buffer used for receiving data */
 } gsm_ipd_t;
 
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+/**
+ * \brief           Message announced by module MQTT client, allocated with its payload and topic
+ */
+typedef struct {
+    uint32_t            mid;                    /*!< Message identifier */
+    uint8_t             qos;                    /*!< Quality of service */
+    size_t              tot_len;                /*!< Payload length announced by the module */
+    size_t              len;                    /*!< Payload bytes stored */
+    size_t              size;                   /*!< Size of payload buffer */
+    uint8_t*            data;                   /*!< Payload buffer, follows the structure */
+    char*               topic;                  /*!< Topic, follows the payload buffer */
+} gsm_sqns_mqtt_rx_t;
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
+
 /**
  * \brief           Connection result on connect command
  */
@@ -379,17 +405,35 @@ typedef struct gsm_msg {
     union {
         struct {
             uint32_t delay;                     /*!< Delay to use before sending first reset AT command */
+            uint8_t probes;                     /*!< Number of `AT` probes sent while waiting for device */
+            char serial_number[20];             /*!< Known serial number, verified against device */
         } reset;                                /*!< Reset device */
         struct {
             uint32_t baudrate;                  /*!< Baudrate for AT port */
+            uint32_t prev_baudrate;             /*!< Local baudrate to restore if switchover fails */
         } uart;                                 /*!< UART configuration */
 
         struct {
             uint8_t mode;                       /*!< Functionality mode */
         } cfun;                                 /*!< Set phone functionality */
+        struct {
+            uint8_t enable;                     /*!< Set to `1` to request PSM */
+            uint32_t tau;                       /*!< Requested periodic TAU (T3412) in units of seconds */
+            uint32_t active_time;               /*!< Requested active time (T3324) in units of seconds */
+        } psm;                                  /*!< Power saving mode */
+        struct {
+            uint8_t enable;                     /*!< Set to `1` to request eDRX */
+            uint8_t act;                        /*!< Access technology type, `4` for LTE-M, `5` for NB-IoT */
+            uint8_t cycle;                      /*!< 4-bit eDRX cycle value as in 3GPP TS 24.008 */
+        } edrx;                                 /*!< Extended discontinuous reception */
+        struct {
+            uint8_t enable;                     /*!< Set to `1` to enable `+CSCON` reports */
+        } cscon;                                /*!< Signalling connection status reporting */
 
         struct {
             const char* pin;                    /*!< Pin code to write */
+            uint8_t pin_sent;                   /*!< Set to `1` once PIN was accepted */
+            uint8_t polls;                      /*!< Number of SIM status polls after PIN entry */
         } cpin_enter;                           /*!< Enter pin code */
         struct {
             const char* pin;                    /*!< New pin code */
@@ -562,12 +606,13 @@ typedef struct gsm_msg {
 			uint16_t rHostPort;					/*!< Remote host port contact */
 			const char* ip;						/*!< IP Address of the remote host port */
 			uint8_t closureType;				/*!< Socket closure behavior for TCP socket */
-			uint8_t lPort;						/*!< UDP socket local connection port */
+			uint16_t lPort;						/*!< UDP socket local connection port */
 			uint8_t connMode;					/*!< Connection mode */
 			uint8_t acceptAnyRemote;			/*!< Determines whether receive datagrams from any another remote than <IPaddr>:<rPort> or not */
 		} socket_dial;                    		/*!< Opens a remote connection via socket */
 		struct {
 			const char* hostName;               /*!< Host name to specify to get the IP address from */
+			gsm_ip_t* ip;						/*!< Resolved IP address of the host */
 		} host_ip_config;                    	/*!< Settings to configure the Host name to IP address */
 
 		struct {
@@ -613,6 +658,12 @@ typedef struct gsm_msg {
 			uint16_t connTo;					/*!< Listen auto-response mode”, that affects AT+SQNSL command */
 			uint8_t txTo;						/*!< Sent data view mode presentation format */
 		} socket_cfg;							/*!< sets the socket configuration extended parameters */
+		struct {
+			uint8_t id;							/*!< Connection or security profile ID to read back */
+			char* params;						/*!< Parameters following the ID, as listed by the module */
+			size_t params_len;					/*!< Length of params buffer including the null terminator */
+			uint8_t found;						/*!< Set to `1` when the module listed the ID */
+		} cfg_get;								/*!< Reads back the settings of one ID with AT+SQNSCFG?, AT+SQNSCFGEXT? or AT+SQNSPCFG? */
 		struct {
 			const char* ctm;               		/*!< Conformance Test Mode */
 		} set_conformance_test;
@@ -624,6 +675,32 @@ typedef struct gsm_msg {
 		struct {
 			uint8_t id;
 		} set_ati;
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+		struct {
+			const char* client_id;				/*!< Client identifier */
+			const char* user;					/*!< User name, `NULL` when not used */
+			const char* pass;					/*!< Password, `NULL` when not used */
+			uint8_t sp_id;						/*!< Security profile identifier, `0` for plain TCP */
+		} sqns_mqtt_cfg;						/*!< Configure module MQTT client */
+		struct {
+			const char* host;					/*!< Broker host name or IP address */
+			gsm_port_t port;					/*!< Broker port */
+			uint16_t keep_alive;				/*!< Keep-alive interval in units of seconds */
+			int32_t rc;							/*!< Result code of +SQNSMQTTONCONNECT */
+		} sqns_mqtt_connect;					/*!< Connect module MQTT client */
+		struct {
+			const char* topic;					/*!< Topic to subscribe to or publish on */
+			const void* data;					/*!< Payload to publish */
+			size_t len;							/*!< Length of payload in units of bytes */
+			uint8_t qos;						/*!< Quality of service */
+		} sqns_mqtt_topic;						/*!< Subscribe or publish */
+		struct {
+			gsm_sqns_mqtt_rx_t* rx;				/*!< Message to read, freed once reported */
+			size_t ptr;							/*!< Payload bytes read so far */
+			uint8_t read;						/*!< `1` before payload, `2` while reading it */
+			uint8_t err;						/*!< Characters of `ERROR` response matched instead of payload */
+		} sqns_mqtt_rcv;						/*!< Read received message */
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
 
 #endif /* GSM_SEQUANS_SPECIFIC_CMD || __DOXYGEN__ */
     } msg;                                      /*!< Group of different possible message contents */
@@ -715,7 +792,10 @@ typedef struct {
  * \brief           Network info
  */
 typedef struct {
-    gsm_network_reg_status_t status;            /*!< Network registration status */
+    gsm_network_reg_status_t status;            /*!< Network registration status, EPS preferred when registered */
+    gsm_network_reg_status_t cs_status;         /*!< Last `+CREG` status */
+    gsm_network_reg_status_t eps_status;        /*!< Last `+CEREG` status */
+    uint8_t rrc_connected;                      /*!< Set to `1` while radio signalling connection is active, from `+CSCON` */
     gsm_operator_curr_t curr_operator;          /*!< Current operator information */
 
     uint8_t is_attached;                        /*!< Flag indicating device is attached and PDP context is active */
@@ -744,7 +824,6 @@ typedef struct {
 
     gsm_conn_t          conns[GSM_CFG_MAX_CONNS];   /*!< Array of all connection structures */
     gsm_ipd_t           ipd;                    /*!< Connection incoming data structure */
-    uint8_t             conn_val_id;            /*!< Validation ID increased each time device connects to network */
 #endif /* GSM_CFG_CONNS || __DOXYGEN__ */
 #if GSM_CFG_SMS || __DOXYGEN__
     gsm_sms_t           sms;                    /*!< SMS information */
@@ -903,6 +982,10 @@ gsmr_t      gsmi_get_sim_info(const uint32_t blocking);
 void        gsmi_reset_everything(uint8_t forced);
 void        gsmi_process_events_for_timeout_or_error(gsm_msg_t* msg, gsmr_t err);
 
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+gsmr_t      gsmi_sqns_mqtt_rx_start(const char* topic, size_t len, uint8_t qos, uint32_t mid);
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
+
 /**
  * \}
  */
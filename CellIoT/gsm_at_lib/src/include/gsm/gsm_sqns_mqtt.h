@@ -0,0 +1,77 @@
+/**
+ * \file            gsm_sqns_mqtt.h
+ * \brief           MQTT client of Sequans module
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#ifndef GSM_HDR_SQNS_MQTT_H
+#define GSM_HDR_SQNS_MQTT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gsm.h"
+
+/**
+ * \ingroup         GSM
+ * \defgroup        GSM_SQNS_MQTT Module MQTT client
+ * \brief           MQTT client running on Sequans module
+ *
+ * MQTT framing, TLS and keep-alive are handled by the module, the library only
+ * sends `AT+SQNSMQTT` commands. Results arrive asynchronously with
+ * \ref GSM_EVT_SQNS_MQTT_CONNECT, \ref GSM_EVT_SQNS_MQTT_PUBLISH and \ref GSM_EVT_SQNS_MQTT_SUBSCRIBE events.
+ * Messages announced by the module are read automatically and reported
+ * with \ref GSM_EVT_SQNS_MQTT_MESSAGE event, payload is valid only during the event.
+ *
+ * TLS uses a security profile set up beforehand with `AT+SQNSPCFG`.
+ * \{
+ */
+
+gsmr_t  gsm_sqns_mqtt_config(const char* client_id, const char* user, const char* pass, uint8_t sp_id,
+                            const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t  gsm_sqns_mqtt_connect(const char* host, gsm_port_t port, uint16_t keep_alive,
+                            const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t  gsm_sqns_mqtt_disconnect(const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t  gsm_sqns_mqtt_subscribe(const char* topic, uint8_t qos,
+                            const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t  gsm_sqns_mqtt_publish(const char* topic, uint8_t qos, const void* data, size_t len,
+                            const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GSM_HDR_SQNS_MQTT_H */
@@ -0,0 +1,105 @@
+/**
+ * \file            gsm_stats.h
+ * \brief           AT command latency and AT port counters
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#ifndef GSM_HDR_STATS_H
+#define GSM_HDR_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gsm_private.h"
+
+/**
+ * \ingroup         GSM
+ * \defgroup        GSM_STATS AT statistics
+ * \brief           Latency of AT commands and AT port utilisation
+ *
+ * Each command is timed from the moment it is sent until its final `OK` or `ERROR`.
+ * Latencies go to a log-scale histogram, bin `i` counts latencies
+ * in range `[4^i, 4^(i + 1))` milliseconds, first bin starts at `0` and last bin is open ended.
+ * \{
+ */
+
+#define GSM_STATS_HIST_BINS             8       /*!< Number of histogram bins */
+#define GSM_STATS_BLOB_VERSION          1       /*!< Version of \ref gsm_stats_export format */
+
+/**
+ * \brief           Statistics of one command
+ */
+typedef struct {
+    uint32_t count;                             /*!< Number of completed commands, with `OK` or `ERROR` */
+    uint32_t sum;                               /*!< Sum of latencies in units of milliseconds */
+    uint16_t min;                               /*!< Lowest latency in units of milliseconds, saturated */
+    uint16_t max;                               /*!< Highest latency in units of milliseconds, saturated */
+    uint16_t errors;                            /*!< Number of commands finished with error */
+    uint16_t timeouts;                          /*!< Number of commands without final response */
+    uint16_t hist[GSM_STATS_HIST_BINS];         /*!< Latency histogram, saturated */
+} gsm_stats_cmd_t;
+
+/**
+ * \brief           AT port statistics
+ */
+typedef struct {
+    uint32_t elapsed;                           /*!< Time since statistics were reset in units of milliseconds */
+    uint32_t busy_time;                         /*!< Time a command was in progress in units of milliseconds */
+    uint32_t tx_bytes;                          /*!< Bytes sent to device */
+    uint32_t rx_bytes;                          /*!< Bytes received from device */
+    uint32_t urcs;                              /*!< Unsolicited result codes received */
+    uint16_t busy_permille;                     /*!< Share of time a command was in progress */
+    uint16_t line_permille;                     /*!< Share of AT port line rate used by TX and RX bytes */
+} gsm_stats_link_t;
+
+void        gsm_stats_reset(void);
+uint8_t     gsm_stats_get_cmd(gsm_cmd_t cmd, gsm_stats_cmd_t* stats);
+void        gsm_stats_get_link(gsm_stats_link_t* stats);
+size_t      gsm_stats_export(void* buff, size_t len);
+uint8_t     gsm_stats_hist_bin(uint32_t time);
+
+void        gsm_stats_attach(gsm_ll_t* ll);
+void        gsm_stats_cmd_start(gsm_cmd_t cmd);
+void        gsm_stats_cmd_end(gsm_cmd_t cmd, uint8_t is_error);
+void        gsm_stats_cmd_timeout(gsm_cmd_t cmd);
+void        gsm_stats_rx(size_t len);
+void        gsm_stats_urc(void);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GSM_HDR_STATS_H */
@@ -0,0 +1,96 @@
+/**
+ * \file            gsm_trace.h
+ * \brief           AT port transcript recorder
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#ifndef GSM_HDR_TRACE_H
+#define GSM_HDR_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "gsm.h"
+
+/**
+ * \ingroup         GSM
+ * \defgroup        GSM_TRACE AT transcript
+ * \brief           Record timestamped AT port traffic
+ *
+ * Transcript is a sequence of records, each made of \ref gsm_trace_rec_t header
+ * followed by `len` data bytes. TX bytes are merged in one record until the
+ * low-level driver is flushed, RX bytes keep the chunk boundaries of the driver.
+ * Same format is accepted by replay low-level backend, see \ref GSM_LL_REPLAY.
+ * \{
+ */
+
+/**
+ * \brief           Direction of transcript record
+ */
+typedef enum {
+    GSM_TRACE_DIR_RX = 'R',                     /*!< Bytes received from device */
+    GSM_TRACE_DIR_TX = 'T',                     /*!< Bytes sent to device */
+} gsm_trace_dir_t;
+
+/**
+ * \brief           Transcript record header, stored unaligned
+ */
+typedef struct {
+    uint32_t time;                              /*!< Time since recording started in units of milliseconds */
+    uint16_t len;                               /*!< Number of data bytes following the header */
+    uint8_t dir;                                /*!< Member of \ref gsm_trace_dir_t enumeration */
+    uint8_t reserved;
+} gsm_trace_rec_t;
+
+/**
+ * \brief           Callback to output one line of transcript dump
+ * \param[in]       line: Null-terminated line, without line ending
+ */
+typedef void (*gsm_trace_out_fn)(const char* line);
+
+gsmr_t      gsm_trace_start(void);
+void        gsm_trace_stop(void);
+uint8_t     gsm_trace_get(const uint8_t** data, size_t* len);
+void        gsm_trace_dump(gsm_trace_out_fn out_fn);
+
+void        gsm_trace_attach(gsm_ll_t* ll);
+void        gsm_trace_rx(const void* data, size_t len);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GSM_HDR_TRACE_H */
@@ -42,6 +42,7 @@ extern "C" {
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include "gsm_config.h"                         /* Feature options shape the types below */
 
 /**
  * \ingroup         GSM
@@ -390,6 +391,7 @@ typedef enum gsm_cb_type_t {
 
     GSM_EVT_NETWORK_OPERATOR_CURRENT,           /*!< Current operator event */
     GSM_EVT_NETWORK_REG_CHANGED,                /*!< Network registration changed. Available even when \ref GSM_CFG_NETWORK is disabled */
+    GSM_EVT_NETWORK_RADIO_CHANGED,              /*!< Radio signalling connection established or released, `+CSCON` received */
 #if GSM_CFG_NETWORK || __DOXYGEN__
     GSM_EVT_NETWORK_ATTACHED,                   /*!< Attached to network, PDP context active and ready for TCP/IP application */
     GSM_EVT_NETWORK_DETACHED,                   /*!< Detached from network, PDP context not active anymore */
@@ -426,6 +428,13 @@ typedef enum gsm_cb_type_t {
     GSM_EVT_PB_LIST,                            /*!< Phonebook list event */
     GSM_EVT_PB_SEARCH,                          /*!< Phonebook search event */
 #endif /* GSM_CFG_PHONEBOOK || __DOXYGEN__ */
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+    GSM_EVT_SQNS_MQTT_CONNECT,                  /*!< Module MQTT client connect result */
+    GSM_EVT_SQNS_MQTT_DISCONNECT,               /*!< Module MQTT client disconnected, on request or by the broker */
+    GSM_EVT_SQNS_MQTT_PUBLISH,                  /*!< Module MQTT client publish result */
+    GSM_EVT_SQNS_MQTT_SUBSCRIBE,                /*!< Module MQTT client subscribe result */
+    GSM_EVT_SQNS_MQTT_MESSAGE,                  /*!< Module MQTT client message received and read */
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
 } gsm_evt_type_t;
 
 /**
@@ -457,6 +466,9 @@ typedef struct gsm_evt {
         struct {
             int16_t rssi;                       /*!< Strength in units of dBm */
         } rssi;                                 /*!< Signal strength event. Use with \ref GSM_EVT_SIGNAL_STRENGTH event */
+        struct {
+            uint8_t connected;                  /*!< Set to `1` when radio is connected, `0` when idle */
+        } radio;                                /*!< Radio state event. Use with \ref GSM_EVT_NETWORK_RADIO_CHANGED event */
 
 #if GSM_CFG_CONN || __DOXYGEN__
         struct {
@@ -540,6 +552,18 @@ typedef struct gsm_evt {
             gsmr_t res;                         /*!< Operation success */
         } pb_search;                            /*!< Phonebok search list. Use with \ref GSM_EVT_PB_SEARCH event */
 #endif /* GSM_CFG_PHONEBOOK || __DOXYGEN__ */
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+        struct {
+            gsmr_t res;                         /*!< Operation result */
+            int32_t rc;                         /*!< Result code reported by the module, `0` on success */
+            const char* topic;                  /*!< Topic for subscribe and message events */
+            const uint8_t* data;                /*!< Message payload */
+            size_t len;                         /*!< Length of message payload in units of bytes */
+            uint8_t qos;                        /*!< Quality of service of message */
+            uint32_t mid;                       /*!< Message identifier for publish and message events */
+        } sqns_mqtt;                            /*!< Module MQTT client. Use with \ref GSM_EVT_SQNS_MQTT_CONNECT, \ref GSM_EVT_SQNS_MQTT_DISCONNECT,
+                                                    \ref GSM_EVT_SQNS_MQTT_PUBLISH, \ref GSM_EVT_SQNS_MQTT_SUBSCRIBE or \ref GSM_EVT_SQNS_MQTT_MESSAGE events */
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
     } evt;                                      /*!< Callback event union */
 } gsm_evt_t;
 
@@ -258,6 +258,7 @@ char *      		gsm_i32_to_gen_str(int32_t num, char* out);
 st_NewRingList * 	gsm_ring_list_init(void);
 void 				gsm_ring_list_insert_elem(st_NewRingList *list, uint32_t byte_pending, uint32_t conn_id, int8_t pos);
 void 				gsm_ring_list_delete_elem(st_NewRingList *list, int8_t pos);
+uint32_t 			gsm_ring_list_delete_conn_elem(st_NewRingList *list, uint32_t conn_id, uint8_t all);
 
 /**
  * \}
@@ -47,8 +47,34 @@ extern "C" {
  * \{
  */
 
+/**
+ * \brief           Statistics of the AT port receive path
+ */
+typedef struct {
+    uint32_t bytes;                             /*!< Bytes passed to upper layer */
+    uint32_t overruns;                          /*!< Number of times unread data was overwritten */
+    uint32_t bytes_lost;                        /*!< Bytes skipped because of overruns */
+    uint32_t throttles;                         /*!< Number of times reception was paused with RTS */
+    uint32_t idle_wakeups;                      /*!< Thread wakeups on idle line */
+    uint32_t level_wakeups;                     /*!< Thread wakeups on fill level during a stream */
+    uint32_t peak_fill;                         /*!< Highest number of unread bytes */
+    uint32_t fill;                              /*!< Current number of unread bytes */
+} gsm_ll_rx_stats_t;
+
+/**
+ * \brief           Statistics of the AT port transmit path
+ */
+typedef struct {
+    uint32_t bytes;                             /*!< Bytes handed to DMA */
+    uint32_t transfers;                         /*!< Number of DMA transfers */
+    uint32_t waits;                             /*!< Times the sender blocked on the previous transfer */
+    uint32_t timeouts;                          /*!< Transfers aborted after \ref GSM_USART_DMA_TX_TIMEOUT */
+} gsm_ll_tx_stats_t;
+
 gsmr_t      gsm_ll_init(gsm_ll_t* ll);
 gsmr_t      gsm_ll_deinit(gsm_ll_t* ll);
+void        gsm_ll_get_rx_stats(gsm_ll_rx_stats_t* stats);
+void        gsm_ll_get_tx_stats(gsm_ll_tx_stats_t* stats);
 
 /**
  * \}
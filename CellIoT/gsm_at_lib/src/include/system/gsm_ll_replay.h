@@ -0,0 +1,116 @@
+/**
+ * \file            gsm_ll_replay.h
+ * \brief           Low-level backend replaying AT transcript
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#ifndef GSM_HDR_LL_REPLAY_H
+#define GSM_HDR_LL_REPLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "gsm.h"
+
+/**
+ * \ingroup         GSM_PORT
+ * \defgroup        GSM_LL_REPLAY Replay low-level backend
+ * \brief           Run the library against recorded AT transcript
+ *
+ * Transcript has the format recorded by \ref GSM_TRACE. RX records are fed to
+ * \ref gsm_input_process from a dedicated thread, each one only after all TX
+ * bytes recorded before it have been sent by the library, and after the recorded
+ * gap to previous record scaled by the speed. TX bytes are compared with the transcript.
+ * \{
+ */
+
+/**
+ * \brief           Fault injected in RX stream
+ */
+typedef enum {
+    GSM_LL_REPLAY_FAULT_DROP,                   /*!< Byte at offset is not delivered */
+    GSM_LL_REPLAY_FAULT_CORRUPT,                /*!< Byte at offset is XOR-ed with value */
+    GSM_LL_REPLAY_FAULT_STALL,                  /*!< Delivery stops for value milliseconds before byte at offset */
+} gsm_ll_replay_fault_type_t;
+
+/**
+ * \brief           RX fault description
+ */
+typedef struct {
+    gsm_ll_replay_fault_type_t type;            /*!< Fault type */
+    uint32_t offset;                            /*!< Offset in RX stream, faults must be sorted by offset */
+    uint32_t value;                             /*!< Fault parameter */
+} gsm_ll_replay_fault_t;
+
+/**
+ * \brief           Replay configuration
+ */
+typedef struct {
+    const uint8_t* transcript;                  /*!< Recorded transcript */
+    size_t len;                                 /*!< Transcript length in units of bytes */
+    uint32_t speed;                             /*!< Time scale in percent, `100` for recorded timing, `0` for no delays */
+    size_t rx_chunk;                            /*!< Maximal bytes per input call, `0` keeps recorded chunks */
+    uint32_t tx_timeout;                        /*!< Time to wait for expected TX bytes in units of milliseconds */
+    const gsm_ll_replay_fault_t* faults;        /*!< Faults to inject, may be `NULL` */
+    size_t faults_len;                          /*!< Number of faults */
+} gsm_ll_replay_cfg_t;
+
+/**
+ * \brief           Replay result
+ */
+typedef struct {
+    uint32_t records;                           /*!< Records processed */
+    uint32_t rx_bytes;                          /*!< Bytes delivered to library */
+    uint32_t tx_bytes;                          /*!< Bytes sent by library */
+    uint32_t tx_mismatches;                     /*!< Sent bytes different from transcript */
+    uint32_t tx_timeouts;                       /*!< Times expected TX bytes were not sent in time */
+    uint32_t faults;                            /*!< Faults injected */
+    uint32_t duration;                          /*!< Replay time in units of milliseconds */
+    uint8_t done;                               /*!< Set to `1` when whole transcript was replayed */
+} gsm_ll_replay_stats_t;
+
+gsmr_t      gsm_ll_replay_start(const gsm_ll_replay_cfg_t* cfg);
+uint8_t     gsm_ll_replay_is_active(void);
+gsmr_t      gsm_ll_replay_wait(uint32_t timeout, gsm_ll_replay_stats_t* stats);
+
+gsmr_t      gsm_ll_replay_init(gsm_ll_t* ll);
+gsmr_t      gsm_ll_replay_deinit(gsm_ll_t* ll);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* GSM_HDR_LL_REPLAY_H */
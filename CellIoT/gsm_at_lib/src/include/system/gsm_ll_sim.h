@@ -0,0 +1,128 @@
+/**
+ * \file            gsm_ll_sim.h
+ * \brief           Low-level backend emulating Sequans Monarch module
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#ifndef GSM_HDR_LL_SIM_H
+#define GSM_HDR_LL_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include "gsm.h"
+
+/**
+ * \ingroup         GSM_PORT
+ * \defgroup        GSM_LL_SIM Simulated module
+ * \brief           In-process module answering the AT dialect used by the library
+ *
+ * Boot, identification, registration and the Sequans socket commands
+ * (`AT+SQNSD`, `AT+SQNSSENDEXT`, `AT+SQNSRECV`, `AT+SQNSH`, `AT+SQNDNSLKUP`)
+ * are answered with `+SQNSRING` and `+SQNSH` URCs, other commands get `OK`.
+ * Responses are delivered at the AT port line rate. Socket traffic goes to a peer
+ * given by the application, by default data is echoed back.
+ *
+ * With \ref GSM_CFG_SQNS_MQTT, the `AT+SQNSMQTT` commands of client `0` are answered
+ * with their `+SQNSMQTTON` URCs. Published messages go to the peer, by default
+ * they are delivered back when a subscription matches.
+ * \{
+ */
+
+/**
+ * \brief           Receive buffer of each simulated socket in units of bytes
+ */
+#ifndef GSM_LL_SIM_SOCK_BUFF_SIZE
+#define GSM_LL_SIM_SOCK_BUFF_SIZE           1536
+#endif
+
+/**
+ * \brief           Remote side of simulated sockets
+ */
+typedef struct {
+    uint8_t (*connect_fn)(uint8_t conn, const char* host, uint16_t port);   /*!< Return `1` to accept connection */
+    void (*send_fn)(uint8_t conn, const uint8_t* data, size_t len);         /*!< Data sent by the device */
+    void (*close_fn)(uint8_t conn);                                         /*!< Connection closed by the device */
+    uint8_t (*mqtt_connect_fn)(const char* host, uint16_t port);            /*!< Return `1` to accept MQTT connection */
+    void (*mqtt_publish_fn)(const char* topic, const uint8_t* data, size_t len);    /*!< Message published by the device */
+} gsm_ll_sim_peer_t;
+
+/**
+ * \brief           Simulation configuration
+ */
+typedef struct {
+    uint32_t baudrate;                          /*!< Line rate, `0` follows AT port baudrate of the library */
+    uint32_t cmd_delay;                         /*!< Module processing time per command in units of milliseconds */
+    uint32_t net_latency;                       /*!< One way network latency in units of milliseconds */
+    uint32_t urc_delay;                         /*!< Delay between data arrival and `+SQNSRING` in units of milliseconds */
+    uint32_t boot_time;                         /*!< Time from reset to `+SYSSTART` in units of milliseconds */
+    const gsm_ll_sim_peer_t* peer;              /*!< Remote side, `NULL` for echo */
+} gsm_ll_sim_cfg_t;
+
+/**
+ * \brief           Simulation counters
+ */
+typedef struct {
+    uint32_t commands;                          /*!< AT commands received */
+    uint32_t socket_commands;                   /*!< Socket commands received */
+    uint32_t urcs;                              /*!< URCs sent */
+    uint32_t at_tx_bytes;                       /*!< Bytes received from library */
+    uint32_t at_rx_bytes;                       /*!< Bytes delivered to library */
+    uint32_t sock_tx_bytes;                     /*!< Socket bytes sent to peer */
+    uint32_t sock_rx_bytes;                     /*!< Socket bytes read by library */
+    uint32_t sock_dropped;                      /*!< Socket bytes lost on full buffer */
+    uint32_t rx_latency_max;                    /*!< Longest time from data arrival to read, in units of milliseconds */
+    uint32_t rx_latency_sum;                    /*!< Sum of times from data arrival to read, divide by \ref rx_reads */
+    uint32_t rx_reads;                          /*!< Number of `AT+SQNSRECV` served */
+    uint32_t mqtt_published;                    /*!< Messages published by the library */
+    uint32_t mqtt_delivered;                    /*!< Messages read with `AT+SQNSMQTTRCVMESSAGE` */
+} gsm_ll_sim_stats_t;
+
+gsmr_t      gsm_ll_sim_start(const gsm_ll_sim_cfg_t* cfg);
+uint8_t     gsm_ll_sim_is_active(void);
+void        gsm_ll_sim_get_stats(gsm_ll_sim_stats_t* stats);
+gsmr_t      gsm_ll_sim_peer_input(uint8_t conn, const void* data, size_t len);
+gsmr_t      gsm_ll_sim_peer_close(uint8_t conn);
+gsmr_t      gsm_ll_sim_mqtt_input(const char* topic, const void* data, size_t len);
+
+gsmr_t      gsm_ll_sim_init(gsm_ll_t* ll);
+gsmr_t      gsm_ll_sim_deinit(gsm_ll_t* ll);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* GSM_HDR_LL_SIM_H */
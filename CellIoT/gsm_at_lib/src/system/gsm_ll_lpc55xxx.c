@@ -38,18 +38,38 @@
  * USART is configured in RX DMA mode and any incoming bytes are processed inside thread function.
  * DMA and USART implement interrupt handlers to notify main thread about new data ready to send to upper layer.
  *
+ * Received bytes go to a single ring made of a closed chain of DMA descriptors.
+ * DMA_Callback counts the filled segments, so the write position is a free running counter
+ * (segments * segment size + bytes in the current segment) compared with a free running read counter.
+ * When the thread falls behind, USART RX DMA requests are paused, the RX FIFO fills up
+ * and the hardware RTS line stops the modem until the thread has caught up.
+ *
+ * The thread is woken either when the line has been idle for a few character times
+ * (MRT reloaded by DMA on each byte, timeout follows the baudrate) so short responses are parsed at once,
+ * or, on sustained streams, when a filled segment leaves at least GSM_USART_DMA_RX_WAKEUP_LEVEL unread bytes,
+ * so long payloads are parsed in large batches.
+ *
+ * Bytes to send are copied in one half of g_txBuffer while the DMA sends the other half.
+ * A half is handed to the DMA when it is full or on flush (send_fn(NULL, 0)), after waiting
+ * on a semaphore released on TX DMA completion, so the sending thread blocks instead of
+ * polling while the previous half is on the wire. The DMA interrupt runs above the
+ * FreeRTOS syscall priority, it pends the MRT interrupt which releases the semaphore.
+ *
  * \ref GSM_CFG_INPUT_USE_PROCESS must be enabled in `gsm_config.h` to use this driver.
  */
 #include "gsm.h"
 #include "gsm_mem.h"
 #include "gsm_input.h"
 #include "gsm_ll.h"
+#include "gsm_ll_replay.h"
+#include "gsm_ll_sim.h"
 #include "gsm_private.h"
 #include "CellIoT_common.h"
 #include "aws_CellIoT.h"
 #include "CellIoT_lib.h"
 #include "fsl_usart_dma.h"
 #include "FreeRTOS.h"
+#include "semphr.h"
 #include "fsl_mrt.h"
 #include "fsl_debug_console.h"
 
@@ -73,13 +93,38 @@ extern uint32_t gsmi_send_sqnsrecv(void);
 #define GSM_USART_RDR_NAME              RDR
 #endif /* !defined(GSM_USART_RDR_NAME) */
 
+#if !defined(GSM_USART_DMA_RX_THROTTLE)
+#define GSM_USART_DMA_RX_THROTTLE       1
+#endif /* !defined(GSM_USART_DMA_RX_THROTTLE) */
+
+/* Unread bytes that wake the thread without waiting for an idle line, checked each time a segment is full. 0 disables */
+#if !defined(GSM_USART_DMA_RX_WAKEUP_LEVEL)
+#define GSM_USART_DMA_RX_WAKEUP_LEVEL   CELLIOTSHIELD_USART_RX_SEGMENT_SIZE
+#endif /* !defined(GSM_USART_DMA_RX_WAKEUP_LEVEL) */
+
+/* Longest time a TX half may stay on the wire, in milliseconds */
+#if !defined(GSM_USART_DMA_TX_TIMEOUT)
+#define GSM_USART_DMA_TX_TIMEOUT        1000
+#endif /* !defined(GSM_USART_DMA_TX_TIMEOUT) */
+
 #define USART_TASK_PRIORITY ( (configMAX_PRIORITIES) - 1U )
 #define USART_TASK_STACKSIZE 1024
 
+#define RX_RING_SIZE        CELLIOTSHIELD_USART_RX_RING_SIZE
+#define RX_SEGMENT_SIZE     CELLIOTSHIELD_USART_RX_SEGMENT_SIZE
+
+#if (RX_RING_SIZE & (RX_RING_SIZE - 1)) || (RX_SEGMENT_SIZE & (RX_SEGMENT_SIZE - 1))
+#error "RX ring and segment sizes must be powers of two"
+#endif
+#if (RX_SEGMENT_SIZE >= DMA_MAX_TRANSFER_COUNT) || (RX_RING_SIZE < 2 * RX_SEGMENT_SIZE)
+#error "RX ring needs at least two segments of less than DMA_MAX_TRANSFER_COUNT bytes"
+#endif
+
+/* Unread bytes above which reception is paused: one free segment is kept ahead of the one being filled */
+#define RX_THROTTLE_LEVEL   (RX_RING_SIZE - 2 * RX_SEGMENT_SIZE)
+
 /* USART memory */
-//static uint8_t      usart_mem[GSM_USART_DMA_RX_BUFF_SIZE];
 static uint8_t      is_running, initialized;
-static size_t       old_pos;
 
 /* USART thread */
 void usart_ll_thread(void * arg);
@@ -89,10 +134,130 @@ static gsm_sys_thread_t usart_ll_thread_id = NULL;
 static gsm_sys_mbox_t usart_ll_mbox_id;
 
 
-static size_t old_pos;
-volatile uint8_t * ptr_cur_buff;
-volatile uint8_t * ptr_prv_buff;
-volatile uint8_t buff_jump = 0;
+/* Free running ring counters, in bytes for the read side and in segments for the DMA side */
+static volatile uint32_t rx_segments_done;
+static volatile uint32_t rx_consumed;
+static uint32_t rx_produced_last;               /* Highest position returned by rx_ring_produced() */
+static volatile uint8_t rx_throttled;
+static volatile uint8_t rx_level_wakeup;
+static volatile uint8_t tx_done;
+static gsm_ll_rx_stats_t rx_stats;
+
+#define TX_HALF_SIZE        (AT_BUFFER_SIZE / 2)
+
+/* Half of g_txBuffer being filled, the other one may be on the wire */
+static uint8_t* tx_fill = g_txBuffer;
+static size_t tx_fill_len;
+/* Available while no TX transfer is in progress */
+static SemaphoreHandle_t tx_idle_sem;
+static gsm_ll_tx_stats_t tx_stats;
+
+/**
+ * \brief           Get free running write position of the DMA in the RX ring
+ * \note            Must not be called from an interrupt with higher priority than the DMA one
+ * \return          Number of bytes written by the DMA since start, modulo 2^32
+ */
+static uint32_t
+rx_ring_produced(void) {
+    uint32_t segments, remaining, produced, primask;
+
+    /* Segment counter and descriptor count must be read on the same segment */
+    do {
+        segments = rx_segments_done;
+        remaining = DMA_GetRemainingBytes(CELLIOTSHIELD_DMA_RXHANDLE.base, CELLIOTSHIELD_DMA_RXHANDLE.channel);
+    } while (segments != rx_segments_done);
+
+    /* Segment just completed, next descriptor not reloaded yet */
+    if (remaining > RX_SEGMENT_SIZE) {
+        remaining = 0;
+    }
+    produced = segments * RX_SEGMENT_SIZE + (RX_SEGMENT_SIZE - remaining);
+
+    /*
+     * Descriptor may be reloaded before DMA_Callback() counts the segment,
+     * the position then reads one segment back. Never go below the last one
+     */
+    primask = DisableGlobalIRQ();
+    if ((int32_t)(produced - rx_produced_last) < 0) {
+        produced = rx_produced_last;
+    } else {
+        rx_produced_last = produced;
+    }
+    EnableGlobalIRQ(primask);
+    return produced;
+}
+
+/**
+ * \brief           Send all unread bytes of the RX ring to upper layer
+ */
+static void
+rx_ring_process(void) {
+    uint32_t produced, consumed, avail, idx, len;
+
+    produced = rx_ring_produced();
+    consumed = rx_consumed;
+    avail = produced - consumed;
+
+    if (avail > RX_RING_SIZE) {
+        /*
+         * DMA lapped the reader, oldest bytes are overwritten.
+         * Skip to the oldest complete data, keeping one segment of margin with the writer.
+         */
+        rx_stats.overruns++;
+        rx_stats.bytes_lost += avail - (RX_RING_SIZE - RX_SEGMENT_SIZE);
+        configPRINTF(("AT RX ring overrun, %d bytes lost\r\n", (int)(avail - (RX_RING_SIZE - RX_SEGMENT_SIZE))));
+        consumed = produced - (RX_RING_SIZE - RX_SEGMENT_SIZE);
+        avail = RX_RING_SIZE - RX_SEGMENT_SIZE;
+    }
+    if (avail > rx_stats.peak_fill) {
+        rx_stats.peak_fill = avail;
+    }
+
+    while (consumed != produced) {
+        idx = consumed & (RX_RING_SIZE - 1);
+        len = produced - consumed;
+        if (len > RX_RING_SIZE - idx) {
+            len = RX_RING_SIZE - idx;           /* Up to the end of the ring first */
+        }
+        gsm_input_process((void*)&CELLIOTSHIELD_USART_RX_RING[idx], len);
+        consumed += len;
+        rx_stats.bytes += len;
+    }
+    rx_consumed = consumed;
+
+    /* Data may have been overwritten while upper layer was parsing it */
+    if (rx_ring_produced() - (consumed - avail) > RX_RING_SIZE) {
+        rx_stats.overruns++;
+    }
+
+#if GSM_USART_DMA_RX_THROTTLE
+    if (rx_throttled) {
+        uint32_t primask = DisableGlobalIRQ();
+        rx_throttled = 0;
+        USART_EnableRxDMA(CELLIOTSHIELD_USART, true);   /* RTS is released once FIFO drains */
+        EnableGlobalIRQ(primask);
+    }
+#endif /* GSM_USART_DMA_RX_THROTTLE */
+}
+
+/**
+ * \brief           Get statistics of the AT receive ring
+ * \param[out]      stats: Pointer to structure to fill
+ */
+void
+gsm_ll_get_rx_stats(gsm_ll_rx_stats_t* stats) {
+    *stats = rx_stats;
+    stats->fill = rx_ring_produced() - rx_consumed;
+}
+
+/**
+ * \brief           Get statistics of the AT transmit path
+ * \param[out]      stats: Pointer to structure to fill
+ */
+void
+gsm_ll_get_tx_stats(gsm_ll_tx_stats_t* stats) {
+    *stats = tx_stats;
+}
 
 /**
  * \brief           USART data processing
@@ -101,7 +266,6 @@ void
 usart_ll_thread(void * arg) {
 	BaseType_t evt;
 	uint8_t* mbox_data;
-    size_t pos;
     static TickType_t timeout = portMAX_DELAY;
 
     GSM_UNUSED(arg);
@@ -115,43 +279,15 @@ usart_ll_thread(void * arg) {
         	continue;
         }
 
-        /* Calculate the new next available position in the RX buffer */
-		pos = sizeof(CELLIOTSHIELD_USART_RX_BUFFER) - 1 - DMA_GetRemainingBytes(CELLIOTSHIELD_DMA_RXHANDLE.base, CELLIOTSHIELD_DMA_RXHANDLE.channel);
-
-        if (pos != old_pos && is_running) {
-            if (pos > old_pos && buff_jump == 0) {
-                gsm_input_process((void*)&ptr_cur_buff[old_pos], pos - old_pos);
-            }
-            else
-            {
-            	/* Check if the data filled by the DMA has overloaded the next buffer
-            	 * Which results to come back to the original buffer
-            	 * Hence counting the number of buffer changes
-            	 */
-            	if(buff_jump > 1)
-            	{
-            		gsm_input_process((void*)&ptr_cur_buff[old_pos], sizeof(CELLIOTSHIELD_USART_RX_BUFFER) - 1 - old_pos);
-            		gsm_input_process((void*)&ptr_prv_buff[0], sizeof(CELLIOTSHIELD_USART_RX_BUFFER) - 1);
-            	}
-            	else
-            	{
-					gsm_input_process((void*)&ptr_prv_buff[old_pos], sizeof(CELLIOTSHIELD_USART_RX_BUFFER) - 1 - old_pos);
-            	}
-
-				if (pos > 0) {
-					gsm_input_process((void*)&ptr_cur_buff[0], pos);
-				}
-				buff_jump = 0;
-            }
-            old_pos = pos;
-            if (old_pos == sizeof(CELLIOTSHIELD_USART_RX_BUFFER)) {
-                old_pos = 0;
-            }
+        if (is_running) {
+            rx_ring_process();
         }
 
         if ( NULL != gsm.m.ring_list->first_ring)
         {
         	timeout = pdMS_TO_TICKS(100);
+        	/* Producer thread may be staging a command in the same TX half */
+        	gsm_core_lock();
         	if(!gsm.m.ring_list->is_at_sqnsrecv_ongoing)
         	{
 				if(!gsmi_send_sqnsrecv())
@@ -159,6 +295,7 @@ usart_ll_thread(void * arg) {
 					configPRINTF(("Couldn't get hold of RX buffer because they are all full...\r\n"));
 				}
         	}
+        	gsm_core_unlock();
         }
         else
         {
@@ -183,13 +320,12 @@ configure_uart(uint32_t baudrate) {
 		return;
 	}
 
-	/* Set pointer to the current receive buffer and the previous one */
-	ptr_cur_buff = CELLIOTSHIELD_USART_RX_BUFFER;
-	ptr_prv_buff = CELLIOTSHIELD_USART_RING_BUFFER;
-
 	configPRINTF(("Cellular-IoT Hardware configuration initialized.\r\n"));
 
-	old_pos = 0;
+	rx_segments_done = 0;
+	rx_consumed = 0;
+	rx_produced_last = 0;
+	rx_throttled = 0;
 	is_running = 1;
 
 	/* Create mbox and start thread */
@@ -226,46 +362,69 @@ reset_device(uint8_t state) {
 }
 #endif /* defined(GSM_RESET_PIN) */
 
+/**
+ * \brief           Start DMA transfer of the filled TX half and switch to the other one
+ */
+static void
+tx_start(void) {
+    usart_transfer_t sendXfer;
+
+    /* Previous half must be fully sent before the DMA can be reprogrammed */
+    if (uxSemaphoreGetCount(tx_idle_sem) == 0) {
+        tx_stats.waits++;
+    }
+    if (xSemaphoreTake(tx_idle_sem, pdMS_TO_TICKS(GSM_USART_DMA_TX_TIMEOUT)) != pdTRUE) {
+        USART_TransferAbortSendDMA(CELLIOTSHIELD_USART, &CELLIOTSHIELD_DMA_HANDLE);
+        tx_stats.timeouts++;
+    }
+
+    sendXfer.data = tx_fill;
+    sendXfer.dataSize = tx_fill_len;
+    if (USART_TransferSendDMA(CELLIOTSHIELD_USART, &CELLIOTSHIELD_DMA_HANDLE, &sendXfer) != kStatus_Success) {
+        xSemaphoreGive(tx_idle_sem);            /* Nothing started, data is lost */
+    } else {
+        tx_stats.transfers++;
+        tx_stats.bytes += tx_fill_len;
+    }
+
+    tx_fill = (tx_fill == g_txBuffer) ? &g_txBuffer[TX_HALF_SIZE] : g_txBuffer;
+    tx_fill_len = 0;
+}
+
 /**
  * \brief           Send data to GSM device
- * \param[in]       data: Pointer to data to send
- * \param[in]       len: Number of bytes to send
+ * \note            Data is copied, it is only transmitted once a TX half is full or on flush
+ * \param[in]       data: Pointer to data to send, `NULL` to flush
+ * \param[in]       len: Number of bytes to send, `0` to flush
  * \return          Number of bytes sent
  */
 static size_t
 send_data(const void* data, size_t len) {
-	usart_transfer_t sendXfer;
+    const uint8_t* d = data;
+    size_t sent = 0, chunk;
+
 #if SERIAL_DEBUG
-	char * ptx = (char *)data;
-	for(int i=0;i<len;i++)
-	{
-		PRINTF("%c",*ptx);
-		ptx++;
-	}
+    for (size_t i = 0; d != NULL && i < len; i++) {
+        PRINTF("%c", d[i]);
+    }
 #endif
-	if( len > 0 )
-	{
-		do
-		{
-			if( len > AT_BUFFER_SIZE )
-			{
-				sendXfer.data = (uint8_t *)data;
-				sendXfer.dataSize = AT_BUFFER_SIZE;
-
-				data += AT_BUFFER_SIZE;
-				len -= AT_BUFFER_SIZE;
-			}
-			else
-			{
-				sendXfer.data = (uint8_t *)data;
-				sendXfer.dataSize = len;
-				len = 0;
-			}
-
-			while( USART_TransferSendDMA(CELLIOTSHIELD_USART, &CELLIOTSHIELD_DMA_HANDLE, &sendXfer) == kStatus_USART_TxBusy );
-		}while( len > 0 );
-	}
-    return len;
+    if (d == NULL || len == 0) {
+        if (tx_fill_len > 0) {
+            tx_start();
+        }
+        return 0;
+    }
+
+    while (sent < len) {
+        chunk = GSM_MIN(len - sent, TX_HALF_SIZE - tx_fill_len);
+        memcpy(&tx_fill[tx_fill_len], &d[sent], chunk);
+        tx_fill_len += chunk;
+        sent += chunk;
+        if (tx_fill_len == TX_HALF_SIZE) {
+            tx_start();
+        }
+    }
+    return sent;
 }
 
 /**
@@ -288,6 +447,27 @@ gsm_ll_init(gsm_ll_t* ll) {
     }
 #endif /* !GSM_CFG_MEM_CUSTOM */
 
+#if GSM_CFG_LL_REPLAY
+    if (gsm_ll_replay_is_active()) {
+        initialized = 1;
+        return gsm_ll_replay_init(ll);          /* Transcript replaces the AT port */
+    }
+#endif /* GSM_CFG_LL_REPLAY */
+#if GSM_CFG_LL_SIM
+    if (gsm_ll_sim_is_active()) {
+        initialized = 1;
+        return gsm_ll_sim_init(ll);             /* Simulated module replaces the AT port */
+    }
+#endif /* GSM_CFG_LL_SIM */
+
+    if (tx_idle_sem == NULL) {
+        tx_idle_sem = xSemaphoreCreateBinary();
+        if (tx_idle_sem == NULL) {
+            return gsmERRMEM;
+        }
+        xSemaphoreGive(tx_idle_sem);
+    }
+
     if (!initialized) {
         ll->send_fn = send_data;                /* Set callback function to send data */
 #if defined(GSM_RESET_PIN)
@@ -295,7 +475,11 @@ gsm_ll_init(gsm_ll_t* ll) {
 #endif /* defined(GSM_RESET_PIN) */
     }
 
-    configure_uart(ll->uart.baudrate);          /* Initialize UART for communication */
+    if (!initialized) {
+        configure_uart(ll->uart.baudrate);      /* Initialize UART for communication */
+    } else if (CELLIOTSHIELD_USARTSetBaudrate(ll->uart.baudrate) != kStatus_Success) {   /* Only reload the divider, RX DMA keeps running */
+        return gsmPARERR;
+    }
     initialized = 1;
     return gsmOK;
 }
@@ -307,6 +491,18 @@ gsm_ll_init(gsm_ll_t* ll) {
  */
 gsmr_t
 gsm_ll_deinit(gsm_ll_t* ll) {
+#if GSM_CFG_LL_REPLAY
+    if (gsm_ll_replay_is_active()) {
+        initialized = 0;
+        return gsm_ll_replay_deinit(ll);
+    }
+#endif /* GSM_CFG_LL_REPLAY */
+#if GSM_CFG_LL_SIM
+    if (gsm_ll_sim_is_active()) {
+        initialized = 0;
+        return gsm_ll_sim_deinit(ll);
+    }
+#endif /* GSM_CFG_LL_SIM */
     if (usart_ll_mbox_id != NULL) {
     	gsm_sys_mbox_t tmp = usart_ll_mbox_id;
         usart_ll_mbox_id = NULL;
@@ -328,47 +524,91 @@ gsm_ll_deinit(gsm_ll_t* ll) {
  */
 void DMA_Callback(dma_handle_t *handle, void *param, bool transferDone, uint32_t tcds)
 {
-	/* When DMA Channel 0 descriptor is exhausting,
-	 * we need to switch RX buffer
-	 */
+	/* A segment of the RX ring is full, DMA already moved to the next descriptor */
     if (tcds == kDMA_IntA)
     {
-    	/* Descriptor has expired so the current buffer has changed */
-    	ptr_cur_buff = CELLIOTSHIELD_USART_RING_BUFFER;
-    	ptr_prv_buff = CELLIOTSHIELD_USART_RX_BUFFER;
+    	rx_segments_done++;
+
+#if GSM_USART_DMA_RX_THROTTLE
+		/* Not enough room left ahead of the DMA: stop requests, RTS follows the RX FIFO */
+		if (!rx_throttled && (rx_segments_done * RX_SEGMENT_SIZE - rx_consumed) > RX_THROTTLE_LEVEL)
+		{
+			USART_EnableRxDMA(CELLIOTSHIELD_USART, false);
+			rx_throttled = 1;
+			rx_stats.throttles++;
+		}
+#endif /* GSM_USART_DMA_RX_THROTTLE */
+
+#if GSM_USART_DMA_RX_WAKEUP_LEVEL
+		/* Stream still running, the idle timer will not expire: wake the thread through the MRT handler */
+		if ((rx_segments_done * RX_SEGMENT_SIZE - rx_consumed) >= GSM_USART_DMA_RX_WAKEUP_LEVEL)
+		{
+			rx_level_wakeup = 1;
+			NVIC_SetPendingIRQ(MRT0_IRQn);
+		}
+#endif /* GSM_USART_DMA_RX_WAKEUP_LEVEL */
     }
-    else if (tcds == kDMA_IntB)
+}
+
+
+/**
+ * \brief           USART TX DMA transfer complete handler
+ * \note            DMA interrupt is above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY,
+ *                  the semaphore is released by the MRT handler
+ */
+void USART_TxCallbackHandler(USART_Type *base, usart_dma_handle_t *handle, status_t status, void *userData)
+{
+	if (status == kStatus_USART_TxIdle)
 	{
-		/* Descriptor has expired so the current buffer has changed */
-		ptr_cur_buff = CELLIOTSHIELD_USART_RX_BUFFER;
-		ptr_prv_buff = CELLIOTSHIELD_USART_RING_BUFFER;
+		tx_done = 1;
+		NVIC_SetPendingIRQ(MRT0_IRQn);
 	}
-
-    /* Follow the number of buffer changes */
-    buff_jump++;
 }
 
-
 void MRT0_IRQHandler(void)
 {
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	uint8_t idle = (MRT_GetStatusFlags(MRT0, kMRT_Channel_0) & kMRT_TimerInterruptFlag) != 0;
+
     /* Clear interrupt flag.*/
     MRT_ClearStatusFlags(MRT0, kMRT_Channel_0, kMRT_TimerInterruptFlag);
 
-	if (usart_ll_mbox_id != NULL)
+	/* Pended by USART_TxCallbackHandler() */
+	if (tx_done)
 	{
-		size_t pos;
-		/* Calculate the new next available position in the RX buffer */
-		pos = sizeof(CELLIOTSHIELD_USART_RX_BUFFER) - 1 - DMA_GetRemainingBytes(CELLIOTSHIELD_DMA_RXHANDLE.base, CELLIOTSHIELD_DMA_RXHANDLE.channel);
+		tx_done = 0;
+		xSemaphoreGiveFromISR(tx_idle_sem, &xHigherPriorityTaskWoken);
+	}
 
-		if (pos != old_pos && is_running)
+	/* RX line went idle, or pended by DMA_Callback() on a fill level.
+	 * Position is not checked here, the DMA interrupt may have reloaded
+	 * the descriptor before the segment is counted.
+	 */
+	if (rx_level_wakeup)
+	{
+		rx_level_wakeup = 0;
+		rx_stats.level_wakeups++;
+	}
+	else if (idle)
+	{
+		rx_stats.idle_wakeups++;
+	}
+	else
+	{
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+		return;                                 /* Only TX completion */
+	}
+
+	if (usart_ll_mbox_id != NULL)
+	{
+		if (is_running)
 		{
 			uint8_t mbox_msg = 0;
-			BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 			xQueueSendToBackFromISR(usart_ll_mbox_id, &mbox_msg, &xHigherPriorityTaskWoken); /* Put new message for ISR API */
-			/* Now the buffer is empty we can switch context if necessary. */
-			portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 		}
 	}
+	/* Now the buffer is empty we can switch context if necessary. */
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 
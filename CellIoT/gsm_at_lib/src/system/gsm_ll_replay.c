@@ -0,0 +1,306 @@
+/**
+ * \file            gsm_ll_replay.c
+ * \brief           Low-level backend replaying AT transcript
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#include "gsm_private.h"
+#include "gsm_ll.h"
+#include "gsm_ll_replay.h"
+#include "gsm_trace.h"
+#include "gsm_input.h"
+#include "gsm_parser.h"
+
+#if GSM_CFG_LL_REPLAY || __DOXYGEN__
+
+#define REPLAY_THREAD_STACKSIZE     512
+#define REPLAY_RX_CHUNK_MAX         128
+
+static gsm_ll_replay_cfg_t replay_cfg;
+static gsm_ll_replay_stats_t replay_stats;
+static uint8_t replay_active;
+static gsm_sys_thread_t replay_thread_id;
+static gsm_sys_sem_t replay_tx_sem;             /* Released on each send call */
+static gsm_sys_sem_t replay_done_sem;           /* Released when transcript is over */
+
+/* Position in TX stream of transcript, advanced by send function */
+static size_t tx_rec_pos, tx_rec_off;
+static volatile uint32_t tx_sent;
+
+/* Position in RX stream and next fault to inject */
+static uint32_t rx_off;
+static size_t fault_idx;
+
+/**
+ * \brief           Read record header at position
+ * \return          `1` if complete record is available, `0` otherwise
+ */
+static uint8_t
+replay_get_rec(size_t pos, gsm_trace_rec_t* rec) {
+    if (pos + sizeof(*rec) > replay_cfg.len) {
+        return 0;
+    }
+    GSM_MEMCPY(rec, &replay_cfg.transcript[pos], sizeof(*rec));
+    return pos + sizeof(*rec) + rec->len <= replay_cfg.len;
+}
+
+/**
+ * \brief           Get next expected TX byte
+ * \param[out]      ch: Expected byte
+ * \return          `1` on success, `0` when transcript has no more TX bytes
+ */
+static uint8_t
+replay_next_tx(uint8_t* ch) {
+    gsm_trace_rec_t rec;
+
+    while (replay_get_rec(tx_rec_pos, &rec)) {
+        if (rec.dir == GSM_TRACE_DIR_TX && tx_rec_off < rec.len) {
+            *ch = replay_cfg.transcript[tx_rec_pos + sizeof(rec) + tx_rec_off++];
+            return 1;
+        }
+        tx_rec_pos += sizeof(rec) + rec.len;
+        tx_rec_off = 0;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Send function, compares library output with transcript
+ */
+static size_t
+replay_send(const void* data, size_t len) {
+    const uint8_t* d = data;
+    uint8_t ch;
+
+    if (d == NULL || len == 0) {
+        return 0;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (!replay_next_tx(&ch) || ch != d[i]) {
+            replay_stats.tx_mismatches++;
+        }
+    }
+    replay_stats.tx_bytes += len;
+    tx_sent += len;
+    gsm_sys_sem_release(&replay_tx_sem);
+    return len;
+}
+
+/**
+ * \brief           Deliver RX record to library with chunking and faults
+ */
+static void
+replay_rx(const uint8_t* data, size_t len) {
+    uint8_t buff[REPLAY_RX_CHUNK_MAX];
+    size_t chunk, n, i;
+    const gsm_ll_replay_fault_t* f;
+
+    chunk = replay_cfg.rx_chunk > 0 ? replay_cfg.rx_chunk : sizeof(buff);
+    chunk = GSM_MIN(chunk, sizeof(buff));
+    for (i = 0; i < len;) {
+        for (n = 0; n < chunk && i < len; i++, rx_off++) {
+            f = fault_idx < replay_cfg.faults_len ? &replay_cfg.faults[fault_idx] : NULL;
+            if (f != NULL && f->offset == rx_off) {
+                fault_idx++;
+                replay_stats.faults++;
+                if (f->type == GSM_LL_REPLAY_FAULT_DROP) {
+                    continue;
+                } else if (f->type == GSM_LL_REPLAY_FAULT_CORRUPT) {
+                    buff[n++] = data[i] ^ GSM_U8(f->value);
+                    continue;
+                } else if (f->type == GSM_LL_REPLAY_FAULT_STALL) {
+                    if (n > 0) {
+                        gsm_input_process(buff, n);
+                        replay_stats.rx_bytes += n;
+                        n = 0;
+                    }
+                    gsm_delay(f->value);
+                }
+            }
+            buff[n++] = data[i];
+        }
+        if (n > 0) {
+            gsm_input_process(buff, n);
+            replay_stats.rx_bytes += n;
+        }
+    }
+}
+
+/**
+ * \brief           Read data announced by \`+SQNSRING\`, done by AT port thread on hardware
+ */
+static void
+replay_serve_rings(void) {
+    gsm_core_lock();
+    if (gsm.m.ring_list->first_ring != NULL && !gsm.m.ring_list->is_at_sqnsrecv_ongoing) {
+        gsmi_send_sqnsrecv();
+    }
+    gsm_core_unlock();
+}
+
+/**
+ * \brief           Replay thread
+ * \param[in]       arg: Thread argument
+ */
+static void
+replay_thread(void* arg) {
+    gsm_trace_rec_t rec;
+    size_t pos = 0;
+    uint32_t tx_expected = 0, prev_time = 0, start = gsm_sys_now(), t;
+
+    GSM_UNUSED(arg);
+    while (replay_get_rec(pos, &rec)) {
+        if (rec.dir == GSM_TRACE_DIR_TX) {
+            /* Library must have sent everything recorded so far */
+            tx_expected += rec.len;
+            t = gsm_sys_now();
+            while (tx_sent < tx_expected) {
+                if (gsm_sys_now() - t >= replay_cfg.tx_timeout) {
+                    replay_stats.tx_timeouts++;
+                    break;
+                }
+                gsm_sys_sem_wait(&replay_tx_sem, replay_cfg.tx_timeout);
+            }
+        } else {
+            if (replay_cfg.speed > 0 && rec.time > prev_time) {
+                gsm_delay((rec.time - prev_time) * replay_cfg.speed / 100);
+            }
+            replay_rx(&replay_cfg.transcript[pos + sizeof(rec)], rec.len);
+            replay_serve_rings();
+        }
+        prev_time = rec.time;
+        pos += sizeof(rec) + rec.len;
+        replay_stats.records++;
+    }
+    replay_stats.duration = gsm_sys_now() - start;
+    replay_stats.done = 1;
+    gsm_sys_sem_release(&replay_done_sem);
+    gsm_sys_thread_terminate(NULL);
+}
+
+/**
+ * \brief           Load transcript to replay
+ * \note            Must be called before \ref gsm_init, transcript must stay valid during replay
+ * \param[in]       cfg: Replay configuration, copied
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_replay_start(const gsm_ll_replay_cfg_t* cfg) {
+    GSM_ASSERT("cfg != NULL", cfg != NULL);
+    GSM_ASSERT("cfg->transcript != NULL", cfg->transcript != NULL);
+
+    if (replay_active) {
+        return gsmERR;
+    }
+    if (!gsm_sys_sem_isvalid(&replay_tx_sem) && !gsm_sys_sem_create(&replay_tx_sem, 0)) {
+        return gsmERRMEM;
+    }
+    if (!gsm_sys_sem_isvalid(&replay_done_sem) && !gsm_sys_sem_create(&replay_done_sem, 0)) {
+        return gsmERRMEM;
+    }
+    replay_cfg = *cfg;
+    if (replay_cfg.tx_timeout == 0) {
+        replay_cfg.tx_timeout = 10000;
+    }
+    GSM_MEMSET(&replay_stats, 0x00, sizeof(replay_stats));
+    tx_rec_pos = 0;
+    tx_rec_off = 0;
+    tx_sent = 0;
+    rx_off = 0;
+    fault_idx = 0;
+    replay_active = 1;
+    return gsmOK;
+}
+
+/**
+ * \brief           Check if replay backend replaces the AT port
+ * \return          `1` if transcript is loaded, `0` otherwise
+ */
+uint8_t
+gsm_ll_replay_is_active(void) {
+    return replay_active;
+}
+
+/**
+ * \brief           Wait for end of transcript
+ * \param[in]       timeout: Maximal time to wait in units of milliseconds
+ * \param[out]      stats: Pointer to output result, may be `NULL`
+ * \return          \ref gsmOK when transcript is over, \ref gsmTIMEOUT otherwise
+ */
+gsmr_t
+gsm_ll_replay_wait(uint32_t timeout, gsm_ll_replay_stats_t* stats) {
+    gsmr_t res = gsmOK;
+
+    if (!replay_stats.done && gsm_sys_sem_wait(&replay_done_sem, timeout) == GSM_SYS_TIMEOUT) {
+        res = gsmTIMEOUT;
+    }
+    if (stats != NULL) {
+        *stats = replay_stats;
+    }
+    return res;
+}
+
+/**
+ * \brief           Low-level init for replay, called by low-level driver when replay is active
+ * \note            Called again on AT port baudrate change
+ * \param[in,out]   ll: Pointer to \ref gsm_ll_t structure to fill data for communication functions
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_replay_init(gsm_ll_t* ll) {
+    /* Baudrate change calls it again, trace and stats wrappers chain to the installed function */
+    if (replay_thread_id == NULL) {
+        ll->send_fn = replay_send;
+        ll->reset_fn = NULL;
+        if (!gsm_sys_thread_create(&replay_thread_id, "gsm_replay", replay_thread, NULL, REPLAY_THREAD_STACKSIZE, GSM_SYS_THREAD_PRIO)) {
+            return gsmERRMEM;
+        }
+    }
+    return gsmOK;
+}
+
+/**
+ * \brief           Low-level de-init for replay
+ * \param[in,out]   ll: Pointer to \ref gsm_ll_t structure
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_replay_deinit(gsm_ll_t* ll) {
+    if (replay_thread_id != NULL && !replay_stats.done) {
+        gsm_sys_thread_terminate(&replay_thread_id);
+    }
+    replay_thread_id = NULL;
+    replay_active = 0;
+    GSM_UNUSED(ll);
+    return gsmOK;
+}
+
+#endif /* GSM_CFG_LL_REPLAY || __DOXYGEN__ */
@@ -0,0 +1,1042 @@
+/**
+ * \file            gsm_ll_sim.c
+ * \brief           Low-level backend emulating Sequans Monarch module
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#include "gsm_private.h"
+#include "gsm_ll.h"
+#include "gsm_ll_sim.h"
+#include "gsm_input.h"
+#include "gsm_parser.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+#if GSM_CFG_LL_SIM || __DOXYGEN__
+
+#define SIM_THREAD_STACKSIZE        512
+#define SIM_RX_CHUNK_MAX            64
+#define SIM_CMD_LEN_MAX             256
+#define SIM_OUT_BUFF_SIZE           0x1000
+#define SIM_EVENTS_MAX              (GSM_CFG_MAX_CONNS + 4)
+#define SIM_SETTING_IDS_MAX         6
+#define SIM_SETTING_LEN             64
+
+/* Defaults when configuration leaves them `0` */
+#define SIM_DEFAULT_BAUDRATE        921600
+#define SIM_DEFAULT_BOOT_TIME       100
+
+/* Identification strings answered by the module */
+#define SIM_MANUFACTURER            "SEQUANS Communications"
+#define SIM_MODEL                   "VZM20Q"
+#define SIM_REVISION                "UE5.2.0.3-sim"
+#define SIM_SERIAL                  "000000000000000"
+
+#if GSM_CFG_SQNS_MQTT
+#define SIM_MQTT_TOPIC_LEN          64
+#define SIM_MQTT_SUBS_MAX           4
+#define SIM_MQTT_MSGS_MAX           2
+#endif /* GSM_CFG_SQNS_MQTT */
+
+/**
+ * \brief           Simulated module socket
+ */
+typedef struct {
+    uint8_t open;                               /*!< Connected to peer */
+    uint8_t ring_pending;                       /*!< `+SQNSRING` sent and not yet read */
+    uint8_t recv_hex;                           /*!< `AT+SQNSRECV` data is hex encoded */
+    uint8_t send_hex;                           /*!< `AT+SQNSSENDEXT` data is hex encoded */
+    uint32_t arrival;                           /*!< Arrival time of oldest unread data */
+    size_t len;                                 /*!< Number of unread bytes */
+    uint8_t buff[GSM_LL_SIM_SOCK_BUFF_SIZE];    /*!< Unread data */
+} sim_sock_t;
+
+/**
+ * \brief           Timed module actions
+ */
+typedef enum {
+    SIM_EVT_CMD = 1,                            /*!< Command line processed */
+    SIM_EVT_DATA,                               /*!< Data of `AT+SQNSSENDEXT` processed */
+    SIM_EVT_SYSSTART,                           /*!< Boot finished */
+    SIM_EVT_CONNECT,                            /*!< `AT+SQNSD` result */
+    SIM_EVT_RING,                               /*!< Data arrived on socket */
+    SIM_EVT_CLOSE,                              /*!< Socket closed by peer */
+#if GSM_CFG_SQNS_MQTT
+    SIM_EVT_MQTT_CONNECT,                       /*!< `AT+SQNSMQTTCONNECT` result */
+    SIM_EVT_MQTT_MESSAGE,                       /*!< Message arrived from broker */
+#endif /* GSM_CFG_SQNS_MQTT */
+} sim_evt_type_t;
+
+typedef struct {
+    uint8_t type;                               /*!< Member of \ref sim_evt_type_t, `0` when free */
+    uint8_t conn;                               /*!< Connection ID, `1` based, message slot for MQTT */
+    uint8_t ok;                                 /*!< Result for connect */
+    uint32_t due;                               /*!< Time to execute */
+} sim_evt_t;
+
+static gsm_ll_sim_cfg_t sim_cfg;
+static gsm_ll_sim_stats_t sim_stats;
+static uint8_t sim_active;
+static gsm_sys_thread_t sim_thread_id;
+static gsm_sys_sem_t sim_sem;                   /* Released when there is work for the thread */
+static uint32_t sim_baudrate;
+
+static sim_sock_t sim_socks[GSM_CFG_MAX_CONNS];
+static sim_evt_t sim_evts[SIM_EVENTS_MAX];
+
+/**
+ * \brief           Setting kept in module NVM, listed back by its read command
+ */
+typedef struct {
+    const char* name;                           /*!< Command without `AT` */
+    char params[SIM_SETTING_IDS_MAX][SIM_SETTING_LEN];  /*!< Parameters after the ID, empty when never written */
+} sim_setting_t;
+
+static sim_setting_t sim_settings[] = {
+    { "+SQNSCFG", { { 0 } } },
+    { "+SQNSCFGEXT", { { 0 } } },
+    { "+SQNSPCFG", { { 0 } } },
+};
+
+#if GSM_CFG_SQNS_MQTT
+/**
+ * \brief           Message held by the module until `AT+SQNSMQTTRCVMESSAGE`
+ */
+typedef struct {
+    uint32_t mid;                               /*!< Message identifier, `0` when free */
+    char topic[SIM_MQTT_TOPIC_LEN];             /*!< Topic */
+    size_t len;                                 /*!< Payload length */
+    uint8_t data[GSM_LL_SIM_SOCK_BUFF_SIZE];    /*!< Payload */
+} sim_mqtt_msg_t;
+
+/* MQTT client of the module */
+static struct {
+    uint8_t connected;                          /*!< Connected to broker */
+    uint32_t mid;                               /*!< Last message identifier */
+    char topic[SIM_MQTT_TOPIC_LEN];             /*!< Topic of `AT+SQNSMQTTPUBLISH` in data mode */
+    char subs[SIM_MQTT_SUBS_MAX][SIM_MQTT_TOPIC_LEN];   /*!< Subscribed topic filters */
+    sim_mqtt_msg_t msgs[SIM_MQTT_MSGS_MAX];     /*!< Messages not read yet */
+} sim_mqtt;
+#endif /* GSM_CFG_SQNS_MQTT */
+
+/* Output to the library, delivered at line rate */
+static uint8_t out_buff[SIM_OUT_BUFF_SIZE];
+static size_t out_len;
+
+/* Command line, copied to cmd_exec when the line is complete */
+static char cmd_line[SIM_CMD_LEN_MAX], cmd_exec[SIM_CMD_LEN_MAX];
+static size_t cmd_len;
+
+/* Data mode after `> ` of `AT+SQNSSENDEXT`, connection `0` for `AT+SQNSMQTTPUBLISH` */
+static uint8_t data_conn;
+static size_t data_expected, data_len, data_chars;
+static uint8_t data_buff[GSM_LL_SIM_SOCK_BUFF_SIZE];
+
+/**
+ * \brief           Time to transfer bytes at line rate, 10 bits per byte
+ * \return          Time in units of milliseconds
+ */
+static uint32_t
+sim_wire_time(size_t len) {
+    return GSM_U32((len * 10000UL) / sim_baudrate);
+}
+
+/**
+ * \brief           Schedule module action
+ * \note            Called with core locked
+ */
+static void
+sim_evt_add(sim_evt_type_t type, uint8_t conn, uint8_t ok, uint32_t delay) {
+    for (size_t i = 0; i < GSM_ARRAYSIZE(sim_evts); i++) {
+        if (!sim_evts[i].type) {
+            sim_evts[i].type = GSM_U8(type);
+            sim_evts[i].conn = conn;
+            sim_evts[i].ok = ok;
+            sim_evts[i].due = gsm_sys_now() + delay;
+            gsm_sys_sem_release(&sim_sem);
+            return;
+        }
+    }
+}
+
+/**
+ * \brief           Queue bytes for the library
+ * \note            Called with core locked
+ */
+static void
+sim_out(const void* data, size_t len) {
+    len = GSM_MIN(len, sizeof(out_buff) - out_len);
+    GSM_MEMCPY(&out_buff[out_len], data, len);
+    out_len += len;
+    gsm_sys_sem_release(&sim_sem);
+}
+
+#define SIM_OUT_STR(str)            sim_out((str), strlen(str))
+
+/**
+ * \brief           Queue formatted line for the library, surrounded with CRLF
+ */
+static void
+sim_out_line(const char* fmt, ...) {
+    char line[128];
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    SIM_OUT_STR(CRLF);
+    sim_out(line, GSM_MIN(GSM_SZ(len), sizeof(line) - 1));
+    SIM_OUT_STR(CRLF);
+}
+
+#define SIM_OUT_OK()                SIM_OUT_STR(CRLF "OK" CRLF)
+#define SIM_OUT_ERROR()             SIM_OUT_STR(CRLF "ERROR" CRLF)
+
+/**
+ * \brief           Get socket from connection ID in command
+ * \return          Socket or `NULL` for invalid ID
+ */
+static sim_sock_t*
+sim_get_sock(uint32_t conn) {
+    return conn >= 1 && conn <= GSM_CFG_MAX_CONNS ? &sim_socks[conn - 1] : NULL;
+}
+
+/**
+ * \brief           Parse next comma separated number of command
+ */
+static uint32_t
+sim_parse_number(const char** str) {
+    uint32_t val = 0;
+    const char* p = *str;
+
+    if (*p == ',') {
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        val = 10 * val + (*p++ - '0');
+    }
+    *str = p;
+    return val;
+}
+
+/**
+ * \brief           Store or list a setting kept in module NVM
+ * \param[in]       cmd: Command without `AT`
+ * \param[in]       args: Arguments after `=`
+ * \return          `1` when the read command was answered, `0` otherwise
+ */
+static uint8_t
+sim_setting_cmd(const char* cmd, const char* args) {
+    for (size_t i = 0; i < GSM_ARRAYSIZE(sim_settings); i++) {
+        sim_setting_t* st = &sim_settings[i];
+        size_t n = strlen(st->name);
+        uint32_t id;
+
+        if (strncmp(cmd, st->name, n)) {
+            continue;
+        }
+        if (cmd[n] == '?') {
+            for (id = 1; id <= SIM_SETTING_IDS_MAX; id++) {
+                if (st->params[id - 1][0] != '\0') {
+                    sim_out_line("%s: %u,%s", st->name, (unsigned)id, st->params[id - 1]);
+                }
+            }
+            SIM_OUT_OK();
+            return 1;
+        } else if (cmd[n] == '=') {
+            id = sim_parse_number(&args);
+            if (id >= 1 && id <= SIM_SETTING_IDS_MAX) {
+                if (*args == ',') {
+                    args++;
+                }
+                strncpy(st->params[id - 1], args, SIM_SETTING_LEN - 1);
+                st->params[id - 1][SIM_SETTING_LEN - 1] = '\0';
+            }
+            return 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Parse next comma separated quoted string of command
+ */
+static void
+sim_parse_string(const char** str, char* dst, size_t dst_len) {
+    const char* p = *str;
+    size_t i = 0;
+
+    if (*p == ',') {
+        p++;
+    }
+    if (*p == '"') {
+        p++;
+    }
+    for (; *p != '\0' && *p != '"' && *p != ','; p++) {
+        if (i + 1 < dst_len) {
+            dst[i++] = *p;
+        }
+    }
+    if (*p == '"') {
+        p++;
+    }
+    dst[i] = '\0';
+    *str = p;
+}
+
+/**
+ * \brief           Close socket on module side
+ * \param[in]       remote: Set to `1` when closed by the peer
+ */
+static void
+sim_sock_close(uint8_t conn, uint8_t remote) {
+    sim_sock_t* s = sim_get_sock(conn);
+
+    if (s == NULL || !s->open) {
+        return;
+    }
+    s->open = 0;
+    s->ring_pending = 0;
+    s->len = 0;
+    if (remote) {
+        sim_out_line("+SQNSH: %d", (int)conn);
+        sim_stats.urcs++;
+    } else if (sim_cfg.peer != NULL && sim_cfg.peer->close_fn != NULL) {
+        sim_cfg.peer->close_fn(conn);
+    }
+}
+
+/**
+ * \brief           Answer `AT+SQNSRECV`
+ */
+static void
+sim_cmd_sqnsrecv(const char* args) {
+    static const char hex[] = "0123456789ABCDEF";
+    uint32_t conn, max, now;
+    sim_sock_t* s;
+    size_t n;
+    char h[2];
+
+    conn = sim_parse_number(&args);
+    max = sim_parse_number(&args);
+    s = sim_get_sock(conn);
+    if (s == NULL || max == 0) {
+        SIM_OUT_ERROR();
+        return;
+    }
+    n = GSM_MIN(GSM_SZ(max), s->len);
+    sim_out_line("+SQNSRECV: %d,%d", (int)conn, (int)n);
+    for (size_t i = 0; i < n; i++) {
+        if (s->recv_hex) {
+            h[0] = hex[s->buff[i] >> 4];
+            h[1] = hex[s->buff[i] & 0x0F];
+            sim_out(h, 2);
+        } else {
+            sim_out(&s->buff[i], 1);
+        }
+    }
+    SIM_OUT_STR(CRLF);
+    SIM_OUT_OK();
+
+    if (n > 0) {
+        now = gsm_sys_now();
+        sim_stats.rx_latency_max = GSM_MAX(sim_stats.rx_latency_max, now - s->arrival);
+        sim_stats.rx_latency_sum += now - s->arrival;
+        sim_stats.rx_reads++;
+        sim_stats.sock_rx_bytes += GSM_U32(n);
+        memmove(s->buff, &s->buff[n], s->len - n);
+        s->len -= n;
+        s->arrival = now;
+    }
+    s->ring_pending = 0;
+    if (s->len > 0) {
+        sim_evt_add(SIM_EVT_RING, GSM_U8(conn), 0, sim_cfg.urc_delay);
+    }
+}
+
+#if GSM_CFG_SQNS_MQTT
+
+/**
+ * \brief           Check if topic matches subscription filter, with `+` and `#` wildcards
+ */
+static uint8_t
+sim_mqtt_match(const char* filter, const char* topic) {
+    while (*filter != '\0') {
+        if (*filter == '#') {
+            return 1;
+        } else if (*filter == '+') {
+            while (*topic != '\0' && *topic != '/') {
+                topic++;
+            }
+            filter++;
+        } else if (*filter++ != *topic++) {
+            return 0;
+        }
+    }
+    return *topic == '\0';
+}
+
+/**
+ * \brief           Hold message from broker and announce it with `+SQNSMQTTONMESSAGE`
+ * \note            Called with core locked
+ * \param[in]       delay: Time until the module has received it
+ * \return          \ref gsmOK on success, \ref gsmERRMEM when the module holds too many messages
+ */
+static gsmr_t
+sim_mqtt_deliver(const char* topic, const void* data, size_t len, uint32_t delay) {
+    for (size_t i = 0; i < SIM_MQTT_MSGS_MAX; i++) {
+        sim_mqtt_msg_t* m = &sim_mqtt.msgs[i];
+
+        if (m->mid == 0) {
+            m->mid = ++sim_mqtt.mid;
+            strncpy(m->topic, topic, sizeof(m->topic) - 1);
+            m->topic[sizeof(m->topic) - 1] = '\0';
+            m->len = GSM_MIN(len, sizeof(m->data));
+            GSM_MEMCPY(m->data, data, m->len);
+            sim_stats.sock_dropped += GSM_U32(len - m->len);
+            sim_evt_add(SIM_EVT_MQTT_MESSAGE, GSM_U8(i), 0, delay + sim_cfg.urc_delay);
+            return gsmOK;
+        }
+    }
+    sim_stats.sock_dropped += GSM_U32(len);
+    return gsmERRMEM;
+}
+
+/**
+ * \brief           Payload of `AT+SQNSMQTTPUBLISH` received, goes to peer or back to subscriptions
+ * \note            Called with core locked
+ */
+static void
+sim_mqtt_published(void) {
+    sim_stats.mqtt_published++;
+    sim_stats.sock_tx_bytes += GSM_U32(data_len);
+    SIM_OUT_OK();
+    sim_out_line("+SQNSMQTTONPUBLISH: 0,%d,0", (int)++sim_mqtt.mid);
+    sim_stats.urcs++;
+
+    if (sim_cfg.peer != NULL && sim_cfg.peer->mqtt_publish_fn != NULL) {
+        sim_cfg.peer->mqtt_publish_fn(sim_mqtt.topic, data_buff, data_len);
+        return;
+    }
+    for (size_t i = 0; i < SIM_MQTT_SUBS_MAX; i++) {
+        if (sim_mqtt.subs[i][0] != '\0' && sim_mqtt_match(sim_mqtt.subs[i], sim_mqtt.topic)) {
+            sim_mqtt_deliver(sim_mqtt.topic, data_buff, data_len, 2 * sim_cfg.net_latency);
+            break;                              /* Broker sends one copy per client */
+        }
+    }
+}
+
+/**
+ * \brief           Answer `AT+SQNSMQTT` commands of client `0`
+ * \param[in]       cmd: Command after `AT+SQNSMQTT`
+ * \param[in]       args: Arguments after client ID
+ */
+static void
+sim_cmd_mqtt(const char* cmd, const char* args) {
+    char topic[SIM_MQTT_TOPIC_LEN], host[64];
+    uint32_t port, mid;
+    sim_mqtt_msg_t* m;
+    uint8_t ok;
+    size_t i;
+
+    if (!strncmp(cmd, "CONNECT=", 8)) {
+        sim_parse_string(&args, host, sizeof(host));
+        port = sim_parse_number(&args);
+        if (sim_mqtt.connected) {
+            SIM_OUT_ERROR();
+            return;
+        }
+        ok = 1;
+        if (sim_cfg.peer != NULL && sim_cfg.peer->mqtt_connect_fn != NULL) {
+            ok = sim_cfg.peer->mqtt_connect_fn(host, GSM_U16(port));
+        }
+        SIM_OUT_OK();
+        sim_evt_add(SIM_EVT_MQTT_CONNECT, 0, ok, 4 * sim_cfg.net_latency);
+    } else if (!strncmp(cmd, "DISCONNECT=", 11)) {
+        GSM_MEMSET(sim_mqtt.subs, 0x00, sizeof(sim_mqtt.subs));
+        for (i = 0; i < SIM_MQTT_MSGS_MAX; i++) {
+            sim_mqtt.msgs[i].mid = 0;
+        }
+        SIM_OUT_OK();
+        if (sim_mqtt.connected) {
+            sim_mqtt.connected = 0;
+            sim_out_line("+SQNSMQTTONDISCONNECT: 0,0");
+            sim_stats.urcs++;
+        }
+    } else if (!strncmp(cmd, "SUBSCRIBE=", 10)) {
+        sim_parse_string(&args, topic, sizeof(topic));
+        if (!sim_mqtt.connected) {
+            SIM_OUT_ERROR();
+            return;
+        }
+        for (i = 0; i < SIM_MQTT_SUBS_MAX && sim_mqtt.subs[i][0] != '\0' && strcmp(sim_mqtt.subs[i], topic); i++) {}
+        if (i < SIM_MQTT_SUBS_MAX) {
+            strcpy(sim_mqtt.subs[i], topic);
+        }
+        SIM_OUT_OK();
+        sim_out_line("+SQNSMQTTONSUBSCRIBE: 0,\"%s\",%d", topic, i < SIM_MQTT_SUBS_MAX ? 0 : 1);
+        sim_stats.urcs++;
+    } else if (!strncmp(cmd, "PUBLISH=", 8)) {
+        sim_parse_string(&args, sim_mqtt.topic, sizeof(sim_mqtt.topic));
+        sim_parse_number(&args);                /* QoS, broker of simulation does not lose messages */
+        data_expected = sim_parse_number(&args);
+        if (!sim_mqtt.connected || data_expected == 0 || data_expected > sizeof(data_buff)) {
+            data_expected = 0;
+            SIM_OUT_ERROR();
+        } else {
+            data_conn = 0;
+            data_len = 0;
+            data_chars = 0;
+            SIM_OUT_STR(CRLF "> ");
+        }
+    } else if (!strncmp(cmd, "RCVMESSAGE=", 11)) {
+        sim_parse_string(&args, topic, sizeof(topic));
+        mid = sim_parse_number(&args);
+        for (i = 0, m = NULL; i < SIM_MQTT_MSGS_MAX; i++) {
+            if (sim_mqtt.msgs[i].mid != 0 && (mid == 0 || sim_mqtt.msgs[i].mid == mid)
+                && !strcmp(sim_mqtt.msgs[i].topic, topic)) {
+                m = &sim_mqtt.msgs[i];
+                break;
+            }
+        }
+        if (m == NULL) {
+            SIM_OUT_ERROR();                    /* Empty line, then ERROR */
+            return;
+        }
+        SIM_OUT_STR(CRLF);
+        sim_out(m->data, m->len);
+        SIM_OUT_OK();
+        sim_stats.sock_rx_bytes += GSM_U32(m->len);
+        sim_stats.mqtt_delivered++;
+        m->mid = 0;
+    } else {
+        SIM_OUT_OK();                           /* AT+SQNSMQTTCFG */
+    }
+}
+
+#endif /* GSM_CFG_SQNS_MQTT */
+
+/**
+ * \brief           Execute complete command line
+ */
+static void
+sim_cmd(const char* cmd) {
+    char host[64];
+    const char* args;
+    uint32_t conn, port;
+    sim_sock_t* s;
+    uint8_t ok;
+
+    if (strncmp(cmd, "AT", 2)) {
+        return;                                 /* Echo of garbage or empty line */
+    }
+    sim_stats.commands++;
+    cmd += 2;
+    args = strchr(cmd, '=');
+    args = args != NULL ? args + 1 : "";
+
+    if (!strncmp(cmd, "+SQNS", 5)) {
+        sim_stats.socket_commands++;
+    }
+    if (sim_setting_cmd(cmd, args)) {
+        return;                                 /* Setting read back */
+    }
+    if (!strncmp(cmd, "+CFUN=1,1", 9)) {
+        for (size_t i = 0; i < GSM_CFG_MAX_CONNS; i++) {
+            sim_socks[i].open = 0;
+            sim_socks[i].ring_pending = 0;
+            sim_socks[i].len = 0;
+        }
+#if GSM_CFG_SQNS_MQTT
+        GSM_MEMSET(&sim_mqtt, 0x00, sizeof(sim_mqtt));
+#endif /* GSM_CFG_SQNS_MQTT */
+        SIM_OUT_OK();
+        sim_evt_add(SIM_EVT_SYSSTART, 0, 0, sim_cfg.boot_time);
+    } else if (!strcmp(cmd, "+CGMI")) {
+        sim_out_line(SIM_MANUFACTURER);
+        SIM_OUT_OK();
+    } else if (!strcmp(cmd, "+CGMM")) {
+        sim_out_line(SIM_MODEL);
+        SIM_OUT_OK();
+    } else if (!strcmp(cmd, "+CGMR")) {
+        sim_out_line(SIM_REVISION);
+        SIM_OUT_OK();
+    } else if (!strcmp(cmd, "+CGSN")) {
+        sim_out_line(SIM_SERIAL);
+        SIM_OUT_OK();
+    } else if (!strcmp(cmd, "+CPIN?")) {
+        sim_out_line("+CPIN: READY");
+        SIM_OUT_OK();
+    } else if (!strcmp(cmd, "+CREG?")) {
+        sim_out_line("+CREG: 2,1");
+        SIM_OUT_OK();
+    } else if (!strcmp(cmd, "+CEREG?")) {
+        sim_out_line("+CEREG: 2,1");
+        SIM_OUT_OK();
+    } else if (!strcmp(cmd, "+CSQ")) {
+        sim_out_line("+CSQ: 20,99");
+        SIM_OUT_OK();
+    } else if (!strncmp(cmd, "+SQNDNSLKUP=", 12)) {
+        sim_parse_string(&args, host, sizeof(host));
+        sim_out_line("+SQNDNSLKUP: \"%s\",\"127.0.0.1\"", host);
+        SIM_OUT_OK();
+    } else if (!strncmp(cmd, "+SQNSCFGEXT=", 12)) {
+        /* connId, srMode, recvDataMode, keepalive, listenAutoRsp, sendDataMode */
+        conn = sim_parse_number(&args);
+        if ((s = sim_get_sock(conn)) != NULL) {
+            sim_parse_number(&args);
+            s->recv_hex = GSM_U8(sim_parse_number(&args) == 1);
+            sim_parse_number(&args);
+            sim_parse_number(&args);
+            s->send_hex = GSM_U8(sim_parse_number(&args) == 1);
+        }
+        SIM_OUT_OK();
+    } else if (!strncmp(cmd, "+SQNSD=", 7)) {
+        /* connId, txProt, rHostPort, IP, ... */
+        conn = sim_parse_number(&args);
+        sim_parse_number(&args);
+        port = sim_parse_number(&args);
+        sim_parse_string(&args, host, sizeof(host));
+        if ((s = sim_get_sock(conn)) == NULL || s->open) {
+            SIM_OUT_ERROR();
+        } else {
+            ok = 1;
+            if (sim_cfg.peer != NULL && sim_cfg.peer->connect_fn != NULL) {
+                ok = sim_cfg.peer->connect_fn(GSM_U8(conn), host, GSM_U16(port));
+            }
+            sim_evt_add(SIM_EVT_CONNECT, GSM_U8(conn), ok, 2 * sim_cfg.net_latency);
+        }
+    } else if (!strncmp(cmd, "+SQNSSENDEXT=", 13)) {
+        conn = sim_parse_number(&args);
+        data_expected = sim_parse_number(&args);
+        if ((s = sim_get_sock(conn)) == NULL || !s->open
+            || data_expected == 0 || data_expected > sizeof(data_buff)) {
+            data_expected = 0;
+            SIM_OUT_ERROR();
+        } else {
+            data_conn = GSM_U8(conn);
+            data_len = 0;
+            data_chars = 0;
+            SIM_OUT_STR(CRLF "> ");
+        }
+    } else if (!strncmp(cmd, "+SQNSRECV=", 10)) {
+        sim_cmd_sqnsrecv(args);
+    } else if (!strncmp(cmd, "+SQNSH=", 7)) {
+        conn = sim_parse_number(&args);
+        sim_sock_close(GSM_U8(conn), 0);
+        SIM_OUT_OK();
+#if GSM_CFG_SQNS_MQTT
+    } else if (!strncmp(cmd, "+SQNSMQTT", 9)) {
+        if (sim_parse_number(&args) != 0) {
+            SIM_OUT_ERROR();                    /* Only client 0 exists */
+        } else {
+            sim_cmd_mqtt(cmd + 9, args);
+        }
+#endif /* GSM_CFG_SQNS_MQTT */
+    } else {
+        SIM_OUT_OK();
+    }
+}
+
+/**
+ * \brief           Get value of hex character
+ */
+static uint8_t
+sim_hex_val(uint8_t ch) {
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
+    } else if (ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    } else if (ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + 10;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Send function, receives commands and socket data from the library
+ */
+static size_t
+sim_send(const void* data, size_t len) {
+    const uint8_t* d = data;
+    sim_sock_t* s;
+
+    if (d == NULL || len == 0) {
+        return 0;
+    }
+    gsm_core_lock();
+    sim_stats.at_tx_bytes += GSM_U32(len);
+    for (size_t i = 0; i < len; i++) {
+        if (data_expected > 0) {
+            s = sim_get_sock(data_conn);
+            if (s != NULL && s->send_hex) {
+                if (data_chars++ & 0x01) {
+                    data_buff[data_len] |= sim_hex_val(d[i]);
+                    data_len++;
+                } else {
+                    data_buff[data_len] = GSM_U8(sim_hex_val(d[i]) << 4);
+                }
+            } else {
+                data_buff[data_len++] = d[i];
+            }
+            if (data_len == data_expected) {
+                data_expected = 0;
+                sim_evt_add(SIM_EVT_DATA, data_conn, 0, sim_wire_time(data_chars > 0 ? data_chars : data_len) + sim_cfg.cmd_delay);
+            }
+        } else if (d[i] == '\r') {
+            cmd_line[cmd_len] = '\0';
+            strcpy(cmd_exec, cmd_line);
+            sim_evt_add(SIM_EVT_CMD, 0, 0, sim_wire_time(cmd_len + 1) + sim_cfg.cmd_delay);
+            cmd_len = 0;
+        } else if (d[i] != '\n' && cmd_len + 1 < sizeof(cmd_line)) {
+            cmd_line[cmd_len++] = d[i];
+        }
+    }
+    gsm_core_unlock();
+    return len;
+}
+
+/**
+ * \brief           Execute scheduled action
+ * \note            Called with core locked
+ */
+static void
+sim_evt_exec(sim_evt_t* e) {
+    sim_sock_t* s = sim_get_sock(e->conn);
+
+    switch (e->type) {
+        case SIM_EVT_CMD:
+            sim_cmd(cmd_exec);
+            break;
+        case SIM_EVT_DATA:
+#if GSM_CFG_SQNS_MQTT
+            if (e->conn == 0) {
+                sim_mqtt_published();
+                break;
+            }
+#endif /* GSM_CFG_SQNS_MQTT */
+            sim_stats.sock_tx_bytes += GSM_U32(data_len);
+            if (sim_cfg.peer != NULL && sim_cfg.peer->send_fn != NULL) {
+                sim_cfg.peer->send_fn(e->conn, data_buff, data_len);
+            } else {
+                gsm_ll_sim_peer_input(e->conn, data_buff, data_len);
+            }
+            SIM_OUT_OK();
+            break;
+        case SIM_EVT_SYSSTART:
+            sim_out_line("+SYSSTART");
+            sim_stats.urcs++;
+            break;
+        case SIM_EVT_CONNECT:
+            s->open = e->ok;
+            s->len = 0;
+            if (e->ok) {
+                SIM_OUT_OK();
+            } else {
+                SIM_OUT_STR(CRLF "NO CARRIER" CRLF);
+            }
+            break;
+        case SIM_EVT_RING:
+            if (s->open && s->len > 0 && !s->ring_pending) {
+                s->ring_pending = 1;
+                sim_out_line("+SQNSRING: %d,%d", (int)e->conn, (int)s->len);
+                sim_stats.urcs++;
+            }
+            break;
+        case SIM_EVT_CLOSE:
+            sim_sock_close(e->conn, 1);
+            break;
+#if GSM_CFG_SQNS_MQTT
+        case SIM_EVT_MQTT_CONNECT:
+            sim_mqtt.connected = e->ok;
+            sim_out_line("+SQNSMQTTONCONNECT: 0,%d", e->ok ? 0 : -1);
+            sim_stats.urcs++;
+            break;
+        case SIM_EVT_MQTT_MESSAGE: {
+            sim_mqtt_msg_t* m = &sim_mqtt.msgs[e->conn];
+
+            if (m->mid != 0) {
+                sim_out_line("+SQNSMQTTONMESSAGE: 0,\"%s\",%d,0,%d", m->topic, (int)m->len, (int)m->mid);
+                sim_stats.urcs++;
+            }
+            break;
+        }
+#endif /* GSM_CFG_SQNS_MQTT */
+        default:
+            break;
+    }
+    e->type = 0;
+}
+
+/**
+ * \brief           Read data announced by \`+SQNSRING\`, done by AT port thread on hardware
+ */
+static void
+sim_serve_rings(void) {
+    gsm_core_lock();
+    if (gsm.m.ring_list->first_ring != NULL && !gsm.m.ring_list->is_at_sqnsrecv_ongoing) {
+        gsmi_send_sqnsrecv();
+    }
+    gsm_core_unlock();
+}
+
+/**
+ * \brief           Simulation thread
+ * \param[in]       arg: Thread argument
+ */
+static void
+sim_thread(void* arg) {
+    uint8_t buff[SIM_RX_CHUNK_MAX];
+    uint32_t now, wait, left;
+    size_t n;
+
+    GSM_UNUSED(arg);
+    while (1) {
+        gsm_core_lock();
+        now = gsm_sys_now();
+        wait = 0;                               /* Forever */
+
+        /* Actions in order they were scheduled, output of earlier ones first */
+        for (size_t i = 0; i < GSM_ARRAYSIZE(sim_evts); i++) {
+            if (sim_evts[i].type) {
+                left = sim_evts[i].due - now;
+                if (GSM_I32(left) <= 0) {
+                    sim_evt_exec(&sim_evts[i]);
+                } else if (wait == 0 || left < wait) {
+                    wait = left;
+                }
+            }
+        }
+
+        /* Deliver outside of the lock, the library processes input under it */
+        n = GSM_MIN(out_len, sizeof(buff));
+        GSM_MEMCPY(buff, out_buff, n);
+        memmove(out_buff, &out_buff[n], out_len - n);
+        out_len -= n;
+        gsm_core_unlock();
+
+        if (n > 0) {
+            gsm_input_process(buff, n);
+            sim_stats.at_rx_bytes += GSM_U32(n);
+            sim_serve_rings();
+            gsm_delay(GSM_MAX(sim_wire_time(n), 1));
+        } else {
+            gsm_sys_sem_wait(&sim_sem, wait);
+        }
+    }
+}
+
+/**
+ * \brief           Configure simulated module
+ * \note            Must be called before \ref gsm_init
+ * \param[in]       cfg: Simulation configuration, copied. Set to `NULL` for defaults
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_sim_start(const gsm_ll_sim_cfg_t* cfg) {
+    if (sim_active) {
+        return gsmERR;
+    }
+    if (!gsm_sys_sem_isvalid(&sim_sem) && !gsm_sys_sem_create(&sim_sem, 0)) {
+        return gsmERRMEM;
+    }
+    if (cfg != NULL) {
+        sim_cfg = *cfg;
+    } else {
+        GSM_MEMSET(&sim_cfg, 0x00, sizeof(sim_cfg));
+    }
+    if (sim_cfg.boot_time == 0) {
+        sim_cfg.boot_time = SIM_DEFAULT_BOOT_TIME;
+    }
+    GSM_MEMSET(&sim_stats, 0x00, sizeof(sim_stats));
+    GSM_MEMSET(sim_evts, 0x00, sizeof(sim_evts));
+    GSM_MEMSET(sim_socks, 0x00, sizeof(sim_socks));
+#if GSM_CFG_SQNS_MQTT
+    GSM_MEMSET(&sim_mqtt, 0x00, sizeof(sim_mqtt));
+#endif /* GSM_CFG_SQNS_MQTT */
+    for (size_t i = 0; i < GSM_CFG_MAX_CONNS; i++) {
+        /* As left in module NVM by the socket setup of the application */
+        sim_socks[i].recv_hex = 1;
+        sim_socks[i].send_hex = 1;
+    }
+    out_len = 0;
+    cmd_len = 0;
+    data_expected = 0;
+    sim_active = 1;
+    return gsmOK;
+}
+
+/**
+ * \brief           Check if simulated module replaces the AT port
+ * \return          `1` if simulation is started, `0` otherwise
+ */
+uint8_t
+gsm_ll_sim_is_active(void) {
+    return sim_active;
+}
+
+/**
+ * \brief           Get simulation counters
+ * \param[out]      stats: Pointer to output result
+ */
+void
+gsm_ll_sim_get_stats(gsm_ll_sim_stats_t* stats) {
+    gsm_core_lock();
+    *stats = sim_stats;
+    gsm_core_unlock();
+}
+
+/**
+ * \brief           Data received from the peer on simulated socket
+ *
+ * `+SQNSRING` is sent after network latency and URC delay.
+ * Data not fitting in socket buffer is dropped
+ *
+ * \param[in]       conn: Connection ID, `1` based as in AT commands
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data in units of bytes
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_sim_peer_input(uint8_t conn, const void* data, size_t len) {
+    sim_sock_t* s = sim_get_sock(conn);
+    size_t n;
+
+    if (s == NULL) {
+        return gsmPARERR;
+    }
+    gsm_core_lock();
+    if (!s->open) {
+        gsm_core_unlock();
+        return gsmCLOSED;
+    }
+    if (s->len == 0) {
+        s->arrival = gsm_sys_now() + sim_cfg.net_latency;
+    }
+    n = GSM_MIN(len, sizeof(s->buff) - s->len);
+    GSM_MEMCPY(&s->buff[s->len], data, n);
+    s->len += n;
+    sim_stats.sock_dropped += GSM_U32(len - n);
+    sim_evt_add(SIM_EVT_RING, conn, 0, sim_cfg.net_latency + sim_cfg.urc_delay);
+    gsm_core_unlock();
+    return gsmOK;
+}
+
+/**
+ * \brief           Close simulated socket from the peer side, module sends `+SQNSH`
+ * \param[in]       conn: Connection ID, `1` based as in AT commands
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_sim_peer_close(uint8_t conn) {
+    if (sim_get_sock(conn) == NULL) {
+        return gsmPARERR;
+    }
+    gsm_core_lock();
+    sim_evt_add(SIM_EVT_CLOSE, conn, 0, sim_cfg.net_latency);
+    gsm_core_unlock();
+    return gsmOK;
+}
+
+#if GSM_CFG_SQNS_MQTT || __DOXYGEN__
+
+/**
+ * \brief           Message published by the broker to the MQTT client of simulated module
+ *
+ * `+SQNSMQTTONMESSAGE` is sent after network latency and URC delay,
+ * whether the topic was subscribed to is left to the caller
+ *
+ * \param[in]       topic: Message topic
+ * \param[in]       data: Payload
+ * \param[in]       len: Length of payload in units of bytes
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_sim_mqtt_input(const char* topic, const void* data, size_t len) {
+    gsmr_t res;
+
+    if (topic == NULL || (data == NULL && len > 0)) {
+        return gsmPARERR;
+    }
+    gsm_core_lock();
+    if (!sim_mqtt.connected) {
+        gsm_core_unlock();
+        return gsmCLOSED;
+    }
+    res = sim_mqtt_deliver(topic, data, len, sim_cfg.net_latency);
+    gsm_core_unlock();
+    return res;
+}
+
+#endif /* GSM_CFG_SQNS_MQTT || __DOXYGEN__ */
+
+/**
+ * \brief           Low-level init for simulated module, called by low-level driver when simulation is active
+ * \note            Called again on AT port baudrate change
+ * \param[in,out]   ll: Pointer to \ref gsm_ll_t structure to fill data for communication functions
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_sim_init(gsm_ll_t* ll) {
+    /* Baudrate change calls it again, trace and stats wrappers chain to the installed function */
+    if (sim_thread_id == NULL) {
+        ll->send_fn = sim_send;
+        ll->reset_fn = NULL;
+    }
+    sim_baudrate = sim_cfg.baudrate > 0 ? sim_cfg.baudrate : ll->uart.baudrate;
+    if (sim_baudrate == 0) {
+        sim_baudrate = SIM_DEFAULT_BAUDRATE;
+    }
+    if (sim_thread_id == NULL
+        && !gsm_sys_thread_create(&sim_thread_id, "gsm_sim", sim_thread, NULL, SIM_THREAD_STACKSIZE, GSM_SYS_THREAD_PRIO)) {
+        return gsmERRMEM;
+    }
+    return gsmOK;
+}
+
+/**
+ * \brief           Low-level de-init for simulated module
+ * \param[in,out]   ll: Pointer to \ref gsm_ll_t structure
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+gsm_ll_sim_deinit(gsm_ll_t* ll) {
+    if (sim_thread_id != NULL) {
+        gsm_sys_thread_terminate(&sim_thread_id);
+    }
+    sim_thread_id = NULL;
+    sim_active = 0;
+    GSM_UNUSED(ll);
+    return gsmOK;
+}
+
+#endif /* GSM_CFG_LL_SIM || __DOXYGEN__ */
@@ -0,0 +1,573 @@
+/**
+ * \file            gsm_sys_posix.c
+ * \brief           System dependant functions for POSIX threads
+ */
+
+/*
+ * Copyright (c) 2019 Tilen MAJERLE
+ * Copyright 2020 NXP
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of GSM-AT library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v0.6.0
+ */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <errno.h>
+#include "gsm_sys.h"
+
+#if GSM_CFG_SYS_PORT == GSM_SYS_PORT_POSIX && !__DOXYGEN__
+
+struct gsm_sys_posix_mutex {
+    pthread_mutex_t m;
+};
+
+struct gsm_sys_posix_sem {
+    pthread_mutex_t m;
+    pthread_cond_t cv;
+    uint8_t token;                              /* Binary semaphore, one token at most */
+};
+
+struct gsm_sys_posix_mbox {
+    pthread_mutex_t m;
+    pthread_cond_t cv;                          /* Signalled on every put and get */
+    size_t size, in, out, count;
+    void* entries[];
+};
+
+struct gsm_sys_posix_thread {
+    pthread_t id;
+    gsm_sys_thread_fn fn;
+    void* arg;
+};
+
+static gsm_sys_mutex_t sys_mutex;               /* Mutex ID for main protection */
+static __thread gsm_sys_thread_t sys_self;      /* Handle of calling thread, created by this port */
+
+/**
+ * \brief           Initialize condition variable on monotonic clock
+ */
+static void
+posix_cond_init(pthread_cond_t* cv) {
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cv, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+/**
+ * \brief           Unlock mutex of a wait, when a thread is cancelled in it
+ */
+static void
+posix_wait_cleanup(void* arg) {
+    pthread_mutex_unlock(arg);
+}
+
+/**
+ * \brief           Get absolute monotonic time timeout milliseconds from now
+ */
+static struct timespec
+posix_deadline(uint32_t timeout) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += timeout / 1000;
+    ts.tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+/**
+ * \brief           Elapsed time since start, `1` at least to differ from \ref GSM_SYS_TIMEOUT
+ */
+static uint32_t
+posix_elapsed(uint32_t start) {
+    uint32_t elapsed = gsm_sys_now() - start;
+    return elapsed > 0 ? elapsed : 1;
+}
+
+/**
+ * \brief           Init system dependant parameters
+ * \note            Called from high-level application layer when required
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_init(void) {
+    return gsm_sys_mutex_create(&sys_mutex);    /* Create system mutex */
+}
+
+/**
+ * \brief           Get current time in units of milliseconds
+ * \return          Current time in units of milliseconds
+ */
+uint32_t
+gsm_sys_now(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U);
+}
+
+/**
+ * \brief           Protect stack core
+ * \note            This function may be called multiple times, recursive protection is required
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_protect(void) {
+    return gsm_sys_mutex_lock(&sys_mutex);
+}
+
+/**
+ * \brief           Unprotect stack core
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_unprotect(void) {
+    return gsm_sys_mutex_unlock(&sys_mutex);
+}
+
+/**
+ * \brief           Create a new recursive mutex
+ * \param[out]      p: Pointer to mutex structure to save result to
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mutex_create(gsm_sys_mutex_t* p) {
+    pthread_mutexattr_t attr;
+
+    *p = malloc(sizeof(**p));
+    if (*p == NULL) {
+        return 0;
+    }
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&(*p)->m, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return 1;
+}
+
+/**
+ * \brief           Delete mutex
+ * \param[in]       p: Pointer to mutex structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mutex_delete(gsm_sys_mutex_t* p) {
+    pthread_mutex_destroy(&(*p)->m);
+    free(*p);
+    return 1;
+}
+
+/**
+ * \brief           Wait forever to lock the mutex
+ * \param[in]       p: Pointer to mutex structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mutex_lock(gsm_sys_mutex_t* p) {
+    return pthread_mutex_lock(&(*p)->m) == 0;
+}
+
+/**
+ * \brief           Unlock mutex
+ * \param[in]       p: Pointer to mutex structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mutex_unlock(gsm_sys_mutex_t* p) {
+    return pthread_mutex_unlock(&(*p)->m) == 0;
+}
+
+/**
+ * \brief           Check if mutex structure is valid
+ * \param[in]       p: Pointer to mutex structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mutex_isvalid(gsm_sys_mutex_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+/**
+ * \brief           Set mutex structure as invalid
+ * \param[in]       p: Pointer to mutex structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mutex_invalid(gsm_sys_mutex_t* p) {
+    *p = GSM_SYS_MUTEX_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Create a new binary semaphore and set initial state
+ * \param[out]      p: Pointer to semaphore structure to fill with result
+ * \param[in]       cnt: `0` to create it taken, `1` to leave it available
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_sem_create(gsm_sys_sem_t* p, uint8_t cnt) {
+    *p = malloc(sizeof(**p));
+    if (*p == NULL) {
+        return 0;
+    }
+    pthread_mutex_init(&(*p)->m, NULL);
+    posix_cond_init(&(*p)->cv);
+    (*p)->token = cnt > 0;
+    return 1;
+}
+
+/**
+ * \brief           Delete binary semaphore
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_sem_delete(gsm_sys_sem_t* p) {
+    pthread_cond_destroy(&(*p)->cv);
+    pthread_mutex_destroy(&(*p)->m);
+    free(*p);
+    return 1;
+}
+
+/**
+ * \brief           Wait for semaphore to be available
+ * \param[in]       p: Pointer to semaphore structure
+ * \param[in]       timeout: Timeout to wait in milliseconds. When 0 is applied, wait forever
+ * \return          Number of milliseconds waited, \ref GSM_SYS_TIMEOUT on timeout
+ */
+uint32_t
+gsm_sys_sem_wait(gsm_sys_sem_t* p, uint32_t timeout) {
+    struct gsm_sys_posix_sem* s = *p;
+    struct timespec ts = posix_deadline(timeout);
+    uint32_t start = gsm_sys_now();
+    uint8_t got;
+    int err = 0;
+
+    pthread_mutex_lock(&s->m);
+    pthread_cleanup_push(posix_wait_cleanup, &s->m);
+    while (!s->token && err != ETIMEDOUT) {
+        err = timeout == 0 ? pthread_cond_wait(&s->cv, &s->m) : pthread_cond_timedwait(&s->cv, &s->m, &ts);
+    }
+    got = s->token;
+    s->token = 0;
+    pthread_cleanup_pop(1);
+    return got ? posix_elapsed(start) : GSM_SYS_TIMEOUT;
+}
+
+/**
+ * \brief           Release semaphore
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_sem_release(gsm_sys_sem_t* p) {
+    struct gsm_sys_posix_sem* s = *p;
+
+    pthread_mutex_lock(&s->m);
+    s->token = 1;
+    pthread_cond_signal(&s->cv);
+    pthread_mutex_unlock(&s->m);
+    return 1;
+}
+
+/**
+ * \brief           Check if semaphore is valid
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_sem_isvalid(gsm_sys_sem_t* p) {
+    return p != NULL && *p != NULL;
+}
+
+/**
+ * \brief           Invalid semaphore
+ * \param[in]       p: Pointer to semaphore structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_sem_invalid(gsm_sys_sem_t* p) {
+    *p = GSM_SYS_SEM_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Create a new message queue of pointers
+ * \param[out]      b: Pointer to message queue structure
+ * \param[in]       QueueLength: Number of entries for message queue to hold
+ * \param[in]       ItemSize: Size of items, only `sizeof(void *)` is supported
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mbox_create(gsm_sys_mbox_t* b, size_t QueueLength, size_t ItemSize) {
+    if (ItemSize != sizeof(void*) || QueueLength == 0) {
+        return 0;
+    }
+    *b = malloc(sizeof(**b) + QueueLength * sizeof(void*));
+    if (*b == NULL) {
+        return 0;
+    }
+    pthread_mutex_init(&(*b)->m, NULL);
+    posix_cond_init(&(*b)->cv);
+    (*b)->size = QueueLength;
+    (*b)->in = (*b)->out = (*b)->count = 0;
+    return 1;
+}
+
+/**
+ * \brief           Delete message queue
+ * \param[in]       b: Pointer to message queue structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mbox_delete(gsm_sys_mbox_t* b) {
+    if ((*b)->count > 0) {                      /* We still have messages in queue, should not delete queue */
+        return 0;
+    }
+    pthread_cond_destroy(&(*b)->cv);
+    pthread_mutex_destroy(&(*b)->m);
+    free(*b);
+    return 1;
+}
+
+/**
+ * \brief           Put a new entry to message queue and wait until memory available
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to entry to insert to message queue
+ * \return          Time in units of milliseconds needed to put a message to queue
+ */
+uint32_t
+gsm_sys_mbox_put(gsm_sys_mbox_t* b, void* m) {
+    struct gsm_sys_posix_mbox* q = *b;
+    uint32_t start = gsm_sys_now();
+
+    pthread_mutex_lock(&q->m);
+    pthread_cleanup_push(posix_wait_cleanup, &q->m);
+    while (q->count == q->size) {
+        pthread_cond_wait(&q->cv, &q->m);
+    }
+    q->entries[q->in] = m;
+    q->in = (q->in + 1) % q->size;
+    q->count++;
+    pthread_cond_broadcast(&q->cv);
+    pthread_cleanup_pop(1);
+    return posix_elapsed(start);
+}
+
+/**
+ * \brief           Get a new entry from message queue with timeout
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to pointer to result to save value from message queue to
+ * \param[in]       timeout: Maximal timeout to wait for new message. When 0 is applied, wait for unlimited time
+ * \return          Time in units of milliseconds needed to get a message, \ref GSM_SYS_TIMEOUT on timeout
+ */
+uint32_t
+gsm_sys_mbox_get(gsm_sys_mbox_t* b, void** m, uint32_t timeout) {
+    struct gsm_sys_posix_mbox* q = *b;
+    struct timespec ts = posix_deadline(timeout);
+    uint32_t start = gsm_sys_now();
+    uint8_t got;
+    int err = 0;
+
+    pthread_mutex_lock(&q->m);
+    pthread_cleanup_push(posix_wait_cleanup, &q->m);
+    while (q->count == 0 && err != ETIMEDOUT) {
+        err = timeout == 0 ? pthread_cond_wait(&q->cv, &q->m) : pthread_cond_timedwait(&q->cv, &q->m, &ts);
+    }
+    got = q->count > 0;
+    if (got) {
+        *m = q->entries[q->out];
+        q->out = (q->out + 1) % q->size;
+        q->count--;
+        pthread_cond_broadcast(&q->cv);
+    }
+    pthread_cleanup_pop(1);
+    return got ? posix_elapsed(start) : GSM_SYS_TIMEOUT;
+}
+
+/**
+ * \brief           Put a new entry to message queue without timeout (now or fail)
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to message to save to queue
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mbox_putnow(gsm_sys_mbox_t* b, void* m) {
+    struct gsm_sys_posix_mbox* q = *b;
+    uint8_t res = 0;
+
+    pthread_mutex_lock(&q->m);
+    if (q->count < q->size) {
+        q->entries[q->in] = m;
+        q->in = (q->in + 1) % q->size;
+        q->count++;
+        pthread_cond_broadcast(&q->cv);
+        res = 1;
+    }
+    pthread_mutex_unlock(&q->m);
+    return res;
+}
+
+/**
+ * \brief           Get an entry from message queue immediately
+ * \param[in]       b: Pointer to message queue structure
+ * \param[in]       m: Pointer to pointer to result to save value from message queue to
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mbox_getnow(gsm_sys_mbox_t* b, void** m) {
+    struct gsm_sys_posix_mbox* q = *b;
+    uint8_t res = 0;
+
+    pthread_mutex_lock(&q->m);
+    if (q->count > 0) {
+        *m = q->entries[q->out];
+        q->out = (q->out + 1) % q->size;
+        q->count--;
+        pthread_cond_broadcast(&q->cv);
+        res = 1;
+    }
+    pthread_mutex_unlock(&q->m);
+    return res;
+}
+
+/**
+ * \brief           Check if message queue is valid
+ * \param[in]       b: Pointer to message queue structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mbox_isvalid(gsm_sys_mbox_t* b) {
+    return b != NULL && *b != NULL;
+}
+
+/**
+ * \brief           Invalid message queue
+ * \param[in]       b: Pointer to message queue structure
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_mbox_invalid(gsm_sys_mbox_t* b) {
+    *b = GSM_SYS_MBOX_NULL;
+    return 1;
+}
+
+/**
+ * \brief           Release thread handle when thread exits or is cancelled
+ */
+static void
+posix_thread_cleanup(void* arg) {
+    sys_self = NULL;
+    free(arg);
+}
+
+/**
+ * \brief           Thread entry, keeps handle of the thread for self termination
+ */
+static void*
+posix_thread_entry(void* arg) {
+    sys_self = arg;
+    pthread_cleanup_push(posix_thread_cleanup, arg);
+    sys_self->fn(sys_self->arg);
+    pthread_cleanup_pop(1);
+    return NULL;
+}
+
+/**
+ * \brief           Create a new detached thread
+ * \param[out]      t: Pointer to thread identifier if create was successful, may be `NULL`
+ * \param[in]       name: Name of a new thread
+ * \param[in]       thread_func: Thread function to use as thread body
+ * \param[in]       arg: Thread function argument
+ * \param[in]       stack_size: Ignored, default stack size is used
+ * \param[in]       prio: Ignored, threads run with default scheduling
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_thread_create(gsm_sys_thread_t* t, const char* name, gsm_sys_thread_fn thread_func, void* const arg, size_t stack_size, gsm_sys_thread_prio_t prio) {
+    gsm_sys_thread_t thread;
+
+    (void)stack_size;
+    (void)prio;
+    thread = malloc(sizeof(*thread));
+    if (thread == NULL) {
+        return 0;
+    }
+    thread->fn = thread_func;
+    thread->arg = arg;
+    if (t != NULL) {
+        *t = thread;                            /* Set before start, thread may use it immediately */
+    }
+    if (pthread_create(&thread->id, NULL, posix_thread_entry, thread) != 0) {
+        if (t != NULL) {
+            *t = NULL;
+        }
+        free(thread);
+        return 0;
+    }
+    pthread_detach(thread->id);
+    pthread_setname_np(thread->id, name);
+    return 1;
+}
+
+/**
+ * \brief           Terminate thread (shut it down and remove)
+ * \note            Other threads are cancelled, this is only safe when they wait outside core lock
+ * \param[in]       t: Pointer to thread handle to terminate. If set to NULL, terminate current thread
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_thread_terminate(gsm_sys_thread_t* t) {
+    gsm_sys_thread_t thread = t != NULL ? *t : sys_self;
+
+    if (thread == NULL) {
+        return 0;
+    }
+    if (thread == sys_self) {
+        pthread_exit(NULL);                     /* Handle is released by cleanup handler */
+    }
+    pthread_cancel(thread->id);
+    return 1;
+}
+
+/**
+ * \brief           Yield current thread
+ * \return          1 on success, 0 otherwise
+ */
+uint8_t
+gsm_sys_thread_yield(void) {
+    sched_yield();
+    return 1;
+}
+
+#endif /* GSM_CFG_SYS_PORT == GSM_SYS_PORT_POSIX && !__DOXYGEN__ */
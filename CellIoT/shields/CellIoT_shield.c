@@ -22,21 +22,44 @@ usart_dma_handle_t g_uartDmaHandle;
 dma_handle_t g_uartTxDmaHandle;
 dma_handle_t g_uartRxDmaHandle;
 dma_handle_t g_timerTransferHandle;
-/* MRT Register value that will be pushed to MRT INTVAL register when USART RX will pace DMA CH10 */
-const uint32_t timerRegisterValue = /*0x80000100*/ 0x800F4240;
+/* MRT Register value that will be pushed to MRT INTVAL register when USART RX will pace DMA CH10
+ * Rewritten by CELLIOTSHIELD_SetIdleTimeout() each time the baudrate changes
+ */
+volatile uint32_t timerRegisterValue = /*0x80000100*/ 0x800F4240;
 
 ctimer_callback_t ctimer_callback_table[] = { Timer_CallbackHandler };
 
-/*! @brief Static table of descriptors */
+/*! @brief Static table of descriptors
+ *  [0] reloads the MRT on each received byte, [1..n] fill the segments of the RX ring
+ */
+#define CELLIOTSHIELD_DMA_DESC_NB (1U + CELLIOTSHIELD_USART_RX_SEGMENTS)
 #if defined(__ICCARM__)
 #pragma data_alignment              = 16
-dma_descriptor_t g_pingpong_desc;
+dma_descriptor_t g_pingpong_desc[CELLIOTSHIELD_DMA_DESC_NB];
 #elif defined(__CC_ARM) || defined(__ARMCC_VERSION)
-__attribute__((aligned(16))) dma_descriptor_t g_pingpong_desc;
+__attribute__((aligned(16))) dma_descriptor_t g_pingpong_desc[CELLIOTSHIELD_DMA_DESC_NB];
 #elif defined(__GNUC__)
-__attribute__((aligned(16))) dma_descriptor_t g_pingpong_desc[3];
+__attribute__((aligned(16))) dma_descriptor_t g_pingpong_desc[CELLIOTSHIELD_DMA_DESC_NB];
 #endif
 
+/*!
+ * @brief Set the RX idle-line timeout to CELLIOTSHIELD_USART_IDLE_CHARS character times.
+ *
+ * The MRT is reloaded with this value on every received byte, so it expires
+ * once the line has been silent for that long and the RX thread is woken.
+ */
+static void CELLIOTSHIELD_SetIdleTimeout( uint32_t baudrate )
+{
+	/* 10 bits per character: start, 8 data, stop */
+	uint64_t ticks = ((uint64_t)CLOCK_GetFreq(kCLOCK_BusClk) * (CELLIOTSHIELD_USART_IDLE_CHARS * 10U)) / baudrate;
+
+	if (ticks > MRT_CHANNEL_INTVAL_IVALUE_MASK)
+	{
+		ticks = MRT_CHANNEL_INTVAL_IVALUE_MASK;
+	}
+	timerRegisterValue = MRT_CHANNEL_INTVAL_LOAD_MASK | MRT_CHANNEL_INTVAL_IVALUE((uint32_t)ticks);
+}
+
 /*!
  * @brief Low level initialization, RTOS does not have to run yet
  */
@@ -96,6 +119,44 @@ int CELLIOTSHIELD_USARTConfig( uint32_t baudrate )
 	/* Enable DMA request from rxFIFO */
 	USART_EnableRxDMA(CELLIOTSHIELD_USART, true);
 
+	CELLIOTSHIELD_SetIdleTimeout(baudrate);
+
+	return kStatus_Success;
+}
+
+/**
+ * @brief Change the USART baudrate without touching the RX DMA chain.
+ *
+ * The pending TX transfer is drained first so no character straddles the switch,
+ * the receiver keeps feeding the ring buffers and only the divider is reloaded.
+ */
+int CELLIOTSHIELD_USARTSetBaudrate( uint32_t baudrate )
+{
+	status_t status;
+
+	/* Wait for the last DMA transfer and the shift register to be empty */
+	while (CELLIOTSHIELD_DMA_HANDLE.txState != 0U)	/* kUSART_TxIdle */
+	{
+	}
+	while ((USART_GetStatusFlags(CELLIOTSHIELD_USART) & kUSART_TxFifoEmptyFlag) == 0U)
+	{
+	}
+	while ((CELLIOTSHIELD_USART->STAT & USART_STAT_TXIDLE_MASK) == 0U)
+	{
+	}
+
+	/* The divider may only be written while the USART is disabled */
+	CELLIOTSHIELD_USART->CFG &= ~USART_CFG_ENABLE_MASK;
+	status = USART_SetBaudRate(CELLIOTSHIELD_USART, baudrate, CLOCK_GetFlexCommClkFreq(USART_GetInstance(CELLIOTSHIELD_USART)));
+	CELLIOTSHIELD_USART->CFG |= USART_CFG_ENABLE_MASK;
+
+	if (status != kStatus_Success)
+	{
+		return kStatus_InvalidArgument;
+	}
+
+	CELLIOTSHIELD_SetIdleTimeout(baudrate);
+
 	return kStatus_Success;
 }
 
@@ -105,6 +166,7 @@ int CELLIOTSHIELD_USARTConfig( uint32_t baudrate )
 int CELLIOTSHIELD_DMAConfig( void )
 {
 	dma_transfer_config_t transferConfig[2];
+	uint32_t segment;
 	dma_channel_trigger_t channel0HwTrg = { kDMA_FallingEdgeTrigger, kDMA_EdgeBurstTransfer1, kDMA_SrcWrap };
 	dma_channel_trigger_t channel10HwTrg = { kDMA_FallingEdgeTrigger, kDMA_EdgeBurstTransfer1, kDMA_NoWrap };
 
@@ -130,7 +192,7 @@ int CELLIOTSHIELD_DMAConfig( void )
 	DMA_DisableChannelInterrupts(CELLIOTSHIELD_DMA, CELLIOTSHIELD_DMA_RX_CH);
 
 	/* Create USART DMA handle */
-	USART_TransferCreateHandleDMA(CELLIOTSHIELD_USART, &g_uartDmaHandle, NULL, NULL, &g_uartTxDmaHandle, NULL);
+	USART_TransferCreateHandleDMA(CELLIOTSHIELD_USART, &g_uartDmaHandle, USART_TxCallbackHandler, NULL, &g_uartTxDmaHandle, NULL);
 
 	/* Set Channel 0 DMA Callback */
 	DMA_SetCallback(&g_timerTransferHandle, DMA_Callback, NULL);
@@ -141,7 +203,7 @@ int CELLIOTSHIELD_DMAConfig( void )
 	 * --> Transfer configuration hold by transferConfig[0]
 	 * --> Next descriptor hold by g_pingpong_desc[0]
 	 */
-	DMA_PrepareTransfer(&transferConfig[0], (void *)&timerRegisterValue, ((void *)((uint32_t)&MRT0->CHANNEL[0].INTVAL)), sizeof(uint32_t),
+	DMA_PrepareTransfer(&transferConfig[0], (void *)(uint32_t)&timerRegisterValue, ((void *)((uint32_t)&MRT0->CHANNEL[0].INTVAL)), sizeof(uint32_t),
 						sizeof(uint32_t), kDMA_MemoryToMemory, &g_pingpong_desc[0]);
 
 	/* Load the DMA Channel 10 configuration
@@ -172,7 +234,7 @@ int CELLIOTSHIELD_DMAConfig( void )
 	DMA_SetChannelConfig(CELLIOTSHIELD_DMA, CELLIOTSHIELD_DMA_RX_CH, &channel10HwTrg, true);
 
 	/* Configure the DMA Channel 10 Descriptor */
-    DMA_CreateDescriptor(&g_pingpong_desc[0], &transferConfig[0].xfercfg, (void *)&timerRegisterValue, ((void *)((uint32_t)&MRT0->CHANNEL[0].INTVAL)),
+    DMA_CreateDescriptor(&g_pingpong_desc[0], &transferConfig[0].xfercfg, (void *)(uint32_t)&timerRegisterValue, ((void *)((uint32_t)&MRT0->CHANNEL[0].INTVAL)),
 						 &g_pingpong_desc[0]);
 
 	/* Attach the trigger output of DMA0 Channel 10 to be DMA Output Trigger 0 (DMA0_OTRIG_INMUX[0])
@@ -192,12 +254,13 @@ int CELLIOTSHIELD_DMAConfig( void )
 
 	/* Prepare transfer of DMA Channel 0
 	 * --> Peripheral to Memory transfer
-	 * --> Write the content of RX FIFO to USART RX buffers
+	 * --> Write the content of RX FIFO to the 1st segment of the USART RX ring
 	 * --> Transfer configuration hold by transferConfig[1]
-	 * --> Next descriptor hold by g_pingpong_desc[2]
+	 * --> Next descriptor is the one of the 2nd segment
 	 */
-	DMA_PrepareTransfer(&transferConfig[1], ((void *)((uint32_t)&CELLIOTSHIELD_USART->FIFORD)), CELLIOTSHIELD_USART_RX_BUFFER, sizeof(uint8_t),
-						sizeof(CELLIOTSHIELD_USART_RX_BUFFER) - 1, kDMA_PeripheralToMemory, &g_pingpong_desc[2]);
+	DMA_PrepareTransfer(&transferConfig[1], ((void *)((uint32_t)&CELLIOTSHIELD_USART->FIFORD)), CELLIOTSHIELD_USART_RX_RING, sizeof(uint8_t),
+						CELLIOTSHIELD_USART_RX_SEGMENT_SIZE, kDMA_PeripheralToMemory,
+						&g_pingpong_desc[1U + (1U % CELLIOTSHIELD_USART_RX_SEGMENTS)]);
 
 	/* Load the DMA0 Channel 0 configuration
 	 * - Even if DMA Channel 0 is going to do a Peripheral to Memory transfer,
@@ -222,17 +285,18 @@ int CELLIOTSHIELD_DMAConfig( void )
 	 */
 	DMA_SetChannelConfig(CELLIOTSHIELD_DMA, CELLIOTSHIELD_DMA_SPARE_CH, &channel0HwTrg, false);
 
-	/* Configure the DMA Channel 0 1st Descriptor */
+	/* Configure the DMA Channel 0 segment descriptors as a closed chain
+	 * Every segment raises INTA when it is full so DMA_Callback() can count them,
+	 * the last one links back to the 1st so the ring never stops
+	 */
 	transferConfig[1].xfercfg.intA = true;
 	transferConfig[1].xfercfg.intB = false;
-	DMA_CreateDescriptor(&g_pingpong_desc[1], &transferConfig[1].xfercfg, (void *)&CELLIOTSHIELD_USART->FIFORD, CELLIOTSHIELD_USART_RX_BUFFER,
-						 &g_pingpong_desc[2]);
-
-	/* Configure the DMA Channel 0 2nd Descriptor */
-	transferConfig[1].xfercfg.intA = false;
-	transferConfig[1].xfercfg.intB = true;
-	DMA_CreateDescriptor(&g_pingpong_desc[2], &transferConfig[1].xfercfg, (void *)&CELLIOTSHIELD_USART->FIFORD, CELLIOTSHIELD_USART_RING_BUFFER,
-						 &g_pingpong_desc[1]);
+	for (segment = 0U; segment < CELLIOTSHIELD_USART_RX_SEGMENTS; segment++)
+	{
+		DMA_CreateDescriptor(&g_pingpong_desc[1U + segment], &transferConfig[1].xfercfg, (void *)&CELLIOTSHIELD_USART->FIFORD,
+							 &CELLIOTSHIELD_USART_RX_RING[segment * CELLIOTSHIELD_USART_RX_SEGMENT_SIZE],
+							 &g_pingpong_desc[1U + ((segment + 1U) % CELLIOTSHIELD_USART_RX_SEGMENTS)]);
+	}
 
 	/* Set the Software Trigger of DMA Channel 10
 	 * DMA Channel 10 needs a software trigger to initiate a 1st trigger
@@ -260,7 +324,8 @@ int CELLIOTSHIELD_TimerConfig( void )
 	/* Enable timer interrupts for channel 0 */
 	MRT_EnableInterrupts(MRT0, kMRT_Channel_0, kMRT_TimerInterruptEnable);
 
-	/* Enable at the NVIC */
+	/* Enable at the NVIC, the handler posts to an RTOS queue */
+	NVIC_SetPriority(MRT0_IRQn, CELLIOTSHIELD_UART_IRQ_PRIORITY);
 	EnableIRQ(MRT0_IRQn);
 
 	return kStatus_Success;
@@ -42,9 +42,15 @@
 #   define CELLIOTSHIELD_WLAN_IRQ_PRIORITY (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1)
 #endif
 
+/* RX idle-line timeout, in character times at the current baudrate */
+#ifndef CELLIOTSHIELD_USART_IDLE_CHARS
+#   define CELLIOTSHIELD_USART_IDLE_CHARS (4U)
+#endif
+
 /* Fn prototypes, which need to be implemented */
 int CELLIOTSHIELD_Init( uint32_t baudrate );
 int CELLIOTSHIELD_USARTConfig( uint32_t baudrate );
+int CELLIOTSHIELD_USARTSetBaudrate( uint32_t baudrate );
 int CELLIOTSHIELD_DMAConfig( void );
 int CELLIOTSHIELD_TimerConfig( void );
 
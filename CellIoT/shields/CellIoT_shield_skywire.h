@@ -41,9 +41,11 @@ extern dma_handle_t g_timerTransferHandle;
 #define CELLIOTSHIELD_USART_IRQ_PRIORITY (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY)
 #define CELLIOTSHIELD_USART_RTOS_HANDLE (g_uartRtosHandle)
 #define CELLIOTSHIELD_USART_HANDLE (g_uartHandle)
-#define CELLIOTSHIELD_USART_RING_BUFFER (g_rxRingBuffer)
 #define CELLIOTSHIELD_USART_TX_BUFFER (g_txBuffer)
-#define CELLIOTSHIELD_USART_RX_BUFFER (g_rxBuffer)
+#define CELLIOTSHIELD_USART_RX_RING (g_rxRing)
+#define CELLIOTSHIELD_USART_RX_RING_SIZE (AT_RX_RING_SIZE)
+#define CELLIOTSHIELD_USART_RX_SEGMENT_SIZE (AT_RX_SEGMENT_SIZE)
+#define CELLIOTSHIELD_USART_RX_SEGMENTS (AT_RX_RING_SIZE / AT_RX_SEGMENT_SIZE)
 #define CELLIOTSHIELD_USART_BUFFER_SIZE (AT_BUFFER_SIZE)
 #define CELLIOTSHIELD_USART_QUEUE_SIZE (10U)
 
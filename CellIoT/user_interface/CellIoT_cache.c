@@ -0,0 +1,302 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "CellIoT_cache.h"
+#include "CellIoT_lib.h"
+#include "gsm_device_info.h"
+#include "mflash_file.h"
+
+typedef struct
+{
+	uint8_t ucItem;							/* CellIoTCacheItem_t, 0 for a free entry */
+	uint8_t ucIndex;
+	uint8_t ucDigest[DIGEST_SHA256_SIZE];
+	uint8_t ucReadBack[DIGEST_SHA256_SIZE];	/* SHA-256 of the settings as the module listed them after the write */
+} CellIoTCacheEntry_t;
+
+typedef struct
+{
+	uint32_t ulVersion;
+	gsm_device_identity_t xIdentity;		/* module the entries were written to */
+	CellIoTCacheEntry_t xEntries[CELLIOT_CACHE_ENTRIES];
+	uint8_t ucHash[DIGEST_SHA256_SIZE];		/* SHA-256 of all the fields above */
+} CellIoTCacheSnapshot_t;
+
+/* Flash file table, shared with the PKCS#11 storage */
+extern mflash_file_t g_cert_files[];
+
+static CellIoTCacheSnapshot_t xCache;
+static SemaphoreHandle_t xCacheMutex;
+
+/* Set once the identity of the module answering is known to match the snapshot */
+static bool xCacheConfirmed;
+static bool xStorageReady;
+
+/* Bit n set once entry n was read back from the module since it booted */
+static uint32_t ulReadBackDone;
+#if CELLIOT_CACHE_ENTRIES > 32
+#error "CELLIOT_CACHE_ENTRIES must fit in the read-back bitmask"
+#endif
+
+
+static void prvHash(uint8_t hash[DIGEST_SHA256_SIZE])
+{
+	DIGEST_Sha256((const uint8_t *) &xCache, offsetof(CellIoTCacheSnapshot_t, ucHash), hash);
+}
+
+static void prvSave(void)
+{
+	if( xStorageReady )
+	{
+		prvHash(xCache.ucHash);
+		if( mflash_save_file(CELLIOT_CACHE_FILE_NAME, (uint8_t *) &xCache, sizeof(xCache)) != pdTRUE )
+		{
+			configPRINTF(("Could not save the module configuration snapshot\r\n"));
+		}
+	}
+}
+
+static CellIoTCacheEntry_t * prvFind(CellIoTCacheItem_t item, uint8_t index)
+{
+	uint32_t i;
+
+	for( i = 0; i < CELLIOT_CACHE_ENTRIES; i++ )
+	{
+		if( ( xCache.xEntries[i].ucItem == item ) && ( xCache.xEntries[i].ucIndex == index ) )
+		{
+			return &xCache.xEntries[i];
+		}
+	}
+	return NULL;
+}
+
+static uint32_t prvEntryBit(const CellIoTCacheEntry_t * pxEntry)
+{
+	return 1UL << ( pxEntry - xCache.xEntries );
+}
+
+static void prvForget(CellIoTCacheEntry_t * pxEntry)
+{
+	ulReadBackDone &= ~prvEntryBit(pxEntry);
+	memset(pxEntry, 0, sizeof(*pxEntry));
+	prvSave();
+}
+
+/* Reads the setting back from the module, blocking on the AT command.
+ * Called without the mutex held, never from the AT parser thread.
+ */
+static bool prvReadBack(CellIoTCacheItem_t item, uint8_t index, uint8_t digest[DIGEST_SHA256_SIZE])
+{
+	char cParams[CELLIOT_CACHE_READBACK_LEN];
+	gsmr_t status;
+
+	switch( item )
+	{
+		case eCellIoTCacheSocketCfg:
+			status = CellIoT_lib_getSocketCfg(index, cParams, sizeof(cParams));
+			break;
+		case eCellIoTCacheSocketCfgExt:
+			status = CellIoT_lib_getSocketCfgExt(index, cParams, sizeof(cParams));
+			break;
+		case eCellIoTCacheTLSProfile:
+			status = CellIoT_lib_getTLSSecurityProfileCfg(index, cParams, sizeof(cParams));
+			break;
+		default:
+			status = gsmERR;
+			break;
+	}
+	if( status != gsmOK )
+	{
+		return false;
+	}
+
+	DIGEST_Sha256((const uint8_t *) cParams, strlen(cParams), digest);
+	return true;
+}
+
+void CellIoT_cache_Load(void)
+{
+	uint8_t * pucData;
+	uint32_t ulSize;
+	uint8_t hash[DIGEST_SHA256_SIZE];
+
+	if( xCacheMutex == NULL )
+	{
+		xCacheMutex = xSemaphoreCreateMutex();
+	}
+	memset(&xCache, 0, sizeof(xCache));
+	xCache.ulVersion = CELLIOT_CACHE_VERSION;
+	xCacheConfirmed = false;
+	ulReadBackDone = 0;
+
+	xStorageReady = mflash_is_initialized() || ( mflash_init(g_cert_files, 1) == pdTRUE );
+	if( !xStorageReady ||
+		( mflash_read_file(CELLIOT_CACHE_FILE_NAME, &pucData, &ulSize) != pdTRUE ) ||
+		( ulSize != sizeof(xCache) ) )
+	{
+		return;
+	}
+
+	memcpy(&xCache, pucData, sizeof(xCache));
+	prvHash(hash);
+	if( ( xCache.ulVersion != CELLIOT_CACHE_VERSION ) || ( memcmp(hash, xCache.ucHash, sizeof(hash)) != 0 ) )
+	{
+		memset(&xCache, 0, sizeof(xCache));
+		xCache.ulVersion = CELLIOT_CACHE_VERSION;
+		return;
+	}
+
+	/* Reset sequence now only checks the serial number */
+	gsm_device_set_identity(&xCache.xIdentity);
+}
+
+void CellIoT_cache_Validate(void)
+{
+	gsm_device_identity_t xIdentity;
+
+	if( xCacheMutex == NULL )
+	{
+		return;
+	}
+	gsm_device_get_identity(&xIdentity);
+
+	xSemaphoreTake(xCacheMutex, portMAX_DELAY);
+	if( memcmp(&xIdentity, &xCache.xIdentity, sizeof(xIdentity)) != 0 )
+	{
+		/* Another module, or first boot. Saved on the next update so the
+		 * AT parser thread calling us does not wait for the flash.
+		 */
+		memset(xCache.xEntries, 0, sizeof(xCache.xEntries));
+		xCache.xIdentity = xIdentity;
+	}
+	/* The module booted again, every entry is read back once more */
+	ulReadBackDone = 0;
+	xCacheConfirmed = true;
+	xSemaphoreGive(xCacheMutex);
+}
+
+bool CellIoT_cache_IsCurrent(CellIoTCacheItem_t item, uint8_t index, const uint8_t digest[DIGEST_SHA256_SIZE])
+{
+	CellIoTCacheEntry_t * pxEntry;
+	uint8_t readBack[DIGEST_SHA256_SIZE];
+	bool xCurrent = false;
+	bool xReadBackNeeded = false;
+
+	if( xCacheMutex == NULL )
+	{
+		return false;
+	}
+
+	xSemaphoreTake(xCacheMutex, portMAX_DELAY);
+	if( xCacheConfirmed )
+	{
+		pxEntry = prvFind(item, index);
+		xCurrent = ( pxEntry != NULL ) && ( memcmp(pxEntry->ucDigest, digest, DIGEST_SHA256_SIZE) == 0 );
+		xReadBackNeeded = xCurrent && ( ( ulReadBackDone & prvEntryBit(pxEntry) ) == 0 );
+	}
+	xSemaphoreGive(xCacheMutex);
+
+	if( !xReadBackNeeded )
+	{
+		return xCurrent;
+	}
+
+	/* First use since the module booted: only trust the entry when the module
+	 * still lists the settings it listed after the write, e.g. not after a
+	 * factory reset or a write by another host.
+	 */
+	xReadBackNeeded = !prvReadBack(item, index, readBack);
+
+	xSemaphoreTake(xCacheMutex, portMAX_DELAY);
+	pxEntry = prvFind(item, index);
+	xCurrent = xCacheConfirmed && ( pxEntry != NULL ) && !xReadBackNeeded &&
+			   ( memcmp(pxEntry->ucDigest, digest, DIGEST_SHA256_SIZE) == 0 ) &&
+			   ( memcmp(pxEntry->ucReadBack, readBack, DIGEST_SHA256_SIZE) == 0 );
+	if( xCurrent )
+	{
+		ulReadBackDone |= prvEntryBit(pxEntry);
+	}
+	else if( pxEntry != NULL )
+	{
+		configPRINTF(("Module setting %u/%u changed since the snapshot, writing it again\r\n", ( unsigned ) item, ( unsigned ) index));
+		prvForget(pxEntry);
+	}
+	xSemaphoreGive(xCacheMutex);
+
+	return xCurrent;
+}
+
+void CellIoT_cache_Update(CellIoTCacheItem_t item, uint8_t index, const uint8_t digest[DIGEST_SHA256_SIZE])
+{
+	CellIoTCacheEntry_t * pxEntry;
+	uint8_t readBack[DIGEST_SHA256_SIZE];
+
+	if( xCacheMutex == NULL )
+	{
+		return;
+	}
+
+	/* Without a read-back the entry could not be checked later, forget it */
+	if( ( digest != NULL ) && !prvReadBack(item, index, readBack) )
+	{
+		digest = NULL;
+	}
+
+	xSemaphoreTake(xCacheMutex, portMAX_DELAY);
+	if( xCacheConfirmed )
+	{
+		pxEntry = prvFind(item, index);
+		if( digest == NULL )
+		{
+			if( pxEntry != NULL )
+			{
+				prvForget(pxEntry);
+			}
+		}
+		else
+		{
+			if( pxEntry == NULL )
+			{
+				pxEntry = prvFind((CellIoTCacheItem_t) 0, 0);
+			}
+			/* Snapshot full: the setting is simply written again next time */
+			if( pxEntry != NULL )
+			{
+				ulReadBackDone |= prvEntryBit(pxEntry);
+				if( ( pxEntry->ucItem != (uint8_t) item ) ||
+					( memcmp(pxEntry->ucDigest, digest, DIGEST_SHA256_SIZE) != 0 ) ||
+					( memcmp(pxEntry->ucReadBack, readBack, DIGEST_SHA256_SIZE) != 0 ) )
+				{
+					pxEntry->ucItem = (uint8_t) item;
+					pxEntry->ucIndex = index;
+					memcpy(pxEntry->ucDigest, digest, DIGEST_SHA256_SIZE);
+					memcpy(pxEntry->ucReadBack, readBack, DIGEST_SHA256_SIZE);
+					prvSave();
+				}
+			}
+		}
+	}
+	xSemaphoreGive(xCacheMutex);
+}
+
+void CellIoT_cache_Invalidate(void)
+{
+	if( xCacheMutex == NULL )
+	{
+		return;
+	}
+
+	xSemaphoreTake(xCacheMutex, portMAX_DELAY);
+	memset(xCache.xEntries, 0, sizeof(xCache.xEntries));
+	ulReadBackDone = 0;
+	prvSave();
+	xSemaphoreGive(xCacheMutex);
+}
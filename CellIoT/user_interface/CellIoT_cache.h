@@ -0,0 +1,76 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CELLIOT_CACHE_H_
+#define CELLIOT_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ksdk_digest.h"
+
+/* mflash file holding the snapshot */
+#define CELLIOT_CACHE_FILE_NAME		"CellIoT_ModemCfg.dat"
+
+/* Bump when the layout of the snapshot or the meaning of an item changes */
+#define CELLIOT_CACHE_VERSION		( 2U )
+
+/* Number of (item, index) digests in the snapshot */
+#ifndef CELLIOT_CACHE_ENTRIES
+#define CELLIOT_CACHE_ENTRIES		( 16U )
+#endif
+
+/* Longest settings string kept from a read-back, longer ones are compared truncated */
+#ifndef CELLIOT_CACHE_READBACK_LEN
+#define CELLIOT_CACHE_READBACK_LEN	( 128U )
+#endif
+
+/* Settings the module keeps in its NVM across power cycles */
+typedef enum
+{
+	eCellIoTCacheSocketCfg = 1,		/* AT+SQNSCFG, index is the connection ID */
+	eCellIoTCacheSocketCfgExt,		/* AT+SQNSCFGEXT, index is the connection ID */
+	eCellIoTCacheTLSProfile,		/* certificates and AT+SQNSPCFG, index is the profile ID */
+} CellIoTCacheItem_t;
+
+/*
+ * Snapshot of the module configuration, stored in flash.
+ *
+ * Each setting is recorded with the SHA-256 of the values it was last written
+ * with. The snapshot only applies to the module whose identity it holds: the
+ * identity is seeded in the AT parser on init so the reset sequence reads only
+ * the serial number back, and the snapshot is dropped when it does not match.
+ *
+ * The serial number does not tell whether the module NVM still holds the
+ * settings, so each entry also records the SHA-256 of the settings read back
+ * with AT+SQNSCFG?, AT+SQNSCFGEXT? or AT+SQNSPCFG? after the write. The first
+ * time an entry is used after the module booted it is read back again and
+ * forgotten on mismatch. The read-back does not cover certificate contents,
+ * only the slots the profile refers to.
+ */
+
+/* Call on GSM_EVT_INIT_FINISH: loads the snapshot and seeds the module identity */
+void CellIoT_cache_Load(void);
+
+/* Call on GSM_EVT_DEVICE_IDENTIFIED: drops the snapshot when another module answered */
+void CellIoT_cache_Validate(void);
+
+/* True when the setting was written with the same values to this module.
+ * Blocks on the read-back AT command the first time after the module booted,
+ * must not be called from the AT parser thread.
+ */
+bool CellIoT_cache_IsCurrent(CellIoTCacheItem_t item, uint8_t index, const uint8_t digest[DIGEST_SHA256_SIZE]);
+
+/* Records the values a setting was written with, NULL digest forgets the setting.
+ * Reads the setting back from the module, the snapshot is saved to flash only
+ * when it changes.
+ */
+void CellIoT_cache_Update(CellIoTCacheItem_t item, uint8_t index, const uint8_t digest[DIGEST_SHA256_SIZE]);
+
+/* Forgets every setting, e.g. after a factory reset of the module */
+void CellIoT_cache_Invalidate(void);
+
+#endif /* CELLIOT_CACHE_H_ */
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "CellIoT_compress.h"
+
+/* Control byte 000LLLLL: L + 1 literals follow */
+#define LZF_MAX_LITERALS		( 32U )
+
+/* Control byte LLLOOOOO [L - 7] OOOOOOOO: copy L + 2 bytes from O + 1 bytes behind */
+#define LZF_MAX_OFFSET			( 1U << 13 )
+#define LZF_MAX_MATCH			( 255U + 7U + 2U )
+#define LZF_MIN_MATCH			( 3U )
+
+
+static uint32_t prvHash(const uint8_t * pucData)
+{
+	uint32_t ulValue = ( (uint32_t) pucData[0] << 16 ) | ( (uint32_t) pucData[1] << 8 ) | pucData[2];
+
+	return (uint32_t) ( ulValue * 2654435761U ) >> ( 32U - CELLIOT_COMPRESS_HASH_BITS );
+}
+
+size_t CellIoT_compress_Encode(CellIoTCompressWork_t * pxWork, const uint8_t * pucIn, size_t xInLen, uint8_t * pucOut, size_t xOutMax)
+{
+	size_t xIn = 0;
+	size_t xOut = 1;					/* room for the control byte of the first literal run */
+	size_t xLiterals = 0;
+	size_t xRef, xLen, xMaxLen, xOffset;
+	uint32_t ulHash;
+
+	if( ( xInLen == 0 ) || ( xInLen > CELLIOT_COMPRESS_MAX_LEN ) || ( xOutMax < 2 ) )
+	{
+		return 0;
+	}
+	/* Not worth it unless the result is smaller than the input */
+	if( xOutMax >= xInLen )
+	{
+		xOutMax = xInLen - 1;
+	}
+
+	memset(pxWork, 0, sizeof(*pxWork));
+
+	while( xIn < xInLen )
+	{
+		xLen = 0;
+		if( ( xIn + LZF_MIN_MATCH ) <= xInLen )
+		{
+			ulHash = prvHash(&pucIn[xIn]);
+			xRef = pxWork->usHash[ulHash];
+			pxWork->usHash[ulHash] = (uint16_t) ( xIn + 1U );
+
+			if( ( xRef != 0 ) && ( ( xIn - ( xRef - 1U ) ) <= LZF_MAX_OFFSET ) &&
+				( memcmp(&pucIn[xRef - 1U], &pucIn[xIn], LZF_MIN_MATCH) == 0 ) )
+			{
+				xRef--;
+				xMaxLen = xInLen - xIn;
+				if( xMaxLen > LZF_MAX_MATCH )
+				{
+					xMaxLen = LZF_MAX_MATCH;
+				}
+				for( xLen = LZF_MIN_MATCH; ( xLen < xMaxLen ) && ( pucIn[xRef + xLen] == pucIn[xIn + xLen] ); xLen++ )
+				{
+				}
+			}
+		}
+
+		if( xLen == 0 )
+		{
+			/* Literal, the control byte of its run is written when the run ends */
+			if( xOut >= xOutMax )
+			{
+				return 0;
+			}
+			pucOut[xOut++] = pucIn[xIn++];
+			if( ++xLiterals == LZF_MAX_LITERALS )
+			{
+				pucOut[xOut - xLiterals - 1U] = (uint8_t) ( xLiterals - 1U );
+				xLiterals = 0;
+				xOut++;
+			}
+			continue;
+		}
+
+		/* Back reference: close the literal run, or take back its unused control byte */
+		if( xLiterals != 0 )
+		{
+			pucOut[xOut - xLiterals - 1U] = (uint8_t) ( xLiterals - 1U );
+			xLiterals = 0;
+		}
+		else
+		{
+			xOut--;
+		}
+
+		if( ( xOut + 4U ) > xOutMax )
+		{
+			return 0;
+		}
+		xOffset = xIn - xRef - 1U;
+		if( ( xLen - 2U ) < 7U )
+		{
+			pucOut[xOut++] = (uint8_t) ( ( ( xLen - 2U ) << 5 ) | ( xOffset >> 8 ) );
+		}
+		else
+		{
+			pucOut[xOut++] = (uint8_t) ( ( 7U << 5 ) | ( xOffset >> 8 ) );
+			pucOut[xOut++] = (uint8_t) ( xLen - 2U - 7U );
+		}
+		pucOut[xOut++] = (uint8_t) xOffset;
+		xOut++;							/* control byte of the next literal run */
+
+		/* Index the end of the match so that repeats of it are found too */
+		xIn += xLen;
+		if( ( xIn + LZF_MIN_MATCH ) <= xInLen )
+		{
+			pxWork->usHash[prvHash(&pucIn[xIn - 1U])] = (uint16_t) xIn;
+		}
+	}
+
+	if( xLiterals != 0 )
+	{
+		pucOut[xOut - xLiterals - 1U] = (uint8_t) ( xLiterals - 1U );
+	}
+	else
+	{
+		xOut--;
+	}
+
+	return xOut;
+}
+
+size_t CellIoT_compress_Decode(const uint8_t * pucIn, size_t xInLen, uint8_t * pucOut, size_t xOutMax)
+{
+	size_t xIn = 0;
+	size_t xOut = 0;
+	size_t xLen, xOffset;
+	uint8_t ucCtrl;
+
+	while( xIn < xInLen )
+	{
+		ucCtrl = pucIn[xIn++];
+
+		if( ucCtrl < LZF_MAX_LITERALS )
+		{
+			xLen = (size_t) ucCtrl + 1U;
+			if( ( ( xIn + xLen ) > xInLen ) || ( ( xOut + xLen ) > xOutMax ) )
+			{
+				return 0;
+			}
+			memcpy(&pucOut[xOut], &pucIn[xIn], xLen);
+			xIn += xLen;
+			xOut += xLen;
+			continue;
+		}
+
+		xLen = ucCtrl >> 5;
+		if( xLen == 7U )
+		{
+			if( xIn >= xInLen )
+			{
+				return 0;
+			}
+			xLen += pucIn[xIn++];
+		}
+		xLen += 2U;
+		if( xIn >= xInLen )
+		{
+			return 0;
+		}
+		xOffset = ( ( (size_t) ( ucCtrl & 0x1FU ) << 8 ) | pucIn[xIn++] ) + 1U;
+		if( ( xOffset > xOut ) || ( ( xOut + xLen ) > xOutMax ) )
+		{
+			return 0;
+		}
+
+		/* Byte by byte, the source may overlap what is being written */
+		while( xLen-- != 0U )
+		{
+			pucOut[xOut] = pucOut[xOut - xOffset];
+			xOut++;
+		}
+	}
+
+	return xOut;
+}
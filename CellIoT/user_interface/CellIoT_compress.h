@@ -0,0 +1,55 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CELLIOT_COMPRESS_H_
+#define CELLIOT_COMPRESS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Content encoding of the compressed payloads, as announced to the cloud */
+#define CELLIOT_COMPRESS_ENCODING		"lzf"
+
+/* Bits of the match finder hash, the work area takes 2 bytes per entry */
+#ifndef CELLIOT_COMPRESS_HASH_BITS
+#define CELLIOT_COMPRESS_HASH_BITS		( 9U )
+#endif
+
+/* Smaller payloads are sent as they are, the gain would not be worth it */
+#ifndef CELLIOT_COMPRESS_MIN_LEN
+#define CELLIOT_COMPRESS_MIN_LEN		( 64U )
+#endif
+
+/* Longest payload handled, positions are kept on 16 bits */
+#define CELLIOT_COMPRESS_MAX_LEN		( 0xFFFEU )
+
+typedef struct
+{
+	uint16_t usHash[1U << CELLIOT_COMPRESS_HASH_BITS];	/* last position + 1 of each 3-byte hash */
+} CellIoTCompressWork_t;
+
+/*
+ * LZF compression of a message.
+ *
+ * The output is the format of liblzf, decoded by CellIoT_compress_Decode() or
+ * by the lzf tools on the ingestion side. Back references reach 8 KB behind,
+ * within the message only, so the RAM used is the work area above whatever
+ * the message size. The module keeps no state: the caller owns the work area.
+ */
+
+/* Compresses xInLen bytes into pucOut. Returns the compressed size, or 0 when
+ * the result would not be smaller than the input or does not fit in xOutMax:
+ * the message is then sent as it is.
+ */
+size_t CellIoT_compress_Encode(CellIoTCompressWork_t * pxWork, const uint8_t * pucIn, size_t xInLen, uint8_t * pucOut, size_t xOutMax);
+
+/* Decompresses into pucOut. Returns the decompressed size, 0 when the data is
+ * corrupt or does not fit in xOutMax. Plain C, also builds on the host.
+ */
+size_t CellIoT_compress_Decode(const uint8_t * pucIn, size_t xInLen, uint8_t * pucOut, size_t xOutMax);
+
+#endif /* CELLIOT_COMPRESS_H_ */
@@ -0,0 +1,238 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "CellIoT_connmgr.h"
+#include "gsm.h"
+#include "gsm_network.h"
+
+/* Access technology for AT+CEDRXS, LTE-M */
+#define CONNMGR_EDRX_ACT_LTE_M			( 4U )
+
+#define CONNMGR_DEFAULT_BATCH			( 3U )
+#define CONNMGR_DEFAULT_MAX_HOLD_S		( 180U )
+
+static CellIoTPowerCfg_t xCfg;
+static CellIoTRadioWakeCallback_t pxWakeCallback;
+static TimerHandle_t xActiveTimer;
+
+static volatile CellIoTRadioState_t eRadioState = eCellIoTRadioConnected;
+static TickType_t xStateSince;
+static CellIoTRadioStats_t xStats;
+
+static CellIoTTelemetry_t xQueue[CELLIOT_CONNMGR_QUEUE_LEN];
+static uint8_t ucHead;
+static uint8_t ucCount;
+static TickType_t xQueuedAt[CELLIOT_CONNMGR_QUEUE_LEN];	/* enqueue time of each slot */
+
+
+/* Call in a critical section */
+static void prvSetRadioState(CellIoTRadioState_t eState)
+{
+	TickType_t xNow = xTaskGetTickCount();
+	uint32_t ulElapsedMs = (uint32_t)(xNow - xStateSince) * portTICK_PERIOD_MS;
+
+	if( eRadioState == eCellIoTRadioConnected )
+	{
+		xStats.ulConnectedMs += ulElapsedMs;
+	}
+	else if( eRadioState == eCellIoTRadioIdle )
+	{
+		xStats.ulIdleMs += ulElapsedMs;
+	}
+	if( ( eState == eCellIoTRadioConnected ) && ( eRadioState != eCellIoTRadioConnected ) )
+	{
+		xStats.ulWakeups++;
+	}
+	eRadioState = eState;
+	xStateSince = xNow;
+}
+
+static void prvActiveTimerCallback( TimerHandle_t xTimer )
+{
+	( void ) xTimer;
+
+	/* Active time is over without new activity, the module enters PSM */
+	taskENTER_CRITICAL();
+	if( eRadioState == eCellIoTRadioIdle )
+	{
+		prvSetRadioState(eCellIoTRadioAsleep);
+	}
+	taskEXIT_CRITICAL();
+}
+
+static gsmr_t prvGsmEvent(gsm_evt_t * evt)
+{
+	bool xWoken = false;
+
+	if( gsm_evt_get_type(evt) == GSM_EVT_NETWORK_RADIO_CHANGED )
+	{
+		taskENTER_CRITICAL();
+		if( gsm_evt_network_radio_is_connected(evt) )
+		{
+			xWoken = ( eRadioState != eCellIoTRadioConnected );
+			prvSetRadioState(eCellIoTRadioConnected);
+		}
+		else
+		{
+			prvSetRadioState(eCellIoTRadioIdle);
+		}
+		taskEXIT_CRITICAL();
+
+		/* Network may grant another active time, the requested one is used */
+		if( gsm_evt_network_radio_is_connected(evt) )
+		{
+			xTimerStop( xActiveTimer, 0 );
+		}
+		else if( xCfg.ulActiveS != 0U )
+		{
+			xTimerChangePeriod( xActiveTimer, pdMS_TO_TICKS( xCfg.ulActiveS * 1000U ), 0 );
+		}
+
+		if( xWoken && ( pxWakeCallback != NULL ) )
+		{
+			pxWakeCallback();
+		}
+	}
+	return gsmOK;
+}
+
+bool CellIoT_connmgr_Init(const CellIoTPowerCfg_t * pxCfg)
+{
+	if( pxCfg != NULL )
+	{
+		xCfg = *pxCfg;
+	}
+	else
+	{
+		xCfg.ulTauS = CELLIOT_PSM_TAU_S;
+		xCfg.ulActiveS = CELLIOT_PSM_ACTIVE_S;
+		xCfg.ucEdrxCycle = CELLIOT_EDRX_CYCLE;
+		xCfg.ucBatchSize = CONNMGR_DEFAULT_BATCH;
+		xCfg.ulMaxHoldS = CONNMGR_DEFAULT_MAX_HOLD_S;
+	}
+	if( xCfg.ucBatchSize == 0U )
+	{
+		xCfg.ucBatchSize = 1U;
+	}
+
+	if( xActiveTimer == NULL )
+	{
+		xActiveTimer = xTimerCreate( "PSM Active Timer",
+									 pdMS_TO_TICKS( 1000U ),
+									 pdFALSE,
+									 NULL,
+									 prvActiveTimerCallback );
+		if( ( xActiveTimer == NULL ) || ( gsm_evt_register(prvGsmEvent) != gsmOK ) )
+		{
+			return false;
+		}
+	}
+	/* Registration has just completed, the radio is connected */
+	xStateSince = xTaskGetTickCount();
+
+	if( gsm_network_set_radio_report(1, NULL, NULL, 1) != gsmOK )
+	{
+		configPRINTF(("Radio connection reports not supported\r\n"));
+		return false;
+	}
+	if( gsm_network_set_psm(xCfg.ulTauS != 0U, xCfg.ulTauS, xCfg.ulActiveS, NULL, NULL, 1) != gsmOK )
+	{
+		configPRINTF(("PSM request failed\r\n"));
+	}
+	if( gsm_network_set_edrx(xCfg.ucEdrxCycle != 0xFFU, CONNMGR_EDRX_ACT_LTE_M, xCfg.ucEdrxCycle, NULL, NULL, 1) != gsmOK )
+	{
+		configPRINTF(("eDRX request failed\r\n"));
+	}
+	return true;
+}
+
+void CellIoT_connmgr_SetWakeCallback(CellIoTRadioWakeCallback_t pxCallback)
+{
+	pxWakeCallback = pxCallback;
+}
+
+void CellIoT_connmgr_Queue(const char * pcTopic, const char * pcPayload)
+{
+	CellIoTTelemetry_t * pxMsg;
+
+	taskENTER_CRITICAL();
+	if( ucCount == CELLIOT_CONNMGR_QUEUE_LEN )
+	{
+		ucHead = (uint8_t)((ucHead + 1U) % CELLIOT_CONNMGR_QUEUE_LEN);
+		ucCount--;
+		xStats.ulDropped++;
+	}
+	xQueuedAt[(ucHead + ucCount) % CELLIOT_CONNMGR_QUEUE_LEN] = xTaskGetTickCount();
+	pxMsg = &xQueue[(ucHead + ucCount) % CELLIOT_CONNMGR_QUEUE_LEN];
+	ucCount++;
+	xStats.ulQueued++;
+	taskEXIT_CRITICAL();
+
+	/* Only the telemetry task adds and removes messages */
+	strncpy(pxMsg->cTopic, pcTopic, sizeof(pxMsg->cTopic) - 1U);
+	pxMsg->cTopic[sizeof(pxMsg->cTopic) - 1U] = 0;
+	strncpy(pxMsg->cPayload, pcPayload, sizeof(pxMsg->cPayload) - 1U);
+	pxMsg->cPayload[sizeof(pxMsg->cPayload) - 1U] = 0;
+}
+
+bool CellIoT_connmgr_ShouldFlush(void)
+{
+	TickType_t xOldestQueued;
+	uint8_t ucQueued;
+
+	taskENTER_CRITICAL();
+	ucQueued = ucCount;
+	xOldestQueued = xQueuedAt[ucHead];
+	taskEXIT_CRITICAL();
+
+	if( ucQueued == 0U )
+	{
+		return false;
+	}
+	/* Sending while RRC connected costs no extra wake-up. From RRC idle the module
+	 * would have to connect again, that is left to the batch and age limits. */
+	if( ( eRadioState == eCellIoTRadioConnected ) || ( ucQueued >= xCfg.ucBatchSize ) )
+	{
+		return true;
+	}
+	return ( xCfg.ulMaxHoldS != 0U ) &&
+		   ( ( xTaskGetTickCount() - xOldestQueued ) >= pdMS_TO_TICKS( xCfg.ulMaxHoldS * 1000U ) );
+}
+
+const CellIoTTelemetry_t * CellIoT_connmgr_Peek(uint8_t ucIndex)
+{
+	return ( ucIndex < ucCount ) ? &xQueue[(ucHead + ucIndex) % CELLIOT_CONNMGR_QUEUE_LEN] : NULL;
+}
+
+void CellIoT_connmgr_Pop(void)
+{
+	taskENTER_CRITICAL();
+	if( ucCount != 0U )
+	{
+		ucHead = (uint8_t)((ucHead + 1U) % CELLIOT_CONNMGR_QUEUE_LEN);
+		ucCount--;
+	}
+	taskEXIT_CRITICAL();
+}
+
+CellIoTRadioState_t CellIoT_connmgr_GetRadioState(void)
+{
+	return eRadioState;
+}
+
+void CellIoT_connmgr_GetStats(CellIoTRadioStats_t * pxStats)
+{
+	taskENTER_CRITICAL();
+	/* Account the current state up to now */
+	prvSetRadioState(eRadioState);
+	*pxStats = xStats;
+	taskEXIT_CRITICAL();
+}
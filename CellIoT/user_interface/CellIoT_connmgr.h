@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CELLIOT_CONNMGR_H_
+#define CELLIOT_CONNMGR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Requested periodic TAU (T3412), the module sleeps in PSM between updates */
+#ifndef CELLIOT_PSM_TAU_S
+#define CELLIOT_PSM_TAU_S				( 3600U )
+#endif
+
+/* Requested active time (T3324), the module stays reachable after the radio goes idle */
+#ifndef CELLIOT_PSM_ACTIVE_S
+#define CELLIOT_PSM_ACTIVE_S			( 30U )
+#endif
+
+/* Requested eDRX cycle for LTE-M as in 3GPP TS 24.008, 0xFF disables eDRX */
+#ifndef CELLIOT_EDRX_CYCLE
+#define CELLIOT_EDRX_CYCLE				( 0x05U )		/* 81.92 s */
+#endif
+
+/* Telemetry held while the module sleeps */
+#ifndef CELLIOT_CONNMGR_QUEUE_LEN
+#define CELLIOT_CONNMGR_QUEUE_LEN		( 4U )
+#endif
+#define CELLIOT_CONNMGR_TOPIC_LEN		( 128U )
+#define CELLIOT_CONNMGR_PAYLOAD_LEN		( 256U )
+
+typedef enum
+{
+	eCellIoTRadioAsleep = 0,		/* PSM, not reachable */
+	eCellIoTRadioIdle,				/* RRC idle within active time, reachable by paging */
+	eCellIoTRadioConnected,			/* RRC connected */
+} CellIoTRadioState_t;
+
+typedef struct
+{
+	uint32_t ulTauS;
+	uint32_t ulActiveS;
+	uint8_t ucEdrxCycle;
+	uint8_t ucBatchSize;			/* messages queued before the module is woken up */
+	uint32_t ulMaxHoldS;			/* oldest message is sent after this time regardless */
+} CellIoTPowerCfg_t;
+
+typedef struct
+{
+	uint32_t ulConnectedMs;			/* time spent RRC connected */
+	uint32_t ulIdleMs;				/* time spent reachable but idle */
+	uint32_t ulWakeups;				/* transitions to RRC connected */
+	uint32_t ulQueued;
+	uint32_t ulDropped;				/* queue was full */
+} CellIoTRadioStats_t;
+
+typedef struct
+{
+	char cTopic[CELLIOT_CONNMGR_TOPIC_LEN];
+	char cPayload[CELLIOT_CONNMGR_PAYLOAD_LEN];
+} CellIoTTelemetry_t;
+
+/* Called from the AT parser thread when the radio connects, must not block */
+typedef void (*CellIoTRadioWakeCallback_t)(void);
+
+/*
+ * Connection manager for PSM/eDRX.
+ *
+ * Requests the power saving timers from the network and tracks the radio state
+ * with +CSCON. Outbound telemetry is queued while the module sleeps and flushed
+ * back to back once a batch is ready or the radio is RRC connected anyway, so one wake-up
+ * carries several messages on the already open MQTT connection.
+ */
+
+/* Call after network registration. pxCfg can be NULL for the defaults above. */
+bool CellIoT_connmgr_Init(const CellIoTPowerCfg_t * pxCfg);
+
+void CellIoT_connmgr_SetWakeCallback(CellIoTRadioWakeCallback_t pxCallback);
+
+/* Copies the message in the queue, the oldest message is dropped when full */
+void CellIoT_connmgr_Queue(const char * pcTopic, const char * pcPayload);
+
+/* True when the queued messages should be sent now */
+bool CellIoT_connmgr_ShouldFlush(void);
+
+/* Queued message at ucIndex, 0 being the oldest, or NULL.
+ * Messages are left in the queue until CellIoT_connmgr_Pop() so that the ones
+ * not acknowledged are sent again on the next connection.
+ */
+const CellIoTTelemetry_t * CellIoT_connmgr_Peek(uint8_t ucIndex);
+void CellIoT_connmgr_Pop(void);
+
+CellIoTRadioState_t CellIoT_connmgr_GetRadioState(void);
+void CellIoT_connmgr_GetStats(CellIoTRadioStats_t * pxStats);
+
+#endif /* CELLIOT_CONNMGR_H_ */
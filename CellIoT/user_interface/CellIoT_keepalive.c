@@ -0,0 +1,304 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "CellIoT_keepalive.h"
+#include "ksdk_digest.h"
+#include "mflash_file.h"
+
+typedef struct
+{
+	uint32_t ulOperator;					/* 0 for a free entry */
+	uint32_t ulGoodS;						/* 0 until a ping beyond the configured keep-alive was answered */
+	uint32_t ulBadS;
+	uint32_t ulLastUse;						/* order of selection, to replace the oldest entry */
+} CellIoTKeepAliveEntry_t;
+
+typedef struct
+{
+	uint32_t ulVersion;
+	uint32_t ulUseCount;
+	CellIoTKeepAliveEntry_t xEntries[CELLIOT_KEEPALIVE_OPERATORS];
+	uint8_t ucHash[DIGEST_SHA256_SIZE];		/* SHA-256 of all the fields above */
+} CellIoTKeepAliveFile_t;
+
+/* Flash file table, shared with the PKCS#11 storage */
+extern mflash_file_t g_cert_files[];
+
+static CellIoTKeepAliveFile_t xFile;
+static SemaphoreHandle_t xKeepAliveMutex;
+static bool xStorageReady;
+
+/* Entry of the current operator, xUnknown until the operator is reported */
+static CellIoTKeepAliveEntry_t xUnknown = { 0, 0, 0, 0 };
+static CellIoTKeepAliveEntry_t * pxCurrent = &xUnknown;
+
+/* Configured keep-alive, the starting point of the search */
+static uint32_t ulBaselineS = CELLIOT_KEEPALIVE_MIN_S;
+
+static uint8_t ucLostInRow;
+static uint8_t ucHoldPings;
+static uint32_t ulPings;
+static uint32_t ulLost;
+
+
+static void prvSave(void)
+{
+	if( xStorageReady && ( pxCurrent != &xUnknown ) )
+	{
+		DIGEST_Sha256((const uint8_t *) &xFile, offsetof(CellIoTKeepAliveFile_t, ucHash), xFile.ucHash);
+		if( mflash_save_file(CELLIOT_KEEPALIVE_FILE_NAME, (uint8_t *) &xFile, sizeof(xFile)) != pdTRUE )
+		{
+			configPRINTF(("Could not save the keep-alive intervals\r\n"));
+		}
+	}
+}
+
+static uint32_t prvOperatorKey(const gsm_operator_curr_t * pxOperator)
+{
+	const char * pcName;
+	uint32_t ulKey = 2166136261UL;			/* FNV-1a of the name when not numeric */
+
+	if( pxOperator->format == GSM_OPERATOR_FORMAT_NUMBER )
+	{
+		return pxOperator->data.num;
+	}
+	if( pxOperator->format == GSM_OPERATOR_FORMAT_INVALID )
+	{
+		return 0;
+	}
+
+	pcName = pxOperator->data.long_name;
+	while( ( *pcName != '\0' ) && ( pcName < &pxOperator->data.long_name[sizeof(pxOperator->data.long_name)] ) )
+	{
+		ulKey = ( ulKey ^ (uint8_t) *pcName++ ) * 16777619UL;
+	}
+	return ( ulKey != 0 ) ? ulKey : 1;
+}
+
+static uint32_t prvGoodS(void)
+{
+	return ( pxCurrent->ulGoodS != 0 ) ? pxCurrent->ulGoodS : ulBaselineS;
+}
+
+static uint32_t prvIntervalS(uint32_t ulMaxS)
+{
+	uint32_t ulGoodS = prvGoodS();
+	uint32_t ulIntervalS;
+
+	if( ucHoldPings > 0 )
+	{
+		ulIntervalS = ulGoodS;								/* reconnected after a lost probe */
+	}
+	else if( pxCurrent->ulBadS == 0 )
+	{
+		ulIntervalS = ulGoodS * 2U;							/* no drop seen yet */
+	}
+	else if( pxCurrent->ulBadS > ulGoodS + CELLIOT_KEEPALIVE_RESOLUTION_S )
+	{
+		ulIntervalS = ( ulGoodS + pxCurrent->ulBadS ) / 2U;
+	}
+	else
+	{
+		ulIntervalS = ulGoodS;								/* converged */
+	}
+
+	if( ulIntervalS > CELLIOT_KEEPALIVE_MAX_S )
+	{
+		ulIntervalS = ( ulGoodS > CELLIOT_KEEPALIVE_MAX_S ) ? ulGoodS : CELLIOT_KEEPALIVE_MAX_S;
+	}
+	return ( ulIntervalS < ulMaxS ) ? ulIntervalS : ulMaxS;
+}
+
+void CellIoT_keepalive_Load(void)
+{
+	uint8_t * pucData;
+	uint32_t ulSize;
+	uint8_t hash[DIGEST_SHA256_SIZE];
+
+	if( xKeepAliveMutex == NULL )
+	{
+		xKeepAliveMutex = xSemaphoreCreateMutex();
+	}
+
+	xSemaphoreTake(xKeepAliveMutex, portMAX_DELAY);
+	memset(&xFile, 0, sizeof(xFile));
+	xFile.ulVersion = CELLIOT_KEEPALIVE_VERSION;
+	pxCurrent = &xUnknown;
+	ucHoldPings = 0;
+
+	xStorageReady = mflash_is_initialized() || ( mflash_init(g_cert_files, 1) == pdTRUE );
+	if( xStorageReady &&
+		( mflash_read_file(CELLIOT_KEEPALIVE_FILE_NAME, &pucData, &ulSize) == pdTRUE ) &&
+		( ulSize == sizeof(xFile) ) )
+	{
+		memcpy(&xFile, pucData, sizeof(xFile));
+		DIGEST_Sha256((const uint8_t *) &xFile, offsetof(CellIoTKeepAliveFile_t, ucHash), hash);
+		if( ( xFile.ulVersion != CELLIOT_KEEPALIVE_VERSION ) || ( memcmp(hash, xFile.ucHash, sizeof(hash)) != 0 ) )
+		{
+			memset(&xFile, 0, sizeof(xFile));
+			xFile.ulVersion = CELLIOT_KEEPALIVE_VERSION;
+		}
+	}
+	xSemaphoreGive(xKeepAliveMutex);
+}
+
+void CellIoT_keepalive_SetOperator(const gsm_operator_curr_t * pxOperator)
+{
+	CellIoTKeepAliveEntry_t * pxEntry = NULL;
+	uint32_t ulKey = prvOperatorKey(pxOperator);
+	uint32_t i;
+
+	if( ( xKeepAliveMutex == NULL ) || ( ulKey == 0 ) || ( ulKey == pxCurrent->ulOperator ) )
+	{
+		return;
+	}
+
+	xSemaphoreTake(xKeepAliveMutex, portMAX_DELAY);
+	for( i = 0; i < CELLIOT_KEEPALIVE_OPERATORS; i++ )
+	{
+		if( xFile.xEntries[i].ulOperator == ulKey )
+		{
+			pxEntry = &xFile.xEntries[i];
+			break;
+		}
+		if( ( pxEntry == NULL ) || ( xFile.xEntries[i].ulLastUse < pxEntry->ulLastUse ) )
+		{
+			pxEntry = &xFile.xEntries[i];		/* free entries have the lowest use */
+		}
+	}
+
+	if( pxEntry->ulOperator != ulKey )
+	{
+		/* New operator: start the search from the configured keep-alive, saved once something is learned */
+		pxEntry->ulOperator = ulKey;
+		pxEntry->ulGoodS = 0;
+		pxEntry->ulBadS = 0;
+	}
+	pxEntry->ulLastUse = ++xFile.ulUseCount;
+	pxCurrent = pxEntry;
+	ucLostInRow = 0;
+	ucHoldPings = 0;
+	xSemaphoreGive(xKeepAliveMutex);
+}
+
+uint16_t CellIoT_keepalive_GetKeepAliveS(uint16_t usBaselineS)
+{
+	if( xKeepAliveMutex == NULL )
+	{
+		return usBaselineS;
+	}
+
+	xSemaphoreTake(xKeepAliveMutex, portMAX_DELAY);
+	ulBaselineS = ( usBaselineS > CELLIOT_KEEPALIVE_MIN_S ) ? usBaselineS : CELLIOT_KEEPALIVE_MIN_S;
+	xSemaphoreGive(xKeepAliveMutex);
+
+	/* Room for every interval that may be probed, the pings keep the NAT mapping alive */
+	return ( usBaselineS > CELLIOT_KEEPALIVE_MAX_S ) ? usBaselineS : (uint16_t) CELLIOT_KEEPALIVE_MAX_S;
+}
+
+uint32_t CellIoT_keepalive_GetIntervalMs(uint32_t ulMaxMs)
+{
+	uint32_t ulIntervalS;
+
+	if( xKeepAliveMutex == NULL )
+	{
+		return ulMaxMs;
+	}
+
+	xSemaphoreTake(xKeepAliveMutex, portMAX_DELAY);
+	ulIntervalS = prvIntervalS(ulMaxMs / 1000U);
+	xSemaphoreGive(xKeepAliveMutex);
+
+	return ulIntervalS * 1000U;
+}
+
+void CellIoT_keepalive_Report(uint32_t ulIdleMs, bool xAnswered)
+{
+	uint32_t ulIdleS = ulIdleMs / 1000U;
+	bool xChanged = false;
+
+	if( xKeepAliveMutex == NULL )
+	{
+		return;
+	}
+
+	xSemaphoreTake(xKeepAliveMutex, portMAX_DELAY);
+	ulPings++;
+	if( xAnswered )
+	{
+		ucLostInRow = 0;
+		if( ucHoldPings > 0 )
+		{
+			ucHoldPings--;
+		}
+		if( ulIdleS > prvGoodS() )
+		{
+			pxCurrent->ulGoodS = ulIdleS;
+			if( ( pxCurrent->ulBadS != 0 ) && ( pxCurrent->ulBadS <= ulIdleS ) )
+			{
+				pxCurrent->ulBadS = 0;			/* the NAT got more tolerant */
+			}
+			xChanged = true;
+		}
+	}
+	else
+	{
+		ulLost++;
+		if( ulIdleS > prvGoodS() )
+		{
+			/* Probe went too far: the connection is gone, reconnect at the
+			 * last good idle time and bisect below the probe later on */
+			if( ( pxCurrent->ulBadS == 0 ) || ( ulIdleS < pxCurrent->ulBadS ) )
+			{
+				pxCurrent->ulBadS = ulIdleS;
+				xChanged = true;
+			}
+			ucHoldPings = CELLIOT_KEEPALIVE_HOLD_PINGS;
+		}
+		else if( ( ++ucLostInRow >= CELLIOT_KEEPALIVE_FALLBACK ) && ( prvGoodS() > CELLIOT_KEEPALIVE_MIN_S ) )
+		{
+			/* A known good interval keeps failing: the NAT got stricter */
+			pxCurrent->ulBadS = prvGoodS();
+			pxCurrent->ulGoodS = pxCurrent->ulBadS / 2U;
+			if( pxCurrent->ulGoodS < CELLIOT_KEEPALIVE_MIN_S )
+			{
+				pxCurrent->ulGoodS = CELLIOT_KEEPALIVE_MIN_S;
+			}
+			ucLostInRow = 0;
+			xChanged = true;
+		}
+	}
+
+	if( xChanged )
+	{
+		configPRINTF(("Keep-alive: idle %d s tolerated, %d s dropped\r\n", prvGoodS(), pxCurrent->ulBadS));
+		prvSave();
+	}
+	xSemaphoreGive(xKeepAliveMutex);
+}
+
+void CellIoT_keepalive_GetStats(CellIoTKeepAliveStats_t * pxStats)
+{
+	memset(pxStats, 0, sizeof(*pxStats));
+	if( xKeepAliveMutex == NULL )
+	{
+		return;
+	}
+
+	xSemaphoreTake(xKeepAliveMutex, portMAX_DELAY);
+	pxStats->ulOperator = pxCurrent->ulOperator;
+	pxStats->ulGoodS = prvGoodS();
+	pxStats->ulBadS = pxCurrent->ulBadS;
+	pxStats->ulIntervalS = prvIntervalS(UINT32_MAX / 1000U);
+	pxStats->ulPings = ulPings;
+	pxStats->ulLost = ulLost;
+	xSemaphoreGive(xKeepAliveMutex);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CELLIOT_KEEPALIVE_H_
+#define CELLIOT_KEEPALIVE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gsm_typedefs.h"
+
+/* mflash file holding the learned intervals */
+#define CELLIOT_KEEPALIVE_FILE_NAME		"CellIoT_KeepAlive.dat"
+
+/* Bump when the layout of the file changes */
+#define CELLIOT_KEEPALIVE_VERSION		( 2U )
+
+/* Number of operators remembered, the least recently used one is replaced */
+#ifndef CELLIOT_KEEPALIVE_OPERATORS
+#define CELLIOT_KEEPALIVE_OPERATORS		( 8U )
+#endif
+
+/* Floor when even the configured keep-alive is dropped by the NAT */
+#ifndef CELLIOT_KEEPALIVE_MIN_S
+#define CELLIOT_KEEPALIVE_MIN_S			( 60U )
+#endif
+
+/* Longest idle time probed, also the keep-alive announced in CONNECT */
+#ifndef CELLIOT_KEEPALIVE_MAX_S
+#define CELLIOT_KEEPALIVE_MAX_S			( 3600U )
+#endif
+
+/* Search stops when the tolerated and dropped idle times are this close */
+#ifndef CELLIOT_KEEPALIVE_RESOLUTION_S
+#define CELLIOT_KEEPALIVE_RESOLUTION_S	( 30U )
+#endif
+
+/* Unanswered pings in a row at a known good idle time before it is lowered.
+ * A single one is taken for a coverage gap rather than a NAT timeout.
+ */
+#ifndef CELLIOT_KEEPALIVE_FALLBACK
+#define CELLIOT_KEEPALIVE_FALLBACK		( 2U )
+#endif
+
+/* Pings sent at the known good idle time after a lost probe before probing again.
+ * Each lost probe costs a reconnect, this spaces them out.
+ */
+#ifndef CELLIOT_KEEPALIVE_HOLD_PINGS
+#define CELLIOT_KEEPALIVE_HOLD_PINGS	( 4U )
+#endif
+
+typedef struct
+{
+	uint32_t ulOperator;			/* operator the values apply to, 0 when unknown */
+	uint32_t ulGoodS;				/* longest idle time a ping was answered after */
+	uint32_t ulBadS;				/* shortest idle time a ping was lost after, 0 when none */
+	uint32_t ulIntervalS;			/* idle time pings are currently sent after */
+	uint32_t ulPings;				/* pings sent since boot */
+	uint32_t ulLost;				/* pings not answered since boot */
+} CellIoTKeepAliveStats_t;
+
+/*
+ * Ping interval learned per operator.
+ *
+ * The MQTT library only sends a PINGREQ after the connection stayed idle for
+ * the interval returned here, and reports whether it was answered. Carrier NATs
+ * silently drop idle TCP mappings, so the interval is searched upward from the
+ * configured keep-alive, which is assumed to work, between the longest idle
+ * time known to be tolerated and the shortest one known to break the
+ * connection: it doubles while no drop was seen, then bisects. Pings are never
+ * sent more often than with the configured keep-alive unless the NAT drops
+ * that too.
+ *
+ * A lost probe closes the MQTT connection. The application reconnects and the
+ * next pings use the last good idle time before probing again. The result is
+ * stored in flash for each operator (MCC/MNC) and used on the next attach.
+ */
+
+/* Call on GSM_EVT_INIT_FINISH: loads the intervals learned before */
+void CellIoT_keepalive_Load(void);
+
+/* Call on GSM_EVT_NETWORK_OPERATOR_CURRENT: selects the entry of the operator */
+void CellIoT_keepalive_SetOperator(const gsm_operator_curr_t * pxOperator);
+
+/* Keep-alive to announce in CONNECT, usBaselineS is the configured one known to work */
+uint16_t CellIoT_keepalive_GetKeepAliveS(uint16_t usBaselineS);
+
+/* Idle time after which to ping, at most ulMaxMs (the MQTT keep-alive) */
+uint32_t CellIoT_keepalive_GetIntervalMs(uint32_t ulMaxMs);
+
+/* Outcome of a ping sent after ulIdleMs without traffic */
+void CellIoT_keepalive_Report(uint32_t ulIdleMs, bool xAnswered);
+
+void CellIoT_keepalive_GetStats(CellIoTKeepAliveStats_t * pxStats);
+
+#endif /* CELLIOT_KEEPALIVE_H_ */
@@ -8,6 +8,7 @@
 
 #include "CellIoT_lib.h"
 #include "CellIoT_types.h"
+#include "gsm.h"
 #include "aws_clientcredential.h"
 
 #ifdef DEBUG_NAMING
@@ -15,146 +16,10 @@
 #endif
 
 uint8_t g_txBuffer[AT_BUFFER_SIZE] = {0};
-uint8_t g_rxBuffer_1[AT_BUFFER_SIZE] = {0};
-uint8_t g_rxBuffer_2[AT_BUFFER_SIZE] = {0};
-
-st_RXData sRXData[GSM_CFG_MAX_CONNS][BUFFER_POLLS_NB] = {
-											{
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][0].RxBuffer ,
-													.ptr_end = sRXData[0][0].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][1].RxBuffer ,
-													.ptr_end = sRXData[0][1].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][2].RxBuffer ,
-													.ptr_end = sRXData[0][2].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][3].RxBuffer ,
-													.ptr_end = sRXData[0][3].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][4].RxBuffer ,
-													.ptr_end = sRXData[0][4].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][5].RxBuffer ,
-													.ptr_end = sRXData[0][5].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][6].RxBuffer ,
-													.ptr_end = sRXData[0][6].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][7].RxBuffer ,
-													.ptr_end = sRXData[0][7].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][8].RxBuffer ,
-													.ptr_end = sRXData[0][8].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][9].RxBuffer ,
-													.ptr_end = sRXData[0][9].RxBuffer
-												},
-												{	.BytesPending = 0,
-													.connid = 0,
-													.RxBuffer = {0},
-													.ptr_start = sRXData[0][10].RxBuffer ,
-													.ptr_end = sRXData[0][10].RxBuffer
-												},
-//												{	.waitingForData = 0,
-//													.BytesPending = 0,
-//													.connid = 0,
-//													.RxBuffer = {0},
-//													.ptr_start = sRXData[0][11].RxBuffer ,
-//													.ptr_end = sRXData[0][11].RxBuffer
-//												},
-//												{	.waitingForData = 0,
-//													.BytesPending = 0,
-//													.connid = 0,
-//													.RxBuffer = {0},
-//													.ptr_start = sRXData[0][12].RxBuffer ,
-//													.ptr_end = sRXData[0][12].RxBuffer
-//												},
-//												{	.waitingForData = 0,
-//													.BytesPending = 0,
-//													.connid = 0,
-//													.RxBuffer = {0},
-//													.ptr_start = sRXData[0][13].RxBuffer ,
-//													.ptr_end = sRXData[0][13].RxBuffer
-//												},
-//												{	.waitingForData = 0,
-//													.BytesPending = 0,
-//													.connid = 0,
-//													.RxBuffer = {0},
-//													.ptr_start = sRXData[0][14].RxBuffer ,
-//													.ptr_end = sRXData[0][14].RxBuffer
-//												},
-//												{	.waitingForData = 0,
-//													.BytesPending = 0,
-//													.connid = 0,
-//													.RxBuffer = {0},
-//													.ptr_start = sRXData[0][15].RxBuffer ,
-//													.ptr_end = sRXData[0][15].RxBuffer
-//												},
-//												{	.waitingForData = 0,
-//													.BytesPending = 0,
-//													.connid = 0,
-//													.RxBuffer = {0},
-//													.ptr_start = sRXData[0][16].RxBuffer ,
-//													.ptr_end = sRXData[0][16].RxBuffer
-//												},
-//												{	.waitingForData = 0,
-//													.BytesPending = 0,
-//													.connid = 0,
-//													.RxBuffer = {0},
-//													.ptr_start = sRXData[0][17].RxBuffer ,
-//													.ptr_end = sRXData[0][17].RxBuffer
-//												},
-//												{	.waitingForData = 0,
-//													.BytesPending = 0,
-//													.connid = 0,
-//													.RxBuffer = {0},
-//													.ptr_start = sRXData[0][18].RxBuffer ,
-//													.ptr_end = sRXData[0][18].RxBuffer
-//												},
-//												{	.waitingForData = 0,
-//													.BytesPending = 0,
-//													.connid = 0,
-//													.RxBuffer = {0},
-//													.ptr_start = sRXData[0][19].RxBuffer ,
-//													.ptr_end = sRXData[0][19].RxBuffer
-//												}
-
-											}
-};
-
-uint8_t u8_nextFreeBufferPool = 0;				/*!< Variable that hold the next buffer structure where data can be stored */
-uint8_t u8_nextBufferPoolForData = 0;			/*!< Variable that hold the 1st buffer structure where data is available to read */
+uint8_t g_rxRing[AT_RX_RING_SIZE] = {0};
+
+st_RXData sRXData[BUFFER_POLLS_NB] = {0};			/*!< Buffer polls shared by all the connections */
+st_RXQueue sRXQueue[GSM_CFG_MAX_CONNS] = {0};		/*!< Buffers holding the data of each connection */
 
 /**
  * \brief           Write a Certificate or a private Key in Non-Volatile Memory
@@ -188,22 +53,25 @@ CellIoT_lib_WriteCertKeyInNVM(const char * certkey, SQNS_MQTT_CERTORKEY type, ui
 /**
  * \brief           Query to DNS server to resolve the host name into an IP address
  * \param[in]       hostName: URL Host name
+ * \param[out]      ip: Resolved IP address of the host
  * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
  * \param[in]       evt_arg: Custom argument for event callback function
  * \param[in]       blocking: Status whether command should be blocking or not
  * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
  */
 gsmr_t
-CellIoT_lib_getHostIP(const char * hostName, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking)
+CellIoT_lib_getHostIP(const char * hostName, gsm_ip_t* ip, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking)
 {
     GSM_MSG_VAR_DEFINE(msg);
 
     GSM_ASSERT("hostName != NULL", hostName != NULL);
+    GSM_ASSERT("ip != NULL", ip != NULL);
 
     GSM_MSG_VAR_ALLOC(msg, blocking);
     GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SQNDNSLKUP;
     GSM_MSG_VAR_REF(msg).msg.host_ip_config.hostName = hostName;
+    GSM_MSG_VAR_REF(msg).msg.host_ip_config.ip = ip;
 
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 30000);
 }
@@ -211,7 +79,9 @@ CellIoT_lib_getHostIP(const char * hostName, const gsm_api_cmd_evt_fn evt_fn, vo
 /**
  * \brief           Opens a remote connection via socket
  * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
- * \param[in]       txProt: Specify if certificate or private key will be used
+ * \param[in]       txProt: Transmission protocol
+ * 						0: TCP
+ * 						1: UDP
  * \param[in]       rHostPort: Memory slot
  * \param[in]       ip: Host IP Address
  * \param[in]       closureType: Socket closure behaviour for TCP, has no effect for UDP connections
@@ -235,7 +105,7 @@ CellIoT_lib_socketDial(	uint8_t connId,
 						uint16_t rHostPort,
 						const char* ip,
 						uint8_t closureType,
-						uint8_t lPort,
+						uint16_t lPort,
 						uint8_t connMode,
 						uint8_t acceptAnyRemote,
 						const gsm_api_cmd_evt_fn evt_fn,
@@ -270,10 +140,28 @@ CellIoT_lib_socketDial(	uint8_t connId,
  */
 gsmr_t
 CellIoT_lib_socketSend( uint8_t connId, const unsigned char * pTX , uint32_t sTx )
+{
+    return CellIoT_lib_socketSendExt( connId, pTX, sTx, NULL, NULL, 1 );
+}
+
+/**
+ * \brief           Send data over a socket which was established before
+ * \note            In non-blocking mode the data must stay valid until the callback is called
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \param[in]       pTX: Pointer to the data to be sent
+ * \param[in]       sTx: Number of bytes to be sent
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+CellIoT_lib_socketSendExt( uint8_t connId, const unsigned char * pTX , uint32_t sTx, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking )
 {
     GSM_MSG_VAR_DEFINE(msg);
 
-    GSM_MSG_VAR_ALLOC(msg, 1);// blocking
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SQNSSENDEXT;
     GSM_MSG_VAR_REF(msg).msg.tx_data.connId = connId;
     GSM_MSG_VAR_REF(msg).msg.tx_data.ptrTx = pTX;
@@ -306,58 +194,399 @@ CellIoT_lib_socketRecv( uint8_t connId, uint32_t bytes_pending )
  * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
  * \param[in]       pointer to the data to be read
  * \param[in]       number of bytes to be read
- * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ * \return          Number of bytes read, 0 when no data is pending on the connection
  */
 uint32_t
 CellIoT_lib_socketReadData( uint8_t connId, unsigned char * pRX , uint16_t rcvlen )
 {
 	uint32_t ret = 0;
+	uint32_t len;
+	st_RXQueue * queue;
+	st_RXData * rx;
+
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return ret;
+	}
+	queue = &sRXQueue[connId - 1];
 
 	/* If no bytes to read, just return 0 to simulate a time out */
-	if( sRXData[connId - 1][u8_nextBufferPoolForData].BytesPending == 0 )
+	if( queue->count == 0 )
 	{
 		return ret;
 	}
 
-	if( rcvlen >= sRXData[connId - 1][u8_nextBufferPoolForData].BytesPending )
+	gsm_core_lock();
+	while( ( queue->count > 0 ) && ( ret < rcvlen ) )
 	{
-		/* The Application wants more bytes than the buffer can hold
-		 * Therefore read all the pending bytes by copying in the provided pointer
-		 * Clear the buffer, decrease the number of pending reads to do
-		 * and change the buffer buffer to then next one
+		/* Copy from the oldest buffer of the connection as much as the
+		 * Application wants, then move to the next one if it is empty
 		 */
-		memcpy( pRX,
-				sRXData[connId - 1][u8_nextBufferPoolForData].ptr_start,
-				sRXData[connId - 1][u8_nextBufferPoolForData].BytesPending
-				);
+		rx = &sRXData[queue->bufferIdx[queue->head]];
+		len = rx->BytesPending < ( uint32_t )( rcvlen - ret ) ? rx->BytesPending : ( uint32_t )( rcvlen - ret );
+
+		memcpy( &pRX[ret], rx->ptr_start, len );
+
+		ret += len;
+		rx->BytesPending -= len;
+		rx->ptr_start += len;
+		queue->BytesQueued -= len;
+
+		if( rx->BytesPending == 0 )
+		{
+			/* Give the buffer back to the polls */
+			rx->connid = 0;
+			rx->ptr_start = rx->RxBuffer;
+			rx->ptr_end = rx->RxBuffer;
+
+			queue->head == BUFFER_POLLS_NB - 1U ? queue->head = 0U : queue->head++;
+			queue->count--;
+		}
+	}
+	gsm_core_unlock();
 
-		ret = sRXData[connId - 1][u8_nextBufferPoolForData].BytesPending;
+    return ret;
+}
 
-		sRXData[connId - 1][u8_nextBufferPoolForData].BytesPending = 0;
-		sRXData[connId - 1][u8_nextBufferPoolForData].ptr_start = sRXData[connId - 1][u8_nextBufferPoolForData].RxBuffer;
-		sRXData[connId - 1][u8_nextBufferPoolForData].ptr_end = sRXData[connId - 1][u8_nextBufferPoolForData].RxBuffer;
+/**
+ * \brief           Get the oldest data received on a connection without copying it
+ * \note            The data stays valid until \ref CellIoT_lib_socketSkipData releases it.
+ *                  Only one consumer may read a connection with the peek/skip pair: a
+ *                  \ref CellIoT_lib_socketReadData or another peek/skip on the same
+ *                  connection in between would release the data the pointer refers to
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \param[out]      ppRX: Pointer to the data
+ * \return          Number of bytes readable at once, 0 when no data is pending on the connection
+ */
+uint32_t
+CellIoT_lib_socketPeekData( uint8_t connId, unsigned char ** ppRX )
+{
+	uint32_t ret = 0;
+	st_RXQueue * queue;
+	st_RXData * rx;
 
-		u8_nextBufferPoolForData == BUFFER_POLLS_NB - 1U ? u8_nextBufferPoolForData = 0U : u8_nextBufferPoolForData++;
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return ret;
 	}
-	else
+	queue = &sRXQueue[connId - 1];
+
+	gsm_core_lock();
+	if( queue->count > 0 )
 	{
-		/* The Application wants only a part of the received message
-		 * Therefore read the required bytes by copying in the provided pointer
-		 * Reduce the number of pending bytes and update the next start pointer
-		 * to the next character to read
-		 */
-		memcpy( pRX,
-				sRXData[connId - 1][u8_nextBufferPoolForData].ptr_start,
-				rcvlen
-				);
+		rx = &sRXData[queue->bufferIdx[queue->head]];
+		*ppRX = (unsigned char *) rx->ptr_start;
+		ret = rx->BytesPending;
+	}
+	gsm_core_unlock();
 
-		sRXData[connId - 1][u8_nextBufferPoolForData].BytesPending -= rcvlen;
-		sRXData[connId - 1][u8_nextBufferPoolForData].ptr_start += rcvlen;
+	return ret;
+}
+
+/**
+ * \brief           Release data returned by \ref CellIoT_lib_socketPeekData
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \param[in]       len: Number of bytes consumed, at most the value returned by the peek.
+ *                  Skipping more is a caller error and asserts
+ */
+void
+CellIoT_lib_socketSkipData( uint8_t connId, uint32_t len )
+{
+	st_RXQueue * queue;
+	st_RXData * rx;
 
-		ret = rcvlen;
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return;
 	}
+	queue = &sRXQueue[connId - 1];
 
-    return ret;
+	gsm_core_lock();
+	if( queue->count > 0 )
+	{
+		rx = &sRXData[queue->bufferIdx[queue->head]];
+		configASSERT( len <= rx->BytesPending );
+
+		/* Only reached with configASSERT disabled, keep the counters consistent */
+		len = len < rx->BytesPending ? len : rx->BytesPending;
+
+		rx->BytesPending -= len;
+		rx->ptr_start += len;
+		queue->BytesQueued -= len;
+
+		if( rx->BytesPending == 0 )
+		{
+			/* Give the buffer back to the polls */
+			rx->connid = 0;
+			rx->ptr_start = rx->RxBuffer;
+			rx->ptr_end = rx->RxBuffer;
+
+			queue->head == BUFFER_POLLS_NB - 1U ? queue->head = 0U : queue->head++;
+			queue->count--;
+		}
+	}
+	gsm_core_unlock();
+}
+
+/**
+ * \brief           Read one datagram received on a UDP connection
+ * \note            Message boundaries are kept: one call never returns the data of two datagrams.
+ *                  When the datagram is bigger than the buffer of the Application,
+ *                  the remaining bytes are discarded like a BSD socket would
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \param[in]       pointer to the data to be read
+ * \param[in]       size of the buffer
+ * \param[out]      ip: Source address of the datagram. Set to `NULL` when not used
+ * \param[out]      port: Source port of the datagram. Set to `NULL` when not used
+ * \return          Number of bytes read, 0 when no datagram is pending on the connection
+ */
+uint32_t
+CellIoT_lib_socketReadDatagram( uint8_t connId, unsigned char * pRX , uint16_t rcvlen, gsm_ip_t * ip, gsm_port_t * port )
+{
+	uint32_t ret = 0;
+	st_RXQueue * queue;
+	st_RXData * rx;
+
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return ret;
+	}
+	queue = &sRXQueue[connId - 1];
+
+	if( queue->count == 0 )
+	{
+		return ret;
+	}
+
+	gsm_core_lock();
+	if( queue->count > 0 )
+	{
+		rx = &sRXData[queue->bufferIdx[queue->head]];
+		ret = rx->BytesPending < rcvlen ? rx->BytesPending : rcvlen;
+
+		memcpy( pRX, rx->ptr_start, ret );
+		if( ip != NULL )
+		{
+			GSM_MEMCPY( ip, &rx->ip, sizeof(*ip) );
+		}
+		if( port != NULL )
+		{
+			*port = rx->port;
+		}
+
+		/* Truncated datagram, the end of it cannot be read later */
+		if( rx->BytesPending > ret )
+		{
+			queue->BytesDropped += rx->BytesPending - ret;
+			queue->DatagramsDropped++;
+		}
+		queue->BytesQueued -= rx->BytesPending;
+
+		/* Give the buffer back to the polls */
+		rx->BytesPending = 0;
+		rx->connid = 0;
+		rx->ptr_start = rx->RxBuffer;
+		rx->ptr_end = rx->RxBuffer;
+
+		queue->head == BUFFER_POLLS_NB - 1U ? queue->head = 0U : queue->head++;
+		queue->count--;
+	}
+	gsm_core_unlock();
+
+	return ret;
+}
+
+/**
+ * \brief           Allocate a free connection ID to a socket
+ * \return          Connection ID between 1 and GSM_CFG_MAX_CONNS, 0 if all the connections are in use
+ */
+uint8_t
+CellIoT_lib_socketAlloc(void)
+{
+	uint8_t connId = 0;
+
+	gsm_core_lock();
+	for( uint8_t i = 0; i < GSM_CFG_MAX_CONNS; i++ )
+	{
+		if( !gsm.m.conns[i].status.f.reserved )
+		{
+			gsm.m.conns[i].status.f.active = 0;
+			gsm.m.conns[i].status.f.reserved = 1;
+			gsm.m.conns[i].num = i + 1;
+			GSM_MEMSET(&sRXQueue[i], 0x00, sizeof(sRXQueue[i]));
+			connId = i + 1;
+			break;
+		}
+	}
+	gsm_core_unlock();
+
+	return connId;
+}
+
+/**
+ * \brief           Release a connection ID allocated by \ref CellIoT_lib_socketAlloc
+ * \note            Data still pending on the connection is discarded
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ */
+void
+CellIoT_lib_socketFree(uint8_t connId)
+{
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return;
+	}
+
+	gsm_core_lock();
+	CellIoT_lib_rxPoolFlush(connId);
+	gsm.m.conns[connId - 1].status.f.active = 0;
+	gsm.m.conns[connId - 1].status.f.reserved = 0;
+	gsm_core_unlock();
+}
+
+/**
+ * \brief           Check if the module connection is open
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \return          1 if the connection is open, 0 if it was never opened or has been closed by the module
+ */
+uint8_t
+CellIoT_lib_socketIsOpen(uint8_t connId)
+{
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return 0;
+	}
+
+	return gsm.m.conns[connId - 1].status.f.active;
+}
+
+/**
+ * \brief           Check if a buffer poll can be given to a connection
+ * \note            One buffer is always kept for each other socket having no data queued,
+ *                  so a socket which is not read by the Application cannot stall the others
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \return          1 if data can be received on the connection, 0 otherwise
+ */
+uint8_t
+CellIoT_lib_rxPoolCanAccept(uint8_t connId)
+{
+	uint8_t freeBuffers = 0;
+	uint8_t keptBuffers = 0;
+
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return 0;
+	}
+
+	for( uint8_t i = 0; i < BUFFER_POLLS_NB; i++ )
+	{
+		if( sRXData[i].connid == 0 )
+		{
+			freeBuffers++;
+		}
+	}
+
+	for( uint8_t i = 0; i < GSM_CFG_MAX_CONNS; i++ )
+	{
+		if( ( i != connId - 1 ) && gsm.m.conns[i].status.f.reserved && ( sRXQueue[i].count == 0 ) )
+		{
+			keptBuffers++;
+		}
+	}
+
+	return ( freeBuffers > 0 ) && ( ( sRXQueue[connId - 1].count == 0 ) || ( freeBuffers > keptBuffers ) );
+}
+
+/**
+ * \brief           Take a buffer poll and queue it on a connection
+ * \note            Must be called with the core locked, the buffer has to be filled before unlocking
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \param[in]       size: Number of bytes which will be written in the buffer
+ * \return          Pointer to the buffer, NULL if the connection is not allocated or no buffer is free
+ */
+st_RXData *
+CellIoT_lib_rxPoolGet(uint8_t connId, uint32_t size)
+{
+	st_RXQueue * queue;
+	st_RXData * rx = NULL;
+
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return NULL;
+	}
+	queue = &sRXQueue[connId - 1];
+
+	if( gsm.m.conns[connId - 1].status.f.reserved && ( size <= CELLULAR_BUFFER_SIZE ) )
+	{
+		for( uint8_t i = 0; i < BUFFER_POLLS_NB; i++ )
+		{
+			if( sRXData[i].connid == 0 )
+			{
+				rx = &sRXData[i];
+				rx->connid = connId;
+				rx->BytesPending = size;
+				rx->ptr_start = rx->RxBuffer;
+				rx->ptr_end = rx->RxBuffer;
+				GSM_MEMCPY(&rx->ip, &gsm.m.conns[connId - 1].remote_ip, sizeof(rx->ip));
+				rx->port = gsm.m.conns[connId - 1].remote_port;
+
+				queue->bufferIdx[( queue->head + queue->count ) % BUFFER_POLLS_NB] = i;
+				queue->count++;
+				queue->BytesQueued += size;
+				queue->BytesReceived += size;
+				break;
+			}
+		}
+	}
+
+	if( rx == NULL )
+	{
+		queue->BytesDropped += size;
+		if( gsm.m.conns[connId - 1].type == GSM_CONN_TYPE_UDP )
+		{
+			queue->DatagramsDropped++;
+		}
+	}
+
+	return rx;
+}
+
+/**
+ * \brief           Discard the data pending on a connection
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \return          Number of bytes discarded
+ */
+uint32_t
+CellIoT_lib_rxPoolFlush(uint8_t connId)
+{
+	st_RXQueue * queue;
+	st_RXData * rx;
+	uint32_t dropped;
+
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return 0;
+	}
+	queue = &sRXQueue[connId - 1];
+
+	gsm_core_lock();
+	dropped = queue->BytesQueued;
+	while( queue->count > 0 )
+	{
+		rx = &sRXData[queue->bufferIdx[queue->head]];
+		rx->connid = 0;
+		rx->BytesPending = 0;
+		rx->ptr_start = rx->RxBuffer;
+		rx->ptr_end = rx->RxBuffer;
+
+		queue->head == BUFFER_POLLS_NB - 1U ? queue->head = 0U : queue->head++;
+		queue->count--;
+	}
+	queue->head = 0;
+	queue->BytesQueued = 0;
+	queue->BytesDropped += dropped;
+	gsm_core_unlock();
+
+	return dropped;
 }
 
 
@@ -392,9 +621,9 @@ CellIoT_lib_setSocketSecurity(uint8_t spId, uint8_t connId, uint8_t enable, cons
  * \param[in]       version: TLS Profile version
  * \param[in]       cipherSpecs: Exact list of cipher suite to be used, 8-bit hexadecimal "0x" prefixed IANA numbers, semicolon delimited
  * \param[in]       certValidLevel: Server certificate validation 8-bit field
- * \param[in]       caCertificateID: Trusted Certificate Authority certificate ID, integer in range [0-19]
- * \param[in]       clientCertificateID: Client certificate ID, integer in range [0-19]
- * \param[in]       clientPrivateKeyID: Client private key ID, integer in range [0-19]
+ * \param[in]       caCertificateID: Trusted Certificate Authority certificate ID, integer in range [0-19], \ref SQNS_NVM_SLOT_NONE if not used
+ * \param[in]       clientCertificateID: Client certificate ID, integer in range [0-19], \ref SQNS_NVM_SLOT_NONE if not used
+ * \param[in]       clientPrivateKeyID: Client private key ID, integer in range [0-19], \ref SQNS_NVM_SLOT_NONE if not used
  * \param[in]       psk: Pre-shared key used for connection (when a TLS_PSK_* cipher suite is used)
  * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
  * \param[in]       evt_arg: Custom argument for event callback function
@@ -490,6 +719,71 @@ CellIoT_lib_setSocketCfg(uint8_t connId, uint8_t cid, uint16_t pktsize, uint16_t
     return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 30000);
 }
 
+/**
+ * \brief           Read back the settings of one connection or security profile
+ * \param[in]       cmd: Read command of the setting
+ * \param[in]       id: Connection or security profile ID
+ * \param[out]      params: Buffer for the parameters following the ID, as listed by the module
+ * \param[in]       params_len: Size of params buffer, the string is truncated to fit
+ * \return          \ref gsmOK on success, \ref gsmERR when the module does not list the ID,
+ *                  member of \ref gsmr_t enumeration otherwise
+ */
+static gsmr_t
+CellIoT_lib_getCfg(gsm_cmd_t cmd, uint8_t id, char * params, size_t params_len)
+{
+    GSM_MSG_VAR_DEFINE(msg);
+
+    GSM_ASSERT("params != NULL", params != NULL);
+    GSM_ASSERT("params_len > 0", params_len > 0);
+
+    GSM_MSG_VAR_ALLOC(msg, 1);// blocking
+    GSM_MSG_VAR_REF(msg).cmd_def = cmd;
+    GSM_MSG_VAR_REF(msg).msg.cfg_get.id = id;
+    GSM_MSG_VAR_REF(msg).msg.cfg_get.params = params;
+    GSM_MSG_VAR_REF(msg).msg.cfg_get.params_len = params_len;
+
+    return gsmi_send_msg_to_producer_mbox(&GSM_MSG_VAR_REF(msg), gsmi_initiate_cmd, 10000);
+}
+
+/**
+ * \brief           Read back the security profile parameters with AT+SQNSPCFG?
+ * \param[in]       spId: Security profile identifier
+ * \param[out]      params: Buffer for the parameters following the profile ID
+ * \param[in]       params_len: Size of params buffer
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+CellIoT_lib_getTLSSecurityProfileCfg(uint8_t spId, char * params, size_t params_len)
+{
+    return CellIoT_lib_getCfg(GSM_CMD_SQNSPCFG_GET, spId, params, params_len);
+}
+
+/**
+ * \brief           Read back the socket configuration extended parameters with AT+SQNSCFGEXT?
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \param[out]      params: Buffer for the parameters following the connection ID
+ * \param[in]       params_len: Size of params buffer
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+CellIoT_lib_getSocketCfgExt(uint8_t connId, char * params, size_t params_len)
+{
+    return CellIoT_lib_getCfg(GSM_CMD_SQNSCFGEXT_GET, connId, params, params_len);
+}
+
+/**
+ * \brief           Read back the socket configuration parameters with AT+SQNSCFG?
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \param[out]      params: Buffer for the parameters following the connection ID
+ * \param[in]       params_len: Size of params buffer
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+CellIoT_lib_getSocketCfg(uint8_t connId, char * params, size_t params_len)
+{
+    return CellIoT_lib_getCfg(GSM_CMD_SQNSCFG_GET, connId, params, params_len);
+}
+
 /**
  * \brief           Close a socket connection
  * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
@@ -497,10 +791,25 @@ CellIoT_lib_setSocketCfg(uint8_t connId, uint8_t cid, uint16_t pktsize, uint16_t
  */
 gsmr_t
 CellIoT_lib_socketClose(uint32_t connId)
+{
+    return CellIoT_lib_socketCloseExt(connId, NULL, NULL, 1);
+}
+
+/**
+ * \brief           Close a socket connection
+ * \param[in]       connId: Connection ID, must be between 1 and GSM_CFG_MAX_CONNS
+ * \param[in]       evt_fn: Callback function called when command has finished. Set to `NULL` when not used
+ * \param[in]       evt_arg: Custom argument for event callback function
+ * \param[in]       blocking: Status whether command should be blocking or not
+ * \return          \ref gsmOK on success, member of \ref gsmr_t enumeration otherwise
+ */
+gsmr_t
+CellIoT_lib_socketCloseExt(uint32_t connId, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking)
 {
     GSM_MSG_VAR_DEFINE(msg);
 
-    GSM_MSG_VAR_ALLOC(msg, 1);// blocking
+    GSM_MSG_VAR_ALLOC(msg, blocking);
+    GSM_MSG_VAR_SET_EVT(msg, evt_fn, evt_arg);
     GSM_MSG_VAR_REF(msg).cmd_def = GSM_CMD_SQNSH;
     GSM_MSG_VAR_REF(msg).msg.socket_dial.connId = connId;
 
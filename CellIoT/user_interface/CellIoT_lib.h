@@ -24,37 +24,77 @@
 
 #define AT_BUFFER_SIZE (0x400U)
 
+/* AT receive ring, filled by a circular chain of DMA descriptors of AT_RX_SEGMENT_SIZE bytes.
+ * Both sizes must be powers of two, a segment cannot exceed 1023 bytes (DMA transfer count).
+ */
+#ifndef AT_RX_RING_SIZE
+#define AT_RX_RING_SIZE (0x1000U)
+#endif
+#ifndef AT_RX_SEGMENT_SIZE
+#define AT_RX_SEGMENT_SIZE (0x200U)
+#endif
+
+/* Certificate ID of a security profile when no certificate is used */
+#define SQNS_NVM_SLOT_NONE	0xFFU
+
 typedef struct ST_RXDATAPENDING_TAG
 {
 	uint32_t BytesPending;					/*!< Number of Bytes pending to be read by the Application */
-	uint32_t connid;						/*!< Connection ID of the received message */
+	uint32_t connid;						/*!< Connection ID of the received message, 0 when the buffer is free */
 	char RxBuffer[CELLULAR_BUFFER_SIZE];	/*!< RX Buffer poll */
 	char * ptr_start;						/*!< Pointer of the next character to read */
 	char * ptr_end;							/*!< Pointer of the last character to read */
+	gsm_ip_t ip;							/*!< Source address of the data, for UDP connections */
+	gsm_port_t port;						/*!< Source port of the data, for UDP connections */
 } st_RXData;
 
-extern st_RXData sRXData[GSM_CFG_MAX_CONNS][BUFFER_POLLS_NB];
-extern uint8_t u8_nextFreeBufferPool;
-extern uint8_t u8_nextBufferPoolForData;
+/* The buffer polls are shared by all the connections. Each connection keeps
+ * the buffers holding its data in a FIFO, so the application reads the data
+ * of a socket in the order the module delivered it whatever the other sockets do.
+ * On UDP connections a buffer holds exactly one datagram.
+ */
+typedef struct ST_RXQUEUE_TAG
+{
+	uint8_t bufferIdx[BUFFER_POLLS_NB];		/*!< Index in sRXData of the buffers holding data, oldest first */
+	uint8_t head;							/*!< Position of the oldest buffer in bufferIdx */
+	uint8_t count;							/*!< Number of buffers queued */
+	uint32_t BytesQueued;					/*!< Number of Bytes pending to be read by the Application */
+	uint32_t BytesReceived;					/*!< Total number of Bytes received on the connection */
+	uint32_t BytesDropped;					/*!< Number of Bytes discarded (no free buffer or connection closed) */
+	uint32_t DatagramsDropped;				/*!< Number of UDP datagrams lost (no free buffer) or truncated by the Application */
+} st_RXQueue;
+
+extern st_RXData sRXData[BUFFER_POLLS_NB];
+extern st_RXQueue sRXQueue[GSM_CFG_MAX_CONNS];
 
 extern uint8_t g_txBuffer[AT_BUFFER_SIZE];
-extern uint8_t g_rxBuffer_1[AT_BUFFER_SIZE];
-extern uint8_t g_rxBuffer_2[AT_BUFFER_SIZE];
+extern uint8_t g_rxRing[AT_RX_RING_SIZE];
 
 /**********************************************************************************:
  *    Non-Volatile Memory
  **********************************************************************************/
 void DMA_Callback(dma_handle_t *handle, void *param, bool transferDone, uint32_t tcds);
 void Timer_CallbackHandler( uint32_t flags );
+void USART_TxCallbackHandler(USART_Type *base, usart_dma_handle_t *handle, status_t status, void *userData);
 gsmr_t CellIoT_lib_WriteCertKeyInNVM(const char * certkey, SQNS_MQTT_CERTORKEY type, uint8_t index, size_t certkeysize, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 bool CellIoT_lib_ReadCertKeyInNVM(SQNS_MQTT_CERTORKEY type, uint8_t index);
 bool CellIoT_lib_DeleteCertKeyInNVM(SQNS_MQTT_CERTORKEY type, uint8_t index);
 
-gsmr_t CellIoT_lib_getHostIP(const char * hostName, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
-gsmr_t CellIoT_lib_socketDial(uint8_t connId, uint8_t txProt, uint16_t rHostPort, const char* ip, uint8_t closureType, uint8_t lPort, uint8_t connMode, uint8_t acceptAnyRemote, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+gsmr_t CellIoT_lib_getHostIP(const char * hostName, gsm_ip_t* ip, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
+uint8_t CellIoT_lib_socketAlloc(void);
+void CellIoT_lib_socketFree(uint8_t connId);
+uint8_t CellIoT_lib_socketIsOpen(uint8_t connId);
+uint8_t CellIoT_lib_rxPoolCanAccept(uint8_t connId);
+st_RXData * CellIoT_lib_rxPoolGet(uint8_t connId, uint32_t size);
+uint32_t CellIoT_lib_rxPoolFlush(uint8_t connId);
+gsmr_t CellIoT_lib_socketDial(uint8_t connId, uint8_t txProt, uint16_t rHostPort, const char* ip, uint8_t closureType, uint16_t lPort, uint8_t connMode, uint8_t acceptAnyRemote, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t CellIoT_lib_socketSend( uint8_t connId, const unsigned char * pTX , uint32_t sTx );
+gsmr_t CellIoT_lib_socketSendExt( uint8_t connId, const unsigned char * pTX , uint32_t sTx, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking );
 gsmr_t CellIoT_lib_socketRecv( uint8_t connId, uint32_t bytes_pending );
 uint32_t CellIoT_lib_socketReadData( uint8_t connId, unsigned char * pRX , uint16_t rcvlen );
+uint32_t CellIoT_lib_socketPeekData( uint8_t connId, unsigned char ** ppRX );
+void CellIoT_lib_socketSkipData( uint8_t connId, uint32_t len );
+uint32_t CellIoT_lib_socketReadDatagram( uint8_t connId, unsigned char * pRX , uint16_t rcvlen, gsm_ip_t * ip, gsm_port_t * port );
 gsmr_t CellIoT_lib_setSocketSecurity(uint8_t spId, uint8_t connId, uint8_t enable, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t CellIoT_lib_setTLSSecurityProfileCfg(	uint8_t spId,
 									uint8_t version,
@@ -69,7 +109,11 @@ gsmr_t CellIoT_lib_setTLSSecurityProfileCfg(	uint8_t spId,
 									const uint32_t blocking);
 gsmr_t CellIoT_lib_setSocketCfgExt(uint8_t connId, uint8_t srMode, uint8_t recvDataMode, uint8_t keepalive, uint8_t listenAutoRsp, uint8_t sendDataMode, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t CellIoT_lib_setSocketCfg(uint8_t connId, uint8_t cid, uint16_t pktsize, uint16_t maxto, uint32_t connto , uint32_t txTo , const uint32_t blocking);
+gsmr_t CellIoT_lib_getTLSSecurityProfileCfg(uint8_t spId, char * params, size_t params_len);
+gsmr_t CellIoT_lib_getSocketCfgExt(uint8_t connId, char * params, size_t params_len);
+gsmr_t CellIoT_lib_getSocketCfg(uint8_t connId, char * params, size_t params_len);
 gsmr_t CellIoT_lib_socketClose( uint32_t connId);
+gsmr_t CellIoT_lib_socketCloseExt( uint32_t connId, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
 gsmr_t CellIoT_lib_setLogInModule(void);
 gsmr_t CellIoT_lib_readConfTestMode(void);
 gsmr_t CellIoT_lib_setConfTestMode(const char * ctm, const gsm_api_cmd_evt_fn evt_fn, void* const evt_arg, const uint32_t blocking);
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "fsl_ctimer.h"
+#include "CellIoT_profile.h"
+
+#define PROFILE_CTIMER					CTIMER2
+
+static TaskStatus_t xStatus[CELLIOT_PROFILE_MAX_TASKS];
+static CellIoTTaskSample_t xSamples[2][CELLIOT_PROFILE_MAX_TASKS];
+static uint8_t ucSamples[2];
+static uint8_t ucCurrent;						/* xSamples[ucCurrent] is the latest sample */
+static uint32_t ulLastTotal;
+static bool xFirstTaken;
+
+static CellIoTProfile_t xLatest;
+static bool xLatestValid;
+static TimerHandle_t xProfileTimer;
+
+
+void CellIoT_profile_InitTimer(void)
+{
+	ctimer_config_t xConfig;
+
+	CLOCK_AttachClk(kFRO_HF_to_CTIMER2);
+	CTIMER_GetDefaultConfig(&xConfig);
+	xConfig.prescale = ( CLOCK_GetCTimerClkFreq(2U) / CELLIOT_PROFILE_TIMER_HZ ) - 1U;
+	CTIMER_Init(PROFILE_CTIMER, &xConfig);
+	CTIMER_StartTimer(PROFILE_CTIMER);
+}
+
+uint32_t CellIoT_profile_GetTimer(void)
+{
+	return CTIMER_GetTimerCountValue(PROFILE_CTIMER);
+}
+
+void CellIoT_profile_Aggregate(const CellIoTTaskSample_t * pxPrev, uint8_t ucPrev,
+							   const CellIoTTaskSample_t * pxCurr, uint8_t ucCurr,
+							   uint32_t ulPeriod, CellIoTProfile_t * pxProfile)
+{
+	CellIoTTaskLoad_t xLoad;
+	uint32_t ulRun, ulBusy = 0;
+	uint8_t i, j;
+
+	pxProfile->ulPeriod = ulPeriod;
+	pxProfile->ucTasks = 0;
+
+	for( i = 0; ( i < ucCurr ) && ( i < CELLIOT_PROFILE_MAX_TASKS ); i++ )
+	{
+		/* A task created since the previous sample ran for its whole counter */
+		ulRun = pxCurr[i].ulRunTime;
+		for( j = 0; j < ucPrev; j++ )
+		{
+			if( pxPrev[j].ulTaskNumber == pxCurr[i].ulTaskNumber )
+			{
+				ulRun = pxCurr[i].ulRunTime - pxPrev[j].ulRunTime;
+				break;
+			}
+		}
+		if( ulRun > ulPeriod )
+		{
+			ulRun = ulPeriod;
+		}
+
+		memcpy(xLoad.cName, pxCurr[i].cName, sizeof(xLoad.cName));
+		xLoad.cName[sizeof(xLoad.cName) - 1U] = '\0';
+		xLoad.usCpuPermille = ( ulPeriod != 0 ) ? (uint16_t) ( ( (uint64_t) ulRun * 1000U ) / ulPeriod ) : 0U;
+		xLoad.usStackFree = pxCurr[i].usStackFree;
+		if( !pxCurr[i].xIdle )
+		{
+			ulBusy += ulRun;
+		}
+
+		/* Insertion, busiest first */
+		for( j = pxProfile->ucTasks; ( j > 0 ) && ( pxProfile->xTasks[j - 1U].usCpuPermille < xLoad.usCpuPermille ); j-- )
+		{
+			pxProfile->xTasks[j] = pxProfile->xTasks[j - 1U];
+		}
+		pxProfile->xTasks[j] = xLoad;
+		pxProfile->ucTasks++;
+	}
+
+	if( ulBusy > ulPeriod )
+	{
+		ulBusy = ulPeriod;
+	}
+	pxProfile->usCpuPermille = ( ulPeriod != 0 ) ? (uint16_t) ( ( (uint64_t) ulBusy * 1000U ) / ulPeriod ) : 0U;
+}
+
+size_t CellIoT_profile_Format(const CellIoTProfile_t * pxProfile, char * pcBuffer, size_t xBufferLen)
+{
+	size_t xLen;
+	int iLen;
+	uint8_t i;
+
+	iLen = snprintf(pcBuffer, xBufferLen, "{\"cpu\":%u,\"heap\":%u,\"heapMin\":%u,\"tasks\":[",
+					pxProfile->usCpuPermille, (unsigned) pxProfile->ulHeapFree, (unsigned) pxProfile->ulHeapMin);
+	/* Room left for closing "]}" */
+	if( ( iLen < 0 ) || ( ( (size_t) iLen + 3U ) > xBufferLen ) )
+	{
+		return 0;
+	}
+	xLen = (size_t) iLen;
+
+	for( i = 0; i < pxProfile->ucTasks; i++ )
+	{
+		iLen = snprintf(&pcBuffer[xLen], xBufferLen - xLen, "%s[\"%s\",%u,%u]", ( i != 0 ) ? "," : "",
+						pxProfile->xTasks[i].cName, pxProfile->xTasks[i].usCpuPermille, pxProfile->xTasks[i].usStackFree);
+		if( ( iLen < 0 ) || ( ( xLen + (size_t) iLen + 3U ) > xBufferLen ) )
+		{
+			break;
+		}
+		xLen += (size_t) iLen;
+	}
+
+	pcBuffer[xLen++] = ']';
+	pcBuffer[xLen++] = '}';
+	pcBuffer[xLen] = '\0';
+
+	return xLen;
+}
+
+static void prvSample(TimerHandle_t xTimer)
+{
+	CellIoTTaskSample_t * pxSample;
+	TaskHandle_t xIdleTask = xTaskGetIdleTaskHandle();
+	UBaseType_t uxTasks, i;
+	uint32_t ulTotal;
+	uint8_t ucPrev = ucCurrent;
+#if ( CELLIOT_PROFILE_LOG == 1 )
+	static char cLine[configLOGGING_MAX_MESSAGE_LENGTH - 32];
+#endif
+
+	( void ) xTimer;
+
+	/* 0 when the array is too small */
+	uxTasks = uxTaskGetSystemState(xStatus, CELLIOT_PROFILE_MAX_TASKS, &ulTotal);
+	if( uxTasks == 0 )
+	{
+		configPRINTF(("Profile: more than %d tasks, sample skipped\r\n", CELLIOT_PROFILE_MAX_TASKS));
+		return;
+	}
+
+	ucCurrent ^= 1U;
+	pxSample = xSamples[ucCurrent];
+	for( i = 0; i < uxTasks; i++ )
+	{
+		strncpy(pxSample[i].cName, xStatus[i].pcTaskName, CELLIOT_PROFILE_NAME_LEN - 1U);
+		pxSample[i].cName[CELLIOT_PROFILE_NAME_LEN - 1U] = '\0';
+		pxSample[i].ulTaskNumber = xStatus[i].xTaskNumber;
+		pxSample[i].ulRunTime = xStatus[i].ulRunTimeCounter;
+		pxSample[i].usStackFree = xStatus[i].usStackHighWaterMark;
+		pxSample[i].xIdle = ( xStatus[i].xHandle == xIdleTask );
+	}
+	ucSamples[ucCurrent] = (uint8_t) uxTasks;
+
+	if( xFirstTaken )
+	{
+		/* Readers copy the profile with the scheduler suspended */
+		vTaskSuspendAll();
+		CellIoT_profile_Aggregate(xSamples[ucPrev], ucSamples[ucPrev], pxSample, ucSamples[ucCurrent],
+								  ulTotal - ulLastTotal, &xLatest);
+		xLatest.ulHeapFree = xPortGetFreeHeapSize();
+		xLatest.ulHeapMin = xPortGetMinimumEverFreeHeapSize();
+		xLatestValid = true;
+		( void ) xTaskResumeAll();
+
+#if ( CELLIOT_PROFILE_LOG == 1 )
+		if( CellIoT_profile_Format(&xLatest, cLine, sizeof(cLine)) != 0 )
+		{
+			configPRINTF(("Profile: %s\r\n", cLine));
+		}
+#endif
+	}
+	ulLastTotal = ulTotal;
+	xFirstTaken = true;
+}
+
+bool CellIoT_profile_Start(uint32_t ulPeriodMs)
+{
+	if( xProfileTimer == NULL )
+	{
+		xProfileTimer = xTimerCreate("Profile", pdMS_TO_TICKS(ulPeriodMs), pdTRUE, NULL, prvSample);
+	}
+
+	return ( xProfileTimer != NULL ) && ( xTimerStart(xProfileTimer, 0) == pdPASS );
+}
+
+bool CellIoT_profile_Get(CellIoTProfile_t * pxProfile)
+{
+	bool xValid;
+
+	vTaskSuspendAll();
+	xValid = xLatestValid;
+	if( xValid )
+	{
+		*pxProfile = xLatest;
+	}
+	( void ) xTaskResumeAll();
+
+	return xValid;
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CELLIOT_PROFILE_H_
+#define CELLIOT_PROFILE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Tasks followed, a sample is skipped when more tasks exist */
+#ifndef CELLIOT_PROFILE_MAX_TASKS
+#define CELLIOT_PROFILE_MAX_TASKS		( 16U )
+#endif
+
+/* Frequency of the run time counter (CTIMER2). It wraps after 71 minutes at
+ * 1 MHz, so samples must be taken more often than that.
+ */
+#ifndef CELLIOT_PROFILE_TIMER_HZ
+#define CELLIOT_PROFILE_TIMER_HZ		( 1000000U )
+#endif
+
+/* Set to 1 to print each sample on the debug console */
+#ifndef CELLIOT_PROFILE_LOG
+#define CELLIOT_PROFILE_LOG				( 1 )
+#endif
+
+#define CELLIOT_PROFILE_NAME_LEN		( 16U )		/* configMAX_TASK_NAME_LEN */
+
+/* Task state read from the kernel */
+typedef struct
+{
+	char cName[CELLIOT_PROFILE_NAME_LEN];
+	uint32_t ulTaskNumber;			/* unique per task, tells a new task from a deleted one */
+	uint32_t ulRunTime;				/* run time counter of the task, wraps */
+	uint16_t usStackFree;			/* stack high-water mark, in words */
+	bool xIdle;						/* idle task, its share is the free CPU */
+} CellIoTTaskSample_t;
+
+typedef struct
+{
+	char cName[CELLIOT_PROFILE_NAME_LEN];
+	uint16_t usCpuPermille;			/* share of the CPU over the period */
+	uint16_t usStackFree;
+} CellIoTTaskLoad_t;
+
+typedef struct
+{
+	uint32_t ulPeriod;				/* run time counter ticks covered by the figures */
+	uint16_t usCpuPermille;			/* CPU busy, all tasks but idle */
+	uint32_t ulHeapFree;
+	uint32_t ulHeapMin;				/* lowest free heap since boot */
+	uint8_t ucTasks;
+	CellIoTTaskLoad_t xTasks[CELLIOT_PROFILE_MAX_TASKS];	/* busiest first */
+} CellIoTProfile_t;
+
+/*
+ * CPU and memory profile.
+ *
+ * FreeRTOS counts the run time of each task on a free-running CTIMER. A timer
+ * samples the counters, stack high-water marks and heap periodically; the
+ * share of each task is its run time over the period between two samples.
+ * The latest profile is printed on the debug console and can be published as
+ * a compact diagnostics message.
+ */
+
+/* portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() and portGET_RUN_TIME_COUNTER_VALUE() */
+void CellIoT_profile_InitTimer(void);
+uint32_t CellIoT_profile_GetTimer(void);
+
+/* Starts sampling every ulPeriodMs */
+bool CellIoT_profile_Start(uint32_t ulPeriodMs);
+
+/* Copies the latest profile, false until two samples were taken */
+bool CellIoT_profile_Get(CellIoTProfile_t * pxProfile);
+
+/* Compact JSON of the profile, tasks that do not fit are left out.
+ * Returns the length written, 0 when not even the totals fit.
+ */
+size_t CellIoT_profile_Format(const CellIoTProfile_t * pxProfile, char * pcBuffer, size_t xBufferLen);
+
+/* Profile over ulPeriod run time counter ticks between two samples. No kernel
+ * call, the time base is the one of the samples.
+ */
+void CellIoT_profile_Aggregate(const CellIoTTaskSample_t * pxPrev, uint8_t ucPrev,
+							   const CellIoTTaskSample_t * pxCurr, uint8_t ucCurr,
+							   uint32_t ulPeriod, CellIoTProfile_t * pxProfile);
+
+#endif /* CELLIOT_PROFILE_H_ */
@@ -6,32 +6,182 @@
  */
 
 
+#include <string.h>
 #include "CellIoT_tools.h"
 #include "CellIoT_lib.h"
 #include "CellIoT_types.h"
+#include "CellIoT_cache.h"
+#include "ksdk_digest.h"
+#include "aws_secure_sockets_config.h"
 
+/* Module NVM slots holding the certificates of the offloaded TLS profile */
+#ifndef socketsconfigOFFLOAD_TLS_CA_SLOT
+#define socketsconfigOFFLOAD_TLS_CA_SLOT		( 10 )
+#endif
+#ifndef socketsconfigOFFLOAD_TLS_CLIENT_SLOT
+#define socketsconfigOFFLOAD_TLS_CLIENT_SLOT	( 11 )
+#endif
+#ifndef socketsconfigOFFLOAD_TLS_CERT_VALID_LEVEL
+#define socketsconfigOFFLOAD_TLS_CERT_VALID_LEVEL	( 0x01 )
+#endif
+
+/* Bit n set when security is enabled on connection n + 1 */
+static uint8_t ucSecuredConns;
 
-int32_t SOCKETS_SetCfgExt(void)
+
+/* The module keeps socket and security profile settings in NVM, they are only
+ * written when the values differ from the ones recorded in the snapshot.
+ */
+int32_t SOCKETS_SetCfgExt(uint8_t connId)
 {
-	return CellIoT_lib_setSocketCfgExt(gsm.m.conn_val_id + 1, 1, 1, 0, 1, 1, NULL, NULL, 1);
+	/* srMode, recvDataMode, keepalive, listenAutoRsp, sendDataMode */
+	static const uint8_t ucParams[] = { 1, 1, 0, 1, 1 };
+	uint8_t digest[DIGEST_SHA256_SIZE];
+	int32_t status;
+
+	DIGEST_Sha256(ucParams, sizeof(ucParams), digest);
+	if( CellIoT_cache_IsCurrent(eCellIoTCacheSocketCfgExt, connId, digest) )
+	{
+		return gsmOK;
+	}
+
+	status = CellIoT_lib_setSocketCfgExt(connId, ucParams[0], ucParams[1], ucParams[2], ucParams[3], ucParams[4], NULL, NULL, 1);
+	CellIoT_cache_Update(eCellIoTCacheSocketCfgExt, connId, ( status == gsmOK ) ? digest : NULL);
+
+	return status;
 }
 
-int32_t SOCKETS_SetCfg(void)
+int32_t SOCKETS_SetCfg(uint8_t connId)
 {
+	/* cid, pktsize, maxto, connto, txTo */
 #ifdef USE_TRUPHONE
-	return CellIoT_lib_setSocketCfg(gsm.m.conn_val_id + 1, 1, 1450, 0, 600, 50, 1);
+	static const uint32_t ulParams[] = { 1, 1450, 0, 600, 50 };
 #else
 	/* PDP=3 is used for Verizon network! */
-	return CellIoT_lib_setSocketCfg(gsm.m.conn_val_id + 1, 3, 1450, 0, 600, 50, 1);
+	static const uint32_t ulParams[] = { 3, 1450, 0, 600, 50 };
 #endif
+	uint8_t digest[DIGEST_SHA256_SIZE];
+	int32_t status;
+
+	DIGEST_Sha256((const uint8_t *) ulParams, sizeof(ulParams), digest);
+	if( CellIoT_cache_IsCurrent(eCellIoTCacheSocketCfg, connId, digest) )
+	{
+		return gsmOK;
+	}
+
+	status = CellIoT_lib_setSocketCfg(connId, (uint8_t) ulParams[0], (uint16_t) ulParams[1], (uint16_t) ulParams[2],
+									  ulParams[3], ulParams[4], 1);
+	CellIoT_cache_Update(eCellIoTCacheSocketCfg, connId, ( status == gsmOK ) ? digest : NULL);
+
+	return status;
+}
+
+int32_t SOCKETS_SetSockSecurity(uint8_t connId, uint8_t spId, uint8_t enable)
+{
+	int32_t status = gsmOK;
+	uint8_t mask;
+
+	if( ( connId == 0 ) || ( connId > GSM_CFG_MAX_CONNS ) )
+	{
+		return gsmPARERR;
+	}
+	mask = 1U << (connId - 1);
+
+	/* The setting stays on the connection ID, only send it when it changes */
+	if( ( ( ucSecuredConns & mask ) != 0 ) != ( enable != 0 ) )
+	{
+		status = CellIoT_lib_setSocketSecurity(spId, connId, enable, NULL, NULL, 1);
+		if( status == gsmOK )
+		{
+			ucSecuredConns = enable ? ( ucSecuredConns | mask ) : ( ucSecuredConns & ~mask );
+		}
+	}
+
+	return status;
+}
+
+int32_t SOCKETS_SetTLSSecurityCfg(uint8_t spId)
+{
+	static const char cParams[] = "2,0x3C,0,0,0,0";
+	uint8_t digest[DIGEST_SHA256_SIZE];
+	int32_t status;
+
+	DIGEST_Sha256((const uint8_t *) cParams, sizeof(cParams), digest);
+	if( CellIoT_cache_IsCurrent(eCellIoTCacheTLSProfile, spId, digest) )
+	{
+		return gsmOK;
+	}
+
+	status = CellIoT_lib_setTLSSecurityProfileCfg(spId, 2, "0x3C", 0, 0, 0, 0, NULL, NULL, NULL, 1);
+	CellIoT_cache_Update(eCellIoTCacheTLSProfile, spId, ( status == gsmOK ) ? digest : NULL);
+
+	return status;
 }
 
-int32_t SOCKETS_SetSockSecurity(void)
+static size_t prvPemLength(const char * pem, size_t len)
 {
-    return CellIoT_lib_setSocketSecurity(gsm.m.conn_val_id + 1, gsm.m.conn_val_id + 1, 0, NULL, NULL, 1);
+	/* PEM lengths given to the secure sockets include the null terminator */
+	while( ( len > 0 ) && ( pem[len - 1] == '\0' ) )
+	{
+		len--;
+	}
+	return len;
 }
 
-int32_t SOCKETS_SetTLSSecurityCfg(void)
+int32_t SOCKETS_ProvisionOffloadTLS(uint8_t spId,
+									const char * caCert, size_t caCertLen,
+									const char * clientCert, size_t clientCertLen,
+									const char * clientKey, size_t clientKeyLen)
 {
-	return CellIoT_lib_setTLSSecurityProfileCfg(gsm.m.conn_val_id + 1, 2, "0x3C", 0, 0, 0, 0, NULL, NULL, NULL, 1);
+	digest_sha256_ctx_t ctx;
+	uint8_t digest[DIGEST_SHA256_SIZE];
+	uint8_t clientSlot = SQNS_NVM_SLOT_NONE;
+	int32_t status;
+
+	if( caCert == NULL )
+	{
+		return gsmPARERR;
+	}
+	caCertLen = prvPemLength(caCert, caCertLen);
+	clientCertLen = ( clientCert != NULL ) ? prvPemLength(clientCert, clientCertLen) : 0;
+	clientKeyLen = ( clientKey != NULL ) ? prvPemLength(clientKey, clientKeyLen) : 0;
+
+	DIGEST_Sha256InitCtx(&ctx);
+	DIGEST_Sha256Starts(&ctx, 0);
+	DIGEST_Sha256Update(&ctx, &spId, sizeof(spId));
+	DIGEST_Sha256Update(&ctx, (const uint8_t *) caCert, caCertLen);
+	DIGEST_Sha256Update(&ctx, (const uint8_t *) clientCert, clientCertLen);
+	DIGEST_Sha256Update(&ctx, (const uint8_t *) clientKey, clientKeyLen);
+	DIGEST_Sha256Finish(&ctx, digest);
+	DIGEST_Sha256FreeCtx(&ctx);
+
+	if( CellIoT_cache_IsCurrent(eCellIoTCacheTLSProfile, spId, digest) )
+	{
+		return gsmOK;
+	}
+
+	status = CellIoT_lib_WriteCertKeyInNVM(caCert, SQNS_MQTT_CERTIFICATE, socketsconfigOFFLOAD_TLS_CA_SLOT, caCertLen, NULL, NULL, 1);
+
+	if( ( status == gsmOK ) && ( clientCertLen > 0 ) && ( clientKeyLen > 0 ) )
+	{
+		status = CellIoT_lib_WriteCertKeyInNVM(clientCert, SQNS_MQTT_CERTIFICATE, socketsconfigOFFLOAD_TLS_CLIENT_SLOT, clientCertLen, NULL, NULL, 1);
+		if( status == gsmOK )
+		{
+			status = CellIoT_lib_WriteCertKeyInNVM(clientKey, SQNS_MQTT_PRIVATEKEY, socketsconfigOFFLOAD_TLS_CLIENT_SLOT, clientKeyLen, NULL, NULL, 1);
+		}
+		clientSlot = socketsconfigOFFLOAD_TLS_CLIENT_SLOT;
+	}
+
+	if( status == gsmOK )
+	{
+		/* TLS 1.2, cipher suites left to the module */
+		status = CellIoT_lib_setTLSSecurityProfileCfg(spId, 2, "", socketsconfigOFFLOAD_TLS_CERT_VALID_LEVEL,
+													  socketsconfigOFFLOAD_TLS_CA_SLOT, clientSlot, clientSlot,
+													  NULL, NULL, NULL, 1);
+	}
+
+	/* On failure everything is provisioned again next time */
+	CellIoT_cache_Update(eCellIoTCacheTLSProfile, spId, ( status == gsmOK ) ? digest : NULL);
+
+	return status;
 }
@@ -8,11 +8,23 @@
 #ifndef CELLIOT_TOOLS_H_
 #define CELLIOT_TOOLS_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
-int32_t SOCKETS_SetCfgExt(void);
-int32_t SOCKETS_SetCfg(void);
-int32_t SOCKETS_SetSockSecurity(void);
-int32_t SOCKETS_SetTLSSecurityCfg(void);
+/* connId is the module connection ID [1..GSM_CFG_MAX_CONNS] owned by the socket */
+int32_t SOCKETS_SetCfgExt(uint8_t connId);
+int32_t SOCKETS_SetCfg(uint8_t connId);
+int32_t SOCKETS_SetSockSecurity(uint8_t connId, uint8_t spId, uint8_t enable);
+int32_t SOCKETS_SetTLSSecurityCfg(uint8_t spId);
+
+/* Writes the certificates in the module NVM and configures the security profile
+ * spId for TLS run by the module. Nothing is sent when the same certificates were
+ * already provisioned to this module, also across reboots (see CellIoT_cache.h). clientCert/clientKey can be NULL when there is no client
+ * authentication.
+ */
+int32_t SOCKETS_ProvisionOffloadTLS(uint8_t spId,
+									const char * caCert, size_t caCertLen,
+									const char * clientCert, size_t clientCertLen,
+									const char * clientKey, size_t clientKeyLen);
 
 #endif /* CELLIOT_TOOLS_H_ */
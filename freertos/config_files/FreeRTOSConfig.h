@@ -72,7 +72,7 @@
 #define configUSE_MALLOC_FAILED_HOOK                 1
 #define configUSE_APPLICATION_TASK_TAG               0
 #define configUSE_COUNTING_SEMAPHORES                1
-#define configGENERATE_RUN_TIME_STATS                0
+#define configGENERATE_RUN_TIME_STATS                1
 #define configOVERRIDE_DEFAULT_TICK_CONFIGURATION    0
 #define configRECORD_STACK_HIGH_ADDRESS              1
 
@@ -99,6 +99,15 @@
 #define INCLUDE_xTimerPendFunctionCall               1
 #define INCLUDE_xSemaphoreGetMutexHolder             1
 #define INCLUDE_uxTaskGetStackHighWaterMark          1
+#define INCLUDE_xTaskGetIdleTaskHandle               1
+
+/* Run time stats are counted on a free-running CTIMER, see CellIoT_profile.h */
+#if defined( __ICCARM__ ) || defined( __ARMCC_VERSION ) || defined( __GNUC__)
+    extern void CellIoT_profile_InitTimer( void );
+    extern uint32_t CellIoT_profile_GetTimer( void );
+#endif
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()     CellIoT_profile_InitTimer()
+#define portGET_RUN_TIME_COUNTER_VALUE()             CellIoT_profile_GetTimer()
 
 
 /* Normal assert() semantics without relying on the provision of an assert.h
@@ -121,6 +130,12 @@
  * and a time stamp. */
 #define configLOGGING_INCLUDE_TIME_AND_TASK_NAME    1
 
+/* Set to 1 to record the arguments of each log message in a ring and format it
+ * in the logging task, instead of formatting it in a buffer allocated by the
+ * caller.  configLOGGING_DEFERRED_BUFFER_SIZE sets the size of the ring. */
+#define configLOGGING_DEFERRED                      1
+#define configLOGGING_DEFERRED_BUFFER_SIZE          2048
+
 /* Demo specific macros that allow the application writer to insert code to be
  * executed immediately before the MCU's STOP low power mode is entered and exited
  * respectively.  These macros are in addition to the standard
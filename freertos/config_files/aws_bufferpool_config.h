@@ -32,13 +32,24 @@
 #define _AWS_BUFFER_POOL_CONFIG_H_
 
 /**
- * @brief The number of buffers in the static buffer pool.
+ * @brief Size and number of buffers of each class in the static buffer pool.
+ *
+ * A request is served from the smallest class it fits in, or from a larger
+ * class when that one is exhausted. Small buffers hold acks and short commands,
+ * medium ones the usual telemetry and shadow deltas, the large one the
+ * occasional full twin or shadow document.
  */
-#define bufferpoolconfigNUM_BUFFERS    ( 4 )
+#define bufferpoolconfigSMALL_BUFFER_SIZE     ( 256 )
+#define bufferpoolconfigSMALL_NUM_BUFFERS     ( 4 )
+#define bufferpoolconfigMEDIUM_BUFFER_SIZE    ( 1024 + 128 )
+#define bufferpoolconfigMEDIUM_NUM_BUFFERS    ( 2 )
+#define bufferpoolconfigLARGE_BUFFER_SIZE     ( 4096 )
+#define bufferpoolconfigLARGE_NUM_BUFFERS     ( 1 )
 
 /**
- * @brief The size of each buffer in the static buffer pool.
+ * @brief Time in milliseconds after which a buffer not returned is reported
+ * as leaked when the pool runs out.
  */
-#define bufferpoolconfigBUFFER_SIZE    ( 1024 + 128 )
+#define bufferpoolconfigLEAK_HOLD_MS          ( 30000 )
 
 #endif /* _AWS_BUFFER_POOL_CONFIG_H_ */
@@ -48,6 +48,27 @@
  */
 #define socketsconfigDEFAULT_RECV_TIMEOUT    ( 15000 )
 
+/**
+ * @brief Run TLS on the Cellular-IoT module instead of the MCU.
+ *
+ * When set to 1, the network abstraction sets SOCKETS_SO_OFFLOAD_TLS on its
+ * TLS sockets. When set to 0 the option is accepted but TLS always runs on
+ * the MCU (mbedTLS).
+ */
+#define socketsconfigENABLE_OFFLOAD_TLS              ( 0 )
+
+/**
+ * @brief Module security profile and NVM slots used by offloaded TLS.
+ */
+#define socketsconfigOFFLOAD_TLS_PROFILE_ID          ( 1 )
+#define socketsconfigOFFLOAD_TLS_CA_SLOT             ( 10 )
+#define socketsconfigOFFLOAD_TLS_CLIENT_SLOT         ( 11 )
+
+/**
+ * @brief SQNSPCFG server certificate validation level of offloaded TLS.
+ */
+#define socketsconfigOFFLOAD_TLS_CERT_VALID_LEVEL    ( 0x01 )
+
 /**
  * @brief Enable metrics of secure socket.
  */
@@ -50,6 +50,11 @@
 #define IOT_THREAD_DEFAULT_STACK_SIZE    900
 #define IOT_THREAD_DEFAULT_PRIORITY      5
 
+/* MQTT PINGREQs are sent after the idle time learned for the carrier NAT. */
+#include "CellIoT_keepalive.h"
+#define IOT_MQTT_PING_INTERVAL_MS( keepAliveMs )    CellIoT_keepalive_GetIntervalMs( keepAliveMs )
+#define IOT_MQTT_PING_RESULT( idleMs, answered )    CellIoT_keepalive_Report( idleMs, answered )
+
 /* Include the common configuration file for FreeRTOS. */
 #include "iot_config_common.h"
 
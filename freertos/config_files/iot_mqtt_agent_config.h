@@ -50,6 +50,15 @@
  */
 #define mqttconfigKEEP_ALIVE_INTERVAL_SECONDS         ( 1200 )
 
+/**
+ * @brief The keep-alive interval in seconds sent in CONNECT.
+ *
+ * The ping interval is searched upward from mqttconfigKEEP_ALIVE_INTERVAL_SECONDS
+ * for each operator, CONNECT announces the longest one that may be probed.
+ */
+#include "CellIoT_keepalive.h"
+#define mqttconfigCONNECT_KEEP_ALIVE_SECONDS( baselineSeconds )    CellIoT_keepalive_GetKeepAliveS( baselineSeconds )
+
 /**
  * @brief Defines the frequency at which the client should send Keep Alive messages.
  *
@@ -100,6 +109,13 @@
  */
 #define mqttconfigMAX_PARALLEL_OPS       ( 5 )
 
+/**
+ * @brief Maximum number of QoS1 publishes waiting for their PUBACK.
+ *
+ * Keeps the link busy over a cellular round trip of several hundred milliseconds.
+ */
+#define mqttconfigMAX_INFLIGHT_PUBLISHES    ( 4 )
+
 /**
  * @brief Time in milliseconds after which the TCP send operation should timeout.
  */
@@ -59,8 +59,6 @@
 #define LIBRARY_LOG_NAME    ( "NET" )
 #include "iot_logging_setup.h"
 
-#include "CellIoT_tools.h"
-
 /* Provide a default value for the number of milliseconds for a socket poll.
  * This is a temporary workaround to deal with the lack of poll(). */
 #ifndef IOT_NETWORK_SOCKET_POLL_MS
@@ -251,6 +249,34 @@ static IotNetworkError_t _tlsSetup( const IotNetworkCredentials_t * pAfrCredenti
         IOT_SET_AND_GOTO_CLEANUP( IOT_NETWORK_SYSTEM_ERROR );
     }
 
+    #if ( socketsconfigENABLE_OFFLOAD_TLS == 1 )
+        {
+            /* Ask for TLS on the network module, the socket falls back to
+             * mbedTLS when the module cannot run it. */
+            SocketsClientCredentials_t xClientCredentials = { 0 };
+
+            if( ( pAfrCredentials->pClientCert != NULL ) && ( pAfrCredentials->pPrivateKey != NULL ) )
+            {
+                xClientCredentials.pcClientCertificate = pAfrCredentials->pClientCert;
+                xClientCredentials.xClientCertificateLength = pAfrCredentials->clientCertSize;
+                xClientCredentials.pcClientPrivateKey = pAfrCredentials->pPrivateKey;
+                xClientCredentials.xClientPrivateKeyLength = pAfrCredentials->privateKeySize;
+            }
+
+            socketStatus = SOCKETS_SetSockOpt( tcpSocket,
+                                               0,
+                                               SOCKETS_SO_OFFLOAD_TLS,
+                                               &xClientCredentials,
+                                               sizeof( xClientCredentials ) );
+
+            if( socketStatus != SOCKETS_ERROR_NONE )
+            {
+                IotLogError( "Failed to set TLS offload option for new connection." );
+                IOT_SET_AND_GOTO_CLEANUP( IOT_NETWORK_SYSTEM_ERROR );
+            }
+        }
+    #endif /* if ( socketsconfigENABLE_OFFLOAD_TLS == 1 ) */
+
     /* Set ALPN option. */
     if( pAfrCredentials->pAlpnProtos != NULL )
     {
@@ -366,10 +392,6 @@ IotNetworkError_t IotNetworkAfr_Create( void * pConnectionInfo,
         }
     }
 
-    /* Configure secure socket on the Cellular-IoT module */
-	SOCKETS_SetCfg();
-	SOCKETS_SetCfgExt();
-
     /* Establish connection. */
     serverAddress.ucSocketDomain = SOCKETS_AF_INET;
     serverAddress.usPort = SOCKETS_htons( pServerInfo->port );
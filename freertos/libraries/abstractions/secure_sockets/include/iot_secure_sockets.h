@@ -146,7 +146,7 @@ typedef struct xSOCKET * Socket_t; /**< @brief Socket handle data type. */
  *
  */
 /**@{ */
-#define SOCKETS_IPPROTO_UDP    ( 17 )   /*!< UDP. This option is currently not supported. */
+#define SOCKETS_IPPROTO_UDP    ( 17 )   /*!< UDP. Use with SOCKETS_SOCK_DGRAM, see SOCKETS_SendTo(). */
 #define SOCKETS_IPPROTO_TCP    ( 6 )    /*!< TCP. */
 /**@} */
 
@@ -168,6 +168,7 @@ typedef struct xSOCKET * Socket_t; /**< @brief Socket handle data type. */
 #define SOCKETS_SO_NONBLOCK                      ( 9 )  /**< Socket is nonblocking. */
 #define SOCKETS_SO_ALPN_PROTOCOLS                ( 10 ) /**< Application protocol list to be included in TLS ClientHello. */
 #define SOCKETS_SO_WAKEUP_CALLBACK               ( 17 ) /**< Set the callback to be called whenever there is data available on the socket for reading. */
+#define SOCKETS_SO_OFFLOAD_TLS                   ( 18 ) /**< Run TLS on the network module instead of the MCU when the port supports it. */
 
 /**@} */
 
@@ -202,6 +203,20 @@ typedef struct SocketsSockaddr
     uint32_t ulAddress;     /**< IP Address. Convention is to call this sin_addr. */
 } SocketsSockaddr_t;
 
+/**
+ * @brief Client credentials of @ref SOCKETS_SO_OFFLOAD_TLS.
+ *
+ * The strings are PEM encoded and are not copied, they must stay valid
+ * until SOCKETS_Connect() returns.
+ */
+typedef struct SocketsClientCredentials
+{
+    const char * pcClientCertificate;  /**< Client certificate, NULL without client authentication. */
+    size_t xClientCertificateLength;   /**< Length of pcClientCertificate. */
+    const char * pcClientPrivateKey;   /**< Private key of the client certificate. */
+    size_t xClientPrivateKeyLength;    /**< Length of pcClientPrivateKey. */
+} SocketsClientCredentials_t;
+
 /**
  * @brief Well-known port numbers.
  */
@@ -233,10 +248,10 @@ lib_initDECLARE_LIB_INIT( SOCKETS_Init );
  * @sa SOCKETS_Close()
  *
  * @param[in] lDomain Must be set to SOCKETS_AF_INET. See @ref SocketDomains.
- * @param[in] lType Set to SOCKETS_SOCK_STREAM to create a TCP socket.
- * No other value is valid.  See @ref SocketTypes.
- * @param[in] lProtocol Set to SOCKETS_IPPROTO_TCP to create a TCP socket.
- * No other value is valid. See @ref Protocols.
+ * @param[in] lType Set to SOCKETS_SOCK_STREAM to create a TCP socket,
+ * SOCKETS_SOCK_DGRAM to create a UDP socket. See @ref SocketTypes.
+ * @param[in] lProtocol Set to SOCKETS_IPPROTO_TCP with SOCKETS_SOCK_STREAM,
+ * SOCKETS_IPPROTO_UDP with SOCKETS_SOCK_DGRAM. See @ref Protocols.
  *
  * @return
  * * If a socket is created successfully, then the socket handle is
@@ -343,6 +358,64 @@ int32_t SOCKETS_Send( Socket_t xSocket,
                       uint32_t ulFlags );
 /* @[declare_secure_sockets_send] */
 
+/**
+ * @brief Transmit one datagram on a UDP socket.
+ *
+ * The socket must have been created with SOCKETS_SOCK_DGRAM and SOCKETS_IPPROTO_UDP.
+ * An unconnected socket is connected to pxDestAddress by the first call, later
+ * calls must use the same destination. Datagrams are never split: the whole
+ * buffer is sent as one datagram, or nothing is sent.
+ *
+ * @param[in] xSocket The handle of the sending socket.
+ * @param[in] pvBuffer The buffer containing the datagram to be sent.
+ * @param[in] xDataLength The length of the datagram.
+ * @param[in] ulFlags Not currently used. Should be set to 0.
+ * @param[in] pxDestAddress Destination address of the datagram.
+ * @param[in] xDestAddressLength Should be set to sizeof( @ref SocketsSockaddr_t ).
+ *
+ * @return
+ * * On success, the length of the datagram is returned.
+ * * @ref SOCKETS_EINVAL if the datagram is too big for the port or the destination
+ *   is not the one the socket is connected to.
+ * * If an error occurred, a negative value is returned. @ref SocketsErrors
+ */
+/* @[declare_secure_sockets_sendto] */
+int32_t SOCKETS_SendTo( Socket_t xSocket,
+                        const void * pvBuffer,
+                        size_t xDataLength,
+                        uint32_t ulFlags,
+                        SocketsSockaddr_t * pxDestAddress,
+                        Socklen_t xDestAddressLength );
+/* @[declare_secure_sockets_sendto] */
+
+/**
+ * @brief Receive one datagram from a UDP socket.
+ *
+ * Message boundaries are preserved: a call returns the data of a single
+ * datagram. If xBufferLength is smaller than the datagram, the end of the
+ * datagram is discarded.
+ *
+ * @param[in] xSocket The handle of the socket from which data is being received.
+ * @param[out] pvBuffer The buffer into which the datagram will be placed.
+ * @param[in] xBufferLength The maximum number of bytes which can be received.
+ * @param[in] ulFlags Not currently used. Should be set to 0.
+ * @param[out] pxSourceAddress Source address of the datagram. Can be NULL.
+ * @param[out] pxSourceAddressLength Set to sizeof( @ref SocketsSockaddr_t ). Can be NULL.
+ *
+ * @return
+ * * If the receive was successful then the number of bytes placed in pvBuffer is returned.
+ * * If a timeout occurred before a datagram could be received then 0 is returned.
+ * * If an error occurred, a negative value is returned. @ref SocketsErrors
+ */
+/* @[declare_secure_sockets_recvfrom] */
+int32_t SOCKETS_RecvFrom( Socket_t xSocket,
+                          void * pvBuffer,
+                          size_t xBufferLength,
+                          uint32_t ulFlags,
+                          SocketsSockaddr_t * pxSourceAddress,
+                          Socklen_t * pxSourceAddressLength );
+/* @[declare_secure_sockets_recvfrom] */
+
 /**
  * @brief Closes all or part of a full-duplex connection on the socket.
  *
@@ -451,6 +524,15 @@ int32_t SOCKETS_Close( Socket_t xSocket );
  *      - This socket option should be set before SOCKETS_Connect() is
  *        called.
  *      - pvOptionValue is ignored for this option.
+ *    - @ref SOCKETS_SO_OFFLOAD_TLS
+ *      - Run the TLS session requested by @ref SOCKETS_SO_REQUIRE_TLS on the
+ *        network module. The MCU then sends and receives plain data.
+ *      - This socket option should be set before SOCKETS_Connect() is
+ *        called.
+ *      - pvOptionValue is a pointer to a SocketsClientCredentials_t, or NULL
+ *        when the server does not authenticate the client.
+ *      - SOCKETS_Connect() falls back to TLS on the MCU when the module
+ *        cannot run the session (see PORT_SPECIFIC_LINK).
  *    - @ref SOCKETS_SO_TRUSTED_SERVER_CERTIFICATE
  *      - Set the root of trust server certificate for the socket.
  *      - This socket option only takes effect if @ref SOCKETS_SO_REQUIRE_TLS
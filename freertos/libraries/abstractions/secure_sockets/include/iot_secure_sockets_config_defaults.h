@@ -69,4 +69,18 @@
     #define AWS_IOT_SECURE_SOCKETS_METRICS_ENABLED    ( 0 )
 #endif
 
+/**
+ * @brief By default, TLS runs on the MCU even if SOCKETS_SO_OFFLOAD_TLS is set.
+ */
+#ifndef socketsconfigENABLE_OFFLOAD_TLS
+    #define socketsconfigENABLE_OFFLOAD_TLS    ( 0 )
+#endif
+
+/**
+ * @brief Network module security profile used by offloaded TLS.
+ */
+#ifndef socketsconfigOFFLOAD_TLS_PROFILE_ID
+    #define socketsconfigOFFLOAD_TLS_PROFILE_ID    ( 1 )
+#endif
+
 #endif /* AWS_INC_SECURE_SOCKETS_CONFIG_DEFAULTS_H_ */
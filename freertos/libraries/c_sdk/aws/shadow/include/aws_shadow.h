@@ -484,6 +484,8 @@ ShadowReturnCode_t SHADOW_RegisterCallbacks( ShadowClientHandle_t xShadowClientH
  *   of buffers after repeated calls to #SHADOW_Get.
  * - This function should also be called to return buffers taken in callback
  *   functions #ShadowUpdatedCallback_t and #ShadowDeltaCallback_t.
+ * - #eShadowFailure is returned for a buffer not taken from the buffer pool or
+ *   already returned.
  */
 ShadowReturnCode_t SHADOW_ReturnMQTTBuffer( ShadowClientHandle_t xShadowClientHandle,
                                             MQTTBufferHandle_t xBufferHandle );
@@ -48,6 +48,7 @@
 #include "iot_mqtt_agent_config.h"
 #include "iot_mqtt_agent_config_defaults.h"
 #include "aws_shadow.h"
+#include "aws_bufferpool.h"
 
 /* Shadow v2 include. */
 #include "aws_iot_shadow.h"
@@ -106,6 +107,23 @@ static void prvDeltaCallbackWrapper( void * pvArgument,
 static void prvUpdatedCallbackWrapper( void * pvArgument,
                                        AwsIotShadowCallbackParam_t * const pxUpdatedDocument );
 
+/**
+ * @brief Takes a buffer for a document handed to the application from the MQTT
+ * buffer pool, so that it can be returned with #SHADOW_ReturnMQTTBuffer.
+ *
+ * @param[in] xLength Length of the document.
+ * @param[in] pcOwner Label reported if the buffer is never returned.
+ *
+ * @return The buffer, or NULL if none is free.
+ */
+static char * prvTakeDocumentBuffer( size_t xLength,
+                                     const char * pcOwner );
+
+/**
+ * @brief Shadow v2 allocator of the document retrieved by #SHADOW_Get.
+ */
+static void * prvMallocGetDocument( size_t xLength );
+
 /* Retrieves the MQTT v2 connection from the MQTT v1 connection handle. */
 extern IotMqttConnection_t MQTT_AGENT_Getv2Connection( MQTTAgentHandle_t xMQTTHandle );
 
@@ -183,6 +201,23 @@ static ShadowReturnCode_t prvConvertReturnCode( AwsIotShadowError_t xShadowError
 
 /*-----------------------------------------------------------*/
 
+static char * prvTakeDocumentBuffer( size_t xLength,
+                                     const char * pcOwner )
+{
+    uint32_t ulBufferLength = ( uint32_t ) xLength;
+
+    return ( char * ) BUFFERPOOL_TakeBuffer( &ulBufferLength, pcOwner );
+}
+
+/*-----------------------------------------------------------*/
+
+static void * prvMallocGetDocument( size_t xLength )
+{
+    return prvTakeDocumentBuffer( xLength, "Shadow get" );
+}
+
+/*-----------------------------------------------------------*/
+
 static void prvDeltaCallbackWrapper( void * pvArgument,
                                      AwsIotShadowCallbackParam_t * const pxDeltaDocument )
 {
@@ -202,7 +237,7 @@ static void prvDeltaCallbackWrapper( void * pvArgument,
     {
         /* The delta document must be copied in case the user wants to take
          * ownership of it. */
-        pcDeltaDocument = pvPortMalloc( pxDeltaDocument->u.callback.documentLength );
+        pcDeltaDocument = prvTakeDocumentBuffer( pxDeltaDocument->u.callback.documentLength, "Shadow delta" );
 
         if( pcDeltaDocument != NULL )
         {
@@ -218,7 +253,7 @@ static void prvDeltaCallbackWrapper( void * pvArgument,
 
             if( xCallbackReturn == pdFALSE )
             {
-                vPortFree( pcDeltaDocument );
+                BUFFERPOOL_ReturnBuffer( ( uint8_t * ) pcDeltaDocument );
             }
         }
     }
@@ -245,7 +280,7 @@ static void prvUpdatedCallbackWrapper( void * pvArgument,
     {
         /* The updated document must be copied in case the user wants to take
          * ownership of it. */
-        pcUpdatedDocument = pvPortMalloc( pxUpdatedDocument->u.callback.documentLength );
+        pcUpdatedDocument = prvTakeDocumentBuffer( pxUpdatedDocument->u.callback.documentLength, "Shadow updated" );
 
         if( pcUpdatedDocument != NULL )
         {
@@ -261,7 +296,7 @@ static void prvUpdatedCallbackWrapper( void * pvArgument,
 
             if( xCallbackReturn == pdFALSE )
             {
-                vPortFree( pcUpdatedDocument );
+                BUFFERPOOL_ReturnBuffer( ( uint8_t * ) pcUpdatedDocument );
             }
         }
     }
@@ -500,7 +535,7 @@ ShadowReturnCode_t SHADOW_Get( ShadowClientHandle_t xShadowClientHandle,
     xGetDocument.qos = ( IotMqttQos_t ) pxGetParams->xQoS;
     xGetDocument.pThingName = pxGetParams->pcThingName;
     xGetDocument.thingNameLength = strlen( pxGetParams->pcThingName );
-    xGetDocument.u.get.mallocDocument = pvPortMalloc;
+    xGetDocument.u.get.mallocDocument = prvMallocGetDocument;
 
     if( pxGetParams->ucKeepSubscriptions == 1 )
     {
@@ -640,8 +675,11 @@ ShadowReturnCode_t SHADOW_ReturnMQTTBuffer( ShadowClientHandle_t xShadowClientHa
     /* Silence warnings about unused parameters. */
     ( void ) xShadowClientHandle;
 
-    /* Free the Shadow buffer. */
-    vPortFree( xBufferHandle );
+    /* Give the Shadow buffer back, refused if it was not taken from the pool. */
+    if( BUFFERPOOL_ReleaseBuffer( ( uint8_t * ) xBufferHandle ) != pdPASS )
+    {
+        return eShadowFailure;
+    }
 
     return eShadowSuccess;
 }
@@ -57,4 +57,14 @@ BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
 void vLoggingPrintf( const char * pcFormat,
                      ... );
 
+/**
+ * @brief Number of messages dropped because the log ring was full.
+ *
+ * Only provided by the deferred logging task (configLOGGING_DEFERRED set to 1),
+ * which records the format string pointer and the arguments of each message and
+ * formats it later in the logging task.  The format string must then be a
+ * string constant.
+ */
+uint32_t ulLoggingGetLostCount( void );
+
 #endif /* AWS_LOGGING_TASK_H */
@@ -0,0 +1,800 @@
+/*
+ * FreeRTOS Common V1.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "atomic.h"
+
+/* Logging includes. */
+#include "iot_logging_task.h"
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+
+#if ( configLOGGING_DEFERRED == 1 )
+
+/* Sanity check all the definitions required by this file are set. */
+#ifndef configPRINT_STRING
+    #error configPRINT_STRING( x ) must be defined in FreeRTOSConfig.h to use this logging file.  Set configPRINT_STRING( x ) to a function that outputs a string, where X is the string.  For example, #define configPRINT_STRING( x ) MyUARTWriteString( X )
+#endif
+
+#ifndef configLOGGING_MAX_MESSAGE_LENGTH
+    #error configLOGGING_MAX_MESSAGE_LENGTH must be defined in FreeRTOSConfig.h to use this logging file.  configLOGGING_MAX_MESSAGE_LENGTH sets the size of the buffer into which formatted text is written, so also sets the maximum log message length.
+#endif
+
+#ifndef configLOGGING_INCLUDE_TIME_AND_TASK_NAME
+    #error configLOGGING_INCLUDE_TIME_AND_TASK_NAME must be defined in FreeRTOSConfig.h to use this logging file.  Set configLOGGING_INCLUDE_TIME_AND_TASK_NAME to 1 to prepend a time stamp, message number and the name of the calling task to each logged message.  Otherwise set to 0.
+#endif
+
+/* Size in bytes of the ring the log records are written to, a power of two. */
+#ifndef configLOGGING_DEFERRED_BUFFER_SIZE
+    #define configLOGGING_DEFERRED_BUFFER_SIZE    2048
+#endif
+
+#if ( ( configLOGGING_DEFERRED_BUFFER_SIZE & ( configLOGGING_DEFERRED_BUFFER_SIZE - 1 ) ) != 0 )
+    #error configLOGGING_DEFERRED_BUFFER_SIZE must be a power of two.
+#endif
+
+/* Ring size in words. */
+#define loggingRING_WORDS           ( configLOGGING_DEFERRED_BUFFER_SIZE / sizeof( uint32_t ) )
+
+/* Largest record accepted, bigger ones are counted as lost. */
+#define loggingMAX_RECORD_WORDS     ( loggingRING_WORDS / 2 )
+
+/* First word of a record: its length in words and its state. */
+#define loggingHEADER_COMMITTED     0x80000000UL
+#define loggingHEADER_PADDING       0x40000000UL
+#define loggingHEADER_RAW           0x20000000UL /* Printed without time and task name. */
+#define loggingHEADER_LENGTH_MASK   0x0000FFFFUL
+
+#define loggingWORDS( xBytes )      ( ( ( xBytes ) + sizeof( uint32_t ) - 1 ) / sizeof( uint32_t ) )
+
+/* Layout of a record before the arguments: header, tick count, format string
+ * pointer and, if enabled, the task name. */
+#define loggingFORMAT_WORDS         loggingWORDS( sizeof( const char * ) )
+#define loggingTASK_NAME_WORDS      loggingWORDS( configMAX_TASK_NAME_LEN )
+#define loggingTICK_INDEX           1
+#define loggingFORMAT_INDEX         2
+#define loggingTASK_NAME_INDEX      ( loggingFORMAT_INDEX + loggingFORMAT_WORDS )
+#if ( configLOGGING_INCLUDE_TIME_AND_TASK_NAME == 1 )
+    #define loggingRECORD_WORDS     ( loggingTASK_NAME_INDEX + loggingTASK_NAME_WORDS )
+#else
+    #define loggingRECORD_WORDS     loggingTASK_NAME_INDEX
+#endif
+
+/* Longest conversion specification copied to format one argument. */
+#define loggingMAX_SPEC_LENGTH      16
+
+/*-----------------------------------------------------------*/
+
+/*
+ * How an argument is stored in a record, following the C type printf()
+ * reads for the conversion.
+ */
+typedef enum
+{
+    eLoggingArgEnd = 0, /* End of the format string. */
+    eLoggingArgNone,    /* Literal text or %%. */
+    eLoggingArgInt,
+    eLoggingArgLong,
+    eLoggingArgLongLong,
+    eLoggingArgSize,
+    eLoggingArgPointer,
+    eLoggingArgDouble,
+    eLoggingArgString   /* Copied into the record, the caller's buffer may be gone. */
+} LoggingArg_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The task that formats and outputs the records.  vLoggingPrintf() only copies
+ * the format string pointer, the time and task name, and the raw arguments
+ * into a ring: the calling task neither allocates memory nor formats text,
+ * which is left to this task.  Records are reserved with a compare-and-swap on
+ * the write index, so no mutex is taken and a full ring only drops the record
+ * and counts it as lost.
+ */
+static void prvLoggingTask( void * pvParameters );
+
+/*-----------------------------------------------------------*/
+
+/* Words not covered by a reserved record are always zero. */
+static uint32_t ulRing[ loggingRING_WORDS ];
+
+/* Free running word indexes. Producers advance ulReserved, the logging task
+ * advances ulConsumed. */
+static volatile uint32_t ulReserved = 0;
+static volatile uint32_t ulConsumed = 0;
+static volatile uint32_t ulLost = 0;
+
+static TaskHandle_t xLoggingTask = NULL;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Parses the next conversion of a format string.  ppcFormat is moved past
+ * the conversion, pulStars is set to the number of '*' width and precision
+ * arguments it takes first.
+ */
+static LoggingArg_t prvNextArg( const char ** ppcFormat,
+                                const char ** ppcSpec,
+                                size_t * pxSpecLength,
+                                uint32_t * pulStars )
+{
+    const char * pc = *ppcFormat;
+    LoggingArg_t xArg = eLoggingArgInt;
+    uint8_t ucLong = 0;
+
+    *pulStars = 0;
+    *ppcSpec = pc;
+
+    if( *pc == '\0' )
+    {
+        return eLoggingArgEnd;
+    }
+
+    if( *pc != '%' )
+    {
+        while( ( *pc != '\0' ) && ( *pc != '%' ) )
+        {
+            pc++;
+        }
+
+        *pxSpecLength = ( size_t ) ( pc - *ppcSpec );
+        *ppcFormat = pc;
+        return eLoggingArgNone;
+    }
+
+    pc++;
+
+    /* Flags, width and precision. */
+    while( ( *pc != '\0' ) && ( strchr( "-+ #0123456789.*", *pc ) != NULL ) )
+    {
+        if( *pc == '*' )
+        {
+            ( *pulStars )++;
+        }
+
+        pc++;
+    }
+
+    /* Length modifiers. */
+    while( ( *pc != '\0' ) && ( strchr( "hlLzjt", *pc ) != NULL ) )
+    {
+        if( ( *pc == 'l' ) || ( *pc == 'j' ) )
+        {
+            ucLong += ( *pc == 'j' ) ? 2 : 1;
+        }
+        else if( ( *pc == 'z' ) || ( *pc == 't' ) )
+        {
+            xArg = eLoggingArgSize;
+        }
+
+        pc++;
+    }
+
+    switch( *pc )
+    {
+        case '\0':
+            xArg = eLoggingArgNone;
+            break;
+
+        case '%':
+            xArg = eLoggingArgNone;
+            pc++;
+            break;
+
+        case 's':
+            xArg = eLoggingArgString;
+            pc++;
+            break;
+
+        case 'p':
+            xArg = eLoggingArgPointer;
+            pc++;
+            break;
+
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+            xArg = eLoggingArgDouble;
+            pc++;
+            break;
+
+        default:
+
+            if( xArg != eLoggingArgSize )
+            {
+                xArg = ( ucLong > 1 ) ? eLoggingArgLongLong : ( ( ucLong == 1 ) ? eLoggingArgLong : eLoggingArgInt );
+            }
+
+            pc++;
+            break;
+    }
+
+    *pxSpecLength = ( size_t ) ( pc - *ppcSpec );
+    *ppcFormat = pc;
+
+    return xArg;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvArgWords( LoggingArg_t xArg )
+{
+    size_t xWords = 0;
+
+    switch( xArg )
+    {
+        case eLoggingArgInt:
+            xWords = loggingWORDS( sizeof( int ) );
+            break;
+
+        case eLoggingArgLong:
+            xWords = loggingWORDS( sizeof( long ) );
+            break;
+
+        case eLoggingArgLongLong:
+            xWords = loggingWORDS( sizeof( long long ) );
+            break;
+
+        case eLoggingArgSize:
+            xWords = loggingWORDS( sizeof( size_t ) );
+            break;
+
+        case eLoggingArgPointer:
+            xWords = loggingWORDS( sizeof( void * ) );
+            break;
+
+        case eLoggingArgDouble:
+            xWords = loggingWORDS( sizeof( double ) );
+            break;
+
+        default:
+            break;
+    }
+
+    return xWords;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Copies a string argument as its length followed by its characters, or
+ * only returns the number of words needed when pulOut is NULL.
+ */
+static size_t prvStoreString( uint32_t * pulOut,
+                              const char * pcString )
+{
+    size_t xLength = 0;
+
+    if( pcString == NULL )
+    {
+        pcString = "(null)";
+    }
+
+    while( ( xLength < configLOGGING_MAX_MESSAGE_LENGTH ) && ( pcString[ xLength ] != '\0' ) )
+    {
+        xLength++;
+    }
+
+    if( pulOut != NULL )
+    {
+        pulOut[ 0 ] = ( uint32_t ) xLength;
+        memcpy( &pulOut[ 1 ], pcString, xLength );
+    }
+
+    return 1 + loggingWORDS( xLength );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Walks the arguments of pcFormat, storing them from pulOut on, or only
+ * returning the number of words needed when pulOut is NULL.
+ */
+static size_t prvStoreArgs( uint32_t * pulOut,
+                            const char * pcFormat,
+                            va_list args )
+{
+    const char * pcSpec;
+    size_t xSpecLength, xWords = 0;
+    uint32_t ulStars;
+    LoggingArg_t xArg;
+    int iValue;
+    long lValue;
+    long long llValue;
+    size_t xValue;
+    void * pvValue;
+    double dValue;
+
+    while( ( xArg = prvNextArg( &pcFormat, &pcSpec, &xSpecLength, &ulStars ) ) != eLoggingArgEnd )
+    {
+        for( ; ulStars > 0; ulStars-- )
+        {
+            iValue = va_arg( args, int );
+
+            if( pulOut != NULL )
+            {
+                memcpy( &pulOut[ xWords ], &iValue, sizeof( iValue ) );
+            }
+
+            xWords += prvArgWords( eLoggingArgInt );
+        }
+
+        if( pulOut != NULL )
+        {
+            switch( xArg )
+            {
+                case eLoggingArgInt:
+                    iValue = va_arg( args, int );
+                    memcpy( &pulOut[ xWords ], &iValue, sizeof( iValue ) );
+                    break;
+
+                case eLoggingArgLong:
+                    lValue = va_arg( args, long );
+                    memcpy( &pulOut[ xWords ], &lValue, sizeof( lValue ) );
+                    break;
+
+                case eLoggingArgLongLong:
+                    llValue = va_arg( args, long long );
+                    memcpy( &pulOut[ xWords ], &llValue, sizeof( llValue ) );
+                    break;
+
+                case eLoggingArgSize:
+                    xValue = va_arg( args, size_t );
+                    memcpy( &pulOut[ xWords ], &xValue, sizeof( xValue ) );
+                    break;
+
+                case eLoggingArgPointer:
+                    pvValue = va_arg( args, void * );
+                    memcpy( &pulOut[ xWords ], &pvValue, sizeof( pvValue ) );
+                    break;
+
+                case eLoggingArgDouble:
+                    dValue = va_arg( args, double );
+                    memcpy( &pulOut[ xWords ], &dValue, sizeof( dValue ) );
+                    break;
+
+                case eLoggingArgString:
+                    xWords += prvStoreString( &pulOut[ xWords ], va_arg( args, const char * ) );
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        else
+        {
+            switch( xArg )
+            {
+                case eLoggingArgInt:
+                    ( void ) va_arg( args, int );
+                    break;
+
+                case eLoggingArgLong:
+                    ( void ) va_arg( args, long );
+                    break;
+
+                case eLoggingArgLongLong:
+                    ( void ) va_arg( args, long long );
+                    break;
+
+                case eLoggingArgSize:
+                    ( void ) va_arg( args, size_t );
+                    break;
+
+                case eLoggingArgPointer:
+                    ( void ) va_arg( args, void * );
+                    break;
+
+                case eLoggingArgDouble:
+                    ( void ) va_arg( args, double );
+                    break;
+
+                case eLoggingArgString:
+                    xWords += prvStoreString( NULL, va_arg( args, const char * ) );
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        xWords += prvArgWords( xArg );
+    }
+
+    return xWords;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Reserves xWords contiguous words of the ring.  Returns the word index of
+ * the record, or -1 when the ring is full.
+ */
+static int32_t prvReserve( size_t xWords )
+{
+    uint32_t ulStart, ulOffset, ulPadding;
+
+    for( ; ; )
+    {
+        ulStart = ulReserved;
+        ulOffset = ulStart % loggingRING_WORDS;
+
+        /* Records do not wrap, the end of the ring is skipped instead. */
+        ulPadding = ( ( ulOffset + xWords ) > loggingRING_WORDS ) ? ( loggingRING_WORDS - ulOffset ) : 0;
+
+        if( ( ulStart + ulPadding + xWords - ulConsumed ) > loggingRING_WORDS )
+        {
+            return -1;
+        }
+
+        if( Atomic_CompareAndSwap_u32( &ulReserved, ulStart + ulPadding + xWords, ulStart ) == ATOMIC_COMPARE_AND_SWAP_SUCCESS )
+        {
+            break;
+        }
+    }
+
+    if( ulPadding != 0 )
+    {
+        ulRing[ ulOffset ] = loggingHEADER_COMMITTED | loggingHEADER_PADDING | ulPadding;
+        ulOffset = 0;
+    }
+
+    return ( int32_t ) ulOffset;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCommit( uint32_t ulOffset,
+                       uint32_t ulHeader )
+{
+    /* The header is written last, the logging task only reads committed records. */
+    portMEMORY_BARRIER();
+    ulRing[ ulOffset ] = loggingHEADER_COMMITTED | ulHeader;
+
+    if( xLoggingTask != NULL )
+    {
+        if( xPortIsInsideInterrupt() == pdTRUE )
+        {
+            vTaskNotifyGiveFromISR( xLoggingTask, NULL );
+        }
+        else if( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED )
+        {
+            xTaskNotifyGive( xLoggingTask );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecord( uint32_t ulFlags,
+                       const char * pcFormat,
+                       va_list args )
+{
+    size_t xWords;
+    int32_t lOffset;
+    uint32_t * pulRecord;
+    va_list argsCopy;
+
+    va_copy( argsCopy, args );
+    xWords = loggingRECORD_WORDS + prvStoreArgs( NULL, pcFormat, argsCopy );
+    va_end( argsCopy );
+
+    lOffset = ( xWords <= loggingMAX_RECORD_WORDS ) ? prvReserve( xWords ) : -1;
+
+    if( lOffset < 0 )
+    {
+        ( void ) Atomic_Increment_u32( &ulLost );
+        return;
+    }
+
+    pulRecord = &ulRing[ lOffset ];
+    pulRecord[ loggingTICK_INDEX ] = ( uint32_t ) ( ( xPortIsInsideInterrupt() == pdTRUE ) ? xTaskGetTickCountFromISR() : xTaskGetTickCount() );
+    memcpy( &pulRecord[ loggingFORMAT_INDEX ], &pcFormat, sizeof( pcFormat ) );
+
+    #if ( configLOGGING_INCLUDE_TIME_AND_TASK_NAME == 1 )
+        {
+            const char * pcTaskName = "None";
+
+            if( ( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED ) && ( xPortIsInsideInterrupt() == pdFALSE ) )
+            {
+                pcTaskName = pcTaskGetName( NULL );
+            }
+
+            strncpy( ( char * ) &pulRecord[ loggingTASK_NAME_INDEX ], pcTaskName, loggingTASK_NAME_WORDS * sizeof( uint32_t ) );
+        }
+    #endif
+
+    ( void ) prvStoreArgs( &pulRecord[ loggingRECORD_WORDS ], pcFormat, args );
+
+    prvCommit( ( uint32_t ) lOffset, ulFlags | ( uint32_t ) xWords );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Formats a record into pcBuffer, reading back the arguments in the order
+ * prvStoreArgs() wrote them.
+ */
+static void prvFormat( const uint32_t * pulRecord,
+                       BaseType_t xRaw,
+                       char * pcBuffer,
+                       size_t xBufferLength )
+{
+    static BaseType_t xMessageNumber = 0;
+    const char * pcFormat;
+    const uint32_t * pulArgs = &pulRecord[ loggingRECORD_WORDS ];
+    const char * pcSpec;
+    char cSpec[ loggingMAX_SPEC_LENGTH + 1 ];
+    size_t xSpecLength, xLength = 0;
+    uint32_t ulStars, i;
+    int iStars[ 2 ] = { 0, 0 };
+    int iLength;
+    LoggingArg_t xArg;
+    union
+    {
+        int i;
+        long l;
+        long long ll;
+        size_t x;
+        void * pv;
+        double d;
+    } xValue;
+
+    memcpy( &pcFormat, &pulRecord[ loggingFORMAT_INDEX ], sizeof( pcFormat ) );
+    pcBuffer[ 0 ] = '\0';
+
+    #if ( configLOGGING_INCLUDE_TIME_AND_TASK_NAME == 1 )
+        if( ( xRaw == pdFALSE ) && ( strcmp( pcFormat, "\n" ) != 0 ) )
+        {
+            char cTaskName[ loggingTASK_NAME_WORDS * sizeof( uint32_t ) + 1 ];
+
+            memcpy( cTaskName, &pulRecord[ loggingTASK_NAME_INDEX ], loggingTASK_NAME_WORDS * sizeof( uint32_t ) );
+            cTaskName[ loggingTASK_NAME_WORDS * sizeof( uint32_t ) ] = '\0';
+
+            iLength = snprintf( pcBuffer, xBufferLength, "%lu %lu [%s] ",
+                                ( unsigned long ) xMessageNumber++,
+                                ( unsigned long ) pulRecord[ loggingTICK_INDEX ],
+                                cTaskName );
+            xLength = ( iLength > 0 ) ? ( size_t ) iLength : 0;
+        }
+    #else
+        ( void ) xMessageNumber;
+        ( void ) xRaw;
+    #endif
+
+    while( ( xLength < ( xBufferLength - 1 ) ) &&
+           ( ( xArg = prvNextArg( &pcFormat, &pcSpec, &xSpecLength, &ulStars ) ) != eLoggingArgEnd ) )
+    {
+        if( xArg == eLoggingArgNone )
+        {
+            /* Literal text, %% prints a single % */
+            if( ( xSpecLength == 2 ) && ( pcSpec[ 0 ] == '%' ) )
+            {
+                pcSpec++;
+                xSpecLength = 1;
+            }
+
+            iLength = snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, "%.*s", ( int ) xSpecLength, pcSpec );
+        }
+        else
+        {
+            for( i = 0; i < ulStars; i++ )
+            {
+                memcpy( &iStars[ i & 1 ], pulArgs, sizeof( int ) );
+                pulArgs += prvArgWords( eLoggingArgInt );
+            }
+
+            if( xSpecLength > loggingMAX_SPEC_LENGTH )
+            {
+                xSpecLength = loggingMAX_SPEC_LENGTH;
+            }
+
+            memcpy( cSpec, pcSpec, xSpecLength );
+            cSpec[ xSpecLength ] = '\0';
+
+            if( xArg == eLoggingArgString )
+            {
+                /* Stored with its length, printed with a precision as it is not terminated */
+                iLength = snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, "%.*s",
+                                    ( int ) pulArgs[ 0 ], ( const char * ) &pulArgs[ 1 ] );
+                pulArgs += 1 + loggingWORDS( pulArgs[ 0 ] );
+            }
+            else
+            {
+                memcpy( &xValue, pulArgs, prvArgWords( xArg ) * sizeof( uint32_t ) );
+                pulArgs += prvArgWords( xArg );
+
+                switch( xArg )
+                {
+                    case eLoggingArgLong:
+                        iLength = ( ulStars == 2 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], iStars[ 1 ], xValue.l ) :
+                                  ( ulStars == 1 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], xValue.l ) :
+                                  snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, xValue.l );
+                        break;
+
+                    case eLoggingArgLongLong:
+                        iLength = ( ulStars == 2 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], iStars[ 1 ], xValue.ll ) :
+                                  ( ulStars == 1 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], xValue.ll ) :
+                                  snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, xValue.ll );
+                        break;
+
+                    case eLoggingArgSize:
+                        iLength = ( ulStars == 2 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], iStars[ 1 ], xValue.x ) :
+                                  ( ulStars == 1 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], xValue.x ) :
+                                  snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, xValue.x );
+                        break;
+
+                    case eLoggingArgPointer:
+                        iLength = ( ulStars == 2 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], iStars[ 1 ], xValue.pv ) :
+                                  ( ulStars == 1 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], xValue.pv ) :
+                                  snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, xValue.pv );
+                        break;
+
+                    case eLoggingArgDouble:
+                        iLength = ( ulStars == 2 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], iStars[ 1 ], xValue.d ) :
+                                  ( ulStars == 1 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], xValue.d ) :
+                                  snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, xValue.d );
+                        break;
+
+                    default:
+                        iLength = ( ulStars == 2 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], iStars[ 1 ], xValue.i ) :
+                                  ( ulStars == 1 ) ? snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, iStars[ 0 ], xValue.i ) :
+                                  snprintf( &pcBuffer[ xLength ], xBufferLength - xLength, cSpec, xValue.i );
+                        break;
+                }
+            }
+        }
+
+        if( iLength > 0 )
+        {
+            xLength += ( size_t ) iLength;
+        }
+    }
+
+    if( xLength >= xBufferLength )
+    {
+        pcBuffer[ xBufferLength - 1 ] = '\0';
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xLoggingTaskInitialize( uint16_t usStackSize,
+                                   UBaseType_t uxPriority,
+                                   UBaseType_t uxQueueLength )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    /* The ring replaces the queue of messages. */
+    ( void ) uxQueueLength;
+
+    /* Ensure the logging task has not been created already. */
+    if( xLoggingTask == NULL )
+    {
+        xReturn = xTaskCreate( prvLoggingTask, "Logging", usStackSize, NULL, uxPriority, &xLoggingTask );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoggingTask( void * pvParameters )
+{
+    static char cPrintString[ configLOGGING_MAX_MESSAGE_LENGTH ];
+    uint32_t ulHeader, ulOffset, ulReportedLost = 0;
+
+    ( void ) pvParameters;
+
+    for( ; ; )
+    {
+        /* Block to wait for the next record. */
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        while( ulConsumed != ulReserved )
+        {
+            ulOffset = ulConsumed % loggingRING_WORDS;
+            ulHeader = ulRing[ ulOffset ];
+
+            if( ( ulHeader & loggingHEADER_COMMITTED ) == 0 )
+            {
+                /* The task writing this record was preempted, it notifies on commit. */
+                break;
+            }
+
+            portMEMORY_BARRIER();
+
+            if( ( ulHeader & loggingHEADER_PADDING ) == 0 )
+            {
+                prvFormat( &ulRing[ ulOffset ],
+                           ( ( ulHeader & loggingHEADER_RAW ) != 0 ) ? pdTRUE : pdFALSE,
+                           cPrintString,
+                           sizeof( cPrintString ) );
+                configPRINT_STRING( cPrintString );
+            }
+
+            /* Release the record.  All of its words are cleared, not only the
+             * header: a later record may start on any of them, and the logging
+             * task must never see a stale data word as a committed header
+             * while that record is reserved but not yet written. */
+            memset( &ulRing[ ulOffset ], 0, ( ulHeader & loggingHEADER_LENGTH_MASK ) * sizeof( uint32_t ) );
+            portMEMORY_BARRIER();
+            ulConsumed += ulHeader & loggingHEADER_LENGTH_MASK;
+        }
+
+        if( ulLost != ulReportedLost )
+        {
+            snprintf( cPrintString, sizeof( cPrintString ), "[%lu log messages lost]\r\n", ( unsigned long ) ( ulLost - ulReportedLost ) );
+            configPRINT_STRING( cPrintString );
+            ulReportedLost = ulLost;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*!
+ * \brief Records a message to be formatted and printed
+ * by the logging task.
+ *
+ * The message number, time (in ticks), and task that
+ * called vLoggingPrintf are prepended when it is formatted.
+ *
+ */
+void vLoggingPrintf( const char * pcFormat,
+                     ... )
+{
+    va_list args;
+
+    /* The format string is kept by pointer, it must be a string constant. */
+    va_start( args, pcFormat );
+    prvRecord( 0, pcFormat, args );
+    va_end( args );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordRaw( const char * pcFormat,
+                          ... )
+{
+    va_list args;
+
+    va_start( args, pcFormat );
+    prvRecord( loggingHEADER_RAW, pcFormat, args );
+    va_end( args );
+}
+
+void vLoggingPrint( const char * pcMessage )
+{
+    /* The message is copied, it is printed as is. */
+    prvRecordRaw( "%s", pcMessage );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulLoggingGetLostCount( void )
+{
+    return ulLost;
+}
+
+#endif /* configLOGGING_DEFERRED == 1 */
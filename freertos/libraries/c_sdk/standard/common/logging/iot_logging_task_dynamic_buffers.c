@@ -36,6 +36,9 @@
 #include <stdarg.h>
 #include <string.h>
 
+/* Replaced by iot_logging_task_deferred.c when configLOGGING_DEFERRED is 1. */
+#if ( configLOGGING_DEFERRED != 1 )
+
 /* Sanity check all the definitions required by this file are set. */
 #ifndef configPRINT_STRING
     #error configPRINT_STRING( x ) must be defined in FreeRTOSConfig.h to use this logging file.  Set configPRINT_STRING( x ) to a function that outputs a string, where X is the string.  For example, #define configPRINT_STRING( x ) MyUARTWriteString( X )
@@ -248,3 +251,5 @@ void vLoggingPrint( const char * pcMessage )
         }
     }
 }
+
+#endif /* configLOGGING_DEFERRED != 1 */
@@ -0,0 +1,132 @@
+/*
+ * FreeRTOS V1.4.8
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_bufferpool.h
+ * @brief Size-classed buffer pool for MQTT and Shadow messages.
+ *
+ * Buffers handed to the application with a received message come from here and
+ * must be returned with #MQTT_AGENT_ReturnBuffer or #SHADOW_ReturnMQTTBuffer
+ * when taken. Each buffer records the task and the label it was taken for, so
+ * returns of foreign or already returned buffers are refused and buffers held
+ * longer than bufferpoolconfigLEAK_HOLD_MS are reported when the pool runs out.
+ */
+
+#ifndef _AWS_BUFFER_POOL_H_
+#define _AWS_BUFFER_POOL_H_
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* Buffer pool config. */
+#include "aws_bufferpool_config.h"
+
+#ifndef bufferpoolconfigLEAK_HOLD_MS
+    #define bufferpoolconfigLEAK_HOLD_MS    ( 30000 )
+#endif
+
+/**
+ * @brief Number of buffer size classes.
+ */
+#define bufferpoolNUM_CLASSES    ( 3 )
+
+/**
+ * @brief Usage of one buffer size class.
+ */
+typedef struct BufferPoolClassStats
+{
+    uint32_t ulBufferSize; /**< Size of each buffer in bytes. */
+    uint32_t ulNumBuffers; /**< Number of buffers in the class. */
+    uint32_t ulInUse;      /**< Buffers currently taken. */
+    uint32_t ulPeakInUse;  /**< Most buffers taken at the same time. */
+    uint32_t ulTaken;      /**< Buffers taken since boot. */
+} BufferPoolClassStats_t;
+
+/**
+ * @brief Usage of the pool since boot.
+ */
+typedef struct BufferPoolStats
+{
+    BufferPoolClassStats_t xClasses[ bufferpoolNUM_CLASSES ]; /**< Small, medium and large classes. */
+    uint32_t ulRequests;        /**< Buffers requested. */
+    uint32_t ulFailures;        /**< Requests no free buffer was large enough for. */
+    uint32_t ulUpgrades;        /**< Requests served from a larger class as theirs was exhausted. */
+    uint32_t ulLargestRequest;  /**< Largest size requested in bytes. */
+    uint32_t ulBytesInUse;      /**< Bytes of the buffers currently taken. */
+    uint32_t ulPeakBytesInUse;  /**< Most bytes taken at the same time. */
+    uint32_t ulBadReturns;      /**< Returns of buffers not taken from the pool. */
+    uint32_t ulLeaks;           /**< Buffers reported as held too long. */
+} BufferPoolStats_t;
+
+/**
+ * @brief Takes a buffer of at least the requested size.
+ *
+ * @param[in,out] pulBufferLength Bytes needed, set to the size of the buffer
+ * returned. Zero asks for the smallest class.
+ * @param[in] pcOwner Label reported if the buffer leaks, may be NULL.
+ *
+ * @return The buffer, or NULL when no free buffer is large enough.
+ */
+uint8_t * BUFFERPOOL_TakeBuffer( uint32_t * pulBufferLength,
+                                 const char * pcOwner );
+
+/**
+ * @brief Gives a buffer back to the pool.
+ *
+ * @param[in] pucBuffer The buffer, as returned by #BUFFERPOOL_TakeBuffer.
+ *
+ * @return pdPASS, or pdFAIL if the buffer is not a taken buffer of the pool.
+ */
+BaseType_t BUFFERPOOL_ReleaseBuffer( uint8_t * const pucBuffer );
+
+/**
+ * @brief mqttconfigGET_FREE_BUFFER_FXN and mqttconfigRETURN_BUFFER_FXN
+ * interface, an unlabelled #BUFFERPOOL_TakeBuffer and #BUFFERPOOL_ReleaseBuffer.
+ */
+uint8_t * BUFFERPOOL_GetFreeBuffer( uint32_t * pulBufferLength );
+void BUFFERPOOL_ReturnBuffer( uint8_t * const pucBuffer );
+
+/**
+ * @brief Reports the buffers taken longer than a given time.
+ *
+ * Each buffer is reported once per take, with its label and the task that took it.
+ *
+ * @param[in] xMaxHoldTicks Time a buffer may be held.
+ *
+ * @return Number of buffers newly reported.
+ */
+uint32_t BUFFERPOOL_CheckLeaks( TickType_t xMaxHoldTicks );
+
+/**
+ * @brief Reads the usage statistics of the pool.
+ *
+ * @param[out] pxStats Filled with the statistics.
+ */
+void BUFFERPOOL_GetStats( BufferPoolStats_t * pxStats );
+
+#endif /* _AWS_BUFFER_POOL_H_ */
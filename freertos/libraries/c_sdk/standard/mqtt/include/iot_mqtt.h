@@ -866,4 +866,52 @@ bool IotMqtt_IsSubscribed( IotMqttConnection_t mqttConnection,
                            IotMqttSubscription_t * pCurrentSubscription );
 /* @[declare_mqtt_issubscribed] */
 
+/**
+ * @brief Checks whether the server resumed a previous session.
+ *
+ * Returns the session present flag of the CONNACK received for `mqttConnection`.
+ * It can only be set when @ref mqtt_function_connect was called with
+ * #IotMqttConnectInfo_t.cleanSession `false`; the subscriptions of the session
+ * are then still active on the server and need not be sent again.
+ *
+ * @param[in] mqttConnection The MQTT connection to check.
+ *
+ * @return `true` if the server reported a present session; `false` otherwise.
+ */
+/* @[declare_mqtt_issessionpresent] */
+bool IotMqtt_IsSessionPresent( IotMqttConnection_t mqttConnection );
+/* @[declare_mqtt_issessionpresent] */
+
+/**
+ * @brief Publishes a QoS 1 message of a session that may be resumed later.
+ *
+ * Same as @ref mqtt_function_publish, with the packet identifier of the message
+ * in and out. When `*pPacketIdentifier` is `0`, a new message is sent and its
+ * packet identifier written back. Otherwise, the message is the retransmission
+ * of an unacknowledged PUBLISH after reconnecting with
+ * #IotMqttConnectInfo_t.cleanSession `false`: it is sent with the DUP flag and
+ * the given packet identifier, so that the server can recognize it. MQTT 3.1.1
+ * requires this retransmission when the server reports a present session.
+ *
+ * The packet identifier is written before the message is queued for sending.
+ *
+ * @param[in] mqttConnection The MQTT connection to use for the publish.
+ * @param[in] pPublishInfo MQTT publish parameters, the QoS must be 1.
+ * @param[in,out] pPacketIdentifier Packet identifier of the message, `0` for a new one.
+ * @param[in] flags Flags which modify the behavior of this function. See @ref mqtt_constants_flags.
+ * @param[in] pCallbackInfo Asynchronous notification of this function's completion.
+ * @param[out] pPublishOperation Set to a handle by which this operation may be referenced
+ * after this function returns. This reference is invalidated once the publish completes.
+ *
+ * @return See @ref mqtt_function_publish. #IOT_MQTT_BAD_PARAMETER if the QoS is not 1.
+ */
+/* @[declare_mqtt_publishsession] */
+IotMqttError_t IotMqtt_PublishSession( IotMqttConnection_t mqttConnection,
+                                       const IotMqttPublishInfo_t * pPublishInfo,
+                                       uint16_t * pPacketIdentifier,
+                                       uint32_t flags,
+                                       const IotMqttCallbackInfo_t * pCallbackInfo,
+                                       IotMqttOperation_t * pPublishOperation );
+/* @[declare_mqtt_publishsession] */
+
 #endif /* ifndef IOT_MQTT_H_ */
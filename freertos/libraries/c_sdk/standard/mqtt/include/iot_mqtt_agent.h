@@ -145,6 +145,7 @@ typedef struct MQTTAgentConnectParams
                                      *   messages received on the topics for which the user has not registered any subscription callback. Can be NULL. */
     char * pcCertificate;           /**< Certificate used for secure connection. Can be NULL. If it is NULL, the one specified in the aws_credential_keys.h is used. */
     uint32_t ulCertificateSize;     /**< Size of certificate used for secure connection. */
+    BaseType_t xPersistentSession;  /**< pdTRUE to connect with clean session off and restore the subscriptions made on this handle. Unacknowledged MQTT_AGENT_PublishAsync messages are sent again, see MQTT_AGENT_SessionPresent. */
 #if SSS_USE_FTR_FILE
     char * cUserName;               /**< UserName, From Application Layer, if used if during MQTT Connect */
     uint32_t uUsernamelength;       /**< Length of UserName */
@@ -191,6 +192,22 @@ typedef struct MQTTAgentPublishParams
     uint32_t ulDataLength;    /**< Length of the data. */
 } MQTTAgentPublishParams_t;
 
+/**
+ * @brief Signature of the callback invoked when a publish started with
+ * MQTT_AGENT_PublishAsync completes.
+ *
+ * Invoked from the MQTT task for QoS1 once the PUBACK is received, the retries are
+ * exhausted or the connection is closed. On a persistent session, closing the
+ * connection does not complete the publish: the message waits for the next
+ * connection. For QoS0 it is invoked before MQTT_AGENT_PublishAsync returns. The
+ * MQTT agent APIs must not be called from it.
+ *
+ * @param[in] pvContext The context passed to MQTT_AGENT_PublishAsync.
+ * @param[in] xResult eMQTTAgentSuccess if the message was acknowledged by the broker.
+ */
+typedef void ( * MQTTAgentPublishCallback_t )( void * pvContext,
+                                               MQTTAgentReturnCode_t xResult );
+
 /**
  * @brief MQTT library Init function.
  *
@@ -332,6 +349,8 @@ MQTTAgentReturnCode_t MQTT_AGENT_Unsubscribe( MQTTAgentHandle_t xMQTTHandle,
  * is short the calling task's notification state and value may be updated after MQTT_AGENT_Publish()
  * has returned.
  *
+ * @note The message is not kept for a persistent session, use MQTT_AGENT_PublishAsync for it.
+ *
  * @param[in] xMQTTHandle The opaque handle as returned from MQTT_AGENT_Create.
  * @param[in] pxPublishParams Publish parameters.
  * @param[in] xTimeoutTicks Maximum time in ticks after which the operation should fail. Use pdMS_TO_TICKS
@@ -344,6 +363,67 @@ MQTTAgentReturnCode_t MQTT_AGENT_Publish( MQTTAgentHandle_t xMQTTHandle,
                                           const MQTTAgentPublishParams_t * const pxPublishParams,
                                           TickType_t xTimeoutTicks );
 
+/**
+ * @brief Publishes a message without waiting for the acknowledgement.
+ *
+ * Up to mqttconfigMAX_INFLIGHT_PUBLISHES QoS1 messages can wait for their PUBACK at
+ * the same time, the broker may acknowledge them in any order. When the window is
+ * full, this function waits for a slot for at most xTimeoutTicks.
+ *
+ * On a connection made with xPersistentSession, the agent keeps a copy of each QoS1
+ * message until its PUBACK, with the packet identifier given by the session. After
+ * MQTT_AGENT_Disconnect the message keeps its slot, and the next MQTT_AGENT_Connect
+ * with xPersistentSession sends it again, see MQTT_AGENT_SessionPresent. Otherwise,
+ * the callback of a message not acknowledged when the connection is closed reports
+ * the failure and the application resends it on the next connection.
+ *
+ * @param[in] xMQTTHandle The opaque handle as returned from MQTT_AGENT_Create.
+ * @param[in] pxPublishParams Publish parameters. The data is copied and can be freed
+ * after the call returns.
+ * @param[in] pxCallback Called when the publish completes. Can be NULL.
+ * @param[in] pvContext Passed as it is to pxCallback.
+ * @param[in] xTimeoutTicks Maximum time in ticks to wait for a free slot in the window.
+ *
+ * @return eMQTTAgentSuccess if the message was sent, in which case pxCallback is always
+ * invoked, eMQTTAgentTimeout if the window stayed full, otherwise eMQTTAgentFailure.
+ */
+MQTTAgentReturnCode_t MQTT_AGENT_PublishAsync( MQTTAgentHandle_t xMQTTHandle,
+                                               const MQTTAgentPublishParams_t * const pxPublishParams,
+                                               MQTTAgentPublishCallback_t pxCallback,
+                                               void * pvContext,
+                                               TickType_t xTimeoutTicks );
+
+/**
+ * @brief Waits until every publish started with MQTT_AGENT_PublishAsync has completed.
+ *
+ * @param[in] xMQTTHandle The opaque handle as returned from MQTT_AGENT_Create.
+ * @param[in] xTimeoutTicks Maximum time in ticks to wait.
+ *
+ * @return eMQTTAgentSuccess if no publish is in flight anymore, eMQTTAgentTimeout otherwise.
+ */
+MQTTAgentReturnCode_t MQTT_AGENT_WaitPublishes( MQTTAgentHandle_t xMQTTHandle,
+                                                TickType_t xTimeoutTicks );
+
+/**
+ * @brief Tells whether the broker resumed the session on the last connect.
+ *
+ * Only meaningful when the connection was established with xPersistentSession set.
+ * The subscriptions made before are then still active and need not be sent again,
+ * and the broker delivers the QoS1 messages queued while the client was away.
+ *
+ * QoS1 messages of MQTT_AGENT_PublishAsync not acknowledged on the previous
+ * connection were sent again by MQTT_AGENT_Connect: with the DUP flag and their
+ * packet identifier when this returns pdTRUE, so that the broker recognizes them,
+ * as new messages otherwise. A message published with MQTT_AGENT_Publish is not
+ * kept, its caller gets the failure. The messages are held in RAM only, they do not
+ * survive MQTT_AGENT_Delete or a reset of the device.
+ *
+ * @param[in] xMQTTHandle The opaque handle as returned from MQTT_AGENT_Create.
+ *
+ * @return pdTRUE if the CONNACK reported a present session, pdFALSE otherwise.
+ */
+BaseType_t MQTT_AGENT_SessionPresent( MQTTAgentHandle_t xMQTTHandle );
+
 /**
  * @brief Returns the buffer provided in the publish callback.
  *
@@ -356,7 +436,8 @@ MQTTAgentReturnCode_t MQTT_AGENT_Publish( MQTTAgentHandle_t xMQTTHandle,
  * @param[in] xBufferHandle The buffer to return.
  *
  * @return eMQTTAgentSuccess if the return buffer operation succeeds, otherwise an error
- * code explaining the reason of the failure is returned.
+ * code explaining the reason of the failure is returned. eMQTTAgentFailure means the
+ * buffer was not taken from the buffer pool or was already returned.
  */
 MQTTAgentReturnCode_t MQTT_AGENT_ReturnBuffer( MQTTAgentHandle_t xMQTTHandle,
                                                MQTTBufferHandle_t xBufferHandle );
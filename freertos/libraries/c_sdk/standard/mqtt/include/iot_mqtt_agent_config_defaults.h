@@ -58,6 +58,17 @@
     #define mqttconfigKEEP_ALIVE_INTERVAL_SECONDS    ( 1200 )
 #endif
 
+/**
+ * @brief The keep-alive interval in seconds sent in CONNECT.
+ *
+ * Defaults to mqttconfigKEEP_ALIVE_INTERVAL_SECONDS. It may be raised when
+ * PINGREQs are sent after a learned idle time (see IOT_MQTT_PING_INTERVAL_MS)
+ * that can grow beyond mqttconfigKEEP_ALIVE_INTERVAL_SECONDS.
+ */
+#ifndef mqttconfigCONNECT_KEEP_ALIVE_SECONDS
+    #define mqttconfigCONNECT_KEEP_ALIVE_SECONDS( baselineSeconds )    ( baselineSeconds )
+#endif
+
 /**
  * @brief Defines the frequency at which the client should send Keep Alive messages.
  *
@@ -133,6 +144,32 @@
     #define mqttconfigMAX_PARALLEL_OPS    ( 5 )
 #endif
 
+/**
+ * @brief Maximum number of QoS1 messages published with MQTT_AGENT_PublishAsync
+ * waiting for their PUBACK at the same time.
+ */
+#ifndef mqttconfigMAX_INFLIGHT_PUBLISHES
+    #define mqttconfigMAX_INFLIGHT_PUBLISHES    ( 4 )
+#endif
+
+/**
+ * @brief Time in milliseconds before a QoS1 message published with
+ * MQTT_AGENT_PublishAsync is sent again, doubled on each retry.
+ *
+ * Not used on a persistent session, which sends the message again on the next
+ * connection only.
+ */
+#ifndef mqttconfigPUBLISH_RETRY_MS
+    #define mqttconfigPUBLISH_RETRY_MS    ( 5000 )
+#endif
+
+/**
+ * @brief Number of times a QoS1 message is sent again before its publish fails.
+ */
+#ifndef mqttconfigPUBLISH_RETRY_LIMIT
+    #define mqttconfigPUBLISH_RETRY_LIMIT    ( 2 )
+#endif
+
 /**
  * @brief Time in milliseconds after which the TCP send operation should timeout.
  */
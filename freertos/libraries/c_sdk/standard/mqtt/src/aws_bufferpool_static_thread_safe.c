@@ -0,0 +1,324 @@
+/*
+ * FreeRTOS V1.4.8
+ * Copyright (C) 2017 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file aws_bufferpool_static_thread_safe.c
+ * @brief Size-classed static buffer pool, safe to use from any task.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Buffer pool includes. */
+#include "aws_bufferpool.h"
+
+/* Sanity check the configuration. */
+#if ( bufferpoolconfigSMALL_NUM_BUFFERS < 1 ) || ( bufferpoolconfigMEDIUM_NUM_BUFFERS < 1 ) || ( bufferpoolconfigLARGE_NUM_BUFFERS < 1 )
+    #error Each buffer pool class needs at least one buffer.
+#endif
+
+#if ( bufferpoolconfigSMALL_BUFFER_SIZE > bufferpoolconfigMEDIUM_BUFFER_SIZE ) || ( bufferpoolconfigMEDIUM_BUFFER_SIZE > bufferpoolconfigLARGE_BUFFER_SIZE )
+    #error Buffer pool classes must be ordered by increasing size.
+#endif
+
+#define bufferpoolNUM_BUFFERS                                                  \
+    ( bufferpoolconfigSMALL_NUM_BUFFERS + bufferpoolconfigMEDIUM_NUM_BUFFERS + \
+      bufferpoolconfigLARGE_NUM_BUFFERS )
+
+/**
+ * @brief Bookkeeping of one buffer, entries are ordered by class.
+ */
+typedef struct BufferPoolEntry
+{
+    uint8_t * pucBuffer;                          /**< The buffer. */
+    uint8_t ucClass;                              /**< Index of its class. */
+    uint8_t ucTaken;                              /**< Set while the buffer is out of the pool. */
+    uint8_t ucReported;                           /**< Set once reported as leaked. */
+    uint32_t ulRequested;                         /**< Bytes asked for. */
+    TickType_t xTakenAt;                          /**< Tick count when taken. */
+    const char * pcOwner;                         /**< Label given when taken. */
+    char cTaskName[ configMAX_TASK_NAME_LEN ];    /**< Task that took it, copied as it may be deleted since. */
+} BufferPoolEntry_t;
+
+static uint8_t ucSmallBuffers[ bufferpoolconfigSMALL_NUM_BUFFERS ][ bufferpoolconfigSMALL_BUFFER_SIZE ];
+static uint8_t ucMediumBuffers[ bufferpoolconfigMEDIUM_NUM_BUFFERS ][ bufferpoolconfigMEDIUM_BUFFER_SIZE ];
+static uint8_t ucLargeBuffers[ bufferpoolconfigLARGE_NUM_BUFFERS ][ bufferpoolconfigLARGE_BUFFER_SIZE ];
+
+static BufferPoolEntry_t xEntries[ bufferpoolNUM_BUFFERS ];
+static BufferPoolStats_t xStats;
+static BaseType_t xPoolInitialized = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+/* Called in a critical section. */
+static void prvInitPool( void )
+{
+    uint32_t x, y = 0;
+
+    if( xPoolInitialized == pdTRUE )
+    {
+        return;
+    }
+
+    xStats.xClasses[ 0 ].ulBufferSize = bufferpoolconfigSMALL_BUFFER_SIZE;
+    xStats.xClasses[ 0 ].ulNumBuffers = bufferpoolconfigSMALL_NUM_BUFFERS;
+    xStats.xClasses[ 1 ].ulBufferSize = bufferpoolconfigMEDIUM_BUFFER_SIZE;
+    xStats.xClasses[ 1 ].ulNumBuffers = bufferpoolconfigMEDIUM_NUM_BUFFERS;
+    xStats.xClasses[ 2 ].ulBufferSize = bufferpoolconfigLARGE_BUFFER_SIZE;
+    xStats.xClasses[ 2 ].ulNumBuffers = bufferpoolconfigLARGE_NUM_BUFFERS;
+
+    for( x = 0; x < bufferpoolconfigSMALL_NUM_BUFFERS; x++, y++ )
+    {
+        xEntries[ y ].pucBuffer = ucSmallBuffers[ x ];
+        xEntries[ y ].ucClass = 0;
+    }
+
+    for( x = 0; x < bufferpoolconfigMEDIUM_NUM_BUFFERS; x++, y++ )
+    {
+        xEntries[ y ].pucBuffer = ucMediumBuffers[ x ];
+        xEntries[ y ].ucClass = 1;
+    }
+
+    for( x = 0; x < bufferpoolconfigLARGE_NUM_BUFFERS; x++, y++ )
+    {
+        xEntries[ y ].pucBuffer = ucLargeBuffers[ x ];
+        xEntries[ y ].ucClass = 2;
+    }
+
+    xPoolInitialized = pdTRUE;
+}
+
+/*-----------------------------------------------------------*/
+
+uint8_t * BUFFERPOOL_TakeBuffer( uint32_t * pulBufferLength,
+                                 const char * pcOwner )
+{
+    BufferPoolEntry_t * pxEntry = NULL;
+    BufferPoolClassStats_t * pxClass;
+    uint32_t ulRequested = *pulBufferLength;
+    uint32_t x;
+
+    taskENTER_CRITICAL();
+    {
+        prvInitPool();
+
+        xStats.ulRequests++;
+
+        if( ulRequested > xStats.ulLargestRequest )
+        {
+            xStats.ulLargestRequest = ulRequested;
+        }
+
+        /* Entries are ordered by class, so the first free one large enough
+         * is the smallest fit. */
+        for( x = 0; x < bufferpoolNUM_BUFFERS; x++ )
+        {
+            if( ( xEntries[ x ].ucTaken == 0 ) &&
+                ( xStats.xClasses[ xEntries[ x ].ucClass ].ulBufferSize >= ulRequested ) )
+            {
+                pxEntry = &xEntries[ x ];
+                break;
+            }
+        }
+
+        if( pxEntry != NULL )
+        {
+            /* Served from a larger class when a smaller one would fit. */
+            if( ( pxEntry->ucClass > 0 ) &&
+                ( xStats.xClasses[ pxEntry->ucClass - 1 ].ulBufferSize >= ulRequested ) )
+            {
+                xStats.ulUpgrades++;
+            }
+
+            pxEntry->ucTaken = 1;
+            pxEntry->ucReported = 0;
+            pxEntry->ulRequested = ulRequested;
+            pxEntry->xTakenAt = xTaskGetTickCount();
+            pxEntry->pcOwner = pcOwner;
+            ( void ) strncpy( pxEntry->cTaskName, pcTaskGetName( NULL ), sizeof( pxEntry->cTaskName ) - 1 );
+
+            pxClass = &xStats.xClasses[ pxEntry->ucClass ];
+            pxClass->ulTaken++;
+            pxClass->ulInUse++;
+
+            if( pxClass->ulInUse > pxClass->ulPeakInUse )
+            {
+                pxClass->ulPeakInUse = pxClass->ulInUse;
+            }
+
+            xStats.ulBytesInUse += pxClass->ulBufferSize;
+
+            if( xStats.ulBytesInUse > xStats.ulPeakBytesInUse )
+            {
+                xStats.ulPeakBytesInUse = xStats.ulBytesInUse;
+            }
+
+            *pulBufferLength = pxClass->ulBufferSize;
+        }
+        else
+        {
+            xStats.ulFailures++;
+            *pulBufferLength = 0;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( pxEntry == NULL )
+    {
+        configPRINTF( ( "Buffer pool: no free buffer of %u bytes for %s\r\n",
+                        ( unsigned ) ulRequested, ( pcOwner != NULL ) ? pcOwner : pcTaskGetName( NULL ) ) );
+
+        /* Running out is the moment a forgotten buffer shows. */
+        ( void ) BUFFERPOOL_CheckLeaks( pdMS_TO_TICKS( bufferpoolconfigLEAK_HOLD_MS ) );
+
+        return NULL;
+    }
+
+    return pxEntry->pucBuffer;
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t BUFFERPOOL_ReleaseBuffer( uint8_t * const pucBuffer )
+{
+    BaseType_t xResult = pdFAIL;
+    BufferPoolClassStats_t * pxClass;
+    uint32_t x;
+
+    /* Same as freeing NULL. */
+    if( pucBuffer == NULL )
+    {
+        return pdPASS;
+    }
+
+    taskENTER_CRITICAL();
+    {
+        prvInitPool();
+
+        for( x = 0; x < bufferpoolNUM_BUFFERS; x++ )
+        {
+            if( xEntries[ x ].pucBuffer == pucBuffer )
+            {
+                if( xEntries[ x ].ucTaken != 0 )
+                {
+                    xEntries[ x ].ucTaken = 0;
+                    pxClass = &xStats.xClasses[ xEntries[ x ].ucClass ];
+                    pxClass->ulInUse--;
+                    xStats.ulBytesInUse -= pxClass->ulBufferSize;
+                    xResult = pdPASS;
+                }
+
+                break;
+            }
+        }
+
+        if( xResult != pdPASS )
+        {
+            xStats.ulBadReturns++;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if( xResult != pdPASS )
+    {
+        configPRINTF( ( "Buffer pool: %p returned by %s was not taken from the pool\r\n",
+                        pucBuffer, pcTaskGetName( NULL ) ) );
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
+uint8_t * BUFFERPOOL_GetFreeBuffer( uint32_t * pulBufferLength )
+{
+    return BUFFERPOOL_TakeBuffer( pulBufferLength, NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+void BUFFERPOOL_ReturnBuffer( uint8_t * const pucBuffer )
+{
+    ( void ) BUFFERPOOL_ReleaseBuffer( pucBuffer );
+}
+
+/*-----------------------------------------------------------*/
+
+uint32_t BUFFERPOOL_CheckLeaks( TickType_t xMaxHoldTicks )
+{
+    BufferPoolEntry_t xLeaked;
+    TickType_t xNow = xTaskGetTickCount();
+    uint32_t ulReported = 0;
+    BaseType_t xReport;
+    uint32_t x;
+
+    for( x = 0; x < bufferpoolNUM_BUFFERS; x++ )
+    {
+        xReport = pdFALSE;
+
+        taskENTER_CRITICAL();
+        {
+            if( ( xEntries[ x ].ucTaken != 0 ) && ( xEntries[ x ].ucReported == 0 ) &&
+                ( ( TickType_t ) ( xNow - xEntries[ x ].xTakenAt ) > xMaxHoldTicks ) )
+            {
+                xEntries[ x ].ucReported = 1;
+                xStats.ulLeaks++;
+                xLeaked = xEntries[ x ];
+                xReport = pdTRUE;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* Printed outside of the critical section. */
+        if( xReport == pdTRUE )
+        {
+            configPRINTF( ( "Buffer pool: %u of %u bytes held for %u ms by %s, taken by %s\r\n",
+                            ( unsigned ) xLeaked.ulRequested,
+                            ( unsigned ) xStats.xClasses[ xLeaked.ucClass ].ulBufferSize,
+                            ( unsigned ) ( ( xNow - xLeaked.xTakenAt ) * portTICK_PERIOD_MS ),
+                            ( xLeaked.pcOwner != NULL ) ? xLeaked.pcOwner : "?",
+                            xLeaked.cTaskName ) );
+            ulReported++;
+        }
+    }
+
+    return ulReported;
+}
+
+/*-----------------------------------------------------------*/
+
+void BUFFERPOOL_GetStats( BufferPoolStats_t * pxStats )
+{
+    taskENTER_CRITICAL();
+    {
+        prvInitPool();
+        *pxStats = xStats;
+    }
+    taskEXIT_CRITICAL();
+}
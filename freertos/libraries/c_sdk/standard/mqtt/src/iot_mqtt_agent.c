@@ -43,6 +43,7 @@
 #include "iot_mqtt_agent.h"
 #include "iot_mqtt_agent_config.h"
 #include "iot_mqtt_agent_config_defaults.h"
+#include "aws_bufferpool.h"
 
 /* MQTT v2 include. */
 #include "iot_mqtt.h"
@@ -69,12 +70,29 @@
         BaseType_t xInUse;                                                     /**< Whether this instance is in-use. */
         MQTTPublishCallback_t xFunction;                                       /**< MQTT v1 callback function. */
         void * pvParameter;                                                    /**< Parameter to xFunction. */
+        MQTTQoS_t xQoS;                                                        /**< QoS the topic filter was subscribed with. */
 
         uint16_t usTopicFilterLength;                                          /**< Length of pcTopicFilter. */
         char pcTopicFilter[ mqttconfigSUBSCRIPTION_MANAGER_MAX_TOPIC_LENGTH ]; /**< Topic filter. */
     } MQTTCallback_t;
 #endif
 
+/**
+ * @brief Stores data on a publish started with MQTT_AGENT_PublishAsync.
+ */
+typedef struct MQTTInflightPublish
+{
+    BaseType_t xInUse;                      /**< Whether this instance is in-use. */
+    MQTTAgentPublishCallback_t pxCallback;  /**< Completion callback. */
+    void * pvContext;                       /**< Parameter to pxCallback. */
+    struct MQTTConnection * pxConnection;   /**< Connection the publish belongs to. */
+    IotMqttOperation_t xOperation;          /**< Current transmission, NULL while waiting for the next connection. */
+    uint16_t usPacketIdentifier;            /**< Packet identifier given by the session, 0 before the first transmission. */
+    uint16_t usTopicLength;                 /**< Length of the topic at the start of pucMessage. */
+    uint32_t ulDataLength;                  /**< Length of the data following the topic in pucMessage. */
+    uint8_t * pucMessage;                   /**< Copy of topic and data kept for a persistent session, NULL otherwise. */
+} MQTTInflightPublish_t;
+
 /**
  * @brief Stores data on an active MQTT connection.
  */
@@ -83,7 +101,11 @@ typedef struct MQTTConnection
     IotMqttConnection_t xMQTTConnection; /**< MQTT v2 connection handle. */
     MQTTAgentCallback_t pxCallback;      /**< MQTT v1 global callback. */
     void * pvUserData;                   /**< Parameter to pxCallback. */
+    BaseType_t xPersistentSession;       /**< Whether the last connect asked to resume the session. */
     StaticSemaphore_t xConnectionMutex;  /**< Protects from concurrent accesses. */
+    StaticSemaphore_t xInflightSlots;    /**< Counts the free entries of xInflight. */
+    MQTTInflightPublish_t xInflight      /**< Publishes waiting for their PUBACK. */
+    [ mqttconfigMAX_INFLIGHT_PUBLISHES ];
     #if ( mqttconfigENABLE_SUBSCRIPTION_MANAGEMENT == 1 )
         MQTTCallback_t xCallbacks        /**< Conversion table of MQTT v1 to MQTT v2 subscription callbacks. */
         [ mqttconfigSUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];
@@ -119,6 +141,64 @@ static void prvPublishCallbackWrapper( void * pvParameter,
 static void prvDisconnectCallbackWrapper( void * pvParameter,
                                           IotMqttCallbackParam_t * pxDisconnect );
 
+/**
+ * @brief Completes a publish started with MQTT_AGENT_PublishAsync.
+ *
+ * @param[in] pvParameter The in-flight publish entry.
+ * @param[in] pxOperation Information about the completed operation.
+ */
+static void prvPublishCompleteWrapper( void * pvParameter,
+                                       IotMqttCallbackParam_t * pxOperation );
+
+/**
+ * @brief Send a publish started with MQTT_AGENT_PublishAsync on the current connection.
+ *
+ * A message of a persistent session keeps its packet identifier: when
+ * usPacketIdentifier is set, it is sent again with the DUP flag.
+ *
+ * @param[in] pxPublish The in-flight publish entry.
+ * @param[in] pxPublishInfo Topic and data of the message.
+ *
+ * @return IOT_MQTT_STATUS_PENDING if the message was queued for sending.
+ * @note This function should be called with pxConnection->xConnectionMutex
+ * locked.
+ */
+static IotMqttError_t prvSendInflightPublish( MQTTInflightPublish_t * const pxPublish,
+                                              IotMqttPublishInfo_t * const pxPublishInfo );
+
+/**
+ * @brief Free an in-flight publish entry and its slot in the window.
+ *
+ * @param[in] pxPublish The in-flight publish entry.
+ * @note This function should be called with pxConnection->xConnectionMutex
+ * locked.
+ */
+static void prvReleaseInflightPublish( MQTTInflightPublish_t * const pxPublish );
+
+/**
+ * @brief Fail the publishes started with MQTT_AGENT_PublishAsync after the
+ * connection was closed.
+ *
+ * Messages copied for a persistent session are kept for the next connection
+ * when xKeepSession is pdTRUE. The callback of the others is invoked with
+ * eMQTTAgentFailure.
+ *
+ * @param[in] pxConnection The connection the publishes belong to.
+ * @param[in] xKeepSession Whether to keep the messages of a persistent session.
+ */
+static void prvFailInflightPublishes( MQTTConnection_t * const pxConnection,
+                                      BaseType_t xKeepSession );
+
+/**
+ * @brief Send again the messages of a persistent session after a connect.
+ *
+ * They keep their packet identifier when the broker resumed the session, they
+ * are sent as new messages otherwise.
+ *
+ * @param[in] pxConnection The connection the publishes belong to.
+ */
+static void prvResendInflightPublishes( MQTTConnection_t * const pxConnection );
+
 #if ( mqttconfigENABLE_SUBSCRIPTION_MANAGEMENT == 1 )
 
 /**
@@ -129,6 +209,7 @@ static void prvDisconnectCallbackWrapper( void * pvParameter,
  * @param[in] usTopicFilterLength Length of pcTopicFilter.
  * @param[in] xCallback MQTT v1 callback to store.
  * @param[in] pvParameter Parameter to xCallback.
+ * @param[in] xQoS QoS of the subscription.
  *
  * @return pdPASS if the callback was successfully stored; pdFAIL otherwise.
  */
@@ -136,7 +217,22 @@ static void prvDisconnectCallbackWrapper( void * pvParameter,
                                         const char * const pcTopicFilter,
                                         uint16_t usTopicFilterLength,
                                         MQTTPublishCallback_t xCallback,
-                                        void * pvParameter );
+                                        void * pvParameter,
+                                        MQTTQoS_t xQoS );
+
+/**
+ * @brief Fill a list of MQTT v2 subscriptions from the conversion table.
+ *
+ * Used to restore the subscriptions of a persistent session on reconnect.
+ *
+ * @param[in] pxConnection The connection containing the conversion table.
+ * @param[out] pxSubscriptions Where to write the subscriptions, must hold
+ * mqttconfigSUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS entries.
+ *
+ * @return The number of subscriptions written.
+ */
+    static size_t prvGetSubscriptions( MQTTConnection_t * const pxConnection,
+                                       IotMqttSubscription_t * pxSubscriptions );
 
 /**
  * @brief Search the callback conversion table for the given topic filter.
@@ -205,6 +301,7 @@ static void prvPublishCallbackWrapper( void * pvParameter,
 {
     BaseType_t xStatus = pdPASS;
     size_t xBufferSize = 0;
+    uint32_t ulBufferLength = 0;
     uint8_t * pucMqttBuffer = NULL;
     MQTTBool_t xCallbackReturn = eMQTTFalse;
     MQTTConnection_t * pxConnection = ( MQTTConnection_t * ) pvParameter;
@@ -225,14 +322,15 @@ static void prvPublishCallbackWrapper( void * pvParameter,
         }
     }
 
-    /* Allocate an MQTT buffer for the callback. */
+    /* Take an MQTT buffer for the callback from the pool. */
     if( xStatus == pdPASS )
     {
-        pucMqttBuffer = pvPortMalloc( xBufferSize );
+        ulBufferLength = ( uint32_t ) xBufferSize;
+        pucMqttBuffer = BUFFERPOOL_TakeBuffer( &ulBufferLength, "MQTT publish" );
 
         if( pucMqttBuffer == NULL )
         {
-            mqttconfigDEBUG_LOG( ( "Failed to allocate memory for MQTT buffer.\r\n" ) );
+            mqttconfigDEBUG_LOG( ( "No free MQTT buffer of %u bytes.\r\n", ( unsigned ) xBufferSize ) );
             xStatus = pdFAIL;
         }
         else
@@ -308,7 +406,7 @@ static void prvPublishCallbackWrapper( void * pvParameter,
     /* Free the MQTT buffer if the user did not take ownership of it. */
     if( ( xCallbackReturn == eMQTTFalse ) && ( pucMqttBuffer != NULL ) )
     {
-        vPortFree( pucMqttBuffer );
+        BUFFERPOOL_ReturnBuffer( pucMqttBuffer );
     }
 }
 
@@ -332,12 +430,213 @@ static void prvDisconnectCallbackWrapper( void * pvParameter,
 
 /*-----------------------------------------------------------*/
 
+static void prvPublishCompleteWrapper( void * pvParameter,
+                                       IotMqttCallbackParam_t * pxOperation )
+{
+    MQTTInflightPublish_t * pxPublish = ( MQTTInflightPublish_t * ) pvParameter;
+    MQTTConnection_t * pxConnection = pxPublish->pxConnection;
+    MQTTAgentPublishCallback_t pxCallback = NULL;
+    void * pvContext = NULL;
+    BaseType_t xComplete = pdFALSE;
+
+    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &( pxConnection->xConnectionMutex ), portMAX_DELAY );
+
+    /* A transmission abandoned when the connection was closed may still complete,
+     * the entry has moved on and the result is ignored. */
+    if( ( pxPublish->xInUse == pdTRUE ) &&
+        ( pxPublish->xOperation == pxOperation->u.operation.reference ) )
+    {
+        if( ( pxPublish->pucMessage != NULL ) &&
+            ( pxOperation->u.operation.result == IOT_MQTT_NETWORK_ERROR ) )
+        {
+            /* The session keeps the message, it is sent again on the next connection. */
+            pxPublish->xOperation = IOT_MQTT_OPERATION_INITIALIZER;
+        }
+        else
+        {
+            /* Release the slot before the callback so that it can start another publish. */
+            pxCallback = pxPublish->pxCallback;
+            pvContext = pxPublish->pvContext;
+            prvReleaseInflightPublish( pxPublish );
+            xComplete = pdTRUE;
+        }
+    }
+
+    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &( pxConnection->xConnectionMutex ) );
+
+    if( ( xComplete == pdTRUE ) && ( pxCallback != NULL ) )
+    {
+        pxCallback( pvContext, prvConvertReturnCode( pxOperation->u.operation.result ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static IotMqttError_t prvSendInflightPublish( MQTTInflightPublish_t * const pxPublish,
+                                              IotMqttPublishInfo_t * const pxPublishInfo )
+{
+    IotMqttError_t xMqttStatus = IOT_MQTT_STATUS_PENDING;
+    IotMqttCallbackInfo_t xCallbackInfo = IOT_MQTT_CALLBACK_INFO_INITIALIZER;
+    IotMqttConnection_t xMQTTConnection = pxPublish->pxConnection->xMQTTConnection;
+
+    xCallbackInfo.pCallbackContext = pxPublish;
+    xCallbackInfo.function = prvPublishCompleteWrapper;
+
+    if( pxPublish->pucMessage != NULL )
+    {
+        /* MQTT 3.1.1 resends an unacknowledged message on reconnect only, the
+         * session does not retry it on the same connection. */
+        pxPublishInfo->retryMs = 0;
+        pxPublishInfo->retryLimit = 0;
+
+        xMqttStatus = IotMqtt_PublishSession( xMQTTConnection,
+                                              pxPublishInfo,
+                                              &( pxPublish->usPacketIdentifier ),
+                                              0,
+                                              &xCallbackInfo,
+                                              &( pxPublish->xOperation ) );
+    }
+    else
+    {
+        /* The MQTT task resends the message until it is acknowledged, the PUBACK is
+         * matched to its publish by packet identifier. */
+        pxPublishInfo->retryMs = mqttconfigPUBLISH_RETRY_MS;
+        pxPublishInfo->retryLimit = mqttconfigPUBLISH_RETRY_LIMIT;
+
+        xMqttStatus = IotMqtt_Publish( xMQTTConnection,
+                                       pxPublishInfo,
+                                       0,
+                                       &xCallbackInfo,
+                                       &( pxPublish->xOperation ) );
+    }
+
+    if( xMqttStatus != IOT_MQTT_STATUS_PENDING )
+    {
+        pxPublish->xOperation = IOT_MQTT_OPERATION_INITIALIZER;
+    }
+
+    return xMqttStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvReleaseInflightPublish( MQTTInflightPublish_t * const pxPublish )
+{
+    MQTTConnection_t * pxConnection = pxPublish->pxConnection;
+
+    if( pxPublish->pucMessage != NULL )
+    {
+        vPortFree( pxPublish->pucMessage );
+    }
+
+    ( void ) memset( pxPublish, 0x00, sizeof( MQTTInflightPublish_t ) );
+    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &( pxConnection->xInflightSlots ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvFailInflightPublishes( MQTTConnection_t * const pxConnection,
+                                      BaseType_t xKeepSession )
+{
+    MQTTInflightPublish_t * pxPublish = NULL;
+    MQTTAgentPublishCallback_t pxCallback = NULL;
+    void * pvContext = NULL;
+    BaseType_t xFailed = pdFALSE;
+    UBaseType_t x;
+
+    /* The callbacks are invoked without the mutex, one entry at a time. */
+    for( x = 0; x < mqttconfigMAX_INFLIGHT_PUBLISHES; x++ )
+    {
+        pxPublish = &( pxConnection->xInflight[ x ] );
+        xFailed = pdFALSE;
+
+        ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &( pxConnection->xConnectionMutex ), portMAX_DELAY );
+
+        if( pxPublish->xInUse == pdTRUE )
+        {
+            /* The MQTT library destroyed the operation with the connection. */
+            pxPublish->xOperation = IOT_MQTT_OPERATION_INITIALIZER;
+
+            if( ( xKeepSession == pdFALSE ) || ( pxPublish->pucMessage == NULL ) )
+            {
+                pxCallback = pxPublish->pxCallback;
+                pvContext = pxPublish->pvContext;
+                prvReleaseInflightPublish( pxPublish );
+                xFailed = pdTRUE;
+            }
+        }
+
+        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &( pxConnection->xConnectionMutex ) );
+
+        if( ( xFailed == pdTRUE ) && ( pxCallback != NULL ) )
+        {
+            pxCallback( pvContext, eMQTTAgentFailure );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvResendInflightPublishes( MQTTConnection_t * const pxConnection )
+{
+    MQTTInflightPublish_t * pxPublish = NULL;
+    IotMqttPublishInfo_t xPublishInfo = IOT_MQTT_PUBLISH_INFO_INITIALIZER;
+    MQTTAgentPublishCallback_t pxCallback = NULL;
+    void * pvContext = NULL;
+    BaseType_t xFailed = pdFALSE;
+    BaseType_t xResumed = MQTT_AGENT_SessionPresent( ( MQTTAgentHandle_t ) pxConnection );
+    UBaseType_t x;
+
+    for( x = 0; x < mqttconfigMAX_INFLIGHT_PUBLISHES; x++ )
+    {
+        pxPublish = &( pxConnection->xInflight[ x ] );
+        xFailed = pdFALSE;
+
+        ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &( pxConnection->xConnectionMutex ), portMAX_DELAY );
+
+        if( ( pxPublish->xInUse == pdTRUE ) &&
+            ( pxPublish->xOperation == IOT_MQTT_OPERATION_INITIALIZER ) &&
+            ( pxPublish->pucMessage != NULL ) )
+        {
+            /* A new session does not know the packet identifier, the message is new to it. */
+            if( xResumed == pdFALSE )
+            {
+                pxPublish->usPacketIdentifier = 0;
+            }
+
+            xPublishInfo.pTopicName = ( const char * ) pxPublish->pucMessage;
+            xPublishInfo.topicNameLength = pxPublish->usTopicLength;
+            xPublishInfo.qos = IOT_MQTT_QOS_1;
+            xPublishInfo.pPayload = pxPublish->pucMessage + pxPublish->usTopicLength;
+            xPublishInfo.payloadLength = pxPublish->ulDataLength;
+
+            if( prvSendInflightPublish( pxPublish, &xPublishInfo ) != IOT_MQTT_STATUS_PENDING )
+            {
+                pxCallback = pxPublish->pxCallback;
+                pvContext = pxPublish->pvContext;
+                prvReleaseInflightPublish( pxPublish );
+                xFailed = pdTRUE;
+            }
+        }
+
+        ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &( pxConnection->xConnectionMutex ) );
+
+        if( ( xFailed == pdTRUE ) && ( pxCallback != NULL ) )
+        {
+            pxCallback( pvContext, eMQTTAgentFailure );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
 #if ( mqttconfigENABLE_SUBSCRIPTION_MANAGEMENT == 1 )
     static BaseType_t prvStoreCallback( MQTTConnection_t * const pxConnection,
                                         const char * const pcTopicFilter,
                                         uint16_t usTopicFilterLength,
                                         MQTTPublishCallback_t xCallback,
-                                        void * pvParameter )
+                                        void * pvParameter,
+                                        MQTTQoS_t xQoS )
     {
         MQTTCallback_t * pxCallback = NULL;
         BaseType_t xStatus = pdFAIL, i = 0;
@@ -370,6 +669,7 @@ static void prvDisconnectCallbackWrapper( void * pvParameter,
                 pxCallback->pvParameter = pvParameter;
                 pxCallback->usTopicFilterLength = usTopicFilterLength;
                 pxCallback->xFunction = xCallback;
+                pxCallback->xQoS = xQoS;
                 ( void ) strncpy( pxCallback->pcTopicFilter, pcTopicFilter, usTopicFilterLength );
                 xStatus = pdPASS;
             }
@@ -405,6 +705,36 @@ static void prvDisconnectCallbackWrapper( void * pvParameter,
         return pxResult;
     }
 
+/*-----------------------------------------------------------*/
+
+    static size_t prvGetSubscriptions( MQTTConnection_t * const pxConnection,
+                                       IotMqttSubscription_t * pxSubscriptions )
+    {
+        BaseType_t i = 0;
+        size_t xCount = 0;
+
+        if( xSemaphoreTake( ( QueueHandle_t ) &( pxConnection->xConnectionMutex ),
+                            portMAX_DELAY ) == pdTRUE )
+        {
+            for( i = 0; i < mqttconfigSUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS; i++ )
+            {
+                if( pxConnection->xCallbacks[ i ].xInUse == pdTRUE )
+                {
+                    pxSubscriptions[ xCount ].pTopicFilter = pxConnection->xCallbacks[ i ].pcTopicFilter;
+                    pxSubscriptions[ xCount ].topicFilterLength = pxConnection->xCallbacks[ i ].usTopicFilterLength;
+                    pxSubscriptions[ xCount ].qos = ( IotMqttQos_t ) pxConnection->xCallbacks[ i ].xQoS;
+                    pxSubscriptions[ xCount ].callback.pCallbackContext = pxConnection;
+                    pxSubscriptions[ xCount ].callback.function = prvPublishCallbackWrapper;
+                    xCount++;
+                }
+            }
+
+            ( void ) xSemaphoreGive( ( QueueHandle_t ) &( pxConnection->xConnectionMutex ) );
+        }
+
+        return xCount;
+    }
+
 /*-----------------------------------------------------------*/
 
     static void prvRemoveCallback( MQTTConnection_t * const pxConnection,
@@ -506,6 +836,9 @@ MQTTAgentReturnCode_t MQTT_AGENT_Create( MQTTAgentHandle_t * const pxMQTTHandle
     if( xStatus == eMQTTAgentSuccess )
     {
         ( void ) xSemaphoreCreateMutexStatic( &( pxNewConnection->xConnectionMutex ) );
+        ( void ) xSemaphoreCreateCountingStatic( mqttconfigMAX_INFLIGHT_PUBLISHES,
+                                                 mqttconfigMAX_INFLIGHT_PUBLISHES,
+                                                 &( pxNewConnection->xInflightSlots ) );
         *pxMQTTHandle = ( MQTTAgentHandle_t ) pxNewConnection;
     }
 
@@ -525,6 +858,9 @@ MQTTAgentReturnCode_t MQTT_AGENT_Delete( MQTTAgentHandle_t xMQTTHandle )
         pxConnection->xMQTTConnection = IOT_MQTT_CONNECTION_INITIALIZER;
     }
 
+    /* Messages kept for the session are lost with the handle. */
+    prvFailInflightPublishes( pxConnection, pdFALSE );
+
     /* Free memory used by the MQTT connection. */
     vPortFree( pxConnection );
 
@@ -553,10 +889,22 @@ MQTTAgentReturnCode_t MQTT_AGENT_Connect( MQTTAgentHandle_t xMQTTHandle,
     IotMqttNetworkInfo_t xNetworkInfo = IOT_MQTT_NETWORK_INFO_INITIALIZER;
     IotMqttConnectInfo_t xMqttConnectInfo = IOT_MQTT_CONNECT_INFO_INITIALIZER;
 
+    #if ( mqttconfigENABLE_SUBSCRIPTION_MANAGEMENT == 1 )
+        IotMqttSubscription_t xPreviousSubscriptions[ mqttconfigSUBSCRIPTION_MANAGER_MAX_SUBSCRIPTIONS ];
+    #endif
+
     /* Copy the global callback and parameter. */
     pxConnection->pxCallback = pxConnectParams->pxCallback;
     pxConnection->pvUserData = pxConnectParams->pvUserData;
 
+    /* Messages kept for a previous session are not delivered by a clean one. */
+    if( pxConnectParams->xPersistentSession != pdTRUE )
+    {
+        prvFailInflightPublishes( pxConnection, pdFALSE );
+    }
+
+    pxConnection->xPersistentSession = pxConnectParams->xPersistentSession;
+
     /* Set the TLS info for a secured connection. */
     if( ( pxConnectParams->xSecuredConnection == pdTRUE ) ||
         ( ( pxConnectParams->xFlags & mqttagentREQUIRE_TLS ) == mqttagentREQUIRE_TLS ) )
@@ -600,9 +948,27 @@ MQTTAgentReturnCode_t MQTT_AGENT_Connect( MQTTAgentHandle_t xMQTTHandle,
     /* Set the members of the MQTT connect info. */
     xMqttConnectInfo.awsIotMqttMode = true;
     xMqttConnectInfo.cleanSession = true;
+
+    /* Resume the previous session if requested. The subscriptions recorded on this
+     * handle are registered again locally, the broker still has them when it reports
+     * a present session. Unacknowledged publishes are sent again once connected. */
+    if( pxConnectParams->xPersistentSession == pdTRUE )
+    {
+        xMqttConnectInfo.cleanSession = false;
+
+        #if ( mqttconfigENABLE_SUBSCRIPTION_MANAGEMENT == 1 )
+            xMqttConnectInfo.previousSubscriptionCount = prvGetSubscriptions( pxConnection,
+                                                                              xPreviousSubscriptions );
+
+            if( xMqttConnectInfo.previousSubscriptionCount > 0 )
+            {
+                xMqttConnectInfo.pPreviousSubscriptions = xPreviousSubscriptions;
+            }
+        #endif
+    }
     xMqttConnectInfo.pClientIdentifier = ( const char * ) ( pxConnectParams->pucClientId );
     xMqttConnectInfo.clientIdentifierLength = pxConnectParams->usClientIdLength;
-    xMqttConnectInfo.keepAliveSeconds = mqttconfigKEEP_ALIVE_INTERVAL_SECONDS;
+    xMqttConnectInfo.keepAliveSeconds = mqttconfigCONNECT_KEEP_ALIVE_SECONDS( mqttconfigKEEP_ALIVE_INTERVAL_SECONDS );
 #if SSS_USE_FTR_FILE
     xMqttConnectInfo.awsIotMqttMode = false;
     xMqttConnectInfo.pUserName = (const char*)( pxConnectParams->cUserName );
@@ -650,6 +1016,13 @@ MQTTAgentReturnCode_t MQTT_AGENT_Connect( MQTTAgentHandle_t xMQTTHandle,
         }
     #endif /* if ( mqttconfigENABLE_SUBSCRIPTION_MANAGEMENT == 1 ) */
 
+    /* MQTT 3.1.1 4.4: the PUBLISH packets not acknowledged on the previous
+     * connection are sent again, with DUP set on a resumed session. */
+    if( ( xStatus == eMQTTAgentSuccess ) && ( pxConnection->xPersistentSession == pdTRUE ) )
+    {
+        prvResendInflightPublishes( pxConnection );
+    }
+
     return xStatus;
 }
 
@@ -672,11 +1045,23 @@ MQTTAgentReturnCode_t MQTT_AGENT_Disconnect( MQTTAgentHandle_t xMQTTHandle,
         pxConnection->xMQTTConnection = IOT_MQTT_CONNECTION_INITIALIZER;
     }
 
+    /* The MQTT library drops the pending operations without notifying them. */
+    prvFailInflightPublishes( pxConnection, pxConnection->xPersistentSession );
+
     return eMQTTAgentSuccess;
 }
 
 /*-----------------------------------------------------------*/
 
+BaseType_t MQTT_AGENT_SessionPresent( MQTTAgentHandle_t xMQTTHandle )
+{
+    MQTTConnection_t * pxConnection = ( MQTTConnection_t * ) xMQTTHandle;
+
+    return ( IotMqtt_IsSessionPresent( pxConnection->xMQTTConnection ) == true ) ? pdTRUE : pdFALSE;
+}
+
+/*-----------------------------------------------------------*/
+
 MQTTAgentReturnCode_t MQTT_AGENT_Subscribe( MQTTAgentHandle_t xMQTTHandle,
                                             const MQTTAgentSubscribeParams_t * const pxSubscribeParams,
                                             TickType_t xTimeoutTicks )
@@ -699,7 +1084,8 @@ MQTTAgentReturnCode_t MQTT_AGENT_Subscribe( MQTTAgentHandle_t xMQTTHandle,
                               ( const char * ) pxSubscribeParams->pucTopic,
                               pxSubscribeParams->usTopicLength,
                               pxSubscribeParams->pxPublishCallback,
-                              pxSubscribeParams->pvPublishCallbackContext ) == pdFAIL )
+                              pxSubscribeParams->pvPublishCallbackContext,
+                              pxSubscribeParams->xQoS ) == pdFAIL )
         {
             xStatus = eMQTTAgentFailure;
         }
@@ -787,13 +1173,161 @@ MQTTAgentReturnCode_t MQTT_AGENT_Publish( MQTTAgentHandle_t xMQTTHandle,
 
 /*-----------------------------------------------------------*/
 
+MQTTAgentReturnCode_t MQTT_AGENT_PublishAsync( MQTTAgentHandle_t xMQTTHandle,
+                                               const MQTTAgentPublishParams_t * const pxPublishParams,
+                                               MQTTAgentPublishCallback_t pxCallback,
+                                               void * pvContext,
+                                               TickType_t xTimeoutTicks )
+{
+    IotMqttError_t xMqttStatus = IOT_MQTT_STATUS_PENDING;
+    MQTTConnection_t * pxConnection = ( MQTTConnection_t * ) xMQTTHandle;
+    IotMqttPublishInfo_t xPublishInfo = IOT_MQTT_PUBLISH_INFO_INITIALIZER;
+    MQTTInflightPublish_t * pxPublish = NULL;
+    MQTTAgentReturnCode_t xStatus = eMQTTAgentSuccess;
+    UBaseType_t x;
+
+    /* Set the members of the publish info. */
+    xPublishInfo.pTopicName = ( const char * ) pxPublishParams->pucTopic;
+    xPublishInfo.topicNameLength = pxPublishParams->usTopicLength;
+    xPublishInfo.qos = ( IotMqttQos_t ) pxPublishParams->xQoS;
+    xPublishInfo.pPayload = ( const void * ) pxPublishParams->pvData;
+    xPublishInfo.payloadLength = pxPublishParams->ulDataLength;
+
+    /* QoS0 is complete once sent, it does not take a slot. */
+    if( xPublishInfo.qos == IOT_MQTT_QOS_0 )
+    {
+        xMqttStatus = IotMqtt_Publish( pxConnection->xMQTTConnection,
+                                       &xPublishInfo,
+                                       0,
+                                       NULL,
+                                       NULL );
+        xStatus = prvConvertReturnCode( xMqttStatus );
+
+        if( ( xStatus == eMQTTAgentSuccess ) && ( pxCallback != NULL ) )
+        {
+            pxCallback( pvContext, eMQTTAgentSuccess );
+        }
+
+        return xStatus;
+    }
+
+    /* Wait for room in the window. */
+    if( xSemaphoreTake( ( SemaphoreHandle_t ) &( pxConnection->xInflightSlots ), xTimeoutTicks ) != pdTRUE )
+    {
+        return eMQTTAgentTimeout;
+    }
+
+    ( void ) xSemaphoreTake( ( SemaphoreHandle_t ) &( pxConnection->xConnectionMutex ), portMAX_DELAY );
+
+    for( x = 0; x < mqttconfigMAX_INFLIGHT_PUBLISHES; x++ )
+    {
+        if( pxConnection->xInflight[ x ].xInUse == pdFALSE )
+        {
+            pxPublish = &( pxConnection->xInflight[ x ] );
+            pxPublish->xInUse = pdTRUE;
+            pxPublish->pxCallback = pxCallback;
+            pxPublish->pvContext = pvContext;
+            pxPublish->pxConnection = pxConnection;
+            break;
+        }
+    }
+
+    /* The semaphore guarantees a free entry. */
+    mqttconfigASSERT( pxPublish != NULL );
+
+    /* A persistent session keeps a copy until the PUBACK, to send it again after
+     * a reconnect. */
+    if( pxConnection->xPersistentSession == pdTRUE )
+    {
+        pxPublish->pucMessage = pvPortMalloc( ( size_t ) pxPublishParams->usTopicLength +
+                                              ( size_t ) pxPublishParams->ulDataLength );
+
+        if( pxPublish->pucMessage == NULL )
+        {
+            xStatus = eMQTTAgentFailure;
+        }
+        else
+        {
+            ( void ) memcpy( pxPublish->pucMessage,
+                             pxPublishParams->pucTopic,
+                             pxPublishParams->usTopicLength );
+            ( void ) memcpy( pxPublish->pucMessage + pxPublishParams->usTopicLength,
+                             pxPublishParams->pvData,
+                             pxPublishParams->ulDataLength );
+            pxPublish->usTopicLength = pxPublishParams->usTopicLength;
+            pxPublish->ulDataLength = pxPublishParams->ulDataLength;
+        }
+    }
+
+    /* The mutex is held until the operation is recorded in the entry, its
+     * completion waits for it. */
+    if( xStatus == eMQTTAgentSuccess )
+    {
+        xMqttStatus = prvSendInflightPublish( pxPublish, &xPublishInfo );
+
+        if( xMqttStatus != IOT_MQTT_STATUS_PENDING )
+        {
+            xStatus = eMQTTAgentFailure;
+        }
+    }
+
+    if( xStatus != eMQTTAgentSuccess )
+    {
+        /* Not sent, the callback will not be invoked. */
+        prvReleaseInflightPublish( pxPublish );
+    }
+
+    ( void ) xSemaphoreGive( ( SemaphoreHandle_t ) &( pxConnection->xConnectionMutex ) );
+
+    return xStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+MQTTAgentReturnCode_t MQTT_AGENT_WaitPublishes( MQTTAgentHandle_t xMQTTHandle,
+                                                TickType_t xTimeoutTicks )
+{
+    MQTTConnection_t * pxConnection = ( MQTTConnection_t * ) xMQTTHandle;
+    SemaphoreHandle_t xSlots = ( SemaphoreHandle_t ) &( pxConnection->xInflightSlots );
+    TimeOut_t xTimeOut;
+    UBaseType_t x, uxTaken = 0;
+    MQTTAgentReturnCode_t xStatus = eMQTTAgentSuccess;
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    /* Every slot is free once all of them could be taken. */
+    for( x = 0; x < mqttconfigMAX_INFLIGHT_PUBLISHES; x++ )
+    {
+        if( ( xTaskCheckForTimeOut( &xTimeOut, &xTimeoutTicks ) != pdFALSE ) ||
+            ( xSemaphoreTake( xSlots, xTimeoutTicks ) != pdTRUE ) )
+        {
+            xStatus = eMQTTAgentTimeout;
+            break;
+        }
+
+        uxTaken++;
+    }
+
+    for( x = 0; x < uxTaken; x++ )
+    {
+        ( void ) xSemaphoreGive( xSlots );
+    }
+
+    return xStatus;
+}
+
+/*-----------------------------------------------------------*/
+
 MQTTAgentReturnCode_t MQTT_AGENT_ReturnBuffer( MQTTAgentHandle_t xMQTTHandle,
                                                MQTTBufferHandle_t xBufferHandle )
 {
     ( void ) xMQTTHandle;
 
-    /* Free the MQTT buffer. */
-    vPortFree( xBufferHandle );
+    /* Give the MQTT buffer back, refused if it was not taken from the pool. */
+    if( BUFFERPOOL_ReleaseBuffer( ( uint8_t * ) xBufferHandle ) != pdPASS )
+    {
+        return eMQTTAgentFailure;
+    }
 
     return eMQTTAgentSuccess;
 }
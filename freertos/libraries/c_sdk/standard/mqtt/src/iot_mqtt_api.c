@@ -143,6 +143,28 @@ static IotMqttError_t _subscriptionCommon( IotMqttOperationType_t operation,
                                            const IotMqttCallbackInfo_t * pCallbackInfo,
                                            IotMqttOperation_t * pOperationReference );
 
+/**
+ * @brief The common component of both @ref mqtt_function_publish and @ref
+ * mqtt_function_publishsession.
+ *
+ * @param[in] mqttConnection The MQTT connection to use for the publish.
+ * @param[in] pPublishInfo MQTT publish parameters.
+ * @param[in,out] pPacketIdentifier Packet identifier of a session message;
+ * `NULL` for @ref mqtt_function_publish.
+ * @param[in] flags Flags which modify the behavior of this function.
+ * @param[in] pCallbackInfo Asynchronous notification of this function's completion.
+ * @param[out] pPublishOperation Set to a handle by which this operation may be
+ * referenced after this function returns.
+ *
+ * See @ref mqtt_function_publish for a description of the return values.
+ */
+static IotMqttError_t _publishCommon( IotMqttConnection_t mqttConnection,
+                                      const IotMqttPublishInfo_t * pPublishInfo,
+                                      uint16_t * pPacketIdentifier,
+                                      uint32_t flags,
+                                      const IotMqttCallbackInfo_t * pCallbackInfo,
+                                      IotMqttOperation_t * pPublishOperation );
+
 /*-----------------------------------------------------------*/
 
 static bool _mqttSubscription_setUnsubscribe( const IotLink_t * pSubscriptionLink,
@@ -1156,7 +1178,7 @@ IotMqttError_t IotMqtt_Connect( const IotMqttNetworkInfo_t * pNetworkInfo,
 
             taskPoolStatus = IotTaskPool_ScheduleDeferred( IOT_SYSTEM_TASKPOOL,
                                                            pNewMqttConnection->keepAliveJob,
-                                                           pNewMqttConnection->nextKeepAliveMs );
+                                                           _IotMqtt_PingIntervalMs( pNewMqttConnection ) );
 
             if( taskPoolStatus != IOT_TASKPOOL_SUCCESS )
             {
@@ -1496,15 +1518,17 @@ IotMqttError_t IotMqtt_TimedUnsubscribe( IotMqttConnection_t mqttConnection,
 
 /*-----------------------------------------------------------*/
 
-IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
-                                const IotMqttPublishInfo_t * pPublishInfo,
-                                uint32_t flags,
-                                const IotMqttCallbackInfo_t * pCallbackInfo,
-                                IotMqttOperation_t * pPublishOperation )
+static IotMqttError_t _publishCommon( IotMqttConnection_t mqttConnection,
+                                      const IotMqttPublishInfo_t * pPublishInfo,
+                                      uint16_t * pPacketIdentifier,
+                                      uint32_t flags,
+                                      const IotMqttCallbackInfo_t * pCallbackInfo,
+                                      IotMqttOperation_t * pPublishOperation )
 {
     IOT_FUNCTION_ENTRY( IotMqttError_t, IOT_MQTT_SUCCESS );
     _mqttOperation_t * pOperation = NULL;
     uint8_t ** pPacketIdentifierHigh = NULL;
+    uint8_t * pResumeIdentifierHigh = NULL;
 
     /* Default PUBLISH serializer function. */
     IotMqttError_t ( * serializePublish )( const IotMqttPublishInfo_t *,
@@ -1620,6 +1644,11 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
     {
         pPacketIdentifierHigh = &( pOperation->u.operation.pPacketIdentifierHigh );
     }
+    else if( pPacketIdentifier != NULL )
+    {
+        /* A resumed message needs the packet identifier of the first transmission. */
+        pPacketIdentifierHigh = &pResumeIdentifierHigh;
+    }
     else
     {
         EMPTY_ELSE_MARKER;
@@ -1645,6 +1674,39 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
     IotMqtt_Assert( pOperation->u.operation.pMqttPacket != NULL );
     IotMqtt_Assert( pOperation->u.operation.packetSize > 0 );
 
+    /* Keep the packet identifier of a resumed message, report the new one otherwise. */
+    if( pPacketIdentifier != NULL )
+    {
+        if( *pPacketIdentifier != 0 )
+        {
+            if( *pPacketIdentifierHigh == NULL )
+            {
+                IotLogError( "(MQTT connection %p) PUBLISH serializer does not locate the "
+                             "packet identifier, message cannot be resumed.",
+                             mqttConnection );
+
+                IOT_SET_AND_GOTO_CLEANUP( IOT_MQTT_BAD_PARAMETER );
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+
+            _IotMqtt_PublishResume( pOperation->u.operation.pMqttPacket,
+                                    *pPacketIdentifierHigh,
+                                    *pPacketIdentifier );
+            pOperation->u.operation.packetIdentifier = *pPacketIdentifier;
+        }
+        else
+        {
+            *pPacketIdentifier = pOperation->u.operation.packetIdentifier;
+        }
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
     /* Initialize PUBLISH retry if retryLimit is set. */
     if( pPublishInfo->retryLimit > 0 )
     {
@@ -1750,6 +1812,55 @@ IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
 
 /*-----------------------------------------------------------*/
 
+IotMqttError_t IotMqtt_Publish( IotMqttConnection_t mqttConnection,
+                                const IotMqttPublishInfo_t * pPublishInfo,
+                                uint32_t flags,
+                                const IotMqttCallbackInfo_t * pCallbackInfo,
+                                IotMqttOperation_t * pPublishOperation )
+{
+    return _publishCommon( mqttConnection,
+                           pPublishInfo,
+                           NULL,
+                           flags,
+                           pCallbackInfo,
+                           pPublishOperation );
+}
+
+/*-----------------------------------------------------------*/
+
+IotMqttError_t IotMqtt_PublishSession( IotMqttConnection_t mqttConnection,
+                                       const IotMqttPublishInfo_t * pPublishInfo,
+                                       uint16_t * pPacketIdentifier,
+                                       uint32_t flags,
+                                       const IotMqttCallbackInfo_t * pCallbackInfo,
+                                       IotMqttOperation_t * pPublishOperation )
+{
+    IotMqttError_t status = IOT_MQTT_BAD_PARAMETER;
+
+    /* Only a QoS 1 message is resent on a resumed session. */
+    if( ( pPacketIdentifier == NULL ) || ( pPublishInfo == NULL ) )
+    {
+        IotLogError( "Packet identifier and publish info must be provided for a session PUBLISH." );
+    }
+    else if( pPublishInfo->qos != IOT_MQTT_QOS_1 )
+    {
+        IotLogError( "Session PUBLISH must be QoS 1." );
+    }
+    else
+    {
+        status = _publishCommon( mqttConnection,
+                                 pPublishInfo,
+                                 pPacketIdentifier,
+                                 flags,
+                                 pCallbackInfo,
+                                 pPublishOperation );
+    }
+
+    return status;
+}
+
+/*-----------------------------------------------------------*/
+
 IotMqttError_t IotMqtt_TimedPublish( IotMqttConnection_t mqttConnection,
                                      const IotMqttPublishInfo_t * pPublishInfo,
                                      uint32_t flags,
@@ -2012,6 +2123,14 @@ const char * IotMqtt_OperationType( IotMqttOperationType_t operation )
 
 /*-----------------------------------------------------------*/
 
+bool IotMqtt_IsSessionPresent( IotMqttConnection_t mqttConnection )
+{
+    return ( mqttConnection != IOT_MQTT_CONNECTION_INITIALIZER ) &&
+           ( mqttConnection->sessionPresent == true );
+}
+
+/*-----------------------------------------------------------*/
+
 /* Provide access to internal functions and variables if testing. */
 #if IOT_BUILD_TESTS == 1
     #include "iot_test_access_mqtt_api.c"
@@ -41,6 +41,7 @@
 #include "private/iot_mqtt_internal.h"
 
 /* Platform layer includes. */
+#include "platform/iot_clock.h"
 #include "platform/iot_threads.h"
 
 /*-----------------------------------------------------------*/
@@ -319,6 +320,17 @@ static IotMqttError_t _deserializeIncomingPacket( _mqttConnection_t * pMqttConne
 
             /* Deserialize CONNACK and notify of result. */
             status = deserialize( pIncomingPacket );
+
+            /* The session present flag is bit 0 of the acknowledge flags. */
+            if( ( status == IOT_MQTT_SUCCESS ) && ( pIncomingPacket->remainingLength > 0 ) )
+            {
+                pMqttConnection->sessionPresent = ( ( pIncomingPacket->pRemainingData[ 0 ] & 0x01 ) == 0x01 );
+            }
+            else
+            {
+                EMPTY_ELSE_MARKER;
+            }
+
             pOperation = _IotMqtt_FindOperation( pMqttConnection,
                                                  IOT_MQTT_CONNECT,
                                                  NULL );
@@ -738,6 +750,8 @@ static void _sendPuback( _mqttConnection_t * pMqttConnection,
         }
         else
         {
+            pMqttConnection->lastSendMs = ( uint32_t ) IotClock_GetTimeMs();
+
             IotLogDebug( "(MQTT connection %p) PUBACK for received PUBLISH %hu sent.",
                          pMqttConnection,
                          packetIdentifier );
@@ -644,13 +644,34 @@ void _IotMqtt_DestroyOperation( _mqttOperation_t * pOperation )
 
 /*-----------------------------------------------------------*/
 
+uint32_t _IotMqtt_PingIntervalMs( const _mqttConnection_t * pMqttConnection )
+{
+    uint32_t pingIntervalMs = IOT_MQTT_PING_INTERVAL_MS( pMqttConnection->keepAliveMs );
+
+    /* The server closes the connection after 1.5 keep-alive intervals without
+     * a packet, so the ping interval may only be shorter. */
+    if( ( pingIntervalMs == 0 ) || ( pingIntervalMs > pMqttConnection->keepAliveMs ) )
+    {
+        pingIntervalMs = pMqttConnection->keepAliveMs;
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
+
+    return pingIntervalMs;
+}
+
+/*-----------------------------------------------------------*/
+
 void _IotMqtt_ProcessKeepAlive( IotTaskPool_t pTaskPool,
                                 IotTaskPoolJob_t pKeepAliveJob,
                                 void * pContext )
 {
-    bool status = true;
+    bool status = true, pingDone = false, pingAnswered = false;
     IotTaskPoolError_t taskPoolStatus = IOT_TASKPOOL_SUCCESS;
     size_t bytesSent = 0;
+    uint32_t idleMs = 0, pingIntervalMs = 0, delayMs = 0, pingIdleMs = 0;
 
     /* Retrieve the MQTT connection from the context. */
     _mqttConnection_t * pMqttConnection = ( _mqttConnection_t * ) pContext;
@@ -678,8 +699,22 @@ void _IotMqtt_ProcessKeepAlive( IotTaskPool_t pTaskPool,
 
     IotMutex_Lock( &( pMqttConnection->referencesMutex ) );
 
+    /* Any packet sent proves the connection alive as well as a PINGREQ. */
+    idleMs = ( uint32_t ) IotClock_GetTimeMs() - pMqttConnection->lastSendMs;
+    pingIntervalMs = _IotMqtt_PingIntervalMs( pMqttConnection );
+    delayMs = pMqttConnection->nextKeepAliveMs;
+
     /* Determine whether to send a PINGREQ or check for PINGRESP. */
-    if( pMqttConnection->nextKeepAliveMs == pMqttConnection->keepAliveMs )
+    if( ( pMqttConnection->nextKeepAliveMs == pMqttConnection->keepAliveMs ) &&
+        ( idleMs < pingIntervalMs ) )
+    {
+        IotLogDebug( "(MQTT connection %p) Packet sent %lu ms ago, PINGREQ not needed.",
+                     pMqttConnection,
+                     ( unsigned long ) idleMs );
+
+        delayMs = pingIntervalMs - idleMs;
+    }
+    else if( pMqttConnection->nextKeepAliveMs == pMqttConnection->keepAliveMs )
     {
         IotLogDebug( "(MQTT connection %p) Sending PINGREQ.", pMqttConnection );
 
@@ -694,15 +729,20 @@ void _IotMqtt_ProcessKeepAlive( IotTaskPool_t pTaskPool,
         {
             IotLogError( "(MQTT connection %p) Failed to send PINGREQ.", pMqttConnection );
             status = false;
+            pingIdleMs = idleMs;
+            pingDone = true;
         }
         else
         {
             /* Assume the keep-alive will fail. The network receive callback will
              * clear the failure flag upon receiving a PINGRESP. */
             pMqttConnection->keepAliveFailure = true;
+            pMqttConnection->lastSendMs = ( uint32_t ) IotClock_GetTimeMs();
+            pMqttConnection->pingIdleMs = idleMs;
 
             /* Schedule a check for PINGRESP. */
             pMqttConnection->nextKeepAliveMs = IOT_MQTT_RESPONSE_WAIT_MS;
+            delayMs = IOT_MQTT_RESPONSE_WAIT_MS;
 
             IotLogDebug( "(MQTT connection %p) PINGREQ sent. Scheduling check for PINGRESP in %d ms.",
                          pMqttConnection,
@@ -719,6 +759,7 @@ void _IotMqtt_ProcessKeepAlive( IotTaskPool_t pTaskPool,
 
             /* PINGRESP was received. Schedule the next PINGREQ transmission. */
             pMqttConnection->nextKeepAliveMs = pMqttConnection->keepAliveMs;
+            delayMs = pingIntervalMs;
         }
         else
         {
@@ -729,6 +770,10 @@ void _IotMqtt_ProcessKeepAlive( IotTaskPool_t pTaskPool,
             /* The network receive callback did not clear the failure flag. */
             status = false;
         }
+
+        pingIdleMs = pMqttConnection->pingIdleMs;
+        pingAnswered = status;
+        pingDone = true;
     }
 
     /* When a PINGREQ is successfully sent, reschedule this job to check for a
@@ -737,13 +782,13 @@ void _IotMqtt_ProcessKeepAlive( IotTaskPool_t pTaskPool,
     {
         taskPoolStatus = IotTaskPool_ScheduleDeferred( pTaskPool,
                                                        pKeepAliveJob,
-                                                       pMqttConnection->nextKeepAliveMs );
+                                                       delayMs );
 
         if( taskPoolStatus == IOT_TASKPOOL_SUCCESS )
         {
             IotLogDebug( "(MQTT connection %p) Next keep-alive job in %lu ms.",
                          pMqttConnection,
-                         ( unsigned long ) pMqttConnection->nextKeepAliveMs );
+                         ( unsigned long ) delayMs );
         }
         else
         {
@@ -771,6 +816,17 @@ void _IotMqtt_ProcessKeepAlive( IotTaskPool_t pTaskPool,
     }
 
     IotMutex_Unlock( &( pMqttConnection->referencesMutex ) );
+
+    /* Report how long the connection stayed idle before the PINGREQ and
+     * whether it was answered, outside of the connection lock. */
+    if( pingDone == true )
+    {
+        IOT_MQTT_PING_RESULT( pingIdleMs, pingAnswered );
+    }
+    else
+    {
+        EMPTY_ELSE_MARKER;
+    }
 }
 
 /*-----------------------------------------------------------*/
@@ -887,6 +943,8 @@ void _IotMqtt_ProcessSend( IotTaskPool_t pTaskPool,
         }
         else
         {
+            pMqttConnection->lastSendMs = ( uint32_t ) IotClock_GetTimeMs();
+
             /* DISCONNECT operations are considered successful upon successful
              * transmission. In addition, non-waitable operations with no callback
              * may also be considered successful. */
@@ -1192,6 +1192,20 @@ void _IotMqtt_PublishSetDup( uint8_t * pPublishPacket,
 
 /*-----------------------------------------------------------*/
 
+void _IotMqtt_PublishResume( uint8_t * pPublishPacket,
+                             uint8_t * pPacketIdentifierHigh,
+                             uint16_t packetIdentifier )
+{
+    /* The server matches the retransmission to the first one by packet identifier. */
+    *pPacketIdentifierHigh = UINT16_HIGH_BYTE( packetIdentifier );
+    *( pPacketIdentifierHigh + 1 ) = UINT16_LOW_BYTE( packetIdentifier );
+    UINT8_SET_BIT( *pPublishPacket, MQTT_PUBLISH_FLAG_DUP );
+
+    IotLogDebug( "PUBLISH resumed with packet identifier %hu.", packetIdentifier );
+}
+
+/*-----------------------------------------------------------*/
+
 IotMqttError_t _IotMqtt_DeserializePublish( _mqttPacket_t * pPublish )
 {
     IOT_FUNCTION_ENTRY( IotMqttError_t, IOT_MQTT_SUCCESS );
@@ -192,6 +192,12 @@
 #ifndef IOT_MQTT_RETRY_MS_CEILING
     #define IOT_MQTT_RETRY_MS_CEILING               ( 60000 )
 #endif
+#ifndef IOT_MQTT_PING_INTERVAL_MS
+    #define IOT_MQTT_PING_INTERVAL_MS( keepAliveMs )    ( keepAliveMs )
+#endif
+#ifndef IOT_MQTT_PING_RESULT
+    #define IOT_MQTT_PING_RESULT( idleMs, answered )
+#endif
 /** @endcond */
 
 /**
@@ -263,6 +269,7 @@ typedef struct _mqttConnection
     #endif
 
     bool disconnected;                           /**< @brief Tracks if this connection has been disconnected. */
+    bool sessionPresent;                         /**< @brief Session present flag of the CONNACK. */
     IotMutex_t referencesMutex;                  /**< @brief Recursive mutex. Grants access to connection state and operation lists. */
     int32_t references;                          /**< @brief Counts callbacks and operations using this connection. */
     IotListDouble_t pendingProcessing;           /**< @brief List of operations waiting to be processed by a task pool routine. */
@@ -272,6 +279,8 @@ typedef struct _mqttConnection
     IotMutex_t subscriptionMutex;                /**< @brief Grants exclusive access to the subscription list. */
 
     bool keepAliveFailure;                       /**< @brief Failure flag for keep-alive operation. */
+    uint32_t lastSendMs;                         /**< @brief Time of the last packet sent, PINGREQs are only sent when idle. */
+    uint32_t pingIdleMs;                         /**< @brief Idle time before the outstanding PINGREQ. */
     uint32_t keepAliveMs;                        /**< @brief Keep-alive interval in milliseconds. Its max value (per spec) is 65,535,000. */
     uint32_t nextKeepAliveMs;                    /**< @brief Relative delay for next keep-alive job. */
     IotTaskPoolJobStorage_t keepAliveJobStorage; /**< @brief Task pool job for processing this connection's keep-alive. */
@@ -538,6 +547,21 @@ void _IotMqtt_PublishSetDup( uint8_t * pPublishPacket,
                              uint8_t * pPacketIdentifierHigh,
                              uint16_t * pNewPacketIdentifier );
 
+/**
+ * @brief Turn a QoS 1 PUBLISH packet into the retransmission of a message of
+ * a resumed session.
+ *
+ * Unlike #_IotMqtt_PublishSetDup, the packet identifier of the first
+ * transmission is kept, also for an AWS IoT MQTT server.
+ *
+ * @param[in] pPublishPacket Pointer to the PUBLISH packet to modify.
+ * @param[in] pPacketIdentifierHigh The high byte of the packet identifier to modify.
+ * @param[in] packetIdentifier Packet identifier of the first transmission.
+ */
+void _IotMqtt_PublishResume( uint8_t * pPublishPacket,
+                             uint8_t * pPacketIdentifierHigh,
+                             uint16_t packetIdentifier );
+
 /**
  * @brief Deserialize a PUBLISH packet received from the server.
  *
@@ -719,6 +743,18 @@ bool _IotMqtt_DecrementOperationReferences( _mqttOperation_t * pOperation,
  */
 void _IotMqtt_DestroyOperation( _mqttOperation_t * pOperation );
 
+/**
+ * @brief Get the idle time after which a PINGREQ is sent.
+ *
+ * The interval is provided by #IOT_MQTT_PING_INTERVAL_MS and never exceeds
+ * the keep-alive interval sent to the server.
+ *
+ * @param[in] pMqttConnection The MQTT connection.
+ *
+ * @return The ping interval in milliseconds.
+ */
+uint32_t _IotMqtt_PingIntervalMs( const _mqttConnection_t * pMqttConnection );
+
 /**
  * @brief Task pool routine for processing an MQTT connection's keep-alive.
  *
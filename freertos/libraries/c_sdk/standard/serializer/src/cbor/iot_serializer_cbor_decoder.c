@@ -0,0 +1,759 @@
+/*
+ * FreeRTOS Serializer V1.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_serializer_cbor_decoder.c
+ * @brief Implements APIs to parse and decode data from CBOR format (RFC 7049). Supports integers,
+ * text strings, byte strings, boolean and null types, container types such as arrays and maps,
+ * of definite or indefinite length. Tags are skipped, floats and indefinite-length strings are
+ * only skipped over and reported as not supported when read.
+ * Text and byte strings are returned as pointers into the decoded buffer, nothing is copied,
+ * so the buffer must outlive the decoder objects.
+ * The file implements decoder interface in iot_serializer.h.
+ */
+
+#include <string.h>
+
+#include "iot_serializer.h"
+
+/* CBOR major types, stored in the three upper bits of the initial byte. */
+#define _CBOR_MAJOR_UNSIGNED_INT       ( 0U )
+#define _CBOR_MAJOR_NEGATIVE_INT       ( 1U )
+#define _CBOR_MAJOR_BYTE_STRING        ( 2U )
+#define _CBOR_MAJOR_TEXT_STRING        ( 3U )
+#define _CBOR_MAJOR_ARRAY              ( 4U )
+#define _CBOR_MAJOR_MAP                ( 5U )
+#define _CBOR_MAJOR_TAG                ( 6U )
+
+#define _CBOR_ADDITIONAL_INDEFINITE    ( 31U )
+#define _CBOR_BREAK                    ( 0xff )
+
+#define _CBOR_SIMPLE_FALSE             ( 20U )
+#define _CBOR_SIMPLE_TRUE              ( 21U )
+#define _CBOR_SIMPLE_NULL              ( 22U )
+
+/* Deepest nesting of containers skipped over, bounds the recursion. */
+#define _CBOR_MAX_DEPTH                ( 32 )
+
+#define _isValidContainer( decoder )                          \
+    ( ( decoder ) &&                                          \
+      ( decoder )->type >= IOT_SERIALIZER_CONTAINER_STREAM && \
+      ( decoder )->type <= IOT_SERIALIZER_CONTAINER_MAP )
+
+/*
+ * Items of a container not read yet. remainingItems counts keys and values
+ * separately for a map, and is IOT_SERIALIZER_INDEFINITE_LENGTH when the
+ * container ends with a break byte.
+ */
+typedef struct _cborContainer
+{
+    const uint8_t * pStart;
+    const uint8_t * pEnd;
+    size_t remainingItems;
+} _cborContainer_t;
+
+/* Initial byte and argument of a data item. */
+typedef struct _cborHead
+{
+    uint8_t majorType;
+    uint8_t additional;
+    uint64_t value;
+    const uint8_t * pNext; /* First byte after the head. */
+} _cborHead_t;
+
+static IotSerializerError_t _init( IotSerializerDecoderObject_t * pDecoderObject,
+                                   const uint8_t * pDataBuffer,
+                                   size_t maxSize );
+
+static IotSerializerError_t _find( IotSerializerDecoderObject_t * pDecoderObject,
+                                   const char * pKey,
+                                   IotSerializerDecoderObject_t * pValueObject );
+
+static IotSerializerError_t _get( IotSerializerDecoderIterator_t iterator,
+                                  IotSerializerDecoderObject_t * pValueObject );
+
+static IotSerializerError_t _stepIn( IotSerializerDecoderObject_t * pDecoderObject,
+                                     IotSerializerDecoderIterator_t * pIterator );
+
+static bool _isEndOfContainer( IotSerializerDecoderIterator_t iterator );
+
+static IotSerializerError_t _next( IotSerializerDecoderIterator_t iterator );
+
+static IotSerializerError_t _stepOut( IotSerializerDecoderIterator_t iterator,
+                                      IotSerializerDecoderObject_t * pDecoderObject );
+
+static void _destroy( IotSerializerDecoderObject_t * pDecoderObject );
+
+static IotSerializerError_t _skipItem( const uint8_t * pStart,
+                                       const uint8_t * pEnd,
+                                       uint32_t depth,
+                                       const uint8_t ** ppNext );
+
+IotSerializerDecodeInterface_t _IotSerializerCborDecoder =
+{
+    .init             = _init,
+    .find             = _find,
+    .stepIn           = _stepIn,
+    .isEndOfContainer = _isEndOfContainer,
+    .get              = _get,
+    .next             = _next,
+    .stepOut          = _stepOut,
+    .destroy          = _destroy
+};
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _parseHead( const uint8_t * pStart,
+                                        const uint8_t * pEnd,
+                                        _cborHead_t * pHead )
+{
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+    size_t argumentLength = 0, i;
+
+    if( pStart >= pEnd )
+    {
+        error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+    }
+    else
+    {
+        pHead->majorType = ( uint8_t ) ( pStart[ 0 ] >> 5 );
+        pHead->additional = ( uint8_t ) ( pStart[ 0 ] & 0x1fU );
+        pHead->value = pHead->additional;
+
+        switch( pHead->additional )
+        {
+            case 24:
+                argumentLength = 1;
+                break;
+
+            case 25:
+                argumentLength = 2;
+                break;
+
+            case 26:
+                argumentLength = 4;
+                break;
+
+            case 27:
+                argumentLength = 8;
+                break;
+
+            case 28:
+            case 29:
+            case 30:
+                error = IOT_SERIALIZER_INVALID_INPUT;
+                break;
+
+            default:
+                break;
+        }
+
+        if( ( error == IOT_SERIALIZER_SUCCESS ) &&
+            ( ( size_t ) ( pEnd - pStart ) <= argumentLength ) )
+        {
+            error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+        }
+
+        if( ( error == IOT_SERIALIZER_SUCCESS ) && ( argumentLength > 0 ) )
+        {
+            /* Argument follows in network byte order. */
+            pHead->value = 0;
+
+            for( i = 1; i <= argumentLength; i++ )
+            {
+                pHead->value = ( pHead->value << 8 ) | pStart[ i ];
+            }
+        }
+
+        pHead->pNext = pStart + 1 + argumentLength;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _isIndefinite( const _cborHead_t * pHead )
+{
+    return ( pHead->additional == _CBOR_ADDITIONAL_INDEFINITE );
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _skipItems( const uint8_t * pStart,
+                                        const uint8_t * pEnd,
+                                        size_t count,
+                                        uint32_t depth,
+                                        const uint8_t ** ppNext )
+{
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    while( ( error == IOT_SERIALIZER_SUCCESS ) && ( count > 0 ) )
+    {
+        if( count == IOT_SERIALIZER_INDEFINITE_LENGTH )
+        {
+            if( pStart >= pEnd )
+            {
+                error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+            }
+            else if( pStart[ 0 ] == _CBOR_BREAK )
+            {
+                pStart++;
+                break;
+            }
+        }
+        else
+        {
+            count--;
+        }
+
+        if( error == IOT_SERIALIZER_SUCCESS )
+        {
+            error = _skipItem( pStart, pEnd, depth, &pStart );
+        }
+    }
+
+    *ppNext = pStart;
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _skipItem( const uint8_t * pStart,
+                                       const uint8_t * pEnd,
+                                       uint32_t depth,
+                                       const uint8_t ** ppNext )
+{
+    _cborHead_t head;
+    IotSerializerError_t error = _parseHead( pStart, pEnd, &head );
+
+    if( ( error == IOT_SERIALIZER_SUCCESS ) && ( depth >= _CBOR_MAX_DEPTH ) )
+    {
+        error = IOT_SERIALIZER_NOT_SUPPORTED;
+    }
+
+    if( error == IOT_SERIALIZER_SUCCESS )
+    {
+        *ppNext = head.pNext;
+
+        switch( head.majorType )
+        {
+            case _CBOR_MAJOR_UNSIGNED_INT:
+            case _CBOR_MAJOR_NEGATIVE_INT:
+
+                if( _isIndefinite( &head ) )
+                {
+                    error = IOT_SERIALIZER_INVALID_INPUT;
+                }
+
+                break;
+
+            case _CBOR_MAJOR_BYTE_STRING:
+            case _CBOR_MAJOR_TEXT_STRING:
+
+                if( _isIndefinite( &head ) )
+                {
+                    /* Chunks are definite-length strings themselves. */
+                    error = _skipItems( head.pNext, pEnd, IOT_SERIALIZER_INDEFINITE_LENGTH, depth + 1, ppNext );
+                }
+                else if( head.value > ( uint64_t ) ( pEnd - head.pNext ) )
+                {
+                    error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+                }
+                else
+                {
+                    *ppNext = head.pNext + head.value;
+                }
+
+                break;
+
+            case _CBOR_MAJOR_ARRAY:
+            case _CBOR_MAJOR_MAP:
+
+                if( _isIndefinite( &head ) )
+                {
+                    error = _skipItems( head.pNext, pEnd, IOT_SERIALIZER_INDEFINITE_LENGTH, depth + 1, ppNext );
+                }
+                else if( head.value > ( uint64_t ) ( pEnd - head.pNext ) )
+                {
+                    /* Every item takes at least a byte, also rules out overflowing the count. */
+                    error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+                }
+                else
+                {
+                    error = _skipItems( head.pNext,
+                                        pEnd,
+                                        ( size_t ) ( ( head.majorType == _CBOR_MAJOR_MAP ) ? ( head.value * 2U ) : head.value ),
+                                        depth + 1,
+                                        ppNext );
+                }
+
+                break;
+
+            case _CBOR_MAJOR_TAG:
+
+                if( _isIndefinite( &head ) )
+                {
+                    error = IOT_SERIALIZER_INVALID_INPUT;
+                }
+                else
+                {
+                    error = _skipItem( head.pNext, pEnd, depth + 1, ppNext );
+                }
+
+                break;
+
+            default:
+
+                /* Simple values and floats, the argument is the whole value. */
+                if( _isIndefinite( &head ) )
+                {
+                    error = IOT_SERIALIZER_INVALID_INPUT;
+                }
+
+                break;
+        }
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static _cborContainer_t * _createContainer( const uint8_t * pStart,
+                                            const uint8_t * pEnd,
+                                            size_t remainingItems )
+{
+    _cborContainer_t * pContainer = pvPortMalloc( sizeof( _cborContainer_t ) );
+
+    if( pContainer != NULL )
+    {
+        pContainer->pStart = pStart;
+        pContainer->pEnd = pEnd;
+        pContainer->remainingItems = remainingItems;
+    }
+
+    return pContainer;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _parseItem( const uint8_t * pStart,
+                                        const uint8_t * pEnd,
+                                        IotSerializerDecoderObject_t * pValue )
+{
+    _cborHead_t head;
+    size_t remainingItems;
+    IotSerializerError_t error = _parseHead( pStart, pEnd, &head );
+
+    /* Tags only give a meaning to the value that follows. */
+    while( ( error == IOT_SERIALIZER_SUCCESS ) && ( head.majorType == _CBOR_MAJOR_TAG ) )
+    {
+        error = _isIndefinite( &head ) ? IOT_SERIALIZER_INVALID_INPUT : _parseHead( head.pNext, pEnd, &head );
+    }
+
+    if( error == IOT_SERIALIZER_SUCCESS )
+    {
+        switch( head.majorType )
+        {
+            case _CBOR_MAJOR_UNSIGNED_INT:
+            case _CBOR_MAJOR_NEGATIVE_INT:
+
+                if( _isIndefinite( &head ) )
+                {
+                    error = IOT_SERIALIZER_INVALID_INPUT;
+                }
+                else if( head.value > ( uint64_t ) INT64_MAX )
+                {
+                    error = IOT_SERIALIZER_NOT_SUPPORTED;
+                }
+                else
+                {
+                    pValue->type = IOT_SERIALIZER_SCALAR_SIGNED_INT;
+                    pValue->u.value.u.signedInt = ( head.majorType == _CBOR_MAJOR_UNSIGNED_INT ) ?
+                                                  ( int64_t ) head.value : ( -1 - ( int64_t ) head.value );
+                }
+
+                break;
+
+            case _CBOR_MAJOR_BYTE_STRING:
+            case _CBOR_MAJOR_TEXT_STRING:
+
+                if( _isIndefinite( &head ) )
+                {
+                    error = IOT_SERIALIZER_NOT_SUPPORTED;
+                }
+                else if( head.value > ( uint64_t ) ( pEnd - head.pNext ) )
+                {
+                    error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+                }
+                else
+                {
+                    pValue->type = ( head.majorType == _CBOR_MAJOR_TEXT_STRING ) ?
+                                   IOT_SERIALIZER_SCALAR_TEXT_STRING : IOT_SERIALIZER_SCALAR_BYTE_STRING;
+                    pValue->u.value.u.string.pString = ( uint8_t * ) head.pNext;
+                    pValue->u.value.u.string.length = ( size_t ) head.value;
+                }
+
+                break;
+
+            case _CBOR_MAJOR_ARRAY:
+            case _CBOR_MAJOR_MAP:
+
+                if( _isIndefinite( &head ) )
+                {
+                    remainingItems = IOT_SERIALIZER_INDEFINITE_LENGTH;
+                }
+                else if( head.value > ( uint64_t ) ( pEnd - head.pNext ) )
+                {
+                    error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+                }
+                else
+                {
+                    remainingItems = ( size_t ) ( ( head.majorType == _CBOR_MAJOR_MAP ) ? ( head.value * 2U ) : head.value );
+                }
+
+                if( error == IOT_SERIALIZER_SUCCESS )
+                {
+                    pValue->u.pHandle = _createContainer( head.pNext, pEnd, remainingItems );
+
+                    if( pValue->u.pHandle != NULL )
+                    {
+                        pValue->type = ( head.majorType == _CBOR_MAJOR_MAP ) ?
+                                       IOT_SERIALIZER_CONTAINER_MAP : IOT_SERIALIZER_CONTAINER_ARRAY;
+                    }
+                    else
+                    {
+                        error = IOT_SERIALIZER_OUT_OF_MEMORY;
+                    }
+                }
+
+                break;
+
+            default:
+
+                switch( head.additional )
+                {
+                    case _CBOR_SIMPLE_FALSE:
+                    case _CBOR_SIMPLE_TRUE:
+                        pValue->type = IOT_SERIALIZER_SCALAR_BOOL;
+                        pValue->u.value.u.booleanValue = ( head.additional == _CBOR_SIMPLE_TRUE );
+                        break;
+
+                    case _CBOR_SIMPLE_NULL:
+                        pValue->type = IOT_SERIALIZER_SCALAR_NULL;
+                        break;
+
+                    default:
+                        /* Floats, undefined and other simple values. */
+                        error = IOT_SERIALIZER_NOT_SUPPORTED;
+                        break;
+                }
+
+                break;
+        }
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _isEOF( const _cborContainer_t * pContainer )
+{
+    bool isEOF;
+
+    if( pContainer->remainingItems == IOT_SERIALIZER_INDEFINITE_LENGTH )
+    {
+        isEOF = ( pContainer->pStart >= pContainer->pEnd ) || ( pContainer->pStart[ 0 ] == _CBOR_BREAK );
+    }
+    else
+    {
+        isEOF = ( pContainer->remainingItems == 0 );
+    }
+
+    return isEOF;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _init( IotSerializerDecoderObject_t * pDecoderObject,
+                                   const uint8_t * pDataBuffer,
+                                   size_t maxSize )
+{
+    IotSerializerError_t error;
+
+    pDecoderObject->type = IOT_SERIALIZER_UNDEFINED;
+    error = _parseItem( pDataBuffer, pDataBuffer + maxSize, pDecoderObject );
+
+    if( ( error == IOT_SERIALIZER_SUCCESS ) && !_isValidContainer( pDecoderObject ) )
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _find( IotSerializerDecoderObject_t * pDecoderObject,
+                                   const char * pKey,
+                                   IotSerializerDecoderObject_t * pValueObject )
+{
+    _cborContainer_t iterator;
+    IotSerializerDecoderObject_t key = IOT_SERIALIZER_DECODER_OBJECT_INITIALIZER;
+    size_t keyLength;
+    bool isKeyFound = false;
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    if( ( pDecoderObject->type == IOT_SERIALIZER_CONTAINER_MAP ) && ( pDecoderObject->u.pHandle != NULL ) )
+    {
+        iterator = *( ( _cborContainer_t * ) pDecoderObject->u.pHandle );
+        keyLength = strlen( pKey );
+
+        while( ( error == IOT_SERIALIZER_SUCCESS ) && !isKeyFound )
+        {
+            if( _isEOF( &iterator ) )
+            {
+                error = IOT_SERIALIZER_NOT_FOUND;
+            }
+            else
+            {
+                /* Keys of other types are compared as if they were not matching. */
+                key.type = IOT_SERIALIZER_UNDEFINED;
+
+                if( ( _parseItem( iterator.pStart, iterator.pEnd, &key ) == IOT_SERIALIZER_SUCCESS ) &&
+                    ( key.type == IOT_SERIALIZER_SCALAR_TEXT_STRING ) &&
+                    ( key.u.value.u.string.length == keyLength ) &&
+                    ( memcmp( key.u.value.u.string.pString, pKey, keyLength ) == 0 ) )
+                {
+                    isKeyFound = true;
+                }
+                else if( ( key.type == IOT_SERIALIZER_CONTAINER_MAP ) || ( key.type == IOT_SERIALIZER_CONTAINER_ARRAY ) )
+                {
+                    vPortFree( key.u.pHandle );
+                }
+
+                /* Skip the key, and the value unless the key matched. */
+                error = _skipItems( iterator.pStart, iterator.pEnd, isKeyFound ? 1U : 2U, 0, &iterator.pStart );
+
+                if( iterator.remainingItems != IOT_SERIALIZER_INDEFINITE_LENGTH )
+                {
+                    iterator.remainingItems = ( iterator.remainingItems > 2U ) ? ( iterator.remainingItems - 2U ) : 0U;
+                }
+            }
+        }
+
+        if( isKeyFound && ( error == IOT_SERIALIZER_SUCCESS ) )
+        {
+            error = _parseItem( iterator.pStart, iterator.pEnd, pValueObject );
+        }
+    }
+    else
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _stepIn( IotSerializerDecoderObject_t * pDecoderObject,
+                                     IotSerializerDecoderIterator_t * pIterator )
+{
+    IotSerializerDecoderObject_t * pNewObject;
+    _cborContainer_t * pContainer, * pNewContainer;
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    if( _isValidContainer( pDecoderObject ) && ( pDecoderObject->u.pHandle != NULL ) )
+    {
+        pContainer = pDecoderObject->u.pHandle;
+        pNewContainer = _createContainer( pContainer->pStart, pContainer->pEnd, pContainer->remainingItems );
+
+        if( pNewContainer != NULL )
+        {
+            pNewObject = pvPortMalloc( sizeof( IotSerializerDecoderObject_t ) );
+
+            if( pNewObject != NULL )
+            {
+                pNewObject->type = pDecoderObject->type;
+                pNewObject->u.pHandle = pNewContainer;
+                *pIterator = ( IotSerializerDecoderIterator_t ) pNewObject;
+            }
+            else
+            {
+                vPortFree( pNewContainer );
+                error = IOT_SERIALIZER_OUT_OF_MEMORY;
+            }
+        }
+        else
+        {
+            error = IOT_SERIALIZER_OUT_OF_MEMORY;
+        }
+    }
+    else
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool _isEndOfContainer( IotSerializerDecoderIterator_t iterator )
+{
+    IotSerializerDecoderObject_t * pObject = ( IotSerializerDecoderObject_t * ) iterator;
+    bool ret = false;
+
+    if( _isValidContainer( pObject ) )
+    {
+        ret = _isEOF( pObject->u.pHandle );
+    }
+
+    return ret;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _get( IotSerializerDecoderIterator_t iterator,
+                                  IotSerializerDecoderObject_t * pValueObject )
+{
+    IotSerializerDecoderObject_t * pObject = ( IotSerializerDecoderObject_t * ) iterator;
+    _cborContainer_t * pContainer;
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    if( _isValidContainer( pObject ) )
+    {
+        pContainer = pObject->u.pHandle;
+
+        if( !_isEOF( pContainer ) )
+        {
+            error = _parseItem( pContainer->pStart, pContainer->pEnd, pValueObject );
+        }
+        else
+        {
+            error = IOT_SERIALIZER_NOT_FOUND;
+        }
+    }
+    else
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _next( IotSerializerDecoderIterator_t iterator )
+{
+    IotSerializerDecoderObject_t * pObject = ( IotSerializerDecoderObject_t * ) iterator;
+    _cborContainer_t * pContainer;
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    if( _isValidContainer( pObject ) )
+    {
+        pContainer = pObject->u.pHandle;
+
+        if( !_isEOF( pContainer ) )
+        {
+            error = _skipItem( pContainer->pStart, pContainer->pEnd, 0, &pContainer->pStart );
+
+            if( pContainer->remainingItems != IOT_SERIALIZER_INDEFINITE_LENGTH )
+            {
+                pContainer->remainingItems--;
+            }
+        }
+        else
+        {
+            error = IOT_SERIALIZER_NOT_FOUND;
+        }
+    }
+    else
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _stepOut( IotSerializerDecoderIterator_t iterator,
+                                      IotSerializerDecoderObject_t * pDecoderObject )
+{
+    IotSerializerDecoderObject_t * pIterObject = ( IotSerializerDecoderObject_t * ) iterator;
+    _cborContainer_t * pContainer, * pIterContainer;
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    if( _isValidContainer( pIterObject ) && _isValidContainer( pDecoderObject ) )
+    {
+        pContainer = pDecoderObject->u.pHandle;
+        pIterContainer = pIterObject->u.pHandle;
+
+        if( _isEOF( pIterContainer ) )
+        {
+            pContainer->pStart = pIterContainer->pStart;
+
+            /* Also step over the break byte ending the container. */
+            if( ( pIterContainer->remainingItems == IOT_SERIALIZER_INDEFINITE_LENGTH ) &&
+                ( pContainer->pStart < pContainer->pEnd ) )
+            {
+                pContainer->pStart++;
+            }
+
+            pContainer->remainingItems = 0;
+            vPortFree( pIterContainer );
+            vPortFree( pIterObject );
+        }
+        else
+        {
+            error = IOT_SERIALIZER_INTERNAL_FAILURE;
+        }
+    }
+    else
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _destroy( IotSerializerDecoderObject_t * pDecoderObject )
+{
+    if( _isValidContainer( pDecoderObject ) )
+    {
+        if( pDecoderObject->u.pHandle != NULL )
+        {
+            vPortFree( pDecoderObject->u.pHandle );
+            pDecoderObject->u.pHandle = NULL;
+        }
+    }
+}
@@ -0,0 +1,695 @@
+/*
+ * FreeRTOS Serializer V1.1.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file iot_serializer_cbor_encoder.c
+ * @brief Implements APIs to serialize data in CBOR format (RFC 7049). Supports integers,
+ * text strings, byte strings, boolean and null types, container types - arrays and maps.
+ * Data is written straight into the buffer passed to init, so the encoder can stream into
+ * the MQTT payload buffer. Byte strings are stored as is, without base-64 encoding.
+ * The file implements encoder interface in iot_serializer.h.
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+#include "iot_serializer.h"
+
+/* CBOR major types, stored in the three upper bits of the initial byte. */
+#define _CBOR_MAJOR_UNSIGNED_INT       ( 0U )
+#define _CBOR_MAJOR_NEGATIVE_INT       ( 1U )
+#define _CBOR_MAJOR_BYTE_STRING        ( 2U )
+#define _CBOR_MAJOR_TEXT_STRING        ( 3U )
+#define _CBOR_MAJOR_ARRAY              ( 4U )
+#define _CBOR_MAJOR_MAP                ( 5U )
+
+#define _CBOR_INDEFINITE_ARRAY         ( 0x9f )
+#define _CBOR_INDEFINITE_MAP           ( 0xbf )
+#define _CBOR_BREAK                    ( 0xff )
+
+#define _CBOR_FALSE                    ( 0xf4 )
+#define _CBOR_TRUE                     ( 0xf5 )
+#define _CBOR_NULL                     ( 0xf6 )
+
+/* Deepest nesting of containers, limited by the bits of indefiniteMask. */
+#define _CBOR_MAX_DEPTH                ( 32 )
+
+#define _cborHeadLength( value )                \
+    (                                           \
+        ( ( value ) < 24U ) ? 1U :              \
+        ( ( value ) <= UINT8_MAX ) ? 2U :       \
+        ( ( value ) <= UINT16_MAX ) ? 3U :      \
+        ( ( value ) <= UINT32_MAX ) ? 5U : 9U )
+
+#define _cborIsValidScalar( data )    ( ( ( data )->type >= IOT_SERIALIZER_SCALAR_NULL ) && ( ( data )->type <= IOT_SERIALIZER_SCALAR_BYTE_STRING ) )
+
+#define _cborIsValidContainer( container )                            \
+    (                                                                 \
+        ( container != NULL ) &&                                      \
+        ( ( container )->type >= IOT_SERIALIZER_CONTAINER_STREAM ) && \
+        ( ( container )->type <= IOT_SERIALIZER_CONTAINER_MAP ) )
+
+/*
+ * State of the whole encoding. All the nested containers share it, the encoder
+ * objects of the children point to the same state as the outermost one.
+ */
+typedef struct _cborEncoder
+{
+    uint8_t * pBuffer;
+    size_t offset;
+    size_t remainingLength;
+    size_t overflowLength;
+    uint32_t depth;          /* Number of containers currently open. */
+    uint32_t indefiniteMask; /* Bit n set when the container at depth n needs a break byte. */
+} _cborEncoder_t;
+
+/**
+ * @brief Returns the size of the encoded CBOR data,
+ *
+ * Returns the actual CBOR encoded size at that point. If a NULL buffer is used or a different
+ * buffer is passed as input, the function returns zero.
+ *
+ * @param[in] pEncoderObject Pointer to the outermost CBOR encoder
+ * @param[in] pDataBuffer Pointer to the data buffer passed in the init function.
+ *
+ * @return Size of the encoded buffer in bytes
+ */
+static size_t _getEncodedSize( IotSerializerEncoderObject_t * pEncoderObject,
+                               uint8_t * pDataBuffer );
+
+/**
+ * @brief Returns the extra buffer size required, if the encoded data overflows the buffer provided.
+ *
+ * The function can also be used to pre-calculate the size of the buffer needed to encode a CBOR object,
+ * by initializing the encoder object with a null buffer.
+ *
+ * @param[in] pEncoderObject: Pointer to the outermost CBOR encoder object
+ *
+ * @return Additional buffer size needed in bytes.
+ */
+static size_t _getExtraBufferSizeNeeded( IotSerializerEncoderObject_t * pEncoderObject );
+
+/**
+ * @brief Initializes the CBOR encoder object
+ *
+ * User can pass as input a NULL buffer to pre-calculate the size of the encoded CBOR data.
+ *
+ * @param[in] pEncoderObject: Pointer to the CBOR encoder object
+ * @param[in] pDataBuffer Pointer to the buffer
+ * @param[in] maxSize Max Size of the buffer
+ *
+ * @return IOT_SERIALIZER_SUCCESS if successful
+ */
+static IotSerializerError_t _init( IotSerializerEncoderObject_t * pEncoderObject,
+                                   uint8_t * pDataBuffer,
+                                   size_t maxSize );
+
+/**
+ * @brief Destroys the CBOR encoder object
+ *
+ * @param[in] pEncoderObject: Pointer to the outermost CBOR encoder object
+ */
+static void _destroy( IotSerializerEncoderObject_t * pEncoderObject );
+
+/**
+ * @brief Opens a CBOR array or map within a container
+ *
+ * A known length gives a definite-length container, IOT_SERIALIZER_INDEFINITE_LENGTH
+ * an indefinite-length one terminated by a break byte on close.
+ *
+ * @param[in] pEncoderObject: Pointer to the parent container
+ * @param[in] pNewEncoderObject: Pointer to the new container to open
+ * @param[in] length: Number of elements (array) or key-value pairs (map)
+ *
+ * @return IOT_SERIALIZER_SUCCESS if successful
+ */
+static IotSerializerError_t _openContainer( IotSerializerEncoderObject_t * pEncoderObject,
+                                            IotSerializerEncoderObject_t * pNewEncoderObject,
+                                            size_t length );
+
+/**
+ * @brief Opens a CBOR array or map as the value of a key in a map
+ *
+ * @param[in] pEncoderObject: Pointer to the parent map
+ * @param[in] pKey: Key of the new container
+ * @param[in] pNewEncoderObject: Pointer to the new container to open
+ * @param[in] length: Number of elements (array) or key-value pairs (map)
+ *
+ * @return IOT_SERIALIZER_SUCCESS if successful
+ */
+static IotSerializerError_t _openContainerWithKey( IotSerializerEncoderObject_t * pEncoderObject,
+                                                   const char * pKey,
+                                                   IotSerializerEncoderObject_t * pNewEncoderObject,
+                                                   size_t length );
+
+/**
+ * @brief Closes a CBOR array or map
+ *
+ * @param[in] pEncoderObject: Pointer to the parent container
+ * @param[in] pNewEncoderObject: Pointer to the container to close
+ *
+ * @return IOT_SERIALIZER_SUCCESS if successful
+ */
+static IotSerializerError_t _closeContainer( IotSerializerEncoderObject_t * pEncoderObject,
+                                             IotSerializerEncoderObject_t * pNewEncoderObject );
+
+/**
+ * @brief Appends a scalar value to an array or to the outermost stream
+ *
+ * @param[in] pEncoderObject: Pointer to the container
+ * @param[in] scalarData: Value to append
+ *
+ * @return IOT_SERIALIZER_SUCCESS if successful
+ */
+static IotSerializerError_t _append( IotSerializerEncoderObject_t * pEncoderObject,
+                                     IotSerializerScalarData_t scalarData );
+
+/**
+ * @brief Appends a key-value pair to a map
+ *
+ * @param[in] pEncoderObject: Pointer to the map
+ * @param[in] pKey: Key, encoded as a text string
+ * @param[in] scalarData: Value of the key
+ *
+ * @return IOT_SERIALIZER_SUCCESS if successful
+ */
+static IotSerializerError_t _appendKeyValue( IotSerializerEncoderObject_t * pEncoderObject,
+                                             const char * pKey,
+                                             IotSerializerScalarData_t scalarData );
+
+/**
+ * @brief Returns the number of bytes one item takes once encoded
+ *
+ * For a container, only its head is counted: the items it holds are counted
+ * as they are appended.
+ *
+ * @param[in] dataType: Type of the item, a scalar or a map or array container
+ * @param[in] pScalarData: Value of a scalar item, not used for containers
+ * @param[in] length: Number of entries of a container, or IOT_SERIALIZER_INDEFINITE_LENGTH.
+ * Not used for scalars
+ *
+ * @return Encoded size in bytes, 0 for a type the encoder does not support
+ */
+static size_t _getSerializedLength( IotSerializerDataType_t dataType,
+                                    IotSerializerScalarData_t * pScalarData,
+                                    size_t length );
+
+/**
+ * @brief Writes the initial byte of an item and the argument following it
+ *
+ * @param[in] pEncoder: Encoding state, must have room for the head
+ * @param[in] majorType: CBOR major type of the item
+ * @param[in] value: Argument, written in the shortest form
+ */
+static void _appendHead( _cborEncoder_t * pEncoder,
+                         uint8_t majorType,
+                         uint64_t value );
+
+/**
+ * @brief Writes one item, the size returned by _getSerializedLength must be available
+ *
+ * @param[in] pEncoder: Encoding state
+ * @param[in] dataType: Type of the item
+ * @param[in] pScalarData: Value of a scalar item
+ * @param[in] length: Number of entries of a container
+ */
+static void _appendData( _cborEncoder_t * pEncoder,
+                         IotSerializerDataType_t dataType,
+                         IotSerializerScalarData_t * pScalarData,
+                         size_t length );
+
+/**
+ * @brief Writes an item preceded by its key, or counts the overflow when it does not fit
+ *
+ * @param[in] pEncoder: Encoding state
+ * @param[in] pKey: Key of the item in a map, NULL otherwise
+ * @param[in] dataType: Type of the item
+ * @param[in] pScalarData: Value of a scalar item
+ * @param[in] length: Number of entries of a container
+ *
+ * @return IOT_SERIALIZER_SUCCESS if written, IOT_SERIALIZER_BUFFER_TOO_SMALL otherwise
+ */
+static IotSerializerError_t _appendItem( _cborEncoder_t * pEncoder,
+                                         const char * pKey,
+                                         IotSerializerDataType_t dataType,
+                                         IotSerializerScalarData_t * pScalarData,
+                                         size_t length );
+
+IotSerializerEncodeInterface_t _IotSerializerCborEncoder =
+{
+    .getEncodedSize           = _getEncodedSize,
+    .getExtraBufferSizeNeeded = _getExtraBufferSizeNeeded,
+    .init                     = _init,
+    .destroy                  = _destroy,
+    .openContainer            = _openContainer,
+    .openContainerWithKey     = _openContainerWithKey,
+    .closeContainer           = _closeContainer,
+    .append                   = _append,
+    .appendKeyValue           = _appendKeyValue
+};
+
+/*-----------------------------------------------------------*/
+
+static size_t _getSerializedLength( IotSerializerDataType_t dataType,
+                                    IotSerializerScalarData_t * pScalarData,
+                                    size_t length )
+{
+    size_t serializedLength;
+    int64_t signedInt;
+
+    switch( dataType )
+    {
+        case IOT_SERIALIZER_CONTAINER_MAP:
+        case IOT_SERIALIZER_CONTAINER_ARRAY:
+            serializedLength = ( length == IOT_SERIALIZER_INDEFINITE_LENGTH ) ? 1U : _cborHeadLength( ( uint64_t ) length );
+            break;
+
+        case IOT_SERIALIZER_SCALAR_TEXT_STRING:
+        case IOT_SERIALIZER_SCALAR_BYTE_STRING:
+            serializedLength = _cborHeadLength( ( uint64_t ) pScalarData->value.u.string.length ) + pScalarData->value.u.string.length;
+            break;
+
+        case IOT_SERIALIZER_SCALAR_SIGNED_INT:
+            signedInt = pScalarData->value.u.signedInt;
+            serializedLength = ( signedInt >= 0 ) ? _cborHeadLength( ( uint64_t ) signedInt ) : _cborHeadLength( ( uint64_t ) ( -1 - signedInt ) );
+            break;
+
+        case IOT_SERIALIZER_SCALAR_BOOL:
+        case IOT_SERIALIZER_SCALAR_NULL:
+            serializedLength = 1U;
+            break;
+
+        default:
+            serializedLength = 0;
+            break;
+    }
+
+    return serializedLength;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _appendHead( _cborEncoder_t * pEncoder,
+                         uint8_t majorType,
+                         uint64_t value )
+{
+    uint8_t * pHead = pEncoder->pBuffer + pEncoder->offset;
+    size_t headLength = _cborHeadLength( value ), i;
+
+    majorType = ( uint8_t ) ( majorType << 5 );
+
+    switch( headLength )
+    {
+        case 1:
+            pHead[ 0 ] = majorType | ( uint8_t ) value;
+            break;
+
+        case 2:
+            pHead[ 0 ] = majorType | 24U;
+            break;
+
+        case 3:
+            pHead[ 0 ] = majorType | 25U;
+            break;
+
+        case 5:
+            pHead[ 0 ] = majorType | 26U;
+            break;
+
+        default:
+            pHead[ 0 ] = majorType | 27U;
+            break;
+    }
+
+    /* Argument follows in network byte order. */
+    for( i = headLength - 1U; i > 0U; i-- )
+    {
+        pHead[ i ] = ( uint8_t ) value;
+        value >>= 8;
+    }
+
+    pEncoder->offset += headLength;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _appendData( _cborEncoder_t * pEncoder,
+                         IotSerializerDataType_t dataType,
+                         IotSerializerScalarData_t * pScalarData,
+                         size_t length )
+{
+    int64_t signedInt;
+
+    switch( dataType )
+    {
+        case IOT_SERIALIZER_CONTAINER_MAP:
+
+            if( length == IOT_SERIALIZER_INDEFINITE_LENGTH )
+            {
+                pEncoder->pBuffer[ pEncoder->offset++ ] = _CBOR_INDEFINITE_MAP;
+            }
+            else
+            {
+                _appendHead( pEncoder, _CBOR_MAJOR_MAP, ( uint64_t ) length );
+            }
+
+            break;
+
+        case IOT_SERIALIZER_CONTAINER_ARRAY:
+
+            if( length == IOT_SERIALIZER_INDEFINITE_LENGTH )
+            {
+                pEncoder->pBuffer[ pEncoder->offset++ ] = _CBOR_INDEFINITE_ARRAY;
+            }
+            else
+            {
+                _appendHead( pEncoder, _CBOR_MAJOR_ARRAY, ( uint64_t ) length );
+            }
+
+            break;
+
+        case IOT_SERIALIZER_SCALAR_TEXT_STRING:
+        case IOT_SERIALIZER_SCALAR_BYTE_STRING:
+            _appendHead( pEncoder,
+                         ( dataType == IOT_SERIALIZER_SCALAR_TEXT_STRING ) ? _CBOR_MAJOR_TEXT_STRING : _CBOR_MAJOR_BYTE_STRING,
+                         ( uint64_t ) pScalarData->value.u.string.length );
+            memcpy( pEncoder->pBuffer + pEncoder->offset,
+                    pScalarData->value.u.string.pString,
+                    pScalarData->value.u.string.length );
+            pEncoder->offset += pScalarData->value.u.string.length;
+            break;
+
+        case IOT_SERIALIZER_SCALAR_SIGNED_INT:
+            signedInt = pScalarData->value.u.signedInt;
+
+            if( signedInt >= 0 )
+            {
+                _appendHead( pEncoder, _CBOR_MAJOR_UNSIGNED_INT, ( uint64_t ) signedInt );
+            }
+            else
+            {
+                _appendHead( pEncoder, _CBOR_MAJOR_NEGATIVE_INT, ( uint64_t ) ( -1 - signedInt ) );
+            }
+
+            break;
+
+        case IOT_SERIALIZER_SCALAR_BOOL:
+            pEncoder->pBuffer[ pEncoder->offset++ ] = ( pScalarData->value.u.booleanValue == true ) ? _CBOR_TRUE : _CBOR_FALSE;
+            break;
+
+        case IOT_SERIALIZER_SCALAR_NULL:
+            pEncoder->pBuffer[ pEncoder->offset++ ] = _CBOR_NULL;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _appendItem( _cborEncoder_t * pEncoder,
+                                         const char * pKey,
+                                         IotSerializerDataType_t dataType,
+                                         IotSerializerScalarData_t * pScalarData,
+                                         size_t length )
+{
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+    IotSerializerScalarData_t key = { .type = IOT_SERIALIZER_SCALAR_TEXT_STRING };
+    size_t serializedLength;
+
+    /* Same as the JSON encoder, a text string of length 0 is NUL-terminated. */
+    if( ( dataType == IOT_SERIALIZER_SCALAR_TEXT_STRING ) &&
+        ( pScalarData->value.u.string.length == 0 ) &&
+        ( pScalarData->value.u.string.pString != NULL ) )
+    {
+        pScalarData->value.u.string.length = strlen( ( const char * ) pScalarData->value.u.string.pString );
+    }
+
+    serializedLength = _getSerializedLength( dataType, pScalarData, length );
+
+    if( pKey != NULL )
+    {
+        key.value.u.string.pString = ( uint8_t * ) pKey;
+        key.value.u.string.length = strlen( pKey );
+        serializedLength += _getSerializedLength( key.type, &key, 0 );
+    }
+
+    /* Nothing is written once an item did not fit, so the size needed is still counted. */
+    if( pEncoder->remainingLength >= serializedLength )
+    {
+        if( pKey != NULL )
+        {
+            _appendData( pEncoder, key.type, &key, 0 );
+        }
+
+        _appendData( pEncoder, dataType, pScalarData, length );
+        pEncoder->remainingLength -= serializedLength;
+    }
+    else
+    {
+        pEncoder->overflowLength += ( serializedLength - pEncoder->remainingLength );
+        pEncoder->remainingLength = 0;
+        error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _init( IotSerializerEncoderObject_t * pEncoderObject,
+                                   uint8_t * pDataBuffer,
+                                   size_t maxSize )
+{
+    _cborEncoder_t * pEncoder;
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    pEncoder = pvPortMalloc( sizeof( _cborEncoder_t ) );
+
+    if( pEncoder != NULL )
+    {
+        pEncoder->pBuffer = pDataBuffer;
+        pEncoder->remainingLength = ( pDataBuffer != NULL ) ? maxSize : 0;
+        pEncoder->offset = 0;
+        pEncoder->overflowLength = 0;
+        pEncoder->depth = 0;
+        pEncoder->indefiniteMask = 0;
+
+        /* Set the outermost container default type as stream */
+        pEncoderObject->type = IOT_SERIALIZER_CONTAINER_STREAM;
+
+        /* Store the encoder pointer within the handle */
+        pEncoderObject->pHandle = ( void * ) pEncoder;
+    }
+    else
+    {
+        error = IOT_SERIALIZER_OUT_OF_MEMORY;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static void _destroy( IotSerializerEncoderObject_t * pEncoderObject )
+{
+    vPortFree( pEncoderObject->pHandle );
+    pEncoderObject->pHandle = NULL;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _openContainer( IotSerializerEncoderObject_t * pEncoderObject,
+                                            IotSerializerEncoderObject_t * pNewEncoderObject,
+                                            size_t length )
+{
+    return _openContainerWithKey( pEncoderObject, NULL, pNewEncoderObject, length );
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _openContainerWithKey( IotSerializerEncoderObject_t * pEncoderObject,
+                                                   const char * pKey,
+                                                   IotSerializerEncoderObject_t * pNewEncoderObject,
+                                                   size_t length )
+{
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+    _cborEncoder_t * pEncoder;
+
+    if( _cborIsValidContainer( pEncoderObject ) &&
+        _cborIsValidContainer( pNewEncoderObject ) &&
+        ( pNewEncoderObject->type != IOT_SERIALIZER_CONTAINER_STREAM ) &&
+        ( ( pKey == NULL ) != ( pEncoderObject->type == IOT_SERIALIZER_CONTAINER_MAP ) ) &&
+        ( ( ( _cborEncoder_t * ) pEncoderObject->pHandle )->depth < _CBOR_MAX_DEPTH ) )
+    {
+        pEncoder = ( _cborEncoder_t * ) pEncoderObject->pHandle;
+        error = _appendItem( pEncoder, pKey, pNewEncoderObject->type, NULL, length );
+
+        if( length == IOT_SERIALIZER_INDEFINITE_LENGTH )
+        {
+            pEncoder->indefiniteMask |= ( 1UL << pEncoder->depth );
+        }
+        else
+        {
+            pEncoder->indefiniteMask &= ~( 1UL << pEncoder->depth );
+        }
+
+        pEncoder->depth++;
+        pNewEncoderObject->pHandle = ( void * ) pEncoder;
+    }
+    else
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _closeContainer( IotSerializerEncoderObject_t * pEncoderObject,
+                                             IotSerializerEncoderObject_t * pNewEncoderObject )
+{
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+    _cborEncoder_t * pEncoder;
+
+    if( _cborIsValidContainer( pEncoderObject ) &&
+        _cborIsValidContainer( pNewEncoderObject ) &&
+        ( pNewEncoderObject->pHandle != NULL ) &&
+        ( ( ( _cborEncoder_t * ) pNewEncoderObject->pHandle )->depth > 0 ) )
+    {
+        pEncoder = ( _cborEncoder_t * ) pNewEncoderObject->pHandle;
+        pEncoder->depth--;
+
+        if( ( pEncoder->indefiniteMask & ( 1UL << pEncoder->depth ) ) != 0 )
+        {
+            if( pEncoder->remainingLength >= 1U )
+            {
+                pEncoder->pBuffer[ pEncoder->offset++ ] = _CBOR_BREAK;
+                pEncoder->remainingLength--;
+            }
+            else
+            {
+                pEncoder->overflowLength++;
+                error = IOT_SERIALIZER_BUFFER_TOO_SMALL;
+            }
+        }
+
+        pEncoderObject->pHandle = ( void * ) pEncoder;
+        pNewEncoderObject->pHandle = NULL;
+    }
+    else
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _append( IotSerializerEncoderObject_t * pEncoderObject,
+                                     IotSerializerScalarData_t scalarData )
+{
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    if( _cborIsValidContainer( pEncoderObject ) &&
+        ( pEncoderObject->type != IOT_SERIALIZER_CONTAINER_MAP ) &&
+        _cborIsValidScalar( &scalarData ) )
+    {
+        error = _appendItem( ( _cborEncoder_t * ) pEncoderObject->pHandle, NULL, scalarData.type, &scalarData, 0 );
+    }
+    else
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static IotSerializerError_t _appendKeyValue( IotSerializerEncoderObject_t * pEncoderObject,
+                                             const char * pKey,
+                                             IotSerializerScalarData_t scalarData )
+{
+    IotSerializerError_t error = IOT_SERIALIZER_SUCCESS;
+
+    if( _cborIsValidContainer( pEncoderObject ) &&
+        ( pEncoderObject->type == IOT_SERIALIZER_CONTAINER_MAP ) &&
+        ( pKey != NULL ) &&
+        _cborIsValidScalar( &scalarData ) )
+    {
+        error = _appendItem( ( _cborEncoder_t * ) pEncoderObject->pHandle, pKey, scalarData.type, &scalarData, 0 );
+    }
+    else
+    {
+        error = IOT_SERIALIZER_INVALID_INPUT;
+    }
+
+    return error;
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t _getEncodedSize( IotSerializerEncoderObject_t * pEncoderObject,
+                               uint8_t * pDataBuffer )
+{
+    size_t encodedSize = 0;
+    _cborEncoder_t * pEncoder = NULL;
+
+    if( _cborIsValidContainer( pEncoderObject ) )
+    {
+        pEncoder = ( _cborEncoder_t * ) ( pEncoderObject->pHandle );
+
+        if( ( pEncoder != NULL ) && ( pDataBuffer == pEncoder->pBuffer ) )
+        {
+            encodedSize = pEncoder->offset;
+        }
+    }
+
+    return encodedSize;
+}
+
+/*-----------------------------------------------------------*/
+
+static size_t _getExtraBufferSizeNeeded( IotSerializerEncoderObject_t * pEncoderObject )
+{
+    size_t extraSizeNeeded = 0;
+    _cborEncoder_t * pEncoder = NULL;
+
+    if( _cborIsValidContainer( pEncoderObject ) )
+    {
+        pEncoder = ( _cborEncoder_t * ) ( pEncoderObject->pHandle );
+
+        if( pEncoder != NULL )
+        {
+            extraSizeNeeded = pEncoder->overflowLength;
+        }
+    }
+
+    return extraSizeNeeded;
+}
@@ -98,6 +98,8 @@ typedef BaseType_t ( * NetworkSend_t )( void * pvCallerContext,
  * @param[in] pxNetworkSend Caller-defined network send function pointer.
  * @param[in] pvCallerContext Caller-defined context handle to be used with callback
  * functions.
+ * @param[in] usDestinationPort Server port, with pcDestination it identifies the
+ * server a TLS session can be resumed with.
  */
 typedef struct xTLS_PARAMS
 {
@@ -112,6 +114,7 @@ typedef struct xTLS_PARAMS
     NetworkRecv_t pxNetworkRecv;
     NetworkSend_t pxNetworkSend;
     void * pvCallerContext;
+    uint16_t usDestinationPort;
 } TLSParams_t;
 
 /**
@@ -35,6 +35,7 @@
 #include "iot_pkcs11_config.h"
 #include "iot_pkcs11.h"
 #include "task.h"
+#include "semphr.h"
 
 #if SSS_HAVE_ALT_A71CH
 #  include "ax_mbedtls.h"
@@ -83,6 +84,7 @@ extern int mbedtls_ssl_set_curve_list(mbedtls_ssl_config *conf, uint32_t keyInde
  * @brief Internal context structure.
  *
  * @param[in] pcDestination Server location, can be a DNS name or IP address.
+ * @param[in] usDestinationPort Server port, only used to match a cached session.
  * @param[in] pcServerCertificate Server X.509 certificate in PEM format to trust.
  * @param[in] ulServerCertificateLength Length in bytes of the server certificate.
  * @param[in] xNetworkRecv Callback for receiving data on an open TCP socket.
@@ -101,6 +103,7 @@ extern int mbedtls_ssl_set_curve_list(mbedtls_ssl_config *conf, uint32_t keyInde
 typedef struct TLSContext
 {
     const char * pcDestination;
+    uint16_t usDestinationPort;
     const char * pcServerCertificate;
     uint32_t ulServerCertificateLength;
     const char ** ppcAlpnProtocols;
@@ -129,6 +132,32 @@ typedef struct TLSContext
 
 #define TLS_PRINT( X )    vLoggingPrintf X
 
+/**
+ * @brief Resume the last TLS session on the next connection to the same server.
+ *
+ * A module coming out of PSM often finds its TCP connection dropped by the
+ * carrier; an abbreviated handshake skips the certificate exchange and the key
+ * agreement. The cached session holds a copy of the server certificate.
+ */
+#ifndef tlsconfigSESSION_RESUMPTION
+    #define tlsconfigSESSION_RESUMPTION    ( 1 )
+#endif
+
+#if ( tlsconfigSESSION_RESUMPTION == 1 )
+
+/**
+ * @brief Longest server name a session is cached for.
+ */
+    #define tlsSESSION_DESTINATION_LENGTH    ( 128 )
+
+    static mbedtls_ssl_session xCachedSession;
+    static char cCachedDestination[ tlsSESSION_DESTINATION_LENGTH ];
+    static uint16_t usCachedPort;
+    static BaseType_t xSessionCached = pdFALSE;
+    static SemaphoreHandle_t xSessionMutex = NULL;
+    static StaticSemaphore_t xSessionMutexBuffer;
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -162,6 +191,99 @@ static void prvFreeContext( TLSContext_t * pxCtx )
 
 /*-----------------------------------------------------------*/
 
+#if ( tlsconfigSESSION_RESUMPTION == 1 )
+
+/**
+ * @brief Lock the session cache, shared by all TLS contexts.
+ */
+    static void prvSessionLock( void )
+    {
+        /* The mutex is static, creating it allocates nothing. */
+        taskENTER_CRITICAL();
+
+        if( NULL == xSessionMutex )
+        {
+            xSessionMutex = xSemaphoreCreateMutexStatic( &xSessionMutexBuffer );
+        }
+
+        taskEXIT_CRITICAL();
+
+        ( void ) xSemaphoreTake( xSessionMutex, portMAX_DELAY );
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Offer the cached session to the server if it was negotiated with it,
+ * same host name and port.
+ *
+ * @param[in] pxCtx Context whose handshake is about to start.
+ */
+    static void prvRestoreSession( TLSContext_t * pxCtx )
+    {
+        if( NULL != pxCtx->pcDestination )
+        {
+            prvSessionLock();
+
+            if( ( pdTRUE == xSessionCached ) &&
+                ( usCachedPort == pxCtx->usDestinationPort ) &&
+                ( 0 == strcmp( cCachedDestination, pxCtx->pcDestination ) ) )
+            {
+                /* A server that does not know the session anymore answers with
+                 * a full handshake, so a failure here is not an error. */
+                ( void ) mbedtls_ssl_set_session( &pxCtx->xMbedSslCtx, &xCachedSession );
+            }
+
+            ( void ) xSemaphoreGive( xSessionMutex );
+        }
+    }
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Replace the cached session with the one just negotiated.
+ *
+ * @param[in] pxCtx Context whose handshake has completed, or failed.
+ * @param[in] xResult Result of the handshake.
+ */
+    static void prvSaveSession( TLSContext_t * pxCtx,
+                                BaseType_t xResult )
+    {
+        if( ( NULL != pxCtx->pcDestination ) &&
+            ( strlen( pxCtx->pcDestination ) < sizeof( cCachedDestination ) ) )
+        {
+            prvSessionLock();
+
+            if( pdTRUE == xSessionCached )
+            {
+                mbedtls_ssl_session_free( &xCachedSession );
+                xSessionCached = pdFALSE;
+            }
+
+            /* A failed handshake leaves the cache empty. */
+            if( 0 == xResult )
+            {
+                mbedtls_ssl_session_init( &xCachedSession );
+
+                if( 0 == mbedtls_ssl_get_session( &pxCtx->xMbedSslCtx, &xCachedSession ) )
+                {
+                    strcpy( cCachedDestination, pxCtx->pcDestination );
+                    usCachedPort = pxCtx->usDestinationPort;
+                    xSessionCached = pdTRUE;
+                }
+                else
+                {
+                    mbedtls_ssl_session_free( &xCachedSession );
+                }
+            }
+
+            ( void ) xSemaphoreGive( xSessionMutex );
+        }
+    }
+#endif /* if ( tlsconfigSESSION_RESUMPTION == 1 ) */
+
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Network send callback shim.
  *
@@ -739,6 +861,7 @@ BaseType_t TLS_Init( void ** ppvContext,
 
         /* Initialize the context. */
         pxCtx->pcDestination = pxParams->pcDestination;
+        pxCtx->usDestinationPort = pxParams->usDestinationPort;
         pxCtx->pcServerCertificate = pxParams->pcServerCertificate;
         pxCtx->ulServerCertificateLength = pxParams->ulServerCertificateLength;
         pxCtx->ppcAlpnProtocols = pxParams->ppcAlpnProtocols;
@@ -792,7 +915,6 @@ BaseType_t TLS_Init( void ** ppvContext,
 #endif /* ifdef MBEDTLS_DEBUG_C */
 
 /*-----------------------------------------------------------*/
-extern void xInitTimeoutNwkRecvTimer(uint32_t u32Timeout);
 
 BaseType_t TLS_Connect( void * pvContext )
 {
@@ -963,7 +1085,10 @@ BaseType_t TLS_Connect( void * pvContext )
 							 prvTimeoutNetworkRecv );
 
         mbedtls_ssl_conf_read_timeout( &pxCtx->xMbedSslConfig, SOCKET_RECV_TIMEOUT );
-        xInitTimeoutNwkRecvTimer(pxCtx->xMbedSslConfig.read_timeout);
+
+        #if ( tlsconfigSESSION_RESUMPTION == 1 )
+            prvRestoreSession( pxCtx );
+        #endif
 
         /* Negotiate. */
         while( 0 != ( xResult = mbedtls_ssl_handshake( &pxCtx->xMbedSslCtx ) ) )
@@ -974,6 +1099,9 @@ BaseType_t TLS_Connect( void * pvContext )
                 /* There was an unexpected error. Per mbedTLS API documentation,
                  * ensure that upstream clean-up code doesn't accidentally use
                  * a context that failed the handshake. */
+                #if ( tlsconfigSESSION_RESUMPTION == 1 )
+                    prvSaveSession( pxCtx, xResult );
+                #endif
                 prvFreeContext( pxCtx );
                 TLS_PRINT( ( "ERROR: Handshake failed with error code -0x%x \r\n", 0 - xResult ) );
                 break;
@@ -985,6 +1113,10 @@ BaseType_t TLS_Connect( void * pvContext )
     if( 0 == xResult )
     {
         pxCtx->xTLSHandshakeSuccessful = pdTRUE;
+
+        #if ( tlsconfigSESSION_RESUMPTION == 1 )
+            prvSaveSession( pxCtx, xResult );
+        #endif
     }
     else if( xResult > 0 )
     {
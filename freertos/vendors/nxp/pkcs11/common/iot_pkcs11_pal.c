@@ -43,6 +43,8 @@
 
 /* Flash write */
 #include "mflash_file.h"
+#include "CellIoT_cache.h"
+#include "CellIoT_keepalive.h"
 
 /* C runtime includes. */
 #include <stdio.h>
@@ -73,6 +75,12 @@ mflash_file_t g_cert_files[] =
     { .path = pkcs11palFILE_CODE_SIGN_PUBLIC_KEY,
       .flash_addr = MFLASH_FILE_BASEADDR + ( 2 * MFLASH_FILE_SIZE ),
       .max_size = MFLASH_FILE_SIZE },
+    { .path = CELLIOT_CACHE_FILE_NAME,
+      .flash_addr = MFLASH_FILE_BASEADDR + ( 3 * MFLASH_FILE_SIZE ),
+      .max_size = MFLASH_FILE_SIZE },
+    { .path = CELLIOT_KEEPALIVE_FILE_NAME,
+      .flash_addr = MFLASH_FILE_BASEADDR + ( 4 * MFLASH_FILE_SIZE ),
+      .max_size = MFLASH_FILE_SIZE },
     { 0 }
 };
 
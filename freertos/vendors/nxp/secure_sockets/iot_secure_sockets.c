@@ -45,6 +45,7 @@
 #include "gsm_includes.h"
 #include "gsm_private.h"
 #include "CellIoT_lib.h"
+#include "CellIoT_tools.h"
 #undef _SECURE_SOCKETS_WRAPPER_NOT_REDEFINE
 
 /**
@@ -81,6 +82,12 @@
 #define nxpsecuresocketsONE_MILLISECOND             ( 1 )
 #define nxpsecuresocketsSOCKET_CONNECTED_FLAG       ( 1 )
 
+/**
+ * @brief Transmission protocol of the SQNSD command.
+ */
+#define nxpsecuresocketsTX_PROT_TCP                 ( 0 )
+#define nxpsecuresocketsTX_PROT_UDP                 ( 1 )
+
 /* Internal context structure. */
 typedef struct SSOCKETContext
 {
@@ -98,11 +105,14 @@ typedef struct SSOCKETContext
     uint32_t ulState;
     char ** ppcAlpnProtocols;
     uint32_t ulAlpnProtocolsCount;
+    uint8_t ucConnId;           /* Module connection ID [1..GSM_CFG_MAX_CONNS] */
+    uint8_t ucTxProt;           /* nxpsecuresocketsTX_PROT_TCP or nxpsecuresocketsTX_PROT_UDP */
+    uint32_t ulPeerAddress;     /* Address the socket is connected to */
+    uint16_t usPeerPort;
+    BaseType_t xOffloadTLS;     /* TLS requested on the module, pdFALSE again when falling back to mbedTLS */
+    SocketsClientCredentials_t xClientCredentials;
 } SSOCKETContext_t, * SSOCKETContextPtr_t;
 
-static uint8_t u8timeoutExpired;
-TimerHandle_t xRcvTimer;
-
 /*
  * Helper routines.
  */
@@ -141,7 +151,7 @@ static BaseType_t prvNetworkSend( void * pvContext,
 
 #else
     /* Send Data using AT commands */
-    if( CellIoT_lib_socketSend( gsm.m.conn_val_id , pucData , xDataLength ) == gsmOK )
+    if( CellIoT_lib_socketSend( pxContext->ucConnId , pucData , xDataLength ) == gsmOK )
     {
 		#ifdef USE_AWS_CLOUD
     	/* AWS Cloud seems to need a delay here */
@@ -175,34 +185,19 @@ static BaseType_t prvNetworkRecv( void * pvContext,
     uint32_t i = 0;
     do
     {
-    	xRetVal = CellIoT_lib_socketReadData( gsm.m.conn_val_id, pucReceiveBuffer , xReceiveLength );
+    	xRetVal = CellIoT_lib_socketReadData( pxContext->ucConnId, pucReceiveBuffer , xReceiveLength );
     	if( 0 == xRetVal )
+    	{
+    		/* Everything received before the module closed the socket has been read */
+    		if( !CellIoT_lib_socketIsOpen( pxContext->ucConnId ) )
+    			return SOCKETS_ECLOSED;
     		vTaskDelay(pdMS_TO_TICKS(1));
+    	}
     }while( 0 == xRetVal && ++i < 2000);
 
     return xRetVal;
 }
 
-/*-----------------------------------------------------------*/
-
-void vRcvTimerCallback( TimerHandle_t xTimer )
-{
-   /* Optionally do something if the pxTimer parameter is NULL. */
-   configASSERT( xTimer );
-
-   u8timeoutExpired = 1;
-
-}
-
-void xInitTimeoutNwkRecvTimer(uint32_t u32Timeout)
-{
-	xRcvTimer = xTimerCreate("Receive Timer",
-							pdMS_TO_TICKS(u32Timeout),
-							pdFALSE,
-							( void * ) 0,
-							vRcvTimerCallback );
-}
-
 /*
  * @brief Network receive callback.
  */
@@ -213,6 +208,7 @@ static BaseType_t prvTimeoutNetworkRecv( void * pvContext,
 {
     SSOCKETContextPtr_t pxContext = ( SSOCKETContextPtr_t ) pvContext;
     int xRetVal = 0;
+    TickType_t xStart = xTaskGetTickCount();
 
     /* Do not receive data on unconnected socket */
     if( !( pxContext->ulState & nxpsecuresocketsSOCKET_CONNECTED_FLAG ) )
@@ -220,23 +216,104 @@ static BaseType_t prvTimeoutNetworkRecv( void * pvContext,
         return -1;
     }
 
-    u8timeoutExpired = 0;
-    xTimerStart( xRcvTimer, 0 );
-
+    /* The timeout is kept per call, several sockets can wait at the same time */
     do
     {
-    	xRetVal = CellIoT_lib_socketReadData( gsm.m.conn_val_id, pucReceiveBuffer , xReceiveLength );
+    	xRetVal = CellIoT_lib_socketReadData( pxContext->ucConnId, pucReceiveBuffer , xReceiveLength );
     	if( 0 == xRetVal )
+    	{
+    		if( !CellIoT_lib_socketIsOpen( pxContext->ucConnId ) )
+    			return SOCKETS_ECLOSED;
     		vTaskDelay(pdMS_TO_TICKS(1));
-    }while( 0 == xRetVal && 0 == u8timeoutExpired);
+    	}
+    }while( 0 == xRetVal && ( xTaskGetTickCount() - xStart ) < pdMS_TO_TICKS( u32TimeoutPeriodInMs ) );
+
+    return xRetVal;
+}
 
-    u8timeoutExpired = 0;
+/*-----------------------------------------------------------*/
+
+/*
+ * @brief Datagram receive, one call returns at most one datagram.
+ */
+static BaseType_t prvNetworkRecvFrom( SSOCKETContextPtr_t pxContext,
+                                      unsigned char * pucReceiveBuffer,
+                                      size_t xReceiveLength,
+                                      SocketsSockaddr_t * pxSourceAddress )
+{
+    int xRetVal = 0;
+    TickType_t xStart = xTaskGetTickCount();
+    gsm_ip_t ip = { 0 };
+    gsm_port_t port = 0;
+
+    if( xReceiveLength > UINT16_MAX )
+    {
+        xReceiveLength = UINT16_MAX;
+    }
+
+    do
+    {
+        xRetVal = CellIoT_lib_socketReadDatagram( pxContext->ucConnId, pucReceiveBuffer, xReceiveLength, &ip, &port );
+        if( 0 == xRetVal )
+        {
+            if( !CellIoT_lib_socketIsOpen( pxContext->ucConnId ) )
+                return SOCKETS_ECLOSED;
+            vTaskDelay(pdMS_TO_TICKS(1));
+        }
+    }while( 0 == xRetVal &&
+            ( pxContext->ulRecvTimeout == portMAX_DELAY ||
+              ( xTaskGetTickCount() - xStart ) < pdMS_TO_TICKS( pxContext->ulRecvTimeout ) ) );
+
+    if( ( xRetVal > 0 ) && ( NULL != pxSourceAddress ) )
+    {
+        pxSourceAddress->ucLength = sizeof( SocketsSockaddr_t );
+        pxSourceAddress->ucSocketDomain = SOCKETS_AF_INET;
+        pxSourceAddress->usPort = port;
+        pxSourceAddress->ulAddress = ( ( uint32_t ) ip.ip[0] << 24 ) |
+                                     ( ( uint32_t ) ip.ip[1] << 16 ) |
+                                     ( ( uint32_t ) ip.ip[2] << 8 ) |
+                                       ( uint32_t ) ip.ip[3];
+    }
 
     return xRetVal;
 }
 
 /*-----------------------------------------------------------*/
 
+/*
+ * @brief Prepare the module connection for TLS run by the module.
+ *
+ * The module has no ALPN support and needs the server certificate in its NVM,
+ * otherwise TLS stays on the MCU.
+ */
+static BaseType_t prvOffloadTLSSetup( SSOCKETContextPtr_t pxContext )
+{
+#if ( socketsconfigENABLE_OFFLOAD_TLS == 1 )
+    if( ( NULL == pxContext->pcServerCertificate ) || ( NULL != pxContext->ppcAlpnProtocols ) )
+    {
+        return pdFALSE;
+    }
+
+    if( SOCKETS_ProvisionOffloadTLS( socketsconfigOFFLOAD_TLS_PROFILE_ID,
+                                     pxContext->pcServerCertificate,
+                                     pxContext->ulServerCertificateLength,
+                                     pxContext->xClientCredentials.pcClientCertificate,
+                                     pxContext->xClientCredentials.xClientCertificateLength,
+                                     pxContext->xClientCredentials.pcClientPrivateKey,
+                                     pxContext->xClientCredentials.xClientPrivateKeyLength ) != gsmOK )
+    {
+        return pdFALSE;
+    }
+
+    return ( SOCKETS_SetSockSecurity( pxContext->ucConnId, socketsconfigOFFLOAD_TLS_PROFILE_ID, 1 ) == gsmOK ) ? pdTRUE : pdFALSE;
+#else
+    ( void ) pxContext;
+    return pdFALSE;
+#endif
+}
+
+/*-----------------------------------------------------------*/
+
 /*
  * Interface routines.
  */
@@ -248,6 +325,8 @@ int32_t SOCKETS_Close( Socket_t xSocket )
 
     if( ( NULL != pxContext ) && ( SOCKETS_INVALID_SOCKET != pxContext->xSocket ) )
     {
+        uint32_t ulState = pxContext->ulState;
+
         pxContext->ulState = 0;
 
         if( NULL != pxContext->pcDestination )
@@ -260,7 +339,7 @@ int32_t SOCKETS_Close( Socket_t xSocket )
             vPortFree( pxContext->pcServerCertificate );
         }
 
-        if( pdTRUE == pxContext->xRequireTLS )
+        if( ( pdTRUE == pxContext->xRequireTLS ) && ( pdFALSE == pxContext->xOffloadTLS ) )
         {
             TLS_Cleanup( pxContext->pvTLSContext );
         }
@@ -277,8 +356,14 @@ int32_t SOCKETS_Close( Socket_t xSocket )
         }
 
 
-        // Close socket AT
-        CellIoT_lib_socketClose( gsm.m.conn_val_id  );
+        // Close socket AT, unless the module already did
+        if( ( ulState & nxpsecuresocketsSOCKET_CONNECTED_FLAG ) && CellIoT_lib_socketIsOpen( pxContext->ucConnId ) )
+        {
+            CellIoT_lib_socketClose( pxContext->ucConnId );
+        }
+
+        /* Give the connection ID back, other sockets may use it */
+        CellIoT_lib_socketFree( pxContext->ucConnId );
 
         vPortFree( pxContext );
     }
@@ -335,7 +420,41 @@ int32_t SOCKETS_Connect( Socket_t xSocket,
 		strcat(ip_string,".");
 		strcat(ip_string,temp_3);
 
-        xStatus = CellIoT_lib_socketDial(gsm.m.conn_val_id + 1, 0, pxAddress->usPort, ip_string, 0, 0, 1, 0, NULL, NULL, 1);
+        /* Configure the connection of this socket on the Cellular-IoT module.
+         * Without it the dial would use whatever a previous user left, so give
+         * the connection ID back instead; SOCKETS_Close() still has to be called. */
+        if( ( SOCKETS_SetCfg( pxContext->ucConnId ) != gsmOK ) ||
+            ( SOCKETS_SetCfgExt( pxContext->ucConnId ) != gsmOK ) )
+        {
+            configPRINTF( ( "Socket configuration of connection %d failed\r\n", pxContext->ucConnId ) );
+            CellIoT_lib_socketFree( pxContext->ucConnId );
+            pxContext->ucConnId = 0;
+
+            return SOCKETS_SOCKET_ERROR;
+        }
+
+        if( ( pdTRUE == pxContext->xRequireTLS ) && ( pdTRUE == pxContext->xOffloadTLS ) )
+        {
+            pxContext->xOffloadTLS = prvOffloadTLSSetup( pxContext );
+
+            if( pdFALSE == pxContext->xOffloadTLS )
+            {
+                configPRINTF( ( "TLS cannot run on the module, using mbedTLS\r\n" ) );
+            }
+        }
+
+        /* A previous socket may have left security enabled on the connection ID */
+        if( ( pdFALSE == pxContext->xOffloadTLS ) &&
+            ( SOCKETS_SetSockSecurity( pxContext->ucConnId, socketsconfigOFFLOAD_TLS_PROFILE_ID, 0 ) != gsmOK ) )
+        {
+            configPRINTF( ( "Socket security of connection %d cannot be disabled\r\n", pxContext->ucConnId ) );
+            CellIoT_lib_socketFree( pxContext->ucConnId );
+            pxContext->ucConnId = 0;
+
+            return SOCKETS_SOCKET_ERROR;
+        }
+
+        xStatus = CellIoT_lib_socketDial(pxContext->ucConnId, pxContext->ucTxProt, pxAddress->usPort, ip_string, 0, 0, 1, 0, NULL, NULL, 1);
 
 
 
@@ -343,13 +462,16 @@ int32_t SOCKETS_Connect( Socket_t xSocket,
         if( SOCKETS_ERROR_NONE == xStatus )
         {
             pxContext->ulState |= nxpsecuresocketsSOCKET_CONNECTED_FLAG;
+            pxContext->ulPeerAddress = pxAddress->ulAddress;
+            pxContext->usPeerPort = pxAddress->usPort;
         }
 
-        /* Negotiate TLS if requested. */
-        if( ( SOCKETS_ERROR_NONE == xStatus ) && ( pdTRUE == pxContext->xRequireTLS ) )
+        /* Negotiate TLS if requested, the module already did it when offloaded. */
+        if( ( SOCKETS_ERROR_NONE == xStatus ) && ( pdTRUE == pxContext->xRequireTLS ) && ( pdFALSE == pxContext->xOffloadTLS ) )
         {
             xTLSParams.ulSize = sizeof( xTLSParams );
             xTLSParams.pcDestination = pxContext->pcDestination;
+            xTLSParams.usDestinationPort = pxAddress->usPort;
             xTLSParams.pcServerCertificate = pxContext->pcServerCertificate;
             xTLSParams.ulServerCertificateLength = pxContext->ulServerCertificateLength;
             xTLSParams.pvCallerContext = pxContext;
@@ -396,14 +518,14 @@ uint32_t SOCKETS_GetHostByName( const char * pcHostName )
         WIFI_GetHostIP( ( char * ) pcHostName, ( uint8_t * ) &ulAddr );
 #else
         /*{*/
-			gsm_ip_t* ip = &gsm.m.conns[gsm.m.conn_val_id].remote_ip;
+			gsm_ip_t ip = { 0 };
 			//gsm_core_lock();
-			CellIoT_lib_getHostIP(( char * ) pcHostName, NULL, NULL, 1);
+			CellIoT_lib_getHostIP(( char * ) pcHostName, &ip, NULL, NULL, 1);
 			//gsm_core_unlock();
-			ulAddr = ( ( ( ip->ip[0] ) << 24 ) & 0xFF000000 ) +
-					 ( ( ( ip->ip[1] ) << 16 ) & 0x00FF0000 ) +
-				     ( ( ( ip->ip[2] ) << 8 )  & 0x0000FF00 ) +
-					 (   ( ip->ip[3] )         & 0x000000FF );
+			ulAddr = ( ( ( ip.ip[0] ) << 24 ) & 0xFF000000 ) +
+					 ( ( ( ip.ip[1] ) << 16 ) & 0x00FF0000 ) +
+				     ( ( ( ip.ip[2] ) << 8 )  & 0x0000FF00 ) +
+					 (   ( ip.ip[3] )         & 0x000000FF );
 
 			/*ulAddr = ( ( ( ip->ip[0] ) << 24 ) & 0xFF000000 );
 			ulAddr+= ( ( ( ip->ip[1] ) << 16 ) & 0x00FF0000 );
@@ -447,7 +569,12 @@ int32_t SOCKETS_Recv( Socket_t xSocket,
         )
     {
         pxContext->xRecvFlags = ( BaseType_t ) ulFlags;
-        if( pdTRUE == pxContext->xRequireTLS )
+        if( nxpsecuresocketsTX_PROT_UDP == pxContext->ucTxProt )
+        {
+            /* Keep the datagram boundaries */
+            lStatus = prvNetworkRecvFrom( pxContext, pvBuffer, xBufferLength, NULL );
+        }
+        else if( ( pdTRUE == pxContext->xRequireTLS ) && ( pdFALSE == pxContext->xOffloadTLS ) )
         {
             /* Receive through TLS pipe, if negotiated. */
             lStatus = TLS_Recv( pxContext->pvTLSContext, pvBuffer, xBufferLength );
@@ -487,7 +614,19 @@ int32_t SOCKETS_Send( Socket_t xSocket,
     {
         pxContext->xSendFlags = ( BaseType_t ) ulFlags;
 
-        if( pdTRUE == pxContext->xRequireTLS )
+        if( nxpsecuresocketsTX_PROT_UDP == pxContext->ucTxProt )
+        {
+            /* One call is one datagram, it is never split */
+            if( ( xDataLength == 0 ) || ( xDataLength > GSM_CFG_CONN_MAX_DATA_LEN ) )
+            {
+                lWritten = SOCKETS_EINVAL;
+            }
+            else
+            {
+                lWritten = prvNetworkSend( pxContext, pvBuffer, xDataLength );
+            }
+        }
+        else if( ( pdTRUE == pxContext->xRequireTLS ) && ( pdFALSE == pxContext->xOffloadTLS ) )
         {
             /* In case of TLS, reserve extra space for SSL meta data (header, maclen, ivlen, ... = 45B) */
             ulSendMaxLength = 1531;
@@ -561,6 +700,78 @@ int32_t SOCKETS_Send( Socket_t xSocket,
 }
 /*-----------------------------------------------------------*/
 
+int32_t SOCKETS_SendTo( Socket_t xSocket,
+                        const void * pvBuffer,
+                        size_t xDataLength,
+                        uint32_t ulFlags,
+                        SocketsSockaddr_t * pxDestAddress,
+                        Socklen_t xDestAddressLength )
+{
+    int32_t lStatus = SOCKETS_ERROR_NONE;
+    SSOCKETContextPtr_t pxContext = ( SSOCKETContextPtr_t ) xSocket;
+
+    if( ( SOCKETS_INVALID_SOCKET == xSocket ) ||
+        ( NULL == pxDestAddress ) ||
+        ( nxpsecuresocketsTX_PROT_UDP != pxContext->ucTxProt ) )
+    {
+        return SOCKETS_EINVAL;
+    }
+
+    if( !( pxContext->ulState & nxpsecuresocketsSOCKET_CONNECTED_FLAG ) )
+    {
+        /* The module only sends on dialed sockets, the first destination
+         * connects the socket */
+        lStatus = SOCKETS_Connect( xSocket, pxDestAddress, xDestAddressLength );
+    }
+    else if( ( pxContext->ulPeerAddress != pxDestAddress->ulAddress ) ||
+             ( pxContext->usPeerPort != pxDestAddress->usPort ) )
+    {
+        lStatus = SOCKETS_EINVAL;
+    }
+
+    if( SOCKETS_ERROR_NONE == lStatus )
+    {
+        lStatus = SOCKETS_Send( xSocket, pvBuffer, xDataLength, ulFlags );
+    }
+
+    return lStatus;
+}
+/*-----------------------------------------------------------*/
+
+int32_t SOCKETS_RecvFrom( Socket_t xSocket,
+                          void * pvBuffer,
+                          size_t xBufferLength,
+                          uint32_t ulFlags,
+                          SocketsSockaddr_t * pxSourceAddress,
+                          Socklen_t * pxSourceAddressLength )
+{
+    int32_t lStatus = SOCKETS_ERROR_NONE;
+    SSOCKETContextPtr_t pxContext = ( SSOCKETContextPtr_t ) xSocket;
+
+    if( ( SOCKETS_INVALID_SOCKET != xSocket ) &&
+        ( NULL != pvBuffer ) &&
+        ( nxpsecuresocketsTX_PROT_UDP == pxContext->ucTxProt ) &&
+        ( ( nxpsecuresocketsSOCKET_READ_CLOSED_FLAG & pxContext->xShutdownFlags ) == 0UL ) &&
+        ( pxContext->ulState & ( nxpsecuresocketsSOCKET_CONNECTED_FLAG ) )
+        )
+    {
+        pxContext->xRecvFlags = ( BaseType_t ) ulFlags;
+        lStatus = prvNetworkRecvFrom( pxContext, pvBuffer, xBufferLength, pxSourceAddress );
+
+        if( ( lStatus > 0 ) && ( NULL != pxSourceAddress ) && ( NULL != pxSourceAddressLength ) )
+        {
+            *pxSourceAddressLength = sizeof( SocketsSockaddr_t );
+        }
+    }
+    else
+    {
+        lStatus = SOCKETS_SOCKET_ERROR;
+    }
+
+    return lStatus;
+}
+/*-----------------------------------------------------------*/
+
 int32_t SOCKETS_SetSockOpt( Socket_t xSocket,
                             int32_t lLevel,
                             int32_t lOptionName,
@@ -632,9 +843,39 @@ int32_t SOCKETS_SetSockOpt( Socket_t xSocket,
                     break;
                 }
 
+                /* TLS runs over a byte stream, datagram sockets need DTLS */
+                if( nxpsecuresocketsTX_PROT_UDP == pxContext->ucTxProt )
+                {
+                    lStatus = SOCKETS_EINVAL;
+                    break;
+                }
+
                 pxContext->xRequireTLS = pdTRUE;
                 break;
 
+            case SOCKETS_SO_OFFLOAD_TLS:
+
+                /* Secure socket option cannot be used on connected socket */
+                if( pxContext->ulState & ( nxpsecuresocketsSOCKET_CONNECTED_FLAG ) )
+                {
+                    lStatus = SOCKETS_SOCKET_ERROR;
+                    break;
+                }
+
+                if( NULL != pvOptionValue )
+                {
+                    if( xOptionLength != sizeof( SocketsClientCredentials_t ) )
+                    {
+                        lStatus = SOCKETS_EINVAL;
+                        break;
+                    }
+
+                    memcpy( &pxContext->xClientCredentials, pvOptionValue, sizeof( SocketsClientCredentials_t ) );
+                }
+
+                pxContext->xOffloadTLS = pdTRUE;
+                break;
+
             case SOCKETS_SO_NONBLOCK:
 
                 if( pxContext->ulState & ( nxpsecuresocketsSOCKET_CONNECTED_FLAG ) )
@@ -805,8 +1046,8 @@ Socket_t SOCKETS_Socket( int32_t lDomain,
 
     /* Ensure that only supported values are supplied. */
     configASSERT( lDomain == SOCKETS_AF_INET );
-    configASSERT( lType == SOCKETS_SOCK_STREAM );
-    configASSERT( lProtocol == SOCKETS_IPPROTO_TCP );
+    configASSERT( ( ( lType == SOCKETS_SOCK_STREAM ) && ( lProtocol == SOCKETS_IPPROTO_TCP ) ) ||
+                  ( ( lType == SOCKETS_SOCK_DGRAM ) && ( lProtocol == SOCKETS_IPPROTO_UDP ) ) );
 
     /* Allocate the internal context structure. */
     pxContext = pvPortMalloc( sizeof( SSOCKETContext_t ) );
@@ -817,12 +1058,14 @@ Socket_t SOCKETS_Socket( int32_t lDomain,
 
         /* Create the wrapped socket. */
 
-       // Attribute a Socket number to simulate the qcom_socket API
-        xSocket = 1;
+       // Attribute a module connection ID to the socket, -1 if they are all in use
+        pxContext->ucConnId = CellIoT_lib_socketAlloc();
+        xSocket = ( pxContext->ucConnId != 0 ) ? pxContext->ucConnId : -1;
 
         if( xSocket != -1 )
         {
             pxContext->xSocket = ( Socket_t ) xSocket;
+            pxContext->ucTxProt = ( lProtocol == SOCKETS_IPPROTO_UDP ) ? nxpsecuresocketsTX_PROT_UDP : nxpsecuresocketsTX_PROT_TCP;
             /* Set default timeouts. */
             pxContext->ulRecvTimeout = socketsconfigDEFAULT_RECV_TIMEOUT;
             pxContext->ulSendTimeout = socketsconfigDEFAULT_SEND_TIMEOUT;
@@ -1365,6 +1365,10 @@ int mbedtls_aes_crypt_ctr( mbedtls_aes_context *ctx,
 
 /*          HASHCRYPT AES          */
 #if defined(MBEDTLS_FREESCALE_HASHCRYPT_AES)
+#include "ksdk_digest.h"
+
+/* The engine is shared with the ksdk_digest SHA-256/HMAC users; every
+ * HASHCRYPT call below runs under the same lock. */
 
 /*
  * AES key schedule (encryption)
@@ -1447,7 +1451,12 @@ int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx, const unsigned char *key, u
  */
 int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx, const unsigned char input[16], unsigned char output[16])
 {
-    if (kStatus_Success != HASHCRYPT_AES_EncryptEcb(HASHCRYPT, ctx, input, output, 16))
+    status_t status;
+
+    DIGEST_EngineLock();
+    status = HASHCRYPT_AES_EncryptEcb(HASHCRYPT, ctx, input, output, 16);
+    DIGEST_EngineUnlock();
+    if (kStatus_Success != status)
     {
         return (MBEDTLS_ERR_AES_HW_ACCEL_FAILED);
     }
@@ -1460,7 +1469,12 @@ int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx, const unsigned char i
  */
 int mbedtls_internal_aes_decrypt(mbedtls_aes_context *ctx, const unsigned char input[16], unsigned char output[16])
 {
-    if (kStatus_Success != HASHCRYPT_AES_DecryptEcb(HASHCRYPT, ctx, input, output, 16))
+    status_t status;
+
+    DIGEST_EngineLock();
+    status = HASHCRYPT_AES_DecryptEcb(HASHCRYPT, ctx, input, output, 16);
+    DIGEST_EngineUnlock();
+    if (kStatus_Success != status)
     {
         return (MBEDTLS_ERR_AES_HW_ACCEL_FAILED);
     }
@@ -1479,6 +1493,8 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
                           const unsigned char *input,
                           unsigned char *output)
 {
+    status_t status;
+
     if (length % 16)
         return (MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH);
 
@@ -1486,7 +1502,10 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
     {
         uint8_t tmp[16];
         memcpy(tmp, input + length - 16, 16);
-        if (kStatus_Success != HASHCRYPT_AES_DecryptCbc(HASHCRYPT, ctx, input, output, length, iv))
+        DIGEST_EngineLock();
+        status = HASHCRYPT_AES_DecryptCbc(HASHCRYPT, ctx, input, output, length, iv);
+        DIGEST_EngineUnlock();
+        if (kStatus_Success != status)
         {
             return (MBEDTLS_ERR_AES_HW_ACCEL_FAILED);
         }
@@ -1494,7 +1513,10 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
     }
     else
     {
-        if (kStatus_Success != HASHCRYPT_AES_EncryptCbc(HASHCRYPT, ctx, input, output, length, iv))
+        DIGEST_EngineLock();
+        status = HASHCRYPT_AES_EncryptCbc(HASHCRYPT, ctx, input, output, length, iv);
+        DIGEST_EngineUnlock();
+        if (kStatus_Success != status)
         {
             return (MBEDTLS_ERR_AES_HW_ACCEL_FAILED);
         }
@@ -1517,8 +1539,12 @@ int mbedtls_aes_crypt_ctr(mbedtls_aes_context *ctx,
                           const unsigned char *input,
                           unsigned char *output)
 {
-    if (kStatus_Success !=
-        HASHCRYPT_AES_CryptCtr(HASHCRYPT, ctx, input, output, length, nonce_counter, stream_block, nc_off))
+    status_t status;
+
+    DIGEST_EngineLock();
+    status = HASHCRYPT_AES_CryptCtr(HASHCRYPT, ctx, input, output, length, nonce_counter, stream_block, nc_off);
+    DIGEST_EngineUnlock();
+    if (kStatus_Success != status)
     {
         return (MBEDTLS_ERR_AES_HW_ACCEL_FAILED);
     }
@@ -0,0 +1,680 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <string.h>
+
+#include "ksdk_digest.h"
+
+#if DIGEST_HAS_HASHCRYPT && defined(USE_RTOS) && USE_RTOS && defined(FSL_RTOS_FREE_RTOS)
+#include "FreeRTOS.h"
+#include "semphr.h"
+#define DIGEST_USE_RTOS_LOCK 1
+#else
+#define DIGEST_USE_RTOS_LOCK 0
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define HMAC_IPAD 0x36U
+#define HMAC_OPAD 0x5CU
+
+/* clang-format off */
+#define GET_UINT32_BE(b, i)                                             \
+    (((uint32_t)(b)[(i)] << 24) | ((uint32_t)(b)[(i) + 1] << 16) |      \
+     ((uint32_t)(b)[(i) + 2] << 8) | ((uint32_t)(b)[(i) + 3]))
+
+#define PUT_UINT32_BE(n, b, i)                      \
+    {                                               \
+        (b)[(i)]     = (uint8_t)((n) >> 24);        \
+        (b)[(i) + 1] = (uint8_t)((n) >> 16);        \
+        (b)[(i) + 2] = (uint8_t)((n) >> 8);         \
+        (b)[(i) + 3] = (uint8_t)((n));              \
+    }
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32U - (n))))
+#define S0(x) (ROTR(x, 7) ^ ROTR(x, 18) ^ ((x) >> 3))
+#define S1(x) (ROTR(x, 17) ^ ROTR(x, 19) ^ ((x) >> 10))
+#define S2(x) (ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22))
+#define S3(x) (ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25))
+#define F0(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define F1(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+/* clang-format on */
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const uint32_t s_sha256K[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+static const uint32_t s_sha256Iv[8] = {0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+                                       0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+
+static const uint32_t s_sha224Iv[8] = {0xC1059ED8, 0x367CD507, 0x3070DD17, 0xF70E5939,
+                                       0xFFC00B31, 0x68581511, 0x64F98FA7, 0xBEFA4FA4};
+
+#if DIGEST_USE_RTOS_LOCK
+static StaticSemaphore_t s_engineMutexBuffer;
+static SemaphoreHandle_t s_engineMutex = NULL;
+#endif
+
+/*******************************************************************************
+ * Engine lock
+ ******************************************************************************/
+#if DIGEST_HAS_HASHCRYPT
+/* HASHCRYPT runs either a hash or an AES operation at a time. Both this layer
+ * and the HASHCRYPT AES port (aes_alt.c) take this lock around every engine
+ * call; a SHA operation holds it from the first block until its running hash
+ * is saved. */
+void DIGEST_EngineLock(void)
+{
+#if DIGEST_USE_RTOS_LOCK
+    if ((s_engineMutex != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+    {
+        (void)xSemaphoreTake(s_engineMutex, portMAX_DELAY);
+    }
+#endif
+}
+
+void DIGEST_EngineUnlock(void)
+{
+#if DIGEST_USE_RTOS_LOCK
+    if ((s_engineMutex != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+    {
+        (void)xSemaphoreGive(s_engineMutex);
+    }
+#endif
+}
+#endif /* DIGEST_HAS_HASHCRYPT */
+
+void DIGEST_Init(void)
+{
+#if DIGEST_USE_RTOS_LOCK
+    if (s_engineMutex == NULL)
+    {
+        s_engineMutex = xSemaphoreCreateMutexStatic(&s_engineMutexBuffer);
+    }
+#endif
+}
+
+/*******************************************************************************
+ * Software backend
+ ******************************************************************************/
+static void digest_sw_process(digest_sha256_sw_t *sw, const uint8_t data[DIGEST_SHA256_BLOCK_SIZE])
+{
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, h;
+    uint32_t t1, t2;
+    uint32_t i;
+
+    for (i = 0; i < 16U; i++)
+    {
+        w[i] = GET_UINT32_BE(data, 4U * i);
+    }
+    for (; i < 64U; i++)
+    {
+        w[i] = S1(w[i - 2U]) + w[i - 7U] + S0(w[i - 15U]) + w[i - 16U];
+    }
+
+    a = sw->state[0];
+    b = sw->state[1];
+    c = sw->state[2];
+    d = sw->state[3];
+    e = sw->state[4];
+    f = sw->state[5];
+    g = sw->state[6];
+    h = sw->state[7];
+
+    for (i = 0; i < 64U; i++)
+    {
+        t1 = h + S3(e) + F1(e, f, g) + s_sha256K[i] + w[i];
+        t2 = S2(a) + F0(a, b, c);
+        h  = g;
+        g  = f;
+        f  = e;
+        e  = d + t1;
+        d  = c;
+        c  = b;
+        b  = a;
+        a  = t1 + t2;
+    }
+
+    sw->state[0] += a;
+    sw->state[1] += b;
+    sw->state[2] += c;
+    sw->state[3] += d;
+    sw->state[4] += e;
+    sw->state[5] += f;
+    sw->state[6] += g;
+    sw->state[7] += h;
+}
+
+static void digest_sw_starts(digest_sha256_sw_t *sw, int is224)
+{
+    (void)memcpy(sw->state, (is224 != 0) ? s_sha224Iv : s_sha256Iv, sizeof(sw->state));
+    sw->total = 0U;
+}
+
+static void digest_sw_update(digest_sha256_sw_t *sw, const uint8_t *input, size_t ilen)
+{
+    size_t left = (size_t)(sw->total & (DIGEST_SHA256_BLOCK_SIZE - 1U));
+    size_t fill = DIGEST_SHA256_BLOCK_SIZE - left;
+
+    sw->total += ilen;
+
+    if ((left != 0U) && (ilen >= fill))
+    {
+        (void)memcpy(&sw->buffer[left], input, fill);
+        digest_sw_process(sw, sw->buffer);
+        input += fill;
+        ilen -= fill;
+        left = 0U;
+    }
+
+    while (ilen >= DIGEST_SHA256_BLOCK_SIZE)
+    {
+        digest_sw_process(sw, input);
+        input += DIGEST_SHA256_BLOCK_SIZE;
+        ilen -= DIGEST_SHA256_BLOCK_SIZE;
+    }
+
+    if (ilen > 0U)
+    {
+        (void)memcpy(&sw->buffer[left], input, ilen);
+    }
+}
+
+static void digest_sw_finish(digest_sha256_sw_t *sw, uint8_t *output, size_t outlen)
+{
+    size_t used   = (size_t)(sw->total & (DIGEST_SHA256_BLOCK_SIZE - 1U));
+    uint64_t bits = sw->total << 3;
+    uint32_t i;
+
+    sw->buffer[used++] = 0x80U;
+    if (used > (DIGEST_SHA256_BLOCK_SIZE - 8U))
+    {
+        (void)memset(&sw->buffer[used], 0, DIGEST_SHA256_BLOCK_SIZE - used);
+        digest_sw_process(sw, sw->buffer);
+        used = 0U;
+    }
+    (void)memset(&sw->buffer[used], 0, (DIGEST_SHA256_BLOCK_SIZE - 8U) - used);
+    PUT_UINT32_BE((uint32_t)(bits >> 32), sw->buffer, 56U);
+    PUT_UINT32_BE((uint32_t)bits, sw->buffer, 60U);
+    digest_sw_process(sw, sw->buffer);
+
+    for (i = 0; i < (outlen / 4U); i++)
+    {
+        PUT_UINT32_BE(sw->state[i], output, 4U * i);
+    }
+}
+
+/*******************************************************************************
+ * Multi-part SHA-256
+ ******************************************************************************/
+void DIGEST_Sha256InitCtx(digest_sha256_ctx_t *ctx)
+{
+    (void)memset(ctx, 0, sizeof(*ctx));
+}
+
+void DIGEST_Sha256FreeCtx(digest_sha256_ctx_t *ctx)
+{
+    volatile uint8_t *p = (volatile uint8_t *)ctx;
+    size_t n            = sizeof(*ctx);
+
+    if (ctx == NULL)
+    {
+        return;
+    }
+    while (n-- > 0U)
+    {
+        *p++ = 0U;
+    }
+}
+
+void DIGEST_Sha256Clone(digest_sha256_ctx_t *dst, const digest_sha256_ctx_t *src)
+{
+    (void)memcpy(dst, src, sizeof(*dst));
+}
+
+int DIGEST_Sha256Starts(digest_sha256_ctx_t *ctx, int is224)
+{
+    if (ctx == NULL)
+    {
+        return DIGEST_ERR_BAD_INPUT;
+    }
+
+    ctx->is224 = (is224 != 0) ? 1U : 0U;
+
+#if DIGEST_HAS_HASHCRYPT_RELOAD
+    /* HASHCRYPT has no SHA-224 mode, that one always runs in software. */
+    if (is224 == 0)
+    {
+        ctx->backend = kDIGEST_BackendHashcrypt;
+        return (HASHCRYPT_SHA_Init(HASHCRYPT, &ctx->u.hw, kHASHCRYPT_Sha256) == kStatus_Success) ?
+                   DIGEST_OK :
+                   DIGEST_ERR_HW_ACCEL_FAILED;
+    }
+#endif
+
+    ctx->backend = kDIGEST_BackendSoftware;
+    digest_sw_starts(&ctx->u.sw, is224);
+    return DIGEST_OK;
+}
+
+int DIGEST_Sha256Update(digest_sha256_ctx_t *ctx, const uint8_t *input, size_t ilen)
+{
+    if ((ctx == NULL) || ((input == NULL) && (ilen != 0U)))
+    {
+        return DIGEST_ERR_BAD_INPUT;
+    }
+
+#if DIGEST_HAS_HASHCRYPT_RELOAD
+    if (ctx->backend == kDIGEST_BackendHashcrypt)
+    {
+        status_t status;
+
+        DIGEST_EngineLock();
+        status = HASHCRYPT_SHA_Update(HASHCRYPT, &ctx->u.hw, input, ilen);
+        DIGEST_EngineUnlock();
+        return (status == kStatus_Success) ? DIGEST_OK : DIGEST_ERR_HW_ACCEL_FAILED;
+    }
+#endif
+
+    digest_sw_update(&ctx->u.sw, input, ilen);
+    return DIGEST_OK;
+}
+
+int DIGEST_Sha256Finish(digest_sha256_ctx_t *ctx, uint8_t *output)
+{
+    if ((ctx == NULL) || (output == NULL))
+    {
+        return DIGEST_ERR_BAD_INPUT;
+    }
+
+#if DIGEST_HAS_HASHCRYPT_RELOAD
+    if (ctx->backend == kDIGEST_BackendHashcrypt)
+    {
+        status_t status;
+        size_t outputSize = DIGEST_SHA256_SIZE;
+
+        DIGEST_EngineLock();
+        status = HASHCRYPT_SHA_Finish(HASHCRYPT, &ctx->u.hw, output, &outputSize);
+        DIGEST_EngineUnlock();
+        return (status == kStatus_Success) ? DIGEST_OK : DIGEST_ERR_HW_ACCEL_FAILED;
+    }
+#endif
+
+    digest_sw_finish(&ctx->u.sw, output, (ctx->is224 != 0U) ? DIGEST_SHA224_SIZE : DIGEST_SHA256_SIZE);
+    return DIGEST_OK;
+}
+
+/*******************************************************************************
+ * One-shot SHA-256
+ ******************************************************************************/
+#if DIGEST_HAS_HASHCRYPT
+/* Runs a complete hash of up to two buffers while owning the engine, so it does
+ * not depend on the RELOAD feature. */
+static int digest_hw_sha256(const uint8_t *prefix, size_t prefixLen, const uint8_t *input, size_t ilen, uint8_t *output)
+{
+    hashcrypt_hash_ctx_t hw;
+    size_t outputSize = DIGEST_SHA256_SIZE;
+    status_t status;
+
+    DIGEST_EngineLock();
+    status = HASHCRYPT_SHA_Init(HASHCRYPT, &hw, kHASHCRYPT_Sha256);
+    if ((status == kStatus_Success) && (prefixLen != 0U))
+    {
+        status = HASHCRYPT_SHA_Update(HASHCRYPT, &hw, prefix, prefixLen);
+    }
+    if ((status == kStatus_Success) && (ilen != 0U))
+    {
+        status = HASHCRYPT_SHA_Update(HASHCRYPT, &hw, input, ilen);
+    }
+    if (status == kStatus_Success)
+    {
+        status = HASHCRYPT_SHA_Finish(HASHCRYPT, &hw, output, &outputSize);
+    }
+    DIGEST_EngineUnlock();
+
+    (void)memset(&hw, 0, sizeof(hw));
+    return (status == kStatus_Success) ? DIGEST_OK : DIGEST_ERR_HW_ACCEL_FAILED;
+}
+#endif /* DIGEST_HAS_HASHCRYPT */
+
+static int digest_sha256_two_part(const uint8_t *prefix,
+                                  size_t prefixLen,
+                                  const uint8_t *input,
+                                  size_t ilen,
+                                  uint8_t *output)
+{
+#if DIGEST_HAS_HASHCRYPT
+    return digest_hw_sha256(prefix, prefixLen, input, ilen, output);
+#else
+    digest_sha256_sw_t sw;
+
+    digest_sw_starts(&sw, 0);
+    digest_sw_update(&sw, prefix, prefixLen);
+    digest_sw_update(&sw, input, ilen);
+    digest_sw_finish(&sw, output, DIGEST_SHA256_SIZE);
+    (void)memset(&sw, 0, sizeof(sw));
+    return DIGEST_OK;
+#endif
+}
+
+int DIGEST_Sha256(const uint8_t *input, size_t ilen, uint8_t output[DIGEST_SHA256_SIZE])
+{
+    if (((input == NULL) && (ilen != 0U)) || (output == NULL))
+    {
+        return DIGEST_ERR_BAD_INPUT;
+    }
+    return digest_sha256_two_part(NULL, 0U, input, ilen, output);
+}
+
+/*******************************************************************************
+ * HMAC-SHA256
+ ******************************************************************************/
+static int digest_hmac_prepare_key(const uint8_t *key, size_t keylen, uint8_t block[DIGEST_SHA256_BLOCK_SIZE])
+{
+    int ret = DIGEST_OK;
+
+    (void)memset(block, 0, DIGEST_SHA256_BLOCK_SIZE);
+    if (keylen > DIGEST_SHA256_BLOCK_SIZE)
+    {
+        ret = DIGEST_Sha256(key, keylen, block);
+    }
+    else if (keylen > 0U)
+    {
+        (void)memcpy(block, key, keylen);
+    }
+    return ret;
+}
+
+static void digest_hmac_pad(uint8_t block[DIGEST_SHA256_BLOCK_SIZE], uint8_t pad)
+{
+    uint32_t i;
+
+    for (i = 0; i < DIGEST_SHA256_BLOCK_SIZE; i++)
+    {
+        block[i] ^= pad;
+    }
+}
+
+int DIGEST_HmacSha256Starts(digest_hmac_sha256_ctx_t *ctx, const uint8_t *key, size_t keylen)
+{
+    uint8_t block[DIGEST_SHA256_BLOCK_SIZE];
+    int ret;
+
+    if ((ctx == NULL) || ((key == NULL) && (keylen != 0U)))
+    {
+        return DIGEST_ERR_BAD_INPUT;
+    }
+
+    ret = digest_hmac_prepare_key(key, keylen, block);
+
+    digest_hmac_pad(block, HMAC_IPAD);
+    if (ret == DIGEST_OK)
+    {
+        ret = DIGEST_Sha256Starts(&ctx->ipad, 0);
+    }
+    if (ret == DIGEST_OK)
+    {
+        ret = DIGEST_Sha256Update(&ctx->ipad, block, sizeof(block));
+    }
+
+    digest_hmac_pad(block, HMAC_IPAD ^ HMAC_OPAD);
+    if (ret == DIGEST_OK)
+    {
+        ret = DIGEST_Sha256Starts(&ctx->opad, 0);
+    }
+    if (ret == DIGEST_OK)
+    {
+        ret = DIGEST_Sha256Update(&ctx->opad, block, sizeof(block));
+    }
+
+    (void)memset(block, 0, sizeof(block));
+    DIGEST_HmacSha256Reset(ctx);
+    return ret;
+}
+
+int DIGEST_HmacSha256Update(digest_hmac_sha256_ctx_t *ctx, const uint8_t *input, size_t ilen)
+{
+    if (ctx == NULL)
+    {
+        return DIGEST_ERR_BAD_INPUT;
+    }
+    return DIGEST_Sha256Update(&ctx->inner, input, ilen);
+}
+
+int DIGEST_HmacSha256Finish(digest_hmac_sha256_ctx_t *ctx, uint8_t output[DIGEST_SHA256_SIZE])
+{
+    digest_sha256_ctx_t outer;
+    uint8_t innerHash[DIGEST_SHA256_SIZE];
+    int ret;
+
+    if ((ctx == NULL) || (output == NULL))
+    {
+        return DIGEST_ERR_BAD_INPUT;
+    }
+
+    ret = DIGEST_Sha256Finish(&ctx->inner, innerHash);
+    if (ret == DIGEST_OK)
+    {
+        DIGEST_Sha256Clone(&outer, &ctx->opad);
+        ret = DIGEST_Sha256Update(&outer, innerHash, sizeof(innerHash));
+    }
+    if (ret == DIGEST_OK)
+    {
+        ret = DIGEST_Sha256Finish(&outer, output);
+    }
+
+    DIGEST_Sha256FreeCtx(&outer);
+    (void)memset(innerHash, 0, sizeof(innerHash));
+    return ret;
+}
+
+void DIGEST_HmacSha256Reset(digest_hmac_sha256_ctx_t *ctx)
+{
+    DIGEST_Sha256Clone(&ctx->inner, &ctx->ipad);
+}
+
+void DIGEST_HmacSha256Free(digest_hmac_sha256_ctx_t *ctx)
+{
+    if (ctx == NULL)
+    {
+        return;
+    }
+    DIGEST_Sha256FreeCtx(&ctx->inner);
+    DIGEST_Sha256FreeCtx(&ctx->ipad);
+    DIGEST_Sha256FreeCtx(&ctx->opad);
+}
+
+int DIGEST_HmacSha256(const uint8_t *key,
+                      size_t keylen,
+                      const uint8_t *input,
+                      size_t ilen,
+                      uint8_t output[DIGEST_SHA256_SIZE])
+{
+    uint8_t block[DIGEST_SHA256_BLOCK_SIZE];
+    uint8_t innerHash[DIGEST_SHA256_SIZE];
+    int ret;
+
+    if (((key == NULL) && (keylen != 0U)) || ((input == NULL) && (ilen != 0U)) || (output == NULL))
+    {
+        return DIGEST_ERR_BAD_INPUT;
+    }
+
+    /* Inner and outer hashes are each complete in one engine ownership, which
+     * keeps the hardware path available on parts without RELOAD. */
+    ret = digest_hmac_prepare_key(key, keylen, block);
+    digest_hmac_pad(block, HMAC_IPAD);
+    if (ret == DIGEST_OK)
+    {
+        ret = digest_sha256_two_part(block, sizeof(block), input, ilen, innerHash);
+    }
+    digest_hmac_pad(block, HMAC_IPAD ^ HMAC_OPAD);
+    if (ret == DIGEST_OK)
+    {
+        ret = digest_sha256_two_part(block, sizeof(block), innerHash, sizeof(innerHash), output);
+    }
+
+    (void)memset(block, 0, sizeof(block));
+    (void)memset(innerHash, 0, sizeof(innerHash));
+    return ret;
+}
+
+/*******************************************************************************
+ * Self test
+ ******************************************************************************/
+/* FIPS 180-2 B.1 and B.2 */
+static const char s_katMsg1[] = "abc";
+static const char s_katMsg2[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+static const uint8_t s_katSha256[2][DIGEST_SHA256_SIZE] = {
+    {0xBA, 0x78, 0x16, 0xBF, 0x8F, 0x01, 0xCF, 0xEA, 0x41, 0x41, 0x40, 0xDE, 0x5D, 0xAE, 0x22, 0x23,
+     0xB0, 0x03, 0x61, 0xA3, 0x96, 0x17, 0x7A, 0x9C, 0xB4, 0x10, 0xFF, 0x61, 0xF2, 0x00, 0x15, 0xAD},
+    {0x24, 0x8D, 0x6A, 0x61, 0xD2, 0x06, 0x38, 0xB8, 0xE5, 0xC0, 0x26, 0x93, 0x0C, 0x3E, 0x60, 0x39,
+     0xA3, 0x3C, 0xE4, 0x59, 0x64, 0xFF, 0x21, 0x67, 0xF6, 0xEC, 0xED, 0xD4, 0x19, 0xDB, 0x06, 0xC1},
+};
+
+static const uint8_t s_katSha224[DIGEST_SHA224_SIZE] = {
+    0x23, 0x09, 0x7D, 0x22, 0x34, 0x05, 0xD8, 0x22, 0x86, 0x42, 0xA4, 0x77, 0xBD, 0xA2,
+    0x55, 0xB3, 0x2A, 0xAD, 0xBC, 0xE4, 0xBD, 0xA0, 0xB3, 0xF7, 0xE3, 0x6C, 0x9D, 0xA7};
+
+/* RFC 4231 test case 2 */
+static const char s_katHmacKey[]  = "Jefe";
+static const char s_katHmacData[] = "what do ya want for nothing?";
+static const uint8_t s_katHmac[DIGEST_SHA256_SIZE] = {
+    0x5B, 0xDC, 0xC1, 0x46, 0xBF, 0x60, 0x75, 0x4E, 0x6A, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xC7,
+    0x5A, 0x00, 0x3F, 0x08, 0x9D, 0x27, 0x39, 0x83, 0x9D, 0xEC, 0x58, 0xB9, 0x64, 0xEC, 0x38, 0x43};
+
+int DIGEST_SelfTest(void)
+{
+    const char *msgs[2] = {s_katMsg1, s_katMsg2};
+    digest_sha256_ctx_t ctx;
+    digest_sha256_ctx_t saved;
+    digest_hmac_sha256_ctx_t hmac;
+    uint8_t out[DIGEST_SHA256_SIZE];
+    uint32_t i;
+    int ret = 0;
+
+    for (i = 0; (i < 2U) && (ret == 0); i++)
+    {
+        size_t len = strlen(msgs[i]);
+
+        /* one-shot path */
+        if ((DIGEST_Sha256((const uint8_t *)msgs[i], len, out) != DIGEST_OK) ||
+            (memcmp(out, s_katSha256[i], DIGEST_SHA256_SIZE) != 0))
+        {
+            ret = -1;
+            break;
+        }
+
+        /* multi-part path, split in the middle and saved/restored across the split */
+        DIGEST_Sha256InitCtx(&ctx);
+        DIGEST_Sha256InitCtx(&saved);
+        (void)DIGEST_Sha256Starts(&ctx, 0);
+        (void)DIGEST_Sha256Update(&ctx, (const uint8_t *)msgs[i], len / 2U);
+        DIGEST_Sha256Clone(&saved, &ctx);
+        (void)DIGEST_Sha256Update(&ctx, (const uint8_t *)"garbage", 7U);
+        DIGEST_Sha256Clone(&ctx, &saved);
+        (void)DIGEST_Sha256Update(&ctx, (const uint8_t *)msgs[i] + (len / 2U), len - (len / 2U));
+        if ((DIGEST_Sha256Finish(&ctx, out) != DIGEST_OK) || (memcmp(out, s_katSha256[i], DIGEST_SHA256_SIZE) != 0))
+        {
+            ret = -1;
+        }
+        DIGEST_Sha256FreeCtx(&ctx);
+        DIGEST_Sha256FreeCtx(&saved);
+    }
+
+    if (ret == 0)
+    {
+        DIGEST_Sha256InitCtx(&ctx);
+        (void)DIGEST_Sha256Starts(&ctx, 1);
+        (void)DIGEST_Sha256Update(&ctx, (const uint8_t *)s_katMsg1, strlen(s_katMsg1));
+        if ((DIGEST_Sha256Finish(&ctx, out) != DIGEST_OK) || (memcmp(out, s_katSha224, DIGEST_SHA224_SIZE) != 0))
+        {
+            ret = -1;
+        }
+        DIGEST_Sha256FreeCtx(&ctx);
+    }
+
+    if (ret == 0)
+    {
+        if ((DIGEST_HmacSha256((const uint8_t *)s_katHmacKey, strlen(s_katHmacKey), (const uint8_t *)s_katHmacData,
+                               strlen(s_katHmacData), out) != DIGEST_OK) ||
+            (memcmp(out, s_katHmac, DIGEST_SHA256_SIZE) != 0))
+        {
+            ret = -1;
+        }
+    }
+
+    if (ret == 0)
+    {
+        /* keyed state reused twice, as SAS renewal does */
+        (void)memset(&hmac, 0, sizeof(hmac));
+        (void)DIGEST_HmacSha256Starts(&hmac, (const uint8_t *)s_katHmacKey, strlen(s_katHmacKey));
+        for (i = 0; (i < 2U) && (ret == 0); i++)
+        {
+            (void)DIGEST_HmacSha256Update(&hmac, (const uint8_t *)s_katHmacData, strlen(s_katHmacData));
+            if ((DIGEST_HmacSha256Finish(&hmac, out) != DIGEST_OK) || (memcmp(out, s_katHmac, DIGEST_SHA256_SIZE) != 0))
+            {
+                ret = -1;
+            }
+            DIGEST_HmacSha256Reset(&hmac);
+        }
+        DIGEST_HmacSha256Free(&hmac);
+    }
+
+    return ret;
+}
+
+#if defined(DIGEST_ENABLE_BENCHMARK)
+void DIGEST_Sha256Benchmark(const uint8_t *buf,
+                            size_t len,
+                            uint32_t rounds,
+                            uint32_t (*getTime)(void),
+                            uint32_t *oneShotTime,
+                            uint32_t *streamTime)
+{
+    digest_sha256_ctx_t ctx;
+    uint8_t out[DIGEST_SHA256_SIZE];
+    uint32_t start;
+    uint32_t i;
+    size_t off;
+
+    start = getTime();
+    for (i = 0; i < rounds; i++)
+    {
+        (void)DIGEST_Sha256(buf, len, out);
+    }
+    *oneShotTime = getTime() - start;
+
+    start = getTime();
+    for (i = 0; i < rounds; i++)
+    {
+        DIGEST_Sha256InitCtx(&ctx);
+        (void)DIGEST_Sha256Starts(&ctx, 0);
+        for (off = 0; off < len; off += DIGEST_SHA256_BLOCK_SIZE)
+        {
+            size_t chunk = ((len - off) < DIGEST_SHA256_BLOCK_SIZE) ? (len - off) : DIGEST_SHA256_BLOCK_SIZE;
+            (void)DIGEST_Sha256Update(&ctx, buf + off, chunk);
+        }
+        (void)DIGEST_Sha256Finish(&ctx, out);
+    }
+    *streamTime = getTime() - start;
+    DIGEST_Sha256FreeCtx(&ctx);
+}
+#endif /* DIGEST_ENABLE_BENCHMARK */
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2020 NXP
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef KSDK_DIGEST_H
+#define KSDK_DIGEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(DIGEST_DISABLE_HASHCRYPT)
+#include "fsl_device_registers.h"
+#endif
+
+/*
+ * Hardware backend selection.
+ *
+ * The HASHCRYPT engine is used for SHA-256 whenever it is present on the SoC,
+ * unless DIGEST_DISABLE_HASHCRYPT is defined (host builds, debugging).
+ *
+ * Engines without the RELOAD feature cannot resume a running hash after another
+ * operation used the engine, so on those parts only operations that complete in
+ * a single call (DIGEST_Sha256() and DIGEST_HmacSha256()) are accelerated and
+ * multi-part contexts run on the portable software implementation.
+ */
+#if !defined(DIGEST_DISABLE_HASHCRYPT) && defined(FSL_FEATURE_SOC_HASHCRYPT_COUNT) && \
+    (FSL_FEATURE_SOC_HASHCRYPT_COUNT > 0)
+#include "fsl_hashcrypt.h"
+#define DIGEST_HAS_HASHCRYPT 1
+#if defined(FSL_FEATURE_HASHCRYPT_HAS_RELOAD_FEATURE) && (FSL_FEATURE_HASHCRYPT_HAS_RELOAD_FEATURE > 0)
+#define DIGEST_HAS_HASHCRYPT_RELOAD 1
+#else
+#define DIGEST_HAS_HASHCRYPT_RELOAD 0
+#endif
+#else
+#define DIGEST_HAS_HASHCRYPT        0
+#define DIGEST_HAS_HASHCRYPT_RELOAD 0
+#endif
+
+#define DIGEST_SHA256_BLOCK_SIZE 64U
+#define DIGEST_SHA256_SIZE       32U
+#define DIGEST_SHA224_SIZE       28U
+
+#define DIGEST_OK                  (0)
+#define DIGEST_ERR_BAD_INPUT       (-0x0074)
+#define DIGEST_ERR_HW_ACCEL_FAILED (-0x0037)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Backend currently owning a multi-part context. */
+typedef enum _digest_backend
+{
+    kDIGEST_BackendSoftware = 0U, /*!< Portable C implementation. */
+    kDIGEST_BackendHashcrypt,     /*!< HASHCRYPT engine, running hash saved in the context. */
+} digest_backend_t;
+
+/*! @brief Software SHA-256 state. */
+typedef struct _digest_sha256_sw
+{
+    uint32_t state[8];                         /*!< intermediate hash value */
+    uint64_t total;                            /*!< number of bytes processed so far */
+    uint8_t buffer[DIGEST_SHA256_BLOCK_SIZE]; /*!< pending partial block */
+} digest_sha256_sw_t;
+
+/*!
+ * @brief Multi-part SHA-256/SHA-224 context.
+ *
+ * The whole state lives in the structure for both backends, so a context can be
+ * saved and restored at any point with DIGEST_Sha256Clone().
+ */
+typedef struct _digest_sha256_ctx
+{
+    digest_backend_t backend; /*!< backend selected by DIGEST_Sha256Starts() */
+    uint8_t is224;            /*!< 1 for SHA-224, 0 for SHA-256 */
+    union
+    {
+        digest_sha256_sw_t sw;
+#if DIGEST_HAS_HASHCRYPT
+        hashcrypt_hash_ctx_t hw;
+#endif
+    } u;
+} digest_sha256_ctx_t;
+
+/*!
+ * @brief Multi-part HMAC-SHA256 context.
+ *
+ * The keyed inner and outer states are kept after DIGEST_HmacSha256Starts(), so
+ * repeated MACs with the same key (SAS renewal, TLS PRF) skip the key blocks.
+ */
+typedef struct _digest_hmac_sha256_ctx
+{
+    digest_sha256_ctx_t inner;    /*!< running inner hash */
+    digest_sha256_ctx_t ipad;     /*!< saved state after the ipad block */
+    digest_sha256_ctx_t opad;     /*!< saved state after the opad block */
+} digest_hmac_sha256_ctx_t;
+
+/*!
+ * @brief Creates the engine lock. Called once from CRYPTO_InitHardware().
+ */
+void DIGEST_Init(void);
+
+#if DIGEST_HAS_HASHCRYPT
+/*!
+ * @brief Serialises HASHCRYPT between SHA and AES users.
+ *
+ * No-op before the scheduler starts. Not recursive.
+ */
+void DIGEST_EngineLock(void);
+void DIGEST_EngineUnlock(void);
+#endif
+
+void DIGEST_Sha256InitCtx(digest_sha256_ctx_t *ctx);
+void DIGEST_Sha256FreeCtx(digest_sha256_ctx_t *ctx);
+int DIGEST_Sha256Starts(digest_sha256_ctx_t *ctx, int is224);
+int DIGEST_Sha256Update(digest_sha256_ctx_t *ctx, const uint8_t *input, size_t ilen);
+int DIGEST_Sha256Finish(digest_sha256_ctx_t *ctx, uint8_t *output);
+
+/*!
+ * @brief Saves (or restores) a multi-part context by copying it.
+ *
+ * Both contexts may be updated independently afterwards.
+ */
+void DIGEST_Sha256Clone(digest_sha256_ctx_t *dst, const digest_sha256_ctx_t *src);
+
+/*!
+ * @brief Hashes a complete message in one call.
+ *
+ * Accelerated on every HASHCRYPT part because the engine is held for the whole call.
+ */
+int DIGEST_Sha256(const uint8_t *input, size_t ilen, uint8_t output[DIGEST_SHA256_SIZE]);
+
+int DIGEST_HmacSha256Starts(digest_hmac_sha256_ctx_t *ctx, const uint8_t *key, size_t keylen);
+int DIGEST_HmacSha256Update(digest_hmac_sha256_ctx_t *ctx, const uint8_t *input, size_t ilen);
+int DIGEST_HmacSha256Finish(digest_hmac_sha256_ctx_t *ctx, uint8_t output[DIGEST_SHA256_SIZE]);
+/*! @brief Restores the keyed state so a new message can be authenticated with the same key. */
+void DIGEST_HmacSha256Reset(digest_hmac_sha256_ctx_t *ctx);
+void DIGEST_HmacSha256Free(digest_hmac_sha256_ctx_t *ctx);
+
+/*!
+ * @brief Computes HMAC-SHA256 of a complete message in one call.
+ */
+int DIGEST_HmacSha256(const uint8_t *key,
+                      size_t keylen,
+                      const uint8_t *input,
+                      size_t ilen,
+                      uint8_t output[DIGEST_SHA256_SIZE]);
+
+/*!
+ * @brief Known-answer tests (FIPS 180-2 and RFC 4231) for every compiled backend.
+ *
+ * @return 0 when all vectors match.
+ */
+int DIGEST_SelfTest(void);
+
+#if defined(DIGEST_ENABLE_BENCHMARK)
+/*!
+ * @brief Hashes @p len bytes @p rounds times with the one-shot and multi-part paths.
+ *
+ * @param getTime free-running time base provided by the caller (cycle counter on
+ *                target, clock() on host).
+ * @param oneShotTime elapsed time of the DIGEST_Sha256() rounds.
+ * @param streamTime elapsed time of the multi-part rounds (64-byte updates).
+ */
+void DIGEST_Sha256Benchmark(const uint8_t *buf,
+                            size_t len,
+                            uint32_t rounds,
+                            uint32_t (*getTime)(void),
+                            uint32_t *oneShotTime,
+                            uint32_t *streamTime);
+#endif /* DIGEST_ENABLE_BENCHMARK */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KSDK_DIGEST_H */
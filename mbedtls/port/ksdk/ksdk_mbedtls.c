@@ -30,6 +30,7 @@
 #if defined(FSL_FEATURE_SOC_HASHCRYPT_COUNT) && (FSL_FEATURE_SOC_HASHCRYPT_COUNT > 0)
 #include "fsl_hashcrypt.h"
 #endif
+#include "ksdk_digest.h"
 #if defined(FSL_FEATURE_SOC_TRNG_COUNT) && (FSL_FEATURE_SOC_TRNG_COUNT > 0)
 #include "fsl_trng.h"
 #elif defined(FSL_FEATURE_SOC_RNG_COUNT) && (FSL_FEATURE_SOC_RNG_COUNT > 0)
@@ -103,7 +104,7 @@ static bool crypto_key_is_loaded(const void *ctx)
 }
 #endif
 
-#if defined(MBEDTLS_SHA1_ALT) || defined(MBEDTLS_SHA256_ALT)
+#if defined(MBEDTLS_SHA1_ALT) || (defined(MBEDTLS_SHA256_ALT) && !defined(MBEDTLS_FREESCALE_HASHCRYPT_SHA256))
 /* Implementation that should never be optimized out by the compiler */
 static void mbedtls_zeroize(void *v, size_t n)
 {
@@ -157,6 +158,8 @@ void CRYPTO_InitHardware(void)
     /* Initialize HASHCRYPT */
     HASHCRYPT_Init(HASHCRYPT);
 #endif
+    /* HASHCRYPT lock shared by ksdk_digest and the HASHCRYPT AES port */
+    DIGEST_Init();
     { /* Init RNG module.*/
 #if defined(FSL_FEATURE_SOC_TRNG_COUNT) && (FSL_FEATURE_SOC_TRNG_COUNT > 0)
 #if defined(TRNG)
@@ -4273,22 +4276,25 @@ int mbedtls_sha256_finish_ret(mbedtls_sha256_context *ctx, unsigned char output[
 #elif defined(MBEDTLS_FREESCALE_HASHCRYPT_SHA256)
 #include "mbedtls/sha256.h"
 
+/*
+ * HASHCRYPT SHA-256 is routed through ksdk_digest, which owns the engine lock,
+ * keeps the complete state in the context (so mbedtls_sha256_clone() works for
+ * the TLS transcript) and falls back to software where the engine cannot resume
+ * a running hash.
+ */
 void mbedtls_sha256_init(mbedtls_sha256_context *ctx)
 {
-    memset(ctx, 0, sizeof(mbedtls_sha256_context));
+    DIGEST_Sha256InitCtx(ctx);
 }
 
 void mbedtls_sha256_free(mbedtls_sha256_context *ctx)
 {
-    if (ctx == NULL)
-        return;
-
-    mbedtls_zeroize(ctx, sizeof(mbedtls_sha256_context));
+    DIGEST_Sha256FreeCtx(ctx);
 }
 
 void mbedtls_sha256_clone(mbedtls_sha256_context *dst, const mbedtls_sha256_context *src)
 {
-    memcpy(dst, src, sizeof(*dst));
+    DIGEST_Sha256Clone(dst, src);
 }
 
 /*
@@ -4296,12 +4302,7 @@ void mbedtls_sha256_clone(mbedtls_sha256_context *dst, const mbedtls_sha256_cont
  */
 int mbedtls_sha256_starts_ret(mbedtls_sha256_context *ctx, int is224)
 {
-    status_t ret = kStatus_Fail;
-    if (!is224) /* SHA-224 not supported */
-    {
-        ret = HASHCRYPT_SHA_Init(HASHCRYPT, ctx, kHASHCRYPT_Sha256);
-    }
-    if (ret != kStatus_Success)
+    if (DIGEST_Sha256Starts(ctx, is224) != DIGEST_OK)
     {
         return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
     }
@@ -4310,9 +4311,7 @@ int mbedtls_sha256_starts_ret(mbedtls_sha256_context *ctx, int is224)
 
 int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx, const unsigned char data[64])
 {
-    status_t ret = kStatus_Fail;
-    ret = HASHCRYPT_SHA_Update(HASHCRYPT, ctx, data, 64);
-    if (ret != kStatus_Success)
+    if (DIGEST_Sha256Update(ctx, data, 64) != DIGEST_OK)
     {
         return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
     }
@@ -4324,9 +4323,7 @@ int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx, const unsigned
  */
 int mbedtls_sha256_update_ret(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen)
 {
-    status_t ret = kStatus_Fail;
-    ret = HASHCRYPT_SHA_Update(HASHCRYPT, ctx, input, ilen);
-    if (ret != kStatus_Success)
+    if (DIGEST_Sha256Update(ctx, input, ilen) != DIGEST_OK)
     {
         return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
     }
@@ -4338,10 +4335,7 @@ int mbedtls_sha256_update_ret(mbedtls_sha256_context *ctx, const unsigned char *
  */
 int mbedtls_sha256_finish_ret(mbedtls_sha256_context *ctx, unsigned char output[32])
 {
-    status_t ret = kStatus_Fail;
-    size_t outputSize = 32;
-    ret = HASHCRYPT_SHA_Finish(HASHCRYPT, ctx, output, &outputSize);
-    if (ret != kStatus_Success)
+    if (DIGEST_Sha256Finish(ctx, output) != DIGEST_OK)
     {
         return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
     }
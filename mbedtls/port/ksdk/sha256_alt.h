@@ -68,10 +68,12 @@ extern "C" {
 
 #elif defined(MBEDTLS_FREESCALE_HASHCRYPT_SHA256)
 
+#include "ksdk_digest.h"
+
 /**
  * \brief          SHA-256 context structure
  */
-#define mbedtls_sha256_context hashcrypt_hash_ctx_t
+#define mbedtls_sha256_context digest_sha256_ctx_t
 
 #endif /* MBEDTLS_FREESCALE_LTC_SHA256 */
 
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2019-2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "azure_iotc_sas.h"
+#include "msft_Azure_IoT.h"
+#include <mbedtls/base64.h>
+
+/* Retry interval when a renewal could not be computed */
+#define AZURE_SAS_RETRY_S           60U
+
+#define SECONDS_TO_TICKS(s)         ((TickType_t)((s) * configTICK_RATE_HZ))
+
+/* Advances the token clock by whole seconds, the remainder is kept for the next call */
+static unsigned long prvSasNow( AzureSasToken_t * pxSas )
+{
+	TickType_t xElapsed = xTaskGetTickCount() - pxSas->xClockTick;
+	TickType_t xSeconds = xElapsed / configTICK_RATE_HZ;
+
+	pxSas->ulClock += (unsigned long) xSeconds;
+	pxSas->xClockTick += xSeconds * configTICK_RATE_HZ;
+
+	return pxSas->ulClock;
+}
+
+static void prvSasRenewTimerCallback( TimerHandle_t xTimer )
+{
+	AzureSasToken_t * pxSas = (AzureSasToken_t *) pvTimerGetTimerID( xTimer );
+	uint32_t ulNextRenewal = AZURE_SAS_RETRY_S;
+
+	/* Runs in the timer service task, so the telemetry task only sees the
+	 * already published token when it reconnects. */
+	if( AzureSas_Refresh( pxSas ) )
+	{
+		ulNextRenewal = pxSas->ulLifetime - pxSas->ulRenewMargin;
+
+		if( pxSas->pxRenewedCallback != NULL )
+		{
+			pxSas->pxRenewedCallback( pxSas->pvCallbackContext );
+		}
+	}
+	else
+	{
+		AZURE_PRINTF( ("SAS token renewal failed, retry in %d s\r\n", AZURE_SAS_RETRY_S) );
+	}
+
+	xTimerChangePeriod( xTimer, SECONDS_TO_TICKS( ulNextRenewal ), 0 );
+}
+
+bool AzureSas_Init(AzureSasToken_t * pxSas, const char * pcResource, const char * pcKeyName, const char * pcKey, size_t xKeyLength)
+{
+	uint8_t ucKeyDecoded[BUFFER_SIZE_128];
+	size_t xDecodedLength = 0;
+	int res;
+
+	memset(pxSas, 0, sizeof(AzureSasToken_t));
+	pxSas->ulLifetime = AZURE_SAS_LIFETIME_S;
+	pxSas->ulRenewMargin = AZURE_SAS_RENEW_MARGIN_S;
+	pxSas->ulClock = AZURE_SAS_CLOCK();
+	pxSas->xClockTick = xTaskGetTickCount();
+
+	if( (strlen(pcResource) >= sizeof(pxSas->cResource)) ||
+		((pcKeyName != NULL) && (strlen(pcKeyName) >= sizeof(pxSas->cKeyName))) )
+	{
+		return false;
+	}
+	strcpy(pxSas->cResource, pcResource);
+	if( pcKeyName != NULL )
+	{
+		strcpy(pxSas->cKeyName, pcKeyName);
+	}
+
+	/* Decode the key and key the HMAC once, renewals only hash the string to sign */
+	res = mbedtls_base64_decode(ucKeyDecoded, sizeof(ucKeyDecoded), &xDecodedLength,
+								(const unsigned char *) pcKey, xKeyLength);
+	if( (res != 0) || (xDecodedLength == 0) )
+	{
+		AZURE_PRINTF( ("Error: SAS key decoding has failed with %d return value.\r\n", res) );
+		return false;
+	}
+
+	res = DIGEST_HmacSha256Starts(&pxSas->xHmac, ucKeyDecoded, xDecodedLength);
+	memset(ucKeyDecoded, 0, sizeof(ucKeyDecoded));
+
+	return (res == DIGEST_OK);
+}
+
+bool AzureSas_Refresh(AzureSasToken_t * pxSas)
+{
+	char cStringToSign[BUFFER_SIZE_256];
+	uint8_t ucSignature[DIGEST_SHA256_SIZE];
+	char cSignatureB64[BUFFER_SIZE_64];
+	char cSignatureUrl[BUFFER_SIZE_256];
+	uint8_t ucNext = pxSas->ucCurrent ^ 1U;
+	unsigned long ulExpiry = prvSasNow(pxSas) + pxSas->ulLifetime;
+	size_t size;
+	int res;
+
+	/* Create data to be signed with the key containing the expiry time */
+	size = snprintf(cStringToSign, sizeof(cStringToSign), "%s\n%lu000", pxSas->cResource, ulExpiry);
+	if( size >= sizeof(cStringToSign) )
+	{
+		return false;
+	}
+
+	/* Hash the data to be signed with the keyed HMAC state */
+	DIGEST_HmacSha256Reset(&pxSas->xHmac);
+	res = DIGEST_HmacSha256Update(&pxSas->xHmac, (const uint8_t *) cStringToSign, size);
+	if( res == DIGEST_OK )
+	{
+		res = DIGEST_HmacSha256Finish(&pxSas->xHmac, ucSignature);
+	}
+	if( res != DIGEST_OK )
+	{
+		AZURE_PRINTF( ("Error: SAS signature has failed with %d return value.\r\n", res) );
+		return false;
+	}
+
+	/* Encode the signed data */
+	size = 0;
+	res = mbedtls_base64_encode((unsigned char *) cSignatureB64, sizeof(cSignatureB64), &size,
+								ucSignature, sizeof(ucSignature));
+	memset(ucSignature, 0, sizeof(ucSignature));
+	if( (res != 0) || (urlEncodeTo(cSignatureB64, size, cSignatureUrl, sizeof(cSignatureUrl)) == 0) )
+	{
+		return false;
+	}
+
+	/* Build the token in the buffer not currently published */
+	if( pxSas->cKeyName[0] != 0 )
+	{
+		size = snprintf(pxSas->cToken[ucNext], sizeof(pxSas->cToken[ucNext]),
+						"SharedAccessSignature "
+						"sr=%s&sig=%s&se=%lu000&skn=%s",
+						pxSas->cResource, cSignatureUrl, ulExpiry, pxSas->cKeyName);
+	}
+	else
+	{
+		size = snprintf(pxSas->cToken[ucNext], sizeof(pxSas->cToken[ucNext]),
+						"SharedAccessSignature "
+						"sr=%s&sig=%s&se=%lu000",
+						pxSas->cResource, cSignatureUrl, ulExpiry);
+	}
+	if( size >= sizeof(pxSas->cToken[ucNext]) )
+	{
+		return false;
+	}
+
+	pxSas->ulExpiry = ulExpiry;
+	pxSas->ulRenewCount++;
+	pxSas->ucCurrent = ucNext;
+
+	return true;
+}
+
+bool AzureSas_StartRenewal(AzureSasToken_t * pxSas, uint32_t ulLifetime, uint32_t ulRenewMargin, AzureSasRenewedCallback_t pxCallback, void * pvContext)
+{
+	if( ulRenewMargin >= ulLifetime )
+	{
+		return false;
+	}
+
+	pxSas->ulLifetime = ulLifetime;
+	pxSas->ulRenewMargin = ulRenewMargin;
+	pxSas->pxRenewedCallback = pxCallback;
+	pxSas->pvCallbackContext = pvContext;
+
+	if( pxSas->ulRenewCount == 0U )
+	{
+		if( !AzureSas_Refresh(pxSas) )
+		{
+			return false;
+		}
+	}
+
+	if( pxSas->xRenewTimer == NULL )
+	{
+		pxSas->xRenewTimer = xTimerCreate( "SAS Renew Timer",
+										   SECONDS_TO_TICKS( ulLifetime - ulRenewMargin ),
+										   pdFALSE,
+										   ( void * ) pxSas,
+										   prvSasRenewTimerCallback );
+		if( pxSas->xRenewTimer == NULL )
+		{
+			return false;
+		}
+	}
+
+	return ( xTimerChangePeriod( pxSas->xRenewTimer, SECONDS_TO_TICKS( ulLifetime - ulRenewMargin ), 0 ) == pdPASS );
+}
+
+void AzureSas_StopRenewal(AzureSasToken_t * pxSas)
+{
+	if( pxSas->xRenewTimer != NULL )
+	{
+		xTimerStop( pxSas->xRenewTimer, 0 );
+	}
+}
+
+const char * AzureSas_GetToken(const AzureSasToken_t * pxSas)
+{
+	if( pxSas->ulRenewCount == 0U )
+	{
+		return NULL;
+	}
+	return pxSas->cToken[pxSas->ucCurrent];
+}
+
+void AzureSas_Deinit(AzureSasToken_t * pxSas)
+{
+	if( pxSas->xRenewTimer != NULL )
+	{
+		xTimerDelete( pxSas->xRenewTimer, 0 );
+		pxSas->xRenewTimer = NULL;
+	}
+	DIGEST_HmacSha256Free(&pxSas->xHmac);
+	memset(pxSas->cToken, 0, sizeof(pxSas->cToken));
+	pxSas->ulRenewCount = 0U;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2019-2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef IOTC_AZURE_IOTC_SAS_H_
+#define IOTC_AZURE_IOTC_SAS_H_
+
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "timers.h"
+#include "ksdk_digest.h"
+#include "azure_iotc_utils.h"
+
+/*
+ * @brief SAS token lifetime and how long before expiry the token is renewed
+ */
+#define AZURE_SAS_LIFETIME_S        21600U
+#define AZURE_SAS_RENEW_MARGIN_S    1800U
+
+/*
+ * @brief Clock used for the "se" field of the token. Overridable for host builds.
+ *
+ * It is read once at init; later tokens add the uptime elapsed since then, so each
+ * renewal moves the expiry forward even while getNow() has no network time behind it.
+ */
+#ifndef AZURE_SAS_CLOCK
+#define AZURE_SAS_CLOCK()           getNow()
+#endif
+
+typedef void (*AzureSasRenewedCallback_t)(void * pvContext);
+
+/*
+ * @brief Cached SAS token with scheduled renewal.
+ *
+ * The signing key is decoded and keyed into the HMAC state once at init, the
+ * token is rebuilt only when the renewal timer fires, and readers always get the
+ * cached string: reconnecting never recomputes the signature. Two token buffers
+ * are used so the one handed to a connect in progress is not overwritten.
+ */
+typedef struct AZURE_SAS_TOKEN
+{
+	char cResource[BUFFER_SIZE_256];            /* URL-encoded "sr" value */
+	char cKeyName[BUFFER_SIZE_32];              /* "skn" value, empty for device keys */
+	char cToken[2][BUFFER_SIZE_256];
+	volatile uint8_t ucCurrent;                 /* index of the published token */
+	unsigned long ulExpiry;                     /* "se" of the published token */
+	unsigned long ulClock;                      /* AZURE_SAS_CLOCK() at init plus elapsed seconds */
+	TickType_t xClockTick;                      /* tick count ulClock was last advanced at */
+	uint32_t ulLifetime;
+	uint32_t ulRenewMargin;
+	uint32_t ulRenewCount;                      /* number of signatures computed */
+	digest_hmac_sha256_ctx_t xHmac;
+	TimerHandle_t xRenewTimer;
+	AzureSasRenewedCallback_t pxRenewedCallback;
+	void * pvCallbackContext;
+} AzureSasToken_t;
+
+bool AzureSas_Init(AzureSasToken_t * pxSas, const char * pcResource, const char * pcKeyName, const char * pcKey, size_t xKeyLength);
+bool AzureSas_Refresh(AzureSasToken_t * pxSas);
+bool AzureSas_StartRenewal(AzureSasToken_t * pxSas, uint32_t ulLifetime, uint32_t ulRenewMargin, AzureSasRenewedCallback_t pxCallback, void * pvContext);
+void AzureSas_StopRenewal(AzureSasToken_t * pxSas);
+const char * AzureSas_GetToken(const AzureSasToken_t * pxSas);
+void AzureSas_Deinit(AzureSasToken_t * pxSas);
+
+#endif /* IOTC_AZURE_IOTC_SAS_H_ */
@@ -26,6 +26,13 @@
 #define AZURE_IOT_TELEMETRY_TOPIC_FOR_SUB     "devices/%s/messages/events/#"
 #define AZURE_IOT_TELEMETRY_TOPIC_FOR_PUB     "devices/%s/messages/events/"
 
+/* Diagnostics go to the telemetry topic too, tagged so that hub routes can tell them apart */
+#define AZURE_IOT_DIAG_TELEMETRY_TOPIC_FOR_PUB  AZURE_IOT_TELEMETRY_TOPIC_FOR_PUB "type=diag"
+
+/* Message property appended to the telemetry topic, followed by the content encoding.
+ * Preceded by '&' when the topic already carries properties. */
+#define AZURE_IOT_CONTENT_ENCODING_PROPERTY   "%24.ce="
+
 /* Device Method topics */
 #define AZURE_IOT_METHOD_TOPIC_FOR_SUB        "$iothub/methods/#"
 #define AZURE_IOT_METHOD_TOPIC_FOR_PUB        "$iothub/methods/res/%s/?$rid=%d"
@@ -45,8 +52,10 @@
 #define BUFFER_SIZE_2048 2048
 #define BUFFER_SIZE_4096 4096
 
-void generateSasToken(char** ptr_buffer, char* scope_id, size_t scope_id_length, char* device_id, size_t device_id_length, char* key, size_t key_length);
-void getUsernameAndPassword(char** ptr_username, char** ptr_password, char* device_id, size_t device_id_length, char* host_name, size_t host_name_length, char* key, size_t key_length);
+unsigned long getNow(void);
+size_t urlEncodeTo(const char * buffer, size_t length, char * out, size_t out_size);
+bool urlEncode(const char * buffer, size_t length, char ** url_enc_data);
+void getUsername(char** ptr_username, char* device_id, size_t device_id_length, char* host_name, size_t host_name_length);
 bool topic_check(const char* topic, size_t len, char* str, size_t str_len);
 
 #endif /* IOTC_AZURE_IOTC_UTILS_H_ */
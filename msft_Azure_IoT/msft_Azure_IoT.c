@@ -25,8 +25,14 @@
 #include "iot_init.h"
 #include "azure_default_root_certificates.h"
 #include "azure_iotc_utils.h"
+#include "azure_iotc_sas.h"
 #include "iotc_json.h"
 #include "gsm_private.h"
+#include "CellIoT_connmgr.h"
+#include "CellIoT_profile.h"
+#if ( AZURE_COMPRESS_TELEMETRY == 1 )
+#include "CellIoT_compress.h"
+#endif
 
 /* Board specific accelerometer driver include */
 #if defined(BOARD_ACCEL_FXOS)
@@ -166,7 +172,9 @@ typedef enum AZURE_TWIN_TASK_ST
 	AZURE_SM_PUB_SENSOR_TELEMETRY,
 	AZURE_SM_PUB_LOC_TELEMETRY,
 	AZURE_SM_PUB_CELLULAR_TELEMETRY,
+	AZURE_SM_PUB_DIAG_TELEMETRY,			/* CPU, stack and heap profile */
 	AZURE_SM_IDLE,
+	AZURE_SM_RECONNECT,						/* Connection lost, connect again after a back-off */
 	AZURE_SM_STATES_BNDRY
 }Azure_SM_Task;
 
@@ -183,9 +191,19 @@ EventGroupHandle_t xCreatedEventGroup;
 TimerHandle_t xTelemetryPublishTimer;
 EventBits_t uxBits;
 bool bIsStartUpPhase = true;
+/* Set once the hub subscriptions are recorded on xMQTTHandle */
+static bool bHubSubscribed = false;
 #define EVENT_BIT_MASK	( 1 << 0 )
 #define LED_UPDATE_BIT_MASK	( 1 << 1 )
 #define TELEMETRY_PUB_BIT_MASK	( 1 << 2 )
+#define SAS_RENEW_BIT_MASK	( 1 << 3 )
+#define RADIO_AWAKE_BIT_MASK	( 1 << 4 )
+#define MQTT_DISCONNECT_BIT_MASK	( 1 << 5 )
+
+/* Back-off between reconnections, doubled on each failure */
+#define AZURE_RECONNECT_DELAY_MIN_MS	( 5000UL )
+#define AZURE_RECONNECT_DELAY_MAX_MS	( 300000UL )
+static uint32_t ulReconnectDelayMs = AZURE_RECONNECT_DELAY_MIN_MS;
 
 #if defined(BOARD_ACCEL_FXOS) || defined(BOARD_ACCEL_MMA)
 /* Actual state of accelerometer */
@@ -219,12 +237,22 @@ extern void turnOffLed(uint8_t id);
 #define GREEN_LED_ID	1U
 #define BLUE_LED_ID		2U
 
-char* sas_token;
 char* assigned_hub;
 char* username;
-char* password;
 char* operation_id;
 
+#ifdef SAS_KEY
+/* DPS and assigned hub tokens, signed once and renewed ahead of expiry */
+static AzureSasToken_t xDpsSas;
+static AzureSasToken_t xHubSas;
+
+static void prvHubSasRenewed( void * pvContext )
+{
+	( void ) pvContext;
+	xEventGroupSetBits(xCreatedEventGroup, SAS_RENEW_BIT_MASK);
+}
+#endif
+
 
 
 #if defined(BOARD_ACCEL_FXOS) || defined(BOARD_ACCEL_MMA)
@@ -519,6 +547,187 @@ MQTTBool_t Azure_IoT_CallBack(void * pvPublishCallbackContext,
 	return eMQTTTrue;
 }
 
+static void prvRadioAwake( void )
+{
+	xEventGroupSetBits(xCreatedEventGroup, RADIO_AWAKE_BIT_MASK);
+}
+
+/* Connection closed by the MQTT library, e.g. after a lost PINGRESP */
+static BaseType_t prvMqttEvent( void * pvUserData, const MQTTAgentCallbackParams_t * const pxCallbackParams )
+{
+	( void ) pvUserData;
+
+	if( pxCallbackParams->xMQTTEvent == eMQTTAgentDisconnect )
+	{
+		xEventGroupSetBits(xCreatedEventGroup, MQTT_DISCONNECT_BIT_MASK);
+	}
+	return pdFALSE;
+}
+
+/* Connect parameters and SAS token of the DPS endpoint */
+static bool prvSetDpsConnectParams( void )
+{
+#ifdef SAS_KEY
+	char cResource[256];
+
+	AzureSas_Deinit(&xDpsSas);
+	memset(cResource, 0, sizeof(cResource));
+	snprintf(cResource, sizeof(cResource), "%s%%2Fregistrations%%2F", clientcredentialAZURE_IOT_SCOPE_ID);
+	if( (urlEncodeTo(clientcredentialAZURE_IOT_DEVICE_ID, strlen(clientcredentialAZURE_IOT_DEVICE_ID),
+					 cResource + strlen(cResource), sizeof(cResource) - strlen(cResource)) == 0) ||
+		!AzureSas_Init(&xDpsSas, cResource, "registration",
+					   keyDEVICE_SAS_PRIMARY_KEY, strlen(keyDEVICE_SAS_PRIMARY_KEY)) ||
+		!AzureSas_Refresh(&xDpsSas) )
+	{
+		return false;
+	}
+#endif
+
+    memset( &xConnectParams, 0x00, sizeof( xConnectParams ) );
+    xConnectParams.pcURL = clientcredentialAZURE_MQTT_BROKER_ENDPOINT;
+    xConnectParams.usPort = clientcredentialAZURE_MQTT_BROKER_PORT;
+
+    xConnectParams.xFlags = mqttagentREQUIRE_TLS;
+    xConnectParams.pcCertificate = (char *)AZURE_SERVER_ROOT_CERTIFICATE_PEM;
+    xConnectParams.ulCertificateSize = sizeof(AZURE_SERVER_ROOT_CERTIFICATE_PEM);
+    xConnectParams.pxCallback = prvMqttEvent;
+    xConnectParams.pvUserData = NULL;
+
+    xConnectParams.pucClientId = (const uint8_t *)(clientcredentialAZURE_IOT_DEVICE_ID);
+    xConnectParams.usClientIdLength = (uint16_t)strlen(clientcredentialAZURE_IOT_DEVICE_ID);
+#if SSS_USE_FTR_FILE
+    xConnectParams.cUserName = clientcredentialAZURE_IOT_MQTT_USERNAME;
+    xConnectParams.uUsernamelength = ( uint16_t ) strlen(clientcredentialAZURE_IOT_MQTT_USERNAME);
+#ifdef SAS_KEY
+    xConnectParams.p_password = AzureSas_GetToken(&xDpsSas);
+    xConnectParams.passwordlength = ( uint16_t ) strlen(xConnectParams.p_password);
+#else
+    xConnectParams.p_password = NULL;
+    xConnectParams.passwordlength = 0;
+#endif
+#endif
+
+    return true;
+}
+
+/* Bit n set when the n-th queued message got its PUBACK. The context of each
+ * publish also carries the flush number so that a PUBACK arriving after its
+ * flush was closed is not taken for a message of the next one. Both are written
+ * by the MQTT task through the callback, only touch them in a critical section.
+ */
+static volatile uint32_t ulTelemetryAcked;
+static volatile uint8_t ucTelemetryFlush;
+/* Messages of the open flush given to the MQTT agent, 0 when no flush is open */
+static uint8_t ucTelemetrySent;
+
+static void prvTelemetryAcked( void * pvContext, MQTTAgentReturnCode_t xResult )
+{
+	uint32_t ulContext = (uint32_t) pvContext;
+
+	if( xResult == eMQTTAgentSuccess )
+	{
+		taskENTER_CRITICAL();
+		if( ( ulContext >> 8 ) == ucTelemetryFlush )
+		{
+			ulTelemetryAcked |= 1UL << ( ulContext & 0xFFU );
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+
+/* Sends the queued messages without waiting for each PUBACK in turn, the
+ * acknowledged ones are removed from the queue once the window has drained.
+ * The agent keeps the unacknowledged ones of the persistent session over a
+ * reconnect and sends them again itself, so a flush that timed out stays open
+ * and the next call only waits for it.
+ */
+static bool prvFlushTelemetry( void )
+{
+	const CellIoTTelemetry_t * pxMsg;
+	uint32_t ulAcked;
+	uint8_t ucFlush;
+	uint8_t i;
+#if ( AZURE_COMPRESS_TELEMETRY == 1 )
+	/* Only used by this task, the publish copies them in the MQTT packet */
+	static CellIoTCompressWork_t xCompressWork;
+	static uint8_t ucCompressed[CELLIOT_CONNMGR_PAYLOAD_LEN];
+	static char cCompressedTopic[CELLIOT_CONNMGR_TOPIC_LEN + sizeof("&" AZURE_IOT_CONTENT_ENCODING_PROPERTY CELLIOT_COMPRESS_ENCODING)];
+	size_t xCompressedLen;
+#endif
+
+	/* A flush left open by a timeout is not sent twice */
+	if( ucTelemetrySent == 0U )
+	{
+		taskENTER_CRITICAL();
+		ucFlush = ++ucTelemetryFlush;
+		ulTelemetryAcked = 0;
+		taskEXIT_CRITICAL();
+		for( i = 0; ( i < 32U ) && ( ( pxMsg = CellIoT_connmgr_Peek(i) ) != NULL ); i++ )
+		{
+			memset(&(xPublishParameters), 0x00, sizeof(xPublishParameters));
+			xPublishParameters.pucTopic = (const uint8_t *)pxMsg->cTopic;
+			xPublishParameters.pvData = pxMsg->cPayload;
+			xPublishParameters.usTopicLength = (uint16_t)strlen(pxMsg->cTopic);
+			xPublishParameters.ulDataLength = strlen(pxMsg->cPayload);
+			xPublishParameters.xQoS = eMQTTQoS1;
+#if ( AZURE_COMPRESS_TELEMETRY == 1 )
+			xCompressedLen = 0;
+			if( xPublishParameters.ulDataLength >= CELLIOT_COMPRESS_MIN_LEN )
+			{
+				xCompressedLen = CellIoT_compress_Encode(&xCompressWork, (const uint8_t *)pxMsg->cPayload,
+														 xPublishParameters.ulDataLength, ucCompressed, sizeof(ucCompressed));
+			}
+			if( xCompressedLen != 0 )
+			{
+				snprintf(cCompressedTopic, sizeof(cCompressedTopic), "%s%s%s%s",
+						 pxMsg->cTopic, ( pxMsg->cTopic[strlen(pxMsg->cTopic) - 1] == '/' ) ? "" : "&",
+						 AZURE_IOT_CONTENT_ENCODING_PROPERTY, CELLIOT_COMPRESS_ENCODING);
+				xPublishParameters.pucTopic = (const uint8_t *)cCompressedTopic;
+				xPublishParameters.usTopicLength = (uint16_t)strlen(cCompressedTopic);
+				xPublishParameters.pvData = ucCompressed;
+				xPublishParameters.ulDataLength = xCompressedLen;
+			}
+#endif
+
+			if( MQTT_AGENT_PublishAsync(xMQTTHandle, &xPublishParameters, prvTelemetryAcked,
+										(void *)(((uint32_t) ucFlush << 8) | i), AzureTwinDemoTIMEOUT) != eMQTTAgentSuccess )
+			{
+				break;
+			}
+		}
+		ucTelemetrySent = i;
+	}
+
+	if( MQTT_AGENT_WaitPublishes(xMQTTHandle, AzureTwinDemoTIMEOUT) != eMQTTAgentSuccess )
+	{
+		return false;
+	}
+
+	/* Close this flush: every message got its PUBACK or failed */
+	taskENTER_CRITICAL();
+	ulAcked = ulTelemetryAcked;
+	ulTelemetryAcked = 0;
+	ucTelemetryFlush++;
+	taskEXIT_CRITICAL();
+	ucTelemetrySent = 0;
+
+	/* A message acknowledged after a lost one is sent again with it */
+	while( ( ulAcked & 1UL ) != 0U )
+	{
+		CellIoT_connmgr_Pop();
+		ulAcked >>= 1;
+	}
+	return ( CellIoT_connmgr_Peek(0) == NULL );
+}
+
+/* Queues the telemetry, it is sent once the connection manager wants the radio up */
+static bool prvPublishTelemetry( const char * pcTopic, const char * pcPayload )
+{
+	CellIoT_connmgr_Queue(pcTopic, pcPayload);
+
+	return !CellIoT_connmgr_ShouldFlush() || prvFlushTelemetry();
+}
+
 void prvmcsft_Azure_TwinTask( void * pvParameters )
 {
 	MQTTAgentReturnCode_t xMQTTReturn;
@@ -551,40 +760,16 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 
     MQTT_AGENT_Init();
 
-#ifdef SAS_KEY
-    generateSasToken(&sas_token,
-    				 clientcredentialAZURE_IOT_SCOPE_ID, strlen(clientcredentialAZURE_IOT_SCOPE_ID),
-					 clientcredentialAZURE_IOT_DEVICE_ID, strlen(clientcredentialAZURE_IOT_DEVICE_ID),
-					 keyDEVICE_SAS_PRIMARY_KEY, strlen(keyDEVICE_SAS_PRIMARY_KEY));
-#endif
-
-    memset( &xConnectParams, 0x00, sizeof( xConnectParams ) );
-    xConnectParams.pcURL = clientcredentialAZURE_MQTT_BROKER_ENDPOINT;
-    xConnectParams.usPort = clientcredentialAZURE_MQTT_BROKER_PORT;
-
-    xConnectParams.xFlags = mqttagentREQUIRE_TLS;
-    xConnectParams.pcCertificate = (char *)AZURE_SERVER_ROOT_CERTIFICATE_PEM;
-    xConnectParams.ulCertificateSize = sizeof(AZURE_SERVER_ROOT_CERTIFICATE_PEM);
-    xConnectParams.pxCallback = NULL;
-    xConnectParams.pvUserData = NULL;
-
-    xConnectParams.pucClientId = (const uint8_t *)(clientcredentialAZURE_IOT_DEVICE_ID);
-    xConnectParams.usClientIdLength = (uint16_t)strlen(clientcredentialAZURE_IOT_DEVICE_ID);
-#if SSS_USE_FTR_FILE
-    xConnectParams.cUserName = clientcredentialAZURE_IOT_MQTT_USERNAME;
-    xConnectParams.uUsernamelength = ( uint16_t ) strlen(clientcredentialAZURE_IOT_MQTT_USERNAME);
-#ifdef SAS_KEY
-    xConnectParams.p_password = sas_token ;
-    xConnectParams.passwordlength = ( uint16_t ) strlen(sas_token);
-#else
-    xConnectParams.p_password = NULL;
-    xConnectParams.passwordlength = 0;
-#endif
-#endif
+    if( !prvSetDpsConnectParams() )
+    {
+        configPRINTF(("Failed to generate the DPS SAS token, stopping demo.\r\n"));
+        vTaskDelete(NULL);
+    }
 
     eAzure_SM_Task = AZURE_SM_CONNECT_TO_DPS;
 
     xCreatedEventGroup = xEventGroupCreate();
+    CellIoT_connmgr_SetWakeCallback( prvRadioAwake );
     xTelemetryPublishTimer = xTimerCreate( "Telemetry Publish Timer",
 											pdMS_TO_TICKS(60000),
 											pdFALSE,
@@ -609,7 +794,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
     		    else
     		    {
     		    	AZURE_PRINTF( ("Connection refused!! \r\n") );
-    		    	vTaskDelete(NULL);
+    		    	eAzure_SM_Task = AZURE_SM_RECONNECT;
     		    }
     		    break;
 
@@ -630,9 +815,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 					AZURE_PRINTF( ("Unsuccessfully Subscribe to DPS Registration Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
 
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 				break;
 
@@ -661,8 +844,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 				{
 					AZURE_PRINTF( ("Unsuccessfully Publish to DPS Registration Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 
 				break;
@@ -675,7 +857,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 				}
 				else
 				{
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
     				AZURE_PRINTF ( ("No response received for AZURE_SM_PUB_DPSR state\n") );
 					vTaskDelay(pdMS_TO_TICKS(2000));
 				}
@@ -716,8 +898,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 				{
 					AZURE_PRINTF( ("Unsuccessfully Publish to Get Operation Status Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 
 				break;
@@ -730,7 +911,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 				}
 				else
 				{
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
     				AZURE_PRINTF ( ("No response received for AZURE_SM_PUB_GOS state\n") );
 					vTaskDelay(pdMS_TO_TICKS(2000));
 				}
@@ -738,20 +919,48 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 				break;
 
 			case AZURE_SM_GEN_IOTC_CREDENTIALS:
+				getUsername(&username,
+							clientcredentialAZURE_IOT_DEVICE_ID, strlen(clientcredentialAZURE_IOT_DEVICE_ID),
+							assigned_hub, strlen(assigned_hub));
 #ifdef SAS_KEY
-				getUsernameAndPassword(&username, &password,
-									   clientcredentialAZURE_IOT_DEVICE_ID, strlen(clientcredentialAZURE_IOT_DEVICE_ID),
-									   assigned_hub, strlen(assigned_hub),
-									   keyDEVICE_SAS_PRIMARY_KEY, strlen(keyDEVICE_SAS_PRIMARY_KEY));
+				/* The DPS token is not needed anymore */
+				AzureSas_Deinit(&xDpsSas);
+				AzureSas_Deinit(&xHubSas);
+
+				/* A truncated resource would only be rejected by the hub, no token is signed for it */
+				memset(cTopic, 0, sizeof(cTopic));
+				if( urlEncodeTo(assigned_hub, strlen(assigned_hub), cTopic, sizeof(cTopic)) != 0 )
+				{
+					strncat(cTopic, "%2Fdevices%2F", sizeof(cTopic) - strlen(cTopic) - 1);
+					if( urlEncodeTo(clientcredentialAZURE_IOT_DEVICE_ID, strlen(clientcredentialAZURE_IOT_DEVICE_ID),
+									cTopic + strlen(cTopic), sizeof(cTopic) - strlen(cTopic)) == 0 )
+					{
+						cTopic[0] = 0;
+					}
+				}
+
+				/* Signs the first token, then the timer renews it AZURE_SAS_RENEW_MARGIN_S before expiry */
+				if( (cTopic[0] == 0) ||
+					!AzureSas_Init(&xHubSas, cTopic, NULL,
+								   keyDEVICE_SAS_PRIMARY_KEY, strlen(keyDEVICE_SAS_PRIMARY_KEY)) ||
+					!AzureSas_StartRenewal(&xHubSas, AZURE_SAS_LIFETIME_S, AZURE_SAS_RENEW_MARGIN_S,
+										   prvHubSasRenewed, NULL) )
+				{
+					AzureSas_Deinit(&xHubSas);
+				}
 #endif
 
-				if( !(strlen(username) == 0U && strlen(password) == 0U) )
+				if( (username != NULL) && (strlen(username) != 0U)
+#ifdef SAS_KEY
+					&& (AzureSas_GetToken(&xHubSas) != NULL)
+#endif
+				  )
 				{
 					eAzure_SM_Task = AZURE_SM_CONNECT_TO_ASSIGNED_HUB;
 				}
 				else
 				{
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
     				AZURE_PRINTF ( ("Not able to generate username and password for AZURE_SM_GEN_IOTC_CREDENTIALS state\n") );
 					vTaskDelay(pdMS_TO_TICKS(2000));
 				}
@@ -760,19 +969,24 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 
 			case AZURE_SM_CONNECT_TO_ASSIGNED_HUB:
 
-				/* Disconnect to the generic DPS hub */
+				/* Disconnect to the generic DPS hub, or from the hub to renew the token */
 				MQTT_AGENT_Disconnect(xMQTTHandle, pdMS_TO_TICKS( 10000UL ));
+				xEventGroupClearBits(xCreatedEventGroup, MQTT_DISCONNECT_BIT_MASK);
 
-				if( MQTT_AGENT_Delete( xMQTTHandle ) != eMQTTAgentSuccess )
-				{
-					configPRINTF(("Failed to delete the MQTT Handle, stopping demo.\r\n"));
-					vTaskDelete(NULL);
-				}
-
-				if( MQTT_AGENT_Create( &xMQTTHandle ) != eMQTTAgentSuccess )
+				/* A hub reconnect keeps the handle, it holds the subscriptions of the session */
+				if( !bHubSubscribed )
 				{
-					configPRINTF(("Failed to initialize the MQTT Handle, stopping demo.\r\n"));
-					vTaskDelete(NULL);
+					if( MQTT_AGENT_Delete( xMQTTHandle ) != eMQTTAgentSuccess )
+					{
+						configPRINTF(("Failed to delete the MQTT Handle, stopping demo.\r\n"));
+						vTaskDelete(NULL);
+					}
+
+					if( MQTT_AGENT_Create( &xMQTTHandle ) != eMQTTAgentSuccess )
+					{
+						configPRINTF(("Failed to initialize the MQTT Handle, stopping demo.\r\n"));
+						vTaskDelete(NULL);
+					}
 				}
 
 			    memset( &xConnectParams, 0x00, sizeof( xConnectParams ) );
@@ -782,8 +996,11 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 			    xConnectParams.xFlags = mqttagentREQUIRE_TLS;
 			    xConnectParams.pcCertificate = (char *)AZURE_SERVER_ROOT_CERTIFICATE_PEM;
 			    xConnectParams.ulCertificateSize = sizeof(AZURE_SERVER_ROOT_CERTIFICATE_PEM);
-			    xConnectParams.pxCallback = NULL;
+			    xConnectParams.pxCallback = prvMqttEvent;
 			    xConnectParams.pvUserData = NULL;
+			    /* Saves the SUBSCRIBE round trips, and the agent sends the unacknowledged
+			     * telemetry again with DUP and its packet identifier on a resumed session */
+			    xConnectParams.xPersistentSession = pdTRUE;
 
 			    xConnectParams.pucClientId = (const uint8_t *)(clientcredentialAZURE_IOT_DEVICE_ID);
 			    xConnectParams.usClientIdLength = (uint16_t)strlen(clientcredentialAZURE_IOT_DEVICE_ID);
@@ -791,8 +1008,9 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 			    xConnectParams.cUserName = username;
 			    xConnectParams.uUsernamelength = ( uint16_t ) strlen(username);
 			#ifdef SAS_KEY
-			    xConnectParams.p_password = password;
-			    xConnectParams.passwordlength = ( uint16_t ) strlen(password);
+			    /* Cached token, only re-signed by the renewal timer */
+			    xConnectParams.p_password = AzureSas_GetToken(&xHubSas);
+			    xConnectParams.passwordlength = ( uint16_t ) strlen(xConnectParams.p_password);
 			#else
 			    xConnectParams.p_password = NULL;
 			    xConnectParams.passwordlength = 0;
@@ -806,12 +1024,24 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 				if( eMQTTAgentSuccess == xMQTTReturn )
 				{
 					AZURE_PRINTF( ("Connected to Azure IoT Central Successfully\r\n") );
-					eAzure_SM_Task = AZURE_SM_SUB_C2DM;
+					ulReconnectDelayMs = AZURE_RECONNECT_DELAY_MIN_MS;
+
+					if( bHubSubscribed && ( MQTT_AGENT_SessionPresent( xMQTTHandle ) == pdTRUE ) )
+					{
+						/* The hub kept our subscriptions, no need to send them again */
+						AZURE_PRINTF( ("Session resumed\r\n") );
+						if( true == bIsStartUpPhase)	eAzure_SM_Task = AZURE_SM_PUB_GET_TW_PROPERTIES;
+						else	eAzure_SM_Task = AZURE_SM_IDLE;
+					}
+					else
+					{
+						eAzure_SM_Task = AZURE_SM_SUB_C2DM;
+					}
 				}
 				else
 				{
 					AZURE_PRINTF( ("Connection refused!! \r\n") );
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 				break;
 
@@ -838,9 +1068,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 					AZURE_PRINTF( ("Unsuccessfully Subscribe to Cloud-to-Device Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
 
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 				break;
 
@@ -863,9 +1091,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
                 	AZURE_PRINTF( ("Unsuccessfully Subscribe to Device Twin Response Topic\r\n"));
                 	AZURE_PRINTF( ("Disconnect\r\n"));
 
-                	MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-
-                	eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+                	eAzure_SM_Task = AZURE_SM_RECONNECT;
                 }
 
     			break;
@@ -889,9 +1115,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 					AZURE_PRINTF( ("Unsuccessfully Subscribe to Device Method Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
 
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 
 				break;
@@ -919,8 +1143,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 					AZURE_PRINTF( ("Unsuccessfully Subscribe to Device Telemetry Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
 
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 
 				break;
@@ -937,6 +1160,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 				if( MQTT_AGENT_Subscribe(xMQTTHandle, &xSubscribeParams, AzureTwinDemoTIMEOUT) == eMQTTAgentSuccess)
 				{
 					AZURE_PRINTF( ("Successfully Subscribe to Device Twin Patch Topic\r\n") );
+					bHubSubscribed = true;
 					if( true == bIsStartUpPhase)	eAzure_SM_Task = AZURE_SM_PUB_GET_TW_PROPERTIES;
 					else	eAzure_SM_Task = AZURE_SM_IDLE;
 				}
@@ -945,9 +1169,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 					AZURE_PRINTF( ("Unsuccessfully Subscribe to Device Twin Patch Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
 
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 
 				break;
@@ -974,8 +1196,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
                 {
                 	AZURE_PRINTF( ("Unsuccessfully Publish to GET Device Twin Properties Topic\r\n"));
                 	AZURE_PRINTF( ("Disconnect\r\n"));
-                	MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-                	eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+                	eAzure_SM_Task = AZURE_SM_RECONNECT;
                 }
 
     			break;
@@ -1022,8 +1243,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
                 {
                 	AZURE_PRINTF( ("Unsuccessfully Publish to Device Twin Properties Topic\r\n"));
                 	AZURE_PRINTF( ("Disconnect\r\n"));
-                	MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-                	eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+                	eAzure_SM_Task = AZURE_SM_RECONNECT;
                 }
 
     			break;
@@ -1070,8 +1290,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
                 {
                 	AZURE_PRINTF( ("Unsuccessfully Publish to Device Twin Properties Topic\r\n"));
                 	AZURE_PRINTF( ("Disconnect\r\n"));
-                	MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-                	eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+                	eAzure_SM_Task = AZURE_SM_RECONNECT;
                 }
 
 				break;
@@ -1118,8 +1337,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
                 {
                 	AZURE_PRINTF( ("Unsuccessfully Publish to Device Twin Properties Topic\r\n"));
                 	AZURE_PRINTF( ("Disconnect\r\n"));
-                	MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-                	eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+                	eAzure_SM_Task = AZURE_SM_RECONNECT;
                 }
 
 				break;
@@ -1156,22 +1374,15 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 					accel_vector.A_z = 0;
 				}
 
-				memset(&(xPublishParameters), 0x00, sizeof(xPublishParameters));
 				memset(cTopic, 0, sizeof(cTopic));
 				memset(cPayload, 0, sizeof(cPayload));
 
                 sprintf(cTopic, AZURE_IOT_TELEMETRY_TOPIC_FOR_PUB, clientcredentialAZURE_IOT_DEVICE_ID);
 				sprintf(cPayload, Device_Sensor_Telemetry_JSON, accel_vector.A_x , accel_vector.A_y, accel_vector.A_z, light_sensor, gsm.m.rssi, current, button);
 
-				xPublishParameters.pucTopic = (const uint8_t *)cTopic;
-				xPublishParameters.pvData = cPayload;
-				xPublishParameters.usTopicLength = (uint16_t)strlen(cTopic);
-				xPublishParameters.ulDataLength = strlen(cPayload);
-				xPublishParameters.xQoS = eMQTTQoS0;
-
-				if( MQTT_AGENT_Publish(xMQTTHandle, &xPublishParameters, AzureTwinDemoTIMEOUT) == eMQTTAgentSuccess )
+				if( prvPublishTelemetry(cTopic, cPayload) )
 				{
-					AZURE_PRINTF( ("Successfully Publish to SENSOR_TELEMETRY Topic\r\n"));
+					AZURE_PRINTF( ("Successfully Queued SENSOR_TELEMETRY\r\n"));
 					eNext_Azure_State = AZURE_SM_PUB_LOC_TELEMETRY;
 					eAzure_SM_Task = AZURE_SM_IDLE;
 				}
@@ -1179,8 +1390,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 				{
 					AZURE_PRINTF( ("Unsuccessfully Publish to SENSOR_TELEMETRY Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 
 				break;
@@ -1188,22 +1398,15 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
     		case AZURE_SM_PUB_LOC_TELEMETRY:
 				vTaskDelay(pdMS_TO_TICKS(1000));
 
-				memset(&(xPublishParameters), 0x00, sizeof(xPublishParameters));
 				memset(cTopic, 0, sizeof(cTopic));
 				memset(cPayload, 0, sizeof(cPayload));
 
                 sprintf(cTopic, AZURE_IOT_TELEMETRY_TOPIC_FOR_PUB, clientcredentialAZURE_IOT_DEVICE_ID);
 				sprintf(cPayload, Device_Location_Telemetry_JSON, lat, lon, alt);
 
-				xPublishParameters.pucTopic = (const uint8_t *)cTopic;
-				xPublishParameters.pvData = cPayload;
-				xPublishParameters.usTopicLength = (uint16_t)strlen(cTopic);
-				xPublishParameters.ulDataLength = strlen(cPayload);
-				xPublishParameters.xQoS = eMQTTQoS0;
-
-				if( MQTT_AGENT_Publish(xMQTTHandle, &xPublishParameters, AzureTwinDemoTIMEOUT) == eMQTTAgentSuccess )
+				if( prvPublishTelemetry(cTopic, cPayload) )
 				{
-					AZURE_PRINTF( ("Successfully Publish to LOC_TELEMETRY Topic\r\n"));
+					AZURE_PRINTF( ("Successfully Queued LOC_TELEMETRY\r\n"));
 					eNext_Azure_State = AZURE_SM_PUB_CELLULAR_TELEMETRY;
 					eAzure_SM_Task = AZURE_SM_IDLE;
 				}
@@ -1211,8 +1414,7 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 				{
 					AZURE_PRINTF( ("Unsuccessfully Publish to LOC_TELEMETRY Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 
 				break;
@@ -1220,34 +1422,59 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
     		case AZURE_SM_PUB_CELLULAR_TELEMETRY:
 				vTaskDelay(pdMS_TO_TICKS(1000));
 
-				memset(&(xPublishParameters), 0x00, sizeof(xPublishParameters));
 				memset(cTopic, 0, sizeof(cTopic));
 				memset(cPayload, 0, sizeof(cPayload));
 
                 sprintf(cTopic, AZURE_IOT_TELEMETRY_TOPIC_FOR_PUB, clientcredentialAZURE_IOT_DEVICE_ID);
 				sprintf(cPayload, Device_Cellular_Telemetry_JSON, mcc , mnc, lac, cid, iccid, imei, modem_fw, device_id);
 
-				xPublishParameters.pucTopic = (const uint8_t *)cTopic;
-				xPublishParameters.pvData = cPayload;
-				xPublishParameters.usTopicLength = (uint16_t)strlen(cTopic);
-				xPublishParameters.ulDataLength = strlen(cPayload);
-				xPublishParameters.xQoS = eMQTTQoS0;
-
-				if( MQTT_AGENT_Publish(xMQTTHandle, &xPublishParameters, AzureTwinDemoTIMEOUT) == eMQTTAgentSuccess )
+				if( prvPublishTelemetry(cTopic, cPayload) )
 				{
-					AZURE_PRINTF( ("Successfully Publish to CELLULAR_TELEMETRY Topic\r\n"));
-					eNext_Azure_State = AZURE_SM_PUB_SENSOR_TELEMETRY;
+					AZURE_PRINTF( ("Successfully Queued CELLULAR_TELEMETRY\r\n"));
+					eNext_Azure_State = AZURE_SM_PUB_DIAG_TELEMETRY;
 					eAzure_SM_Task = AZURE_SM_IDLE;
 				}
 				else
 				{
 					AZURE_PRINTF( ("Unsuccessfully Publish to CELLULAR_TELEMETRY Topic\r\n"));
 					AZURE_PRINTF( ("Disconnect\r\n"));
-					MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
-					eAzure_SM_Task = AZURE_SM_STATES_BNDRY;
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
+				}
+
+				break;
+
+    		case AZURE_SM_PUB_DIAG_TELEMETRY:
+    		{
+    			CellIoTProfile_t xProfile;
+
+				eNext_Azure_State = AZURE_SM_PUB_SENSOR_TELEMETRY;
+				eAzure_SM_Task = AZURE_SM_IDLE;
+
+				/* Nothing to send before the second sample */
+				if( !CellIoT_profile_Get(&xProfile) )
+				{
+					break;
+				}
+
+				memset(cTopic, 0, sizeof(cTopic));
+				memset(cPayload, 0, sizeof(cPayload));
+
+                sprintf(cTopic, AZURE_IOT_DIAG_TELEMETRY_TOPIC_FOR_PUB, clientcredentialAZURE_IOT_DEVICE_ID);
+				CellIoT_profile_Format(&xProfile, cPayload, CELLIOT_CONNMGR_PAYLOAD_LEN);
+
+				if( prvPublishTelemetry(cTopic, cPayload) )
+				{
+					AZURE_PRINTF( ("Successfully Queued DIAG_TELEMETRY\r\n"));
+				}
+				else
+				{
+					AZURE_PRINTF( ("Unsuccessfully Publish to DIAG_TELEMETRY Topic\r\n"));
+					AZURE_PRINTF( ("Disconnect\r\n"));
+					eAzure_SM_Task = AZURE_SM_RECONNECT;
 				}
 
 				break;
+    		}
 
     		case AZURE_SM_IDLE:
     			if( xTimerIsTimerActive( xTelemetryPublishTimer ) == pdFALSE )
@@ -1255,18 +1482,52 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
     				xTimerStart( xTelemetryPublishTimer, 0 );
     			}
 
+    			/* Bits are cleared one by one once handled: a request that arrives
+    			 * together with another one is served on the next pass through IDLE */
     			uxBits = xEventGroupWaitBits(xCreatedEventGroup,
-    										 LED_UPDATE_BIT_MASK | TELEMETRY_PUB_BIT_MASK,
-											 pdTRUE,
+    										 LED_UPDATE_BIT_MASK | TELEMETRY_PUB_BIT_MASK | SAS_RENEW_BIT_MASK | RADIO_AWAKE_BIT_MASK |
+											 MQTT_DISCONNECT_BIT_MASK,
+											 pdFALSE,
 											 pdFALSE,
 											 pdMS_TO_TICKS( 120000UL ));
 
-    			if( ( uxBits & LED_UPDATE_BIT_MASK ) != 0 )
+    			if( ( uxBits & MQTT_DISCONNECT_BIT_MASK ) != 0 )
+    			{
+    				AZURE_PRINTF( ("Connection lost\r\n"));
+    				eAzure_SM_Task = AZURE_SM_RECONNECT;
+    				break;
+    			}
+
+    			if( ( uxBits & RADIO_AWAKE_BIT_MASK ) != 0 )
+    			{
+    				xEventGroupClearBits(xCreatedEventGroup, RADIO_AWAKE_BIT_MASK);
+
+    				/* Radio woke up for another reason, piggyback the queued telemetry */
+    				if( CellIoT_connmgr_ShouldFlush() && !prvFlushTelemetry() )
+    				{
+    					AZURE_PRINTF( ("Unsuccessfully Publish queued telemetry\r\n"));
+    					AZURE_PRINTF( ("Disconnect\r\n"));
+    					eAzure_SM_Task = AZURE_SM_RECONNECT;
+    					break;
+    				}
+    			}
+
+    			if( ( uxBits & SAS_RENEW_BIT_MASK ) != 0 )
+				{
+					xEventGroupClearBits(xCreatedEventGroup, SAS_RENEW_BIT_MASK);
+
+					/* Reconnect with the renewed token before the current one expires */
+					AZURE_PRINTF( ("SAS token renewed, reconnecting\r\n") );
+					eAzure_SM_Task = AZURE_SM_CONNECT_TO_ASSIGNED_HUB;
+				}
+				else if( ( uxBits & LED_UPDATE_BIT_MASK ) != 0 )
 				{
+					xEventGroupClearBits(xCreatedEventGroup, LED_UPDATE_BIT_MASK);
 					eAzure_SM_Task = AZURE_SM_PUB_SET_LED_PROPERTIES;
 				}
 				else if( ( uxBits & TELEMETRY_PUB_BIT_MASK ) != 0 )
 				{
+					xEventGroupClearBits(xCreatedEventGroup, TELEMETRY_PUB_BIT_MASK);
 					eAzure_SM_Task = eNext_Azure_State;
 				}
 				else
@@ -1276,6 +1537,35 @@ void prvmcsft_Azure_TwinTask( void * pvParameters )
 
     			break;
 
+    		case AZURE_SM_RECONNECT:
+    			/* Closes what is left of the connection, the handle keeps the hub subscriptions */
+    			MQTT_AGENT_Disconnect(xMQTTHandle, AzureTwinDemoTIMEOUT);
+    			xEventGroupClearBits(xCreatedEventGroup, MQTT_DISCONNECT_BIT_MASK | EVENT_BIT_MASK);
+
+    			AZURE_PRINTF( ("Reconnecting in %u s\r\n", (unsigned) (ulReconnectDelayMs / 1000UL)) );
+    			vTaskDelay(pdMS_TO_TICKS(ulReconnectDelayMs));
+    			ulReconnectDelayMs = ( ulReconnectDelayMs < AZURE_RECONNECT_DELAY_MAX_MS / 2UL ) ?
+    								 ( ulReconnectDelayMs * 2UL ) : AZURE_RECONNECT_DELAY_MAX_MS;
+
+    			if( (username != NULL) && (strlen(username) != 0U)
+#ifdef SAS_KEY
+    				&& (AzureSas_GetToken(&xHubSas) != NULL)
+#endif
+    			  )
+    			{
+    				/* Provisioned already, the hub connection is what was lost */
+    				eAzure_SM_Task = AZURE_SM_CONNECT_TO_ASSIGNED_HUB;
+    			}
+    			else if( prvSetDpsConnectParams() )
+    			{
+    				eAzure_SM_Task = AZURE_SM_CONNECT_TO_DPS;
+    			}
+    			else
+    			{
+    				AZURE_PRINTF( ("Failed to generate the DPS SAS token\r\n") );
+    			}
+    			break;
+
     		default:
     	    	AZURE_PRINTF( ( "Invalid Application State!! \r\n" ) );
     	    	AZURE_PRINTF( ( "Closing Azure Demo\r\n" ) );
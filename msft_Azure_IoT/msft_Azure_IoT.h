@@ -23,6 +23,13 @@
 
 #define AZURE_PRINTF(x)		vLoggingPrintf x
 
+/* Set to 1 to send the telemetry compressed when it gets smaller, marked with
+ * its content encoding. The consumers of the hub must then decompress it.
+ */
+#ifndef AZURE_COMPRESS_TELEMETRY
+#define AZURE_COMPRESS_TELEMETRY	0
+#endif
+
 void prvmcsft_Azure_TwinTask( void * pvParameters );
 void vStartAzureLedDemoTask( void );
 
@@ -121,7 +121,12 @@
 
 #define MBEDTLS_FREESCALE_HASHCRYPT_AES    /* Enable use of HASHCRYPT AES.*/
 //#define MBEDTLS_FREESCALE_HASHCRYPT_SHA1   /* Enable use of HASHCRYPT SHA1.*/
-//#define MBEDTLS_FREESCALE_HASHCRYPT_SHA256 /* Enable use of HASHCRYPT SHA256.*/
+/* Hashcrypt without context switch is not able to calculate SHA in parallel with AES,
+ * so the mbedTLS SHA-256 (TLS transcript) stays in software there. One-shot
+ * ksdk_digest hashes still use the engine under the lock shared with AES. */
+#if defined(FSL_FEATURE_HASHCRYPT_HAS_RELOAD_FEATURE) && (FSL_FEATURE_HASHCRYPT_HAS_RELOAD_FEATURE > 0)
+#define MBEDTLS_FREESCALE_HASHCRYPT_SHA256 /* Enable use of HASHCRYPT SHA256 through ksdk_digest.*/
+#endif
 
 #endif
 
@@ -278,8 +283,10 @@
  *
  * To use SHA-224 on LPC, do not define MBEDTLS_SHA256_ALT and both SHA-224 and SHA-256 will use
  * original mbed TLS software implementation.
+ *
+ * HASHCRYPT SHA-256 goes through ksdk_digest, which runs SHA-224 in software.
  */
-#if defined(MBEDTLS_FREESCALE_LPC_SHA256) || defined(MBEDTLS_FREESCALE_DCP_SHA256) || defined(MBEDTLS_FREESCALE_HASHCRYPT_SHA256)
+#if defined(MBEDTLS_FREESCALE_LPC_SHA256) || defined(MBEDTLS_FREESCALE_DCP_SHA256)
 #define MBEDTLS_SHA256_ALT_NO_224
 #endif
 #endif
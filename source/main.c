@@ -55,6 +55,8 @@
 #include "aws_CellIoT.h"
 #include "clock_config.h"
 #include "CellIoT_lib.h"
+#include "CellIoT_connmgr.h"
+#include "CellIoT_profile.h"
 #include "gsm_init.h"
 #include "gsm_includes.h"
 
@@ -67,8 +69,14 @@
 #define INIT_SUCCESS 0
 #define INIT_FAIL    1
 
+/* Maximal time to wait for network registration */
+#define NETWORK_REGISTRATION_TIMEOUT_MS (300000U)
+/* Module resets without registration before waiting with the radio untouched */
+#define NETWORK_REGISTRATION_RESETS     (3U)
+
 #define LOGGING_TASK_PRIORITY   (tskIDLE_PRIORITY + 1)
-#define LOGGING_TASK_STACK_SIZE (200)
+#define LOGGING_TASK_STACK_SIZE (400)     /* messages are formatted in the logging task */
+#define PROFILE_PERIOD_MS       (60000U)  /* CPU, stack and heap sampling */
 #define LOGGING_QUEUE_LENGTH    (16)
 
 /* Accelerometer driver specific defines */
@@ -151,13 +159,27 @@ int initNetwork(void)
 
 	configPRINTF(("Wait to be connected to the network...\r\n"));
 
-	while(
-			( gsm_network_get_reg_status() != GSM_NETWORK_REG_STATUS_CONNECTED )
-			&&
-			( gsm_network_get_reg_status() != GSM_NETWORK_REG_STATUS_CONNECTED_ROAMING)
-	)
+	/* Poor coverage must not stop the device: report each timeout, then wait again */
+	for (uint32_t attempt = 1; AT_Parser_WaitRegistered(NETWORK_REGISTRATION_TIMEOUT_MS) != gsmOK; attempt++)
+	{
+		configPRINTF(("Not registered to the network after %u s (attempt %u, status %d).\r\n",
+					  NETWORK_REGISTRATION_TIMEOUT_MS / 1000U, (unsigned)attempt, (int)gsm_network_get_reg_status()));
+
+		/* A few module resets may clear a stuck search, after that only wait */
+		if (attempt <= NETWORK_REGISTRATION_RESETS)
+		{
+			configPRINTF(("Resetting the module.\r\n"));
+			if (gsm_reset(NULL, NULL, 1) != gsmOK)
+			{
+				configPRINTF(("Module reset failed.\r\n"));
+			}
+		}
+	}
+
+	/* Request PSM/eDRX and follow the radio state for the telemetry queue */
+	if (!CellIoT_connmgr_Init(NULL))
 	{
-		vTaskDelay(pdMS_TO_TICKS(100));
+		configPRINTF(("Power saving modes not available, radio stays on.\r\n"));
 	}
 
 #ifdef DBG_ON_CELLULAR_MODULE
@@ -281,6 +303,11 @@ status_t init_mag_accel(uint8_t *accelDataScale, uint8_t *accelResolution)
 
 void vApplicationDaemonTaskStartupHook(void)
 {
+    if (!CellIoT_profile_Start(PROFILE_PERIOD_MS))
+    {
+        configPRINTF(("Profiling could not be started\r\n"));
+    }
+
 #ifndef SAS_KEY
     /* A simple example to demonstrate key and certificate provisioning in
      * microcontroller flash using PKCS#11 interface. This should be replaced